@@ -120,11 +120,7 @@ void hmt_slam_guiFrame::thread_HMTSLAM()
 
 					// Wait for the mapping framework processed the data
 					// ---------------------------------------------------
-					if (!m_hmtslam->isInputQueueEmpty())
-					{
-						std::this_thread::sleep_for(2ms);
-						continue;
-					}
+					if (!m_hmtslam->waitForEmptyInputQueue(0.05)) continue;
 
 					// Load next object from the rawlog:
 					// ----------------------------------------
@@ -200,10 +200,9 @@ void Run_HMT_SLAM()
 			// Wait for the mapping framework processed the data
 			// ---------------------------------------------------
 			if ((rawlogEntry % STEPS_BETWEEN_WAITING_FOR_QUEUE_EMPTY) == 0)
-				while (!mapping.isInputQueueEmpty() && !os::kbhit() &&
+				while (!mapping.waitForEmptyInputQueue(0.05) && !os::kbhit() &&
 					   !mapping.abortedDueToErrors())
 				{
-					std::this_thread::sleep_for(2ms);
 				}
 		}  // (rawlogEntry>=rawlog_offset)
 
@@ -461,7 +461,8 @@ void MapBuilding_ICP_Live(const string& INI_FILENAME)
 				cam.setPointingAt(robotPose);
 			}
 
-			// The maps:
+			// The maps (after any pending asynchronous insertion):
+			mapBuilder.waitForPendingMapUpdates();
 			{
 				opengl::CSetOfObjects::Ptr obj =
 					mrpt::make_aligned_shared<opengl::CSetOfObjects>();
@@ -565,6 +566,7 @@ void MapBuilding_ICP_Live(const string& INI_FILENAME)
 	printf("Dumping final map in binary format to: %s\n", str.c_str());
 	mapBuilder.saveCurrentMapToFile(str);
 
+	mapBuilder.waitForPendingMapUpdates();
 	const CMultiMetricMap* finalPointsMap =
 		mapBuilder.getCurrentlyBuiltMetricMap();
 	str = format("%s/_finalmaps_.txt", OUT_DIR);
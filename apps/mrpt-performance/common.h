@@ -42,6 +42,7 @@ void register_tests_graphslam();
 void register_tests_CObservation3DRangeScan();
 void register_tests_atan2lut();
 void register_tests_strings();
+void register_tests_raytrace();
 // -------------------------------------------------
 
 using TestFunctor =
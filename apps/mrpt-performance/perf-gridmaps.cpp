@@ -8,6 +8,8 @@
    +------------------------------------------------------------------------+ */
 
 #include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/maps/COctoMap.h>
+#include <mrpt/maps/CVoxelMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/poses/CPose2D.h>
@@ -128,6 +130,38 @@ double grid_test_5_6(int a1, int a2)
 	return tictac.Tac() / N;
 }
 
+// a1: number of threads, a2: insert all the scans at once
+double grid_test_5_threads(int a1, int a2)
+{
+	getRandomGenerator().randomize(333);
+
+	CObservation2DRangeScan scan1;
+	scan1.aperture = M_PIf;
+	scan1.rightToLeft = true;
+	scan1.loadFromVectors(
+		sizeof(SCAN_RANGES_1) / sizeof(SCAN_RANGES_1[0]), SCAN_RANGES_1,
+		SCAN_VALID_1);
+
+	const long N = 3000;
+	std::vector<const CObservation2DRangeScan*> scans(N, &scan1);
+	std::vector<CPose3D> poses;
+	for (long i = 0; i < N; i++)
+		poses.emplace_back(CPose2D(
+			getRandomGenerator().drawUniform(-1.0, 1.0),
+			getRandomGenerator().drawUniform(-1.0, 1.0),
+			getRandomGenerator().drawUniform(-M_PI, M_PI)));
+
+	COccupancyGridMap2D gridmap(-20, 20, -20, 20, 0.05f);
+	gridmap.insertionOptions.num_threads = a1;
+	CTicTac tictac;
+	if (a2)
+		gridmap.insertScans(scans, poses);
+	else
+		for (long i = 0; i < N; i++)
+			gridmap.insertObservation(scans[i], &poses[i]);
+	return tictac.Tac() / N;
+}
+
 double grid_test_7(int a1, int a2)
 {
 	COccupancyGridMap2D gridmap(-20, 20, -20, 20, 0.05f);
@@ -213,6 +247,34 @@ double grid_test_9(int a1, int a2)
 	return tictac.Tac() / a1;
 }
 
+// Inserts a 640x480 point cloud, like those of RGB-D cameras, into a 3D
+// occupancy map: a1=0: COctoMap, a1=1: CVoxelMap, with a2 threads.
+double grid_test_10(int a1, int a2)
+{
+	getRandomGenerator().randomize(333);
+
+	CSimplePointsMap cloud;
+	for (int r = 0; r < 480; r++)
+		for (int c = 0; c < 640; c++)
+			cloud.insertPoint(
+				getRandomGenerator().drawUniform(3.5, 4.5),
+				-2.0 + 4.0 * c / 640, -1.0 + 3.0 * r / 480);
+
+	const long N = 3;
+	COctoMap octomap(0.05);
+	CVoxelMap voxelmap(0.05);
+	voxelmap.insertionOptions.num_threads = a2;
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+	{
+		if (a1)
+			voxelmap.insertPointCloud(cloud, 0, 0.1f * i, 0.5f);
+		else
+			octomap.insertPointCloud(cloud, 0, 0.1f * i, 0.5f);
+	}
+	return tictac.Tac() / N;
+}
+
 // ------------------------------------------------------
 // register_tests_grids
 // ------------------------------------------------------
@@ -226,7 +288,23 @@ void register_tests_grids()
 		"gridmap2D: insert scan w/o widening", grid_test_5_6, 0);
 	lstTests.emplace_back(
 		"gridmap2D: insert scan with widening", grid_test_5_6, 1);
+	lstTests.emplace_back(
+		"gridmap2D: insert scan w/o widening (4 threads)", grid_test_5_threads,
+		4, 0);
+	lstTests.emplace_back(
+		"gridmap2D: insert batch of scans w/o widening (1 thread)",
+		grid_test_5_threads, 1, 1);
+	lstTests.emplace_back(
+		"gridmap2D: insert batch of scans w/o widening (4 threads)",
+		grid_test_5_threads, 4, 1);
 	lstTests.emplace_back("gridmap2D: resize", grid_test_7);
 	lstTests.emplace_back("gridmap2D: computeLikelihood", grid_test_8);
 	lstTests.emplace_back("gridmap2D: determineMatching2D", grid_test_9, 5000);
+	lstTests.emplace_back(
+		"octomap: insert 640x480 point cloud", grid_test_10, 0, 1);
+	lstTests.emplace_back(
+		"voxelmap: insert 640x480 point cloud", grid_test_10, 1, 1);
+	lstTests.emplace_back(
+		"voxelmap: insert 640x480 point cloud (4 threads)", grid_test_10, 1,
+		4);
 }
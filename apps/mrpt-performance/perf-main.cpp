@@ -219,6 +219,7 @@ int main(int argc, char** argv)
 		register_tests_CObservation3DRangeScan();
 		register_tests_atan2lut();
 		register_tests_strings();
+		register_tests_raytrace();
 
 		if (doLog)
 		{
@@ -89,6 +89,49 @@ double pose_interp_test(int a1, int a2)
 	}
 }
 
+// Sorted queries, like those of the points in LiDAR scans, one by one
+// (a2=0) or with interpolateMany() (a2=1). a1 is the interpolation method.
+template <typename PATH_T>
+double pose_interp_test_sorted(int a1, int a2)
+{
+	using namespace std::chrono_literals;
+	using pose_t = typename PATH_T::pose_t;
+
+	PATH_T pose_path;
+	pose_path.setInterpolationMethod(mrpt::poses::TInterpolatorMethod(a1));
+	const auto t0 = mrpt::Clock::now();
+	auto& rnd = mrpt::random::getRandomGenerator();
+	for (int i = 0; i < 1000; i++)
+	{
+		pose_t p;
+		for (size_t k = 0; k < p.size(); k++) p[k] = rnd.drawUniform(-1, 1);
+		pose_path.insert(t0 + i * 100ms, p);
+	}
+
+	// 500 queries per path interval:
+	const long N = 400000;
+	std::vector<mrpt::Clock::time_point> ts(N);
+	for (long i = 0; i < N; i++) ts[i] = t0 + 100ms + i * 200us;
+
+	mrpt::system::CTicTac tictac;
+	std::vector<pose_t> poses(N);
+	std::vector<bool> valid(N);
+	if (a2)
+		pose_path.interpolateMany(ts, poses, valid);
+	else
+	{
+		bool v;
+		for (long i = 0; i < N; i++)
+		{
+			pose_path.interpolate(ts[i], poses[i], v);
+			valid[i] = v;
+		}
+	}
+	const double T = tictac.Tac() / N;
+	dummy_do_nothing_with_string(poses[N / 2].asString());
+	return T;
+}
+
 // ------------------------------------------------------
 // register_tests_pose_interp
 // ------------------------------------------------------
@@ -129,4 +172,23 @@ void register_tests_pose_interp()
 	lstTests.emplace_back(
 		"CPose2DInterpolator: TPose2D query",
 		&pose_interp_test<CPose2DInterpolator, TPose2D, true, false>);
+
+	lstTests.emplace_back(
+		"CPose3DInterpolator: sorted queries, LinearSlerp",
+		&pose_interp_test_sorted<CPose3DInterpolator>, imLinearSlerp, 0);
+	lstTests.emplace_back(
+		"CPose3DInterpolator: interpolateMany, LinearSlerp",
+		&pose_interp_test_sorted<CPose3DInterpolator>, imLinearSlerp, 1);
+	lstTests.emplace_back(
+		"CPose3DInterpolator: sorted queries, SplineSlerp",
+		&pose_interp_test_sorted<CPose3DInterpolator>, imSplineSlerp, 0);
+	lstTests.emplace_back(
+		"CPose3DInterpolator: interpolateMany, SplineSlerp",
+		&pose_interp_test_sorted<CPose3DInterpolator>, imSplineSlerp, 1);
+	lstTests.emplace_back(
+		"CPose2DInterpolator: sorted queries, LinearSlerp",
+		&pose_interp_test_sorted<CPose2DInterpolator>, imLinearSlerp, 0);
+	lstTests.emplace_back(
+		"CPose2DInterpolator: interpolateMany, LinearSlerp",
+		&pose_interp_test_sorted<CPose2DInterpolator>, imLinearSlerp, 1);
 }
@@ -123,6 +123,28 @@ double poses_test_compose3Dpoint3(int a1, int a2)
 	return T;
 }
 
+double poses_test_compose3Dpoints(int a1, int a2)
+{
+	const size_t N = 1000000;
+
+	CPose3D a(1.0, 2.0, 3.0, DEG2RAD(10), DEG2RAD(50), DEG2RAD(-30));
+	std::vector<float> xs(N), ys(N), zs(N), gxs(N), gys(N), gzs(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		xs[i] = 8.0f + i * 1e-5f;
+		ys[i] = -5.0f;
+		zs[i] = -1.0f;
+	}
+
+	CTicTac tictac;
+	a.composePoints(
+		&xs[0], &ys[0], &zs[0], &gxs[0], &gys[0], &gzs[0], N, nullptr,
+		nullptr, a1);
+	double T = tictac.Tac() / N;
+	dummy_do_nothing_with_string(mrpt::format("%f", gxs[N / 2]));
+	return T;
+}
+
 double poses_test_invcompose3Dpoint(int a1, int a2)
 {
 	const long N = 500000;
@@ -451,6 +473,12 @@ void register_tests_poses()
 		"poses: CPose3D.composePoint()", poses_test_compose3Dpoint2);
 	lstTests.emplace_back(
 		"poses: CPose3D.composePoint()+Jacobs", poses_test_compose3Dpoint3);
+	lstTests.emplace_back(
+		"poses: CPose3D.composePoints() 1e6 pts", poses_test_compose3Dpoints,
+		1);
+	lstTests.emplace_back(
+		"poses: CPose3D.composePoints() 1e6 pts, all threads",
+		poses_test_compose3Dpoints, 0);
 
 	lstTests.emplace_back(
 		"poses: CPoint3D (-) CPose3D", poses_test_invcompose3Dpoint);
@@ -10,6 +10,7 @@
 #include <mrpt/random.h>
 #include <mrpt/math/CMatrixFixedNumeric.h>
 #include <mrpt/math/CMatrixTemplateNumeric.h>
+#include <thread>
 
 #include "common.h"
 
@@ -195,6 +196,44 @@ double random_test_10(int a1, int a2)
 	return tictac.Tac() / N;
 }
 
+double random_test_11(int a1, int a2)
+{
+	CRandomGenerator rg;
+
+	// test 11: fillUniform / fillGaussian, in blocks of a1 samples
+	// ----------------------------------------
+	const long N = 100000000 / a1;
+	std::vector<double> v(a1);
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+	{
+		if (a2)
+			rg.fillGaussian(v.data(), v.size(), 5.0, 3.0);
+		else
+			rg.fillUniform(v.data(), v.size(), 0.0, 1.0);
+	}
+	return tictac.Tac() / (N * a1);
+}
+
+double random_test_12(int a1, int a2)
+{
+	CRandomGenerator rg(1);
+
+	// test 12: a1 threads filling their own streams
+	// ----------------------------------------
+	const size_t N = 10000000;
+	std::vector<std::vector<double>> v(a1, std::vector<double>(N));
+	std::vector<std::thread> threads;
+	CTicTac tictac;
+	for (int t = 0; t < a1; t++)
+		threads.emplace_back([&, t]() {
+			auto stream = rg.deriveStream(t + 1);
+			stream.fillGaussian(v[t].data(), N);
+		});
+	for (auto& t : threads) t.join();
+	return tictac.Tac() / (N * a1);
+}
+
 // ------------------------------------------------------
 // register_tests_random
 // ------------------------------------------------------
@@ -204,6 +243,16 @@ void register_tests_random()
 	lstTests.emplace_back("random: drawUniform", random_test_2);
 	lstTests.emplace_back("random: drawGaussian1D_normalized", random_test_3);
 	lstTests.emplace_back("random: drawGaussian1D", random_test_4);
+	lstTests.emplace_back(
+		"random: fillUniform (blocks of 16)", random_test_11, 16, 0);
+	lstTests.emplace_back(
+		"random: fillUniform (blocks of 1000)", random_test_11, 1000, 0);
+	lstTests.emplace_back(
+		"random: fillGaussian (blocks of 16)", random_test_11, 16, 1);
+	lstTests.emplace_back(
+		"random: fillGaussian (blocks of 1000)", random_test_11, 1000, 1);
+	lstTests.emplace_back(
+		"random: fillGaussian (4 threads, 4 streams)", random_test_12, 4);
 	lstTests.emplace_back("random: system rand()", random_test_5);
 
 	lstTests.emplace_back(
@@ -0,0 +1,139 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/opengl/COpenGLScene.h>
+#include <mrpt/opengl/CSetOfTriangles.h>
+#include <mrpt/math/geometry.h>
+#include <mrpt/poses/CPose3D.h>
+#include <cmath>
+
+#include "common.h"
+
+using namespace mrpt;
+using namespace mrpt::math;
+using namespace mrpt::opengl;
+using namespace mrpt::poses;
+using namespace std;
+
+// Builds a scene with a wavy terrain of 2*(N-1)^2 triangles
+static COpenGLScene::Ptr build_terrain_scene(int N)
+{
+	const auto z = [](int r, int c) {
+		return 0.5 * std::sin(r * 0.1) * std::cos(c * 0.07);
+	};
+	const double res = 20.0 / (N - 1);
+	auto tris = mrpt::make_aligned_shared<CSetOfTriangles>();
+	for (int r = 0; r < N - 1; r++)
+		for (int c = 0; c < N - 1; c++)
+		{
+			const TPoint3D p00(-10 + c * res, -10 + r * res, z(r, c));
+			const TPoint3D p01(p00.x + res, p00.y, z(r, c + 1));
+			const TPoint3D p10(p00.x, p00.y + res, z(r + 1, c));
+			const TPoint3D p11(p00.x + res, p00.y + res, z(r + 1, c + 1));
+			TPolygon3D t(3);
+			t[0] = p00, t[1] = p01, t[2] = p11;
+			tris->insertTriangle(CSetOfTriangles::TTriangle(t));
+			t[1] = p11, t[2] = p10;
+			tris->insertTriangle(CSetOfTriangles::TTriangle(t));
+		}
+
+	auto scene = mrpt::make_aligned_shared<COpenGLScene>();
+	scene->insert(tris);
+	return scene;
+}
+
+// Camera looking down at the terrain:
+static const CPose3D camPose(0, 0, 8, 0, DEG2RAD(80.0), 0);
+
+static mrpt::img::TCamera bench_camera(int width)
+{
+	mrpt::img::TCamera cam;
+	cam.ncols = width;
+	cam.nrows = width * 3 / 4;
+	cam.intrinsicParams(0, 0) = cam.intrinsicParams(1, 1) = width / 2;
+	cam.intrinsicParams(0, 2) = width / 2;
+	cam.intrinsicParams(1, 2) = width * 3 / 8;
+	return cam;
+}
+
+double raytrace_brute_force(int meshSize, int)
+{
+	const auto scene = build_terrain_scene(meshSize);
+	vector<TPolygon3D> polys3D;
+	scene->getByClass<CSetOfTriangles>()->getPolygons(polys3D);
+	vector<TPolygonWithPlane> polys;
+	TPolygonWithPlane::getPlanes(polys3D, polys);
+
+	const long N = 200;
+	CTicTac tictac;
+	double d, sum = 0;
+	for (long i = 0; i < N; i++)
+	{
+		const CPose3D ray = camPose + CPose3D(0, 0, 0, 0.001 * i, 0, 0);
+		if (mrpt::math::traceRay(polys, ray.asTPose(), d)) sum += d;
+	}
+	const double t = tictac.Tac() / N;
+	dummy_do_nothing_with_string(mrpt::format("%f", sum));
+	return t;
+}
+
+double raytrace_scene(int meshSize, int)
+{
+	const auto scene = build_terrain_scene(meshSize);
+	double d;
+	scene->traceRay(camPose, d);  // build caches
+
+	const long N = 20000;
+	CTicTac tictac;
+	double sum = 0;
+	for (long i = 0; i < N; i++)
+	{
+		const CPose3D ray = camPose + CPose3D(0, 0, 0, 1e-5 * i, 0, 0);
+		if (scene->traceRay(ray, d)) sum += d;
+	}
+	const double t = tictac.Tac() / N;
+	dummy_do_nothing_with_string(mrpt::format("%f", sum));
+	return t;
+}
+
+double raytrace_depth_image(int width, int nThreads)
+{
+	const auto scene = build_terrain_scene(301);
+	const auto cam = bench_camera(width);
+	CMatrixFloat depth;
+	scene->traceRaysDepthImage(camPose, cam, depth, 1);  // build caches
+
+	const long N = 5;
+	CTicTac tictac;
+	for (long i = 0; i < N; i++)
+		scene->traceRaysDepthImage(camPose, cam, depth, nThreads);
+	return tictac.Tac() / N;
+}
+
+// ------------------------------------------------------
+// register_tests_raytrace
+// ------------------------------------------------------
+void register_tests_raytrace()
+{
+	lstTests.emplace_back(
+		"raytrace: math::traceRay() brute force, 20k triangles",
+		raytrace_brute_force, 101);
+	lstTests.emplace_back(
+		"raytrace: COpenGLScene::traceRay() triangles, 20k triangles",
+		raytrace_scene, 101);
+	lstTests.emplace_back(
+		"raytrace: COpenGLScene::traceRay() triangles, 180k triangles",
+		raytrace_scene, 301);
+	lstTests.emplace_back(
+		"raytrace: depth image 320x240, 180k triangles, 1 thread",
+		raytrace_depth_image, 320, 1);
+	lstTests.emplace_back(
+		"raytrace: depth image 320x240, 180k triangles, all threads",
+		raytrace_depth_image, 320, 0);
+}
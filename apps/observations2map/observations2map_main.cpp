@@ -17,10 +17,14 @@
 
 #include <mrpt/system/os.h>
 #include <mrpt/maps/CSimpleMap.h>
+#include <mrpt/maps/CSimpleMapIndexedFile.h>
 #include <mrpt/maps/CMultiMetricMap.h>
+#include <mrpt/maps/CMetricMapSnapshot.h>
 #include <mrpt/config/CConfigFile.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
+#include <cmath>
+#include <cstdio>
 
 using namespace mrpt;
 using namespace mrpt::maps;
@@ -49,15 +53,47 @@ int main(int argc, char** argv)
 			"-\n");
 
 		// Process arguments:
-		if ((argc != 4 && argc != 6) ||
-			(argc == 6 && 0 != mrpt::system::os::_strcmp(argv[4], "-s")))
+		bool args_ok = (argc >= 4);
+		bool has_region = false;
+		double rx0 = 0, ry0 = 0, rx1 = 0, ry1 = 0;
+		string saveIndexedFile, saveSnapshotFile;
+		for (int i = 4; args_ok && i < argc; i += 2)
+		{
+			if (i + 1 >= argc)
+				args_ok = false;
+			else if (!mrpt::system::os::_strcmp(argv[i], "-s"))
+				METRIC_MAP_CONFIG_SECTION = string(argv[i + 1]);
+			else if (!mrpt::system::os::_strcmp(argv[i], "-r"))
+			{
+				has_region = true;
+				args_ok =
+					(4 == ::sscanf(
+							  argv[i + 1], "%lf,%lf,%lf,%lf", &rx0, &ry0,
+							  &rx1, &ry1));
+			}
+			else if (!mrpt::system::os::_strcmp(argv[i], "-i"))
+				saveIndexedFile = string(argv[i + 1]);
+			else if (!mrpt::system::os::_strcmp(argv[i], "-m"))
+				saveSnapshotFile = string(argv[i + 1]);
+			else
+				args_ok = false;
+		}
+
+		if (!args_ok)
 		{
 			cout << "Use: observations2map <config_file.ini> "
 					"<observations.simplemap> <outputmap_prefix> [-s "
-					"INI_FILE_SECTION_NAME] "
+					"INI_FILE_SECTION_NAME] [-r XMIN,YMIN,XMAX,YMAX] [-i "
+					"INDEXED_SIMPLEMAP_OUT] [-m SNAPSHOT_OUT]"
 				 << endl;
 			cout << "  Default: INI_FILE_SECTION_NAME = MappingApplication"
 				 << endl;
+			cout << "  -r: Only use the keyframes within this region (the "
+					"input must be an indexed simplemap)"
+				 << endl;
+			cout << "  -i: Also save the input as an indexed simplemap" << endl;
+			cout << "  -m: Also save the maps as a snapshot, for fast loading"
+				 << endl;
 			cout << "Push any key to exit..." << endl;
 			os::getch();
 			return -1;
@@ -67,18 +103,42 @@ int main(int argc, char** argv)
 		string inputFile = std::string(argv[2]);
 		string outprefix = std::string(argv[3]);
 
-		if (argc > 4)
-		{
-			METRIC_MAP_CONFIG_SECTION = string(argv[5]);
-		}
-
 		// Load simplemap:
-		cout << "Loading simplemap...";
 		mrpt::maps::CSimpleMap simplemap;
-		mrpt::io::CFileGZInputStream f(inputFile.c_str());
-		mrpt::serialization::archiveFrom(f) >> simplemap;
+		if (CSimpleMapIndexedFile::isIndexedFile(inputFile))
+		{
+			// Only load the required keyframes:
+			CSimpleMapIndexedFile idx(inputFile);
+			cout << "Indexed simplemap with " << idx.size() << " keyframes."
+				 << endl;
+			cout << "Loading keyframes...";
+			if (has_region)
+				idx.loadKeyframes(
+					idx.findInBox(
+						TPoint3D(rx0, ry0, -HUGE_VAL),
+						TPoint3D(rx1, ry1, HUGE_VAL)),
+					simplemap);
+			else
+				idx.loadAll(simplemap);
+		}
+		else
+		{
+			if (has_region)
+				throw std::runtime_error(
+					"Option -r requires an indexed simplemap as input");
+			cout << "Loading simplemap...";
+			mrpt::io::CFileGZInputStream f(inputFile.c_str());
+			mrpt::serialization::archiveFrom(f) >> simplemap;
+		}
 		cout << "done: " << simplemap.size() << " observations." << endl;
 
+		if (!saveIndexedFile.empty())
+		{
+			cout << "Saving indexed simplemap to " << saveIndexedFile << "...";
+			CSimpleMapIndexedFile::saveSimpleMap(simplemap, saveIndexedFile);
+			cout << "done." << endl;
+		}
+
 		// Create metric maps:
 		TSetOfMetricMapInitializers mapCfg;
 		mapCfg.loadFromConfigFile(
@@ -98,6 +158,14 @@ int main(int argc, char** argv)
 		// ---------------------------
 		metricMap.saveMetricMapRepresentationToFile(outprefix);
 
+		if (!saveSnapshotFile.empty())
+		{
+			cout << "Saving metric maps snapshot to " << saveSnapshotFile
+				 << "...";
+			CMetricMapSnapshot::save(metricMap, saveSnapshotFile);
+			cout << "done." << endl;
+		}
+
 		// grid maps:
 		size_t i;
 		for (i = 0; i < metricMap.m_gridMaps.size(); i++)
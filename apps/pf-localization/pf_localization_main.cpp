@@ -34,6 +34,7 @@
 #include <mrpt/maps/CSimpleMap.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
 #include <mrpt/maps/CMultiMetricMap.h>
+#include <mrpt/maps/CMetricMapSnapshot.h>
 
 #include <mrpt/system/os.h>
 #include <mrpt/system/vector_loadsave.h>
@@ -246,7 +247,15 @@ void do_pf_localization(
 		string mapExt = lowerCase(extractFileExtension(
 			MAP_FILE, true));  // Ignore possible .gz extensions
 
-		if (!mapExt.compare("simplemap"))
+		if (CMetricMapSnapshot::isSnapshotFile(MAP_FILE))
+		{
+			// Prebuilt metric maps (see observations2map):
+			// ---------------------------------------------
+			printf("Loading metric map snapshot...");
+			CMetricMapSnapshot::load(MAP_FILE, metricMap);
+			printf("Ok\n");
+		}
+		else if (!mapExt.compare("simplemap"))
 		{
 			// It's a ".simplemap":
 			// -------------------------
@@ -16,6 +16,14 @@
 #include <mrpt/system/os.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+
 // Aparently, TCLAP headers can't be included in more than one source file
 //  or duplicated linking symbols appear! -> Use forward declarations instead:
 // #include <mrpt/otherlibs/tclap/CmdLine.h>
@@ -31,6 +39,13 @@ namespace rawlogtools
 /** A virtual class that implements the common stuff around parsing a rawlog
  * file
  * and (optionally) display a progress indicator to the console.
+ *
+ * By default, entries are read, processed and written one at a time. Derived
+ * classes whose processOneEntry() is thread-safe may call
+ * setParallelWorkers() to run a pipeline instead: the calling thread reads
+ * entries, N worker threads run processOneEntry() concurrently, and a writer
+ * thread invokes OnPostProcess() strictly in the original rawlog order. The
+ * number of entries in flight is bounded to keep memory usage constant.
  */
 class CRawlogProcessor
 {
@@ -40,6 +55,29 @@ class CRawlogProcessor
 	bool verbose;
 	mrpt::system::TTimeStamp m_last_console_update;
 	mrpt::system::CTicTac m_timParse;
+	/** Number of threads running processOneEntry() (1=sequential) */
+	size_t m_num_workers{1};
+
+	/** Per-thread information on the entry being processed */
+	struct TEntryContext
+	{
+		size_t rawlogEntry{0};
+		bool drop{false};
+	};
+	static TEntryContext& entryContext()
+	{
+		static thread_local TEntryContext ctx;
+		return ctx;
+	}
+
+	/** Returns the rawlog index (as in m_rawlogEntry) of the entry being
+	 * processed by the calling thread. Use this instead of m_rawlogEntry from
+	 * within processOneEntry(), since it is also valid in parallel mode. */
+	size_t currentEntryIndex() const { return entryContext().rawlogEntry; }
+
+	/** Can be called from processOneEntry() to skip OnPostProcess() for the
+	 * current entry (e.g. to remove it from the output rawlog). */
+	void dropCurrentEntry() { entryContext().drop = true; }
 
    public:
 	uint64_t m_filSize;
@@ -59,9 +97,26 @@ class CRawlogProcessor
 		m_filSize = _in_rawlog.getTotalBytesCount();
 	}
 
+	/** Enables the parallel pipeline with `n` worker threads (0: as many as
+	 * hardware threads, 1: sequential processing). Only enable it for
+	 * derived classes whose processOneEntry() is thread-safe. */
+	void setParallelWorkers(size_t n)
+	{
+		m_num_workers =
+			n != 0 ? n
+				   : std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+	size_t getParallelWorkers() const { return m_num_workers; }
+
 	// The main method:
 	void doProcessRawlog()
 	{
+		if (m_num_workers > 1)
+		{
+			doProcessRawlogParallel();
+			return;
+		}
+
 		// The 3 different objects we can read from a rawlog:
 		mrpt::obs::CActionCollection::Ptr actions;
 		mrpt::obs::CSensoryFrame::Ptr SF;
@@ -83,31 +138,15 @@ class CRawlogProcessor
 				}
 
 			// Update status to the console?
-			const mrpt::system::TTimeStamp tNow = mrpt::system::now();
-			if (mrpt::system::timeDifference(m_last_console_update, tNow) >
-				0.25)
-			{
-				m_last_console_update = tNow;
-				uint64_t fil_pos = m_in_rawlog.getPosition();
-				if (verbose)
-				{
-					std::cout << mrpt::format(
-						"Progress: %7u objects --- Pos: %9sB/%c%9sB \r",
-						(unsigned int)m_rawlogEntry,
-						mrpt::system::unitsFormat(fil_pos).c_str(),
-						(fil_pos > m_filSize ? '>' : ' '),
-						mrpt::system::unitsFormat(m_filSize)
-							.c_str());  // \r -> don't go to the next line...
-
-					std::cout.flush();
-				}
-			}
+			showProgress();
 
 			// Do whatever:
+			entryContext() = TEntryContext();
+			entryContext().rawlogEntry = m_rawlogEntry;
 			bool process_ret = processOneEntry(actions, SF, obs);
 
 			// Post process:
-			OnPostProcess(actions, SF, obs);
+			if (!entryContext().drop) OnPostProcess(actions, SF, obs);
 
 			// Clear read objects:
 			actions.reset();
@@ -130,6 +169,209 @@ class CRawlogProcessor
 
 	}  // end doProcessRawlog
 
+   private:
+	void showProgress()
+	{
+		const mrpt::system::TTimeStamp tNow = mrpt::system::now();
+		if (mrpt::system::timeDifference(m_last_console_update, tNow) > 0.25)
+		{
+			m_last_console_update = tNow;
+			uint64_t fil_pos = m_in_rawlog.getPosition();
+			if (verbose)
+			{
+				std::cout << mrpt::format(
+					"Progress: %7u objects --- Pos: %9sB/%c%9sB \r",
+					(unsigned int)m_rawlogEntry,
+					mrpt::system::unitsFormat(fil_pos).c_str(),
+					(fil_pos > m_filSize ? '>' : ' '),
+					mrpt::system::unitsFormat(m_filSize)
+						.c_str());  // \r -> don't go to the next line...
+
+				std::cout.flush();
+			}
+		}
+	}
+
+	/** One rawlog entry travelling through the parallel pipeline */
+	struct TPipelineEntry
+	{
+		mrpt::obs::CActionCollection::Ptr actions;
+		mrpt::obs::CSensoryFrame::Ptr SF;
+		mrpt::obs::CObservation::Ptr obs;
+		TEntryContext ctx;
+		bool process_ret{true};
+	};
+
+	/** reader (this thread) -> N workers -> ordered writer */
+	void doProcessRawlogParallel()
+	{
+		std::mutex mtx;
+		std::condition_variable cv_jobs, cv_done, cv_space;
+		std::deque<std::pair<size_t, TPipelineEntry>> jobs;
+		std::map<size_t, TPipelineEntry> done;
+		size_t next_seq_read = 0, next_seq_write = 0;
+		bool input_finished = false, stop = false;
+		std::exception_ptr error;
+		const size_t max_in_flight = 4 * m_num_workers;
+
+		m_timParse.Tic();
+
+		auto worker = [&]() {
+			for (;;)
+			{
+				std::pair<size_t, TPipelineEntry> job;
+				{
+					std::unique_lock<std::mutex> lck(mtx);
+					cv_jobs.wait(
+						lck, [&]() { return input_finished || !jobs.empty(); });
+					if (jobs.empty()) return;
+					job = std::move(jobs.front());
+					jobs.pop_front();
+				}
+				auto& e = job.second;
+				try
+				{
+					bool skip;
+					{
+						std::lock_guard<std::mutex> lck(mtx);
+						skip = stop;
+					}
+					if (!skip)
+					{
+						entryContext() = e.ctx;
+						e.process_ret = processOneEntry(e.actions, e.SF, e.obs);
+						e.ctx = entryContext();
+					}
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lck(mtx);
+					if (!error) error = std::current_exception();
+					stop = true;
+				}
+				{
+					std::lock_guard<std::mutex> lck(mtx);
+					done.emplace(job.first, std::move(e));
+				}
+				cv_done.notify_one();
+			}
+		};
+
+		auto writer = [&]() {
+			for (;;)
+			{
+				TPipelineEntry e;
+				{
+					std::unique_lock<std::mutex> lck(mtx);
+					cv_done.wait(lck, [&]() {
+						return done.count(next_seq_write) != 0 ||
+							   (input_finished &&
+								next_seq_write == next_seq_read);
+					});
+					auto it = done.find(next_seq_write);
+					if (it == done.end()) return;
+					e = std::move(it->second);
+					done.erase(it);
+					if (stop)
+					{
+						// Discard entries after the one that stopped parsing:
+						next_seq_write++;
+						lck.unlock();
+						cv_space.notify_one();
+						continue;
+					}
+				}
+				try
+				{
+					if (!e.ctx.drop) OnPostProcess(e.actions, e.SF, e.obs);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lck(mtx);
+					if (!error) error = std::current_exception();
+					stop = true;
+				}
+				{
+					std::lock_guard<std::mutex> lck(mtx);
+					if (!e.process_ret && !stop)
+					{
+						// Returning false means we should stop parsing the
+						// rest of the rawlog:
+						std::cerr << "\nParsing stopped due to request from "
+									 "Rawlog filter implementation.\n";
+						stop = true;
+					}
+					next_seq_write++;
+				}
+				cv_space.notify_one();
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for (size_t i = 0; i < m_num_workers; i++)
+			workers.emplace_back(worker);
+		std::thread writer_thread(writer);
+
+		// Parse the entire rawlog:
+		auto arch = mrpt::serialization::archiveFrom(m_in_rawlog);
+		for (;;)
+		{
+			TPipelineEntry e;
+			try
+			{
+				if (!mrpt::obs::CRawlog::getActionObservationPairOrObservation(
+						arch, e.actions, e.SF, e.obs, m_rawlogEntry))
+					break;
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lck(mtx);
+				if (!error) error = std::current_exception();
+				break;
+			}
+
+			// Abort if the user presses ESC:
+			if (mrpt::system::os::kbhit())
+				if (27 == mrpt::system::os::getch())
+				{
+					std::cerr << "Aborted since user pressed ESC.\n";
+					break;
+				}
+
+			showProgress();
+
+			e.ctx.rawlogEntry = m_rawlogEntry;
+			{
+				std::unique_lock<std::mutex> lck(mtx);
+				// Bound memory usage: wait for the writer to catch up.
+				cv_space.wait(lck, [&]() {
+					return stop ||
+						   next_seq_read - next_seq_write < max_in_flight;
+				});
+				if (stop) break;
+				jobs.emplace_back(next_seq_read++, std::move(e));
+			}
+			cv_jobs.notify_one();
+		}
+
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			input_finished = true;
+		}
+		cv_jobs.notify_all();
+		cv_done.notify_all();
+		for (auto& t : workers) t.join();
+		writer_thread.join();
+
+		if (verbose) std::cout << "\n";  // new line after the "\r".
+
+		m_timToParse = m_timParse.Tac();
+
+		if (error) std::rethrow_exception(error);
+	}
+
+   public:
+
 	// The virtual method of the user to be invoked for each read object:
 	//  Return false to abort and stop the read loop.
 	virtual bool processOneEntry(
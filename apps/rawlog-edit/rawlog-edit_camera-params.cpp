@@ -13,6 +13,7 @@
 #include <mrpt/config/CConfigFile.h>
 #include <mrpt/obs/CObservationImage.h>
 #include <mrpt/obs/CObservationStereoImages.h>
+#include <atomic>
 
 using namespace mrpt;
 using namespace mrpt::obs;
@@ -38,7 +39,7 @@ DECLARE_OP_FUNCTION(op_camera_params)
 		bool is_stereo;
 
 	   public:
-		size_t m_changedCams;
+		std::atomic<size_t> m_changedCams;
 
 		CRawlogProcessor_CamParams(
 			CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
@@ -145,6 +146,9 @@ DECLARE_OP_FUNCTION(op_camera_params)
 	// Process
 	// ---------------------------------
 	CRawlogProcessor_CamParams proc(in_rawlog, cmdline, verbose);
+	size_t nThreads = 1;
+	getArgValue<size_t>(cmdline, "threads", nThreads);
+	proc.setParallelWorkers(nThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
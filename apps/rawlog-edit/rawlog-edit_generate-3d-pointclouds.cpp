@@ -9,6 +9,7 @@
 
 #include "rawlog-edit-declarations.h"
 #include <mrpt/obs/CObservation3DRangeScan.h>
+#include <atomic>
 
 using namespace mrpt;
 using namespace mrpt::obs;
@@ -30,7 +31,7 @@ DECLARE_OP_FUNCTION(op_generate_3d_pointclouds)
 		TOutputRawlogCreator outrawlog;
 
 	   public:
-		size_t entries_modified;
+		std::atomic<size_t> entries_modified;
 
 		CRawlogProcessor_Generate3DPointClouds(
 			CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
@@ -76,6 +77,9 @@ DECLARE_OP_FUNCTION(op_generate_3d_pointclouds)
 	// Process
 	// ---------------------------------
 	CRawlogProcessor_Generate3DPointClouds proc(in_rawlog, cmdline, verbose);
+	size_t nThreads = 1;
+	getArgValue<size_t>(cmdline, "threads", nThreads);
+	proc.setParallelWorkers(nThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
@@ -13,6 +13,7 @@
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/CObservation3DRangeScan.h>
+#include <atomic>
 
 using namespace mrpt;
 using namespace mrpt::maps;
@@ -33,7 +34,7 @@ DECLARE_OP_FUNCTION(op_generate_pcd)
 	{
 	   protected:
 	   public:
-		size_t entries_done;
+		std::atomic<size_t> entries_done;
 		std::string m_outdir;
 
 		CRawlogProcessor_GeneratePCD(
@@ -54,7 +55,7 @@ DECLARE_OP_FUNCTION(op_generate_pcd)
 		{
 			const string label_time = format(
 				"%s/%06u_%s_%f.pcd", m_outdir.c_str(),
-				static_cast<unsigned int>(m_rawlogEntry),
+				static_cast<unsigned int>(currentEntryIndex()),
 				obs->sensorLabel.empty() ? "NOLABEL" : obs->sensorLabel.c_str(),
 				timestampTotime_t(obs->timestamp));
 			if (IS_CLASS(obs, CObservation3DRangeScan))
@@ -98,6 +99,9 @@ DECLARE_OP_FUNCTION(op_generate_pcd)
 	// Process
 	// ---------------------------------
 	CRawlogProcessor_GeneratePCD proc(in_rawlog, cmdline, verbose);
+	size_t nThreads = 1;
+	getArgValue<size_t>(cmdline, "threads", nThreads);
+	proc.setParallelWorkers(nThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
@@ -145,6 +145,14 @@ TCLAP::SwitchArg arg_overwrite(
 
 TCLAP::SwitchArg arg_quiet("q", "quiet", "Terse output", cmd, false);
 
+TCLAP::ValueArg<size_t> arg_threads(
+	"", "threads",
+	"Number of threads for the operations which support parallel processing "
+	"(--camera-params, --generate-3d-pointclouds, --generate-pcd, "
+	"--stereo-rectify). Entries are still written in their original order. "
+	"0: use all CPU cores.",
+	false, 1, "N", cmd);
+
 // ======================================================================
 //     main() of rawlog-edit
 // ======================================================================
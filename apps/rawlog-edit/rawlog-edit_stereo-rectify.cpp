@@ -9,6 +9,8 @@
 
 #include "rawlog-edit-declarations.h"
 #include <mrpt/vision/CStereoRectifyMap.h>
+#include <atomic>
+#include <mutex>
 
 using namespace mrpt;
 using namespace mrpt::obs;
@@ -34,14 +36,14 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 		string imgFileExtension;
 		double rectify_alpha;  // [0,1] see cvStereoRectify()
 
-		bool m_this_obs_is_ok;
-
 		mrpt::vision::CStereoRectifyMap rectify_map;
+		/** Protects the initialization of rectify_map */
+		std::mutex rectify_map_mtx;
 
-		size_t m_num_external_files_failures;
+		std::atomic<size_t> m_num_external_files_failures;
 
 	   public:
-		size_t m_changedCams;
+		std::atomic<size_t> m_changedCams;
 
 		CRawlogProcessor_StereoRectify(
 			CFileGZInputStream& in_rawlog, TCLAP::CmdLine& cmdline,
@@ -131,8 +133,6 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 
 		bool processOneObservation(CObservation::Ptr& obs) override
 		{
-			m_this_obs_is_ok = true;
-
 			if (strCmpI(obs->sensorLabel, target_label))
 			{
 				if (IS_CLASS(obs, CObservationStereoImages))
@@ -144,11 +144,14 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 					try
 					{
 						// Already initialized the rectification map?
-						if (!rectify_map.isSet())
 						{
-							// On the first ocassion, initialize map:
-							rectify_map.setAlpha(rectify_alpha);
-							rectify_map.setFromCamParams(*o);
+							std::lock_guard<std::mutex> lck(rectify_map_mtx);
+							if (!rectify_map.isSet())
+							{
+								// On the first ocassion, initialize map:
+								rectify_map.setAlpha(rectify_alpha);
+								rectify_map.setFromCamParams(*o);
+							}
 						}
 
 						// This is needed to raise an exception of the correct
@@ -159,7 +162,9 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 						// This call rectifies the images in-place and also
 						// updates
 						// all the camera parameters as needed:
-						rectify_map.rectify(*o);
+						// (The internal memory cache can't be used from
+						// several threads at once)
+						rectify_map.rectify(*o, getParallelWorkers() == 1);
 
 						const string label_time = format(
 							"%s_%f", o->sensorLabel.c_str(),
@@ -183,15 +188,13 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 					catch (mrpt::img::CExceptionExternalImageNotFound&)
 					{
 						const size_t MAX_FAILURES = 1000;
-						m_num_external_files_failures++;
-
-						if (m_num_external_files_failures < MAX_FAILURES)
+						if (++m_num_external_files_failures < MAX_FAILURES)
 						{
-							m_this_obs_is_ok = false;
+							dropCurrentEntry();
 							cerr << "\n *WARNING*: Dropping one observation "
 									"due to missing external image file at "
 									"rawlog entry "
-								 << m_rawlogEntry << endl;
+								 << currentEntryIndex() << endl;
 						}
 						else
 						{
@@ -212,8 +215,6 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 			mrpt::obs::CSensoryFrame::Ptr& SF,
 			mrpt::obs::CObservation::Ptr& obs) override
 		{
-			if (!m_this_obs_is_ok) return;
-
 			ASSERT_((actions && SF) || obs);
 			if (actions)
 				(*outrawlog.out_rawlog) << actions << SF;
@@ -225,6 +226,9 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 	// Process
 	// ---------------------------------
 	CRawlogProcessor_StereoRectify proc(in_rawlog, cmdline, verbose);
+	size_t nThreads = 1;
+	getArgValue<size_t>(cmdline, "threads", nThreads);
+	proc.setParallelWorkers(nThreads);
 	proc.doProcessRawlog();
 
 	// Dump statistics:
@@ -18,7 +18,8 @@
 
 #include <mrpt/hwdrivers/CGenericSensor.h>
 #include <mrpt/config/CConfigFile.h>
-#include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileGZParallelOutputStream.h>
+#include <mrpt/containers/spsc_queue.h>
 #include <mrpt/img/CImage.h>
 #include <mrpt/core/round.h>
 #include <mrpt/obs/CActionCollection.h>
@@ -31,6 +32,7 @@
 #include <mrpt/system/filesystem.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <atomic>
 #include <thread>
 
 #ifdef RAWLOGGRABBER_PLUGIN
@@ -52,19 +54,21 @@ const bool hwdrivers_verbose = (getenv("MRPT_HWDRIVERS_VERBOSE") != nullptr) &&
 
 const std::string GLOBAL_SECTION_NAME = "global";
 
+/** Lock-free queue between one sensor thread (producer) and the main
+ * thread (consumer). */
+using TSensorQueue = mrpt::containers::spsc_queue<CGenericSensor::TListObsPair>;
+
 // Forward declarations:
 struct TThreadParams
 {
 	CConfigFile* cfgFile;
 	string sensor_label;
+	TSensorQueue* queue;
 };
 
 void SensorThread(TThreadParams params);
 
-CGenericSensor::TListObservations global_list_obs;
-std::mutex cs_global_list_obs;
-
-bool allThreadsMustExit = false;
+std::atomic_bool allThreadsMustExit{false};
 
 string rawlog_ext_imgs_dir;  // Directory where to save externally stored
 // images, only for CCameraSensor's.
@@ -107,6 +111,10 @@ int main(int argc, char** argv)
 		int GRABBER_PERIOD_MS = 1000;
 		int rawlog_GZ_compress_level =
 			1;  // 0: No compress, 1-9: compress level
+		int rawlog_GZ_compress_threads = 0;  // 0: #cores
+		int rawlog_GZ_block_size_kb = 1024;
+		int sensor_queue_capacity = 1000;
+		double show_stats_period = 10.0;  // Seconds (0: never)
 
 		MRPT_LOAD_CONFIG_VAR(
 			rawlog_prefix, string, iniFile, GLOBAL_SECTION_NAME);
@@ -121,6 +129,16 @@ int main(int argc, char** argv)
 
 		MRPT_LOAD_CONFIG_VAR(
 			rawlog_GZ_compress_level, int, iniFile, GLOBAL_SECTION_NAME);
+		MRPT_LOAD_CONFIG_VAR(
+			rawlog_GZ_compress_threads, int, iniFile, GLOBAL_SECTION_NAME);
+		MRPT_LOAD_CONFIG_VAR(
+			rawlog_GZ_block_size_kb, int, iniFile, GLOBAL_SECTION_NAME);
+		MRPT_LOAD_CONFIG_VAR(
+			sensor_queue_capacity, int, iniFile, GLOBAL_SECTION_NAME);
+		MRPT_LOAD_CONFIG_VAR(
+			show_stats_period, double, iniFile, GLOBAL_SECTION_NAME);
+		ASSERT_ABOVE_(rawlog_GZ_block_size_kb, 0);
+		ASSERT_ABOVE_(sensor_queue_capacity, 0);
 
 		// Build full rawlog file name:
 		string rawlog_postfix = "_";
@@ -163,6 +181,9 @@ int main(int argc, char** argv)
 		iniFile.getAllSections(sections);
 
 		vector<std::thread> lstThreads;
+		// One ingestion queue per sensor thread:
+		vector<std::pair<std::string, std::unique_ptr<TSensorQueue>>>
+			lstQueues;
 
 		for (auto& section : sections)
 		{
@@ -171,9 +192,14 @@ int main(int argc, char** argv)
 					section, "rawlog-grabber-ignore", false, false))
 				continue;  // This is not a sensor:
 
+			lstQueues.emplace_back(
+				section, std::make_unique<TSensorQueue>(
+							 static_cast<size_t>(sensor_queue_capacity)));
+
 			TThreadParams threParms;
 			threParms.cfgFile = &iniFile;
 			threParms.sensor_label = section;
+			threParms.queue = lstQueues.back().second.get();
 
 			lstThreads.emplace_back(&SensorThread, threParms);
 			std::this_thread::sleep_for(
@@ -183,31 +209,48 @@ int main(int argc, char** argv)
 		// ----------------------------------------------
 		// Run:
 		// ----------------------------------------------
-		mrpt::io::CFileGZOutputStream out_file;
+		// Observations are serialized in this thread, then compressed in
+		// independent gzip blocks by a pool of threads:
+		mrpt::io::CFileGZParallelOutputStream::TOptions gzOpts;
+		gzOpts.compress_level = rawlog_GZ_compress_level;
+		gzOpts.num_threads = rawlog_GZ_compress_threads;
+		gzOpts.block_size = rawlog_GZ_block_size_kb * 1024;
+
+		mrpt::io::CFileGZParallelOutputStream out_file;
 		auto out_arch = archiveFrom(out_file);
 
-		out_file.open(rawlog_filename, rawlog_GZ_compress_level);
+		if (!out_file.open(rawlog_filename, gzOpts))
+			THROW_EXCEPTION_FMT(
+				"Error creating output file: '%s'", rawlog_filename.c_str());
 
 		CSensoryFrame curSF;
+		// Observations sorted by timestamp, only accessed from this thread:
+		CGenericSensor::TListObservations global_list_obs;
 		CGenericSensor::TListObservations copy_of_global_list_obs;
 
+		TTimeStamp last_stats_time = now();
+
 		cout << endl << "Press any key to exit program" << endl;
 		while (!os::kbhit() && !allThreadsMustExit)
 		{
-			// See if we have observations and process them:
+			// Gather new observations from all sensor threads:
+			for (auto& q : lstQueues)
 			{
-				std::lock_guard<std::mutex> lock(cs_global_list_obs);
-				copy_of_global_list_obs.clear();
+				CGenericSensor::TListObsPair o;
+				while (q.second->try_pop(o))
+					global_list_obs.insert(std::move(o));
+			}
 
-				if (!global_list_obs.empty())
-				{
-					auto itEnd = global_list_obs.begin();
-					std::advance(itEnd, global_list_obs.size() / 2);
-					copy_of_global_list_obs.insert(
-						global_list_obs.begin(), itEnd);
-					global_list_obs.erase(global_list_obs.begin(), itEnd);
-				}
-			}  // End of cs lock
+			// Only dump the oldest half, so observations arriving late from
+			// other sensors can still be sorted by timestamp:
+			copy_of_global_list_obs.clear();
+			if (!global_list_obs.empty())
+			{
+				auto itEnd = global_list_obs.begin();
+				std::advance(itEnd, global_list_obs.size() / 2);
+				copy_of_global_list_obs.insert(global_list_obs.begin(), itEnd);
+				global_list_obs.erase(global_list_obs.begin(), itEnd);
+			}
 
 			if (use_sensoryframes)
 			{
@@ -433,6 +476,36 @@ int main(int argc, char** argv)
 						 << endl;
 				}
 			}
+
+			// Back-pressure statistics:
+			if (show_stats_period > 0 &&
+				timeDifference(last_stats_time, now()) > show_stats_period)
+			{
+				last_stats_time = now();
+				const auto st = out_file.getStats();
+				cout << format(
+					"[stats] Written: %.02f MB -> %.02f MB compressed in %u "
+					"blocks. Blocks in flight: %u (max: %u). Writer stalls: "
+					"%u (%.03f s).\n",
+					st.bytes_in / (1024.0 * 1024.0),
+					st.bytes_out / (1024.0 * 1024.0),
+					static_cast<unsigned int>(st.blocks_written),
+					static_cast<unsigned int>(st.blocks_in_flight),
+					static_cast<unsigned int>(st.max_blocks_in_flight),
+					static_cast<unsigned int>(st.stall_count), st.stall_time);
+				for (const auto& q : lstQueues)
+					cout << format(
+						"[stats]  Queue '%s': %u pending, max: %u/%u, "
+						"dropped observations: %u\n",
+						q.first.c_str(),
+						static_cast<unsigned int>(q.second->size()),
+						static_cast<unsigned int>(
+							q.second->high_water_mark()),
+						static_cast<unsigned int>(q.second->capacity()),
+						static_cast<unsigned int>(
+							q.second->rejected_count()));
+			}
+
 			std::this_thread::sleep_for(
 				std::chrono::milliseconds(GRABBER_PERIOD_MS));
 		}
@@ -444,9 +517,6 @@ int main(int argc, char** argv)
 				 << endl;
 		}
 
-		// Flush file to disk:
-		out_file.close();
-
 		// Wait all threads:
 		// ----------------------------
 		allThreadsMustExit = true;
@@ -454,6 +524,20 @@ int main(int argc, char** argv)
 		cout << endl << "Waiting for all threads to close..." << endl;
 		for (auto& lstThread : lstThreads) lstThread.join();
 
+		// Dump remaining observations (in the non-SF mode) and flush file to
+		// disk:
+		if (!use_sensoryframes)
+		{
+			for (auto& q : lstQueues)
+			{
+				CGenericSensor::TListObsPair o;
+				while (q.second->try_pop(o))
+					global_list_obs.insert(std::move(o));
+			}
+			for (auto& o : global_list_obs) out_arch << *o.second;
+		}
+		out_file.close();
+
 		return 0;
 	}
 	catch (std::exception& e)
@@ -519,10 +603,10 @@ void SensorThread(TThreadParams params)
 			CGenericSensor::TListObservations lstObjs;
 			sensor->getObservations(lstObjs);
 
-			{
-				std::lock_guard<std::mutex> lock(cs_global_list_obs);
-				global_list_obs.insert(lstObjs.begin(), lstObjs.end());
-			}
+			// Hand them to the main thread. If the queue is full, drop the
+			// observation instead of stalling the sensor driver (it is
+			// counted once as a rejected push in the queue statistics):
+			for (auto& o : lstObjs) params.queue->try_push(std::move(o));
 
 			lstObjs.clear();
 
@@ -270,7 +270,7 @@ void MapBuilding_RBPF()
 		for (auto& m_particle : mapBuilder.mapPDF.m_particles)
 		{
 			CRBPFParticleData* part_d = m_particle.d.get();
-			CMultiMetricMap& mmap = part_d->mapTillNow;
+			CMultiMetricMap& mmap = part_d->mapTillNowForWriting();
 			mrpt::maps::COccupancyGridMap2D::Ptr it_grid =
 				mmap.getMapByClass<mrpt::maps::COccupancyGridMap2D>();
 			ASSERTMSG_(
@@ -32,8 +32,24 @@ serialization with variants(To be replaced by std::variant eventually).
 	- Changes in applications:
 		- RawLogViewer:
 			- The ICP module now supports Velodyne 3D scans.
+		- rawlog-edit:
+			- New argument `--threads` to run `--camera-params`,
+`--generate-3d-pointclouds`, `--generate-pcd` and `--stereo-rectify` as a
+parallel reader/workers/ordered-writer pipeline.
+		- rawlog-grabber:
+			- Sensor threads now pass observations through lock-free
+per-sensor queues, and the output file is compressed in parallel blocks. New
+`[global]` parameters: `rawlog_GZ_compress_threads`, `rawlog_GZ_block_size_kb`,
+`sensor_queue_capacity`, `show_stats_period`.
 		- pf-localization:
 			- Odometry is now used also for observation-only rawlogs.
+			- `map_file` can be a snapshot of prebuilt metric maps
+(mrpt::maps::CMetricMapSnapshot).
+		- observations2map:
+			- Accepts indexed simplemaps (mrpt::maps::CSimpleMapIndexedFile) as
+input. New arguments `-r` to only use the keyframes within a region, and `-i`
+to convert the input into an indexed simplemap, and `-m` to save the maps as a
+mrpt::maps::CMetricMapSnapshot.
 	- Changes in libraries:
 		- \ref mrpt_base_grp => Refactored into several smaller libraries, one
 per namespace.
@@ -50,20 +66,125 @@ Eigen.
 mrpt::math::std::isnan
 				- `mrpt::math::make_vector<>` => `std::vector<>{...}` braced
 initializator
+			- New class mrpt::math::CPolygonBVH: bounding volume hierarchy to
+accelerate ray tracing against large sets of polygons.
+			- mrpt::math::KDTreeCapable: new methods kdTreeSaveIndex3D() and
+kdTreeLoadIndex3D() to store and restore a built KD-tree.
 			- Removed the include file: `<mrpt/math/jacobians.h>`. Replace by
 `<mrpt/math/num_jacobian.h>` or individual methods in \ref mrpt_poses_grp
 classes.
+		- \ref mrpt_containers_grp  [NEW IN MRPT 2.0.0]
+			- New lock-free single-producer/single-consumer queue
+mrpt::containers::spsc_queue.
+			- New class mrpt::containers::CDynamicGridCircular: a fixed-size 2D
+grid which can be scrolled in time proportional to the number of new cells.
+		- \ref mrpt_io_grp  [NEW IN MRPT 2.0.0]
+			- New class mrpt::io::CFileGZParallelOutputStream to write gzip
+files compressed in parallel blocks.
 		- \ref mrpt_config_grp  [NEW IN MRPT 2.0.0]
 			- mrpt::config::CConfigFileBase::write() now supports enum types.
 		- \ref mrpt_serialization_grp  [NEW IN MRPT 2.0.0]
 			- New method mrpt::serialization::CArchive::ReadPOD() and macro
 `MRPT_READ_POD()` for reading unaligned POD variables.-
 			- Add support for `$env{}` syntax to evaluate environment variables.
+		- \ref mrpt_random_grp
+			- New counter-based generator mrpt::random::CPhilox4x32, with bulk
+fill methods. New methods mrpt::random::CRandomGenerator::fillUniform() and
+mrpt::random::CRandomGenerator::fillGaussian() to draw large arrays of samples,
+and mrpt::random::CRandomGenerator::deriveStream() to create independent and
+reproducible generators for each thread.
+		- \ref mrpt_bayes_grp
+			- New bulk methods
+mrpt::bayes::CParticleFilterCapable::normalizeLogWeights() and
+mrpt::bayes::CParticleFilterCapable::computeESS() for contiguous arrays of
+log-weights. ESS() of all particle filters no longer overflows with large
+log-weights.
+		- \ref mrpt_poses_grp
+			- New mrpt::poses::TPose2DParticlesSoA structure-of-arrays particle
+set, and mrpt::poses::CPoseRandomSampler::drawSamples() to draw many 2D
+samples at once.
+			- New method mrpt::poses::CPoseInterpolatorBase::interpolateMany()
+to interpolate poses at many sorted times in one pass over the path, with the
+SE(3) SLERP terms computed once per interval.
+			- New method mrpt::poses::CPose3D::composePoints() to transform
+many points stored as arrays of floats at once, with SSE2 and optionally
+several threads.
+		- \ref mrpt_obs_grp
+			- New class mrpt::maps::CSimpleMapIndexedFile: simplemaps stored in
+memory-mapped files with an index of keyframe poses, to load only the keyframes
+of a region.
+		- \ref mrpt_maps_grp
+			- mrpt::maps::CPointsMap::insertAnotherMap(),
+mrpt::maps::CPointsMap::changeCoordinatesReference() and 3D point matching
+(used by ICP) transform all points at once with
+mrpt::poses::CPose3D::composePoints().
+			- New classes mrpt::maps::CPointCloudStreamIO and
+mrpt::maps::CPointCloudStreamWriter: streaming readers and writers of PCD
+(ascii and binary) and PLY (ascii and binary little endian) point clouds, in
+blocks of points, with a parallel, locale-independent parser of text numbers.
+			- mrpt::maps::CPointsMap::loadPCDFile() and
+mrpt::maps::CPointsMap::savePCDFile() no longer require PCL, and
+mrpt::maps::CPointsMap::load2Dor3D_from_text_file() uses the new parallel
+parser.
+			- New method mrpt::maps::CPointsMap::insertPoints()
+			- mrpt::maps::COccupancyGridMap2D: new option
+`insertionOptions.num_threads` to trace the rays of each scan in parallel, and
+new method mrpt::maps::COccupancyGridMap2D::insertScans() to insert many scans
+at once. Both give the same cells than sequential insertion. Fixed insertion of
+scans with `decimation` > 1.
+			- New class mrpt::maps::CVoxelMap: a 3D occupancy map implemented
+natively as a sparse grid of voxel blocks, with the same sensor model and a
+compatible API than mrpt::maps::COctoMap, and multi-threaded insertion of all
+the rays of a point cloud at once.
 		- \ref mrpt_slam_grp
 			- rbpf-slam: Add support for simplemap continuation.
+			- New class mrpt::maps::CMetricMapSnapshot: binary snapshots of
+mrpt::maps::CMultiMetricMap with the raw arrays of points maps and occupancy
+grids, plus their KD-trees and likelihood field caches, which are loaded
+without rebuilding them.
+			- mrpt::slam::CMonteCarloLocalization2D: the prediction stage of
+`pfStandardProposal` with a fixed sample size draws and composes all motion
+increments at once, with 2D poses in a structure-of-arrays layout.
 			- CICP: parameter `onlyClosestCorrespondences` deleted (always true
 now).
+			- mrpt::slam::data_association_full_covariance(): the KD-tree now
+gates individual compatibility with an exact Euclidean radius, JCBB can run in
+parallel (`num_threads`, also `data_assoc_num_threads` in
+mrpt::slam::CRangeBearingKFSLAM and mrpt::slam::CRangeBearingKFSLAM2D) and new
+statistics are reported in mrpt::slam::TDataAssociationResults.
+			- mrpt::slam::CGridMapAligner: the `amCorrelation` method computes
+the spectrum of the first map only once, evaluates rotations in parallel
+(`correlation_num_threads`), supports a coarse-to-fine search
+(`correlation_pyramid_levels`) and returns a proper
+mrpt::poses::CPosePDFGaussian.
+			- mrpt::slam::CIncrementalMapPartitioner keeps a sparse graph of
+overlapping keyframes and partitions it with a Lanczos solver warm-started from
+the last partition (`useSparseSolver`, default=true), instead of dense
+eigen-decompositions.
+			- mrpt::slam::CMetricMapBuilderICP: new option `asyncMapUpdate` to
+insert observations into the map from a background thread, while ICP matches
+against the last published immutable copy of the map. See
+mrpt::slam::CMetricMapBuilderICP::waitForPendingMapUpdates().
+			- mrpt::maps::CRBPFParticleData: particles duplicated during RBPF
+resampling share their map (copy-on-write) until one of them modifies it,
+instead of deep-copying it. `mapTillNow` is now accessed through
+mrpt::maps::CRBPFParticleData::mapTillNow() and
+mrpt::maps::CRBPFParticleData::mapTillNowForWriting().
+		- \ref mrpt_hmtslam_grp
+			- mrpt::hmtslam::CHMTSLAM threads wait on condition variables
+instead of polling, the input queue is bounded (`input_queue_max_size`), and
+per-stage latencies are available via
+mrpt::hmtslam::CHMTSLAM::getStageLatencies().
+		- \ref mrpt_graphs_grp
+			- mrpt::graphs::CGraphPartitioner can partition sparse graphs given
+as adjacency lists, finding Fiedler vectors with a restarted Lanczos method
+that can be warm-started from a previous solution.
 		- \ref mrpt_system_grp
+			- mrpt::system::CTimeLogger: new tracing mode for sections
+registered with mrpt::system::CTimeLogger::registerSection(), with per-thread
+lock-free buffers, percentiles and histograms, and export to the Chrome
+trace-event JSON format. Durations measured across threads can be added with
+mrpt::system::CTimeLogger::addSectionTime().
 			- functions to get timestamp as *local* time were removed, since
 they don't make sense. All timestamps in MRPT are UTC, and they can be formated
 as dates in either UTC or local time frames.
@@ -74,24 +195,58 @@ mrpt::nav::CRobot2NavInterface are now invoked *after* `navigationStep()` to
 avoid problems if user code invokes the navigator API to change its state.
 			- Added methods to load/save mrpt::nav::TWaypointSequence to
 configuration files.
+			- New class mrpt::nav::CObstacleDistanceField, and optional
+evaluation of PTGs against a distance field of obstacles in
+mrpt::nav::CReactiveNavigationSystem (`use_distance_field`), with a cost
+independent of the number of obstacle points.
+		- \ref mrpt_tfest_grp
+			- mrpt::tfest::se2_l2_robust() and mrpt::tfest::se3_l2_robust()
+can evaluate RANSAC hypotheses in parallel (`num_threads`) with results
+independent of the number of threads, and end early after reaching a ratio of
+inliers (`min_inliers_ratio_to_end`). Duplicated landmarks and SOG modes are
+now detected with hash tables (`ransac_detectDuplicatedLandmarks`).
 		- \ref mrpt_comms_grp [NEW IN MRPT 2.0.0]
 			- This new module has been created to hold all serial devices &
 networking classes, with minimal dependencies.
+			- New class mrpt::comms::ShmTopic: inter-process pub/sub topics
+over shared memory, with asynchronous subscribers.
+			- New class mrpt::comms::CMessageServerTCP: event-loop (epoll)
+message server for many simultaneous clients, compatible with
+mrpt::comms::CClientTCPSocket::sendMessage().
+			- mrpt::comms::CClientTCPSocket::sendMessage() now sends the message
+header with a single write.
 		- \ref mrpt_maps_grp
 			- Added optional "channel" attribute to CReflectivityGrdMap2D and
 CObservationReflectivity to support different colors of light.
+			- New robot-centered local occupancy grid
+mrpt::maps::CCircularOccupancyGridMap2D.
 		- \ref mrpt_hwdrivers_grp
 			- COpenNI2Generic: is safer in multithreading apps.
 			- CHokuyoURG:
 				- Rewrite driver to be safer and reduce mem allocs.
 				- New parameter `scan_interval` to decimate scans.
+			- mrpt::hwdrivers::CGenericSensor: new parameter
+`recycle_observations` (default=true). 2D laser scanners,
+mrpt::hwdrivers::CVelodyneScanner and mrpt::hwdrivers::COpenNI2Sensor reuse
+observation objects released by consumers, with their buffers, via
+mrpt::hwdrivers::CGenericSensor::newObservation().
 		- \ref mrpt_opengl_grp
 			- Update Assimp lib version 4.0.1 -> 4.1.0 (when built as
 ExternalProject)
+			- mrpt::opengl::CSetOfTriangles and mrpt::opengl::CMesh now use a
+mrpt::math::CPolygonBVH in `traceRay()`.
+			- New methods mrpt::opengl::COpenGLScene::traceRays() and
+mrpt::opengl::COpenGLScene::traceRaysDepthImage() for multi-threaded batches
+of rays.
 		- \ref mrpt_obs_grp
+			- The LUT used in
+mrpt::obs::CObservation3DRangeScan::project3DPointsFromDepthImageInto is now
+thread-local, so observations can be projected from several threads.
 			- mrpt::obs::T3DPointsProjectionParams and
 mrpt::obs::CObservation3DRangeScan::project3DPointsFromDepthImageInto now
 together support organized PCL point clouds.
+			- New class mrpt::obs::CObservationPool: pools of recycled
+observation objects.
 	- BUG FIXES:
 		- Fix reactive navigator inconsistent state if navigation API is called
 from within rnav callbacks.
@@ -102,6 +257,13 @@ mrpt::nav::CMultiObjectiveMotionOptimizerBase
 rotation matrices.
 		- Fix accessing unaligned POD variables deserializing CObservationGPS
 (via the new `MRPT_READ_POD()` macro).
+		- mrpt::random::CRandomGenerator::permuteVector() now uses the state
+of its generator object (it used to ignore its seed) and may move the last
+element.
+		- JCBB in mrpt::slam::data_association_full_covariance() could miss
+the set of pairings with the best joint distance among those of maximum size.
+		- mrpt::slam::CGridMapAligner with `amCorrelation` returned a wrong
+translation, printed each evaluated rotation and saved a debug image to disk.
 		- Fix segfault in CMetricMap::loadFromSimpleMap() if the provided
 CMetricMap has empty smart pointers.
 	- Fix crash in CGPSInterface when not setting an external mutex.
@@ -123,6 +285,10 @@ types.
 	- Applications:
 		- pf-localization:
 			- Odometry is now used also for observation-only rawlogs.
+		- observations2map:
+			- Accepts indexed simplemaps (mrpt::maps::CSimpleMapIndexedFile) as
+input. New arguments `-r` to only use the keyframes within a region, and `-i`
+to convert the input into an indexed simplemap.
 	- \ref mrpt_hwdrivers_grp
 		- mrpt::hwdrivers::COpenNI2Generic: added mutexes for safer
 multi-threading operation.
@@ -53,6 +53,28 @@ etc.
 See: \ref comms_nodelets_example/NodeletsTest_impl.cpp
 \snippet comms_nodelets_example/NodeletsTest_impl.cpp example-nodelets
 
+## Inter-process Pub/Sub
+
+mrpt::comms::ShmTopic provides the same publish/subscribe API for topics
+shared between processes, through a ring buffer in a named shared memory
+segment. Trivially copyable objects and raw buffers (e.g. point clouds or
+images, which can be written in place with
+mrpt::comms::ShmTopic::publishInPlace()) are delivered to subscribers without
+intermediary copies. Unlike intra-process topics, each subscriber runs in its
+own thread and publishing never blocks: a subscriber which is too slow misses
+the oldest messages instead.
+
+## Message servers
+
+mrpt::comms::CServerTCPSocket accepts one blocking connection at a time, so
+serving many clients requires one thread per client. For that case, use
+mrpt::comms::CMessageServerTCP instead: a few event loop threads handle all the
+(non-blocking) client sockets, parse incoming messages and invoke a callback
+for each one. Messages are exchanged in the same format than
+mrpt::comms::CClientTCPSocket::sendMessage() and
+mrpt::comms::CClientTCPSocket::receiveMessage(), so existing clients do not
+need any change.
+
 ## HTTP request methods
 
 mrpt::comms::net::http_get() is an easy way to GET an HTTP resource from any C++
@@ -10,6 +10,8 @@
 
 #include <mrpt/bayes/CParticleFilter.h>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstdint>
 
@@ -225,6 +227,61 @@ class CParticleFilterCapable
 		const std::vector<double>& in_logWeights,
 		std::vector<double>& out_linWeights);
 
+	/** Bulk version of normalizeWeights(), for `N` log-weights stored in a
+	 * contiguous array (e.g. the `log_w` of a structure-of-arrays particle
+	 * set), which are modified in place so their maximum is zero.
+	 * \return The max/min ratio of weights ("dynamic range")
+	 * \sa computeESS */
+	static double normalizeLogWeights(
+		double* log_w, size_t N, double* out_max_log_w = nullptr);
+
+	/** Bulk version of ESS(), for `N` log-weights stored in a contiguous
+	 * array. Weights do not need to be normalized.
+	 * \return The normalized ESS, in the range [0,1]
+	 * \sa normalizeLogWeights */
+	static double computeESS(const double* log_w, size_t N);
+
+	/** Generic version of normalizeLogWeights(), for `N` log-weights read
+	 * and written through `log_w(i)`, which must return a `double&` (e.g. to
+	 * the `log_w` member of the i'th particle). */
+	template <class LOG_W>
+	static double normalizeLogWeights(
+		size_t N, LOG_W&& log_w, double* out_max_log_w = nullptr)
+	{
+		if (!N) return 0;
+		// Plain loops, so the compiler can vectorize them for contiguous data:
+		double maxW = log_w(0), minW = maxW;
+		for (size_t i = 1; i < N; i++)
+		{
+			maxW = std::max(maxW, log_w(i));
+			minW = std::min(minW, log_w(i));
+		}
+		for (size_t i = 0; i < N; i++) log_w(i) -= maxW;
+		if (out_max_log_w) *out_max_log_w = maxW;
+		return std::exp(maxW - minW);
+	}
+
+	/** Generic version of computeESS(), for `N` log-weights read through
+	 * `log_w(i)`. */
+	template <class LOG_W>
+	static double computeESS(size_t N, LOG_W&& log_w)
+	{
+		if (!N) return 0;
+		// ESS = (sum w)^2 / (N sum w^2), with weights relative to the maximum
+		// one to avoid overflows in exp(), and one exp() per particle:
+		double maxW = log_w(0);
+		for (size_t i = 1; i < N; i++) maxW = std::max(maxW, log_w(i));
+		double sumW = 0, sumW2 = 0;
+		for (size_t i = 0; i < N; i++)
+		{
+			const double w = std::exp(log_w(i) - maxW);
+			sumW += w;
+			sumW2 += w * w;
+		}
+		if (sumW2 == 0) return 0;
+		return sumW * sumW / (N * sumW2);
+	}
+
    protected:
 	/** Performs the particle filter prediction/update stages for the algorithm
 	 * "pfStandardProposal" (if not implemented in heritated class, it will
@@ -59,47 +59,20 @@ struct CParticleFilterDataImpl : public CParticleFilterCapable
 	double normalizeWeights(double* out_max_log_w = nullptr) override
 	{
 		MRPT_START
-		if (derived().m_particles.empty()) return 0;
-		double minW = derived().m_particles[0].log_w;
-		double maxW = minW;
-
-		/* Compute the max/min of weights: */
-		for (auto it = derived().m_particles.begin();
-			 it != derived().m_particles.end(); ++it)
-		{
-			maxW = std::max<double>(maxW, it->log_w);
-			minW = std::min<double>(minW, it->log_w);
-		}
-		/* Normalize: */
-		for (auto it = derived().m_particles.begin();
-			 it != derived().m_particles.end(); ++it)
-			it->log_w -= maxW;
-		if (out_max_log_w) *out_max_log_w = maxW;
-
-		/* Return the max/min ratio: */
-		return std::exp(maxW - minW);
+		auto& parts = derived().m_particles;
+		return CParticleFilterCapable::normalizeLogWeights(
+			parts.size(),
+			[&parts](size_t i) -> double& { return parts[i].log_w; },
+			out_max_log_w);
 		MRPT_END
 	}
 
 	double ESS() const override
 	{
 		MRPT_START
-		double cum = 0;
-
-		/* Sum of weights: */
-		double sumLinearWeights = 0;
-		for (auto it = derived().m_particles.begin();
-			 it != derived().m_particles.end(); ++it)
-			sumLinearWeights += std::exp(it->log_w);
-		/* Compute ESS: */
-		for (auto it = derived().m_particles.begin();
-			 it != derived().m_particles.end(); ++it)
-			cum += mrpt::square(std::exp(it->log_w) / sumLinearWeights);
-
-		if (cum == 0)
-			return 0;
-		else
-			return 1.0 / (derived().m_particles.size() * cum);
+		const auto& parts = derived().m_particles;
+		return CParticleFilterCapable::computeESS(
+			parts.size(), [&parts](size_t i) { return parts[i].log_w; });
 		MRPT_END
 	}
 
@@ -150,16 +123,17 @@ struct CParticleFilterDataImpl : public CParticleFilterCapable
 				 */
 				if (!oldParticlesReused[sorted_idx])
 				{
-					/* Reuse the data from the particle: */
-					parts[i].d.reset(derived().m_particles[sorted_idx].d.get());
+					/* Reuse the data from the particle, taking its ownership: */
+					parts[i].d.move_from(derived().m_particles[sorted_idx].d);
 					oldParticlesReused[sorted_idx] = true;
 				}
 				else
 				{
-					/* Make a copy of the particle's data: */
-					ASSERT_(derived().m_particles[sorted_idx].d);
+					/* Make a copy of the particle's data. Indices are sorted,
+					 * so the previous new particle holds the same data: */
+					ASSERT_(i > 0 && parts[i - 1].d);
 					parts[i].d.reset(new typename Derived::CParticleDataContent(
-						*derived().m_particles[sorted_idx].d));
+						*parts[i - 1].d));
 				}
 			}
 			/* Free memory of unused particles */
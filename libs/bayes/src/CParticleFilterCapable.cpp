@@ -573,3 +573,15 @@ void CParticleFilterCapable::log2linearWeights(
 
 	MRPT_END
 }
+
+double CParticleFilterCapable::normalizeLogWeights(
+	double* log_w, size_t N, double* out_max_log_w)
+{
+	return normalizeLogWeights(
+		N, [log_w](size_t i) -> double& { return log_w[i]; }, out_max_log_w);
+}
+
+double CParticleFilterCapable::computeESS(const double* log_w, size_t N)
+{
+	return computeESS(N, [log_w](size_t i) { return log_w[i]; });
+}
@@ -159,19 +159,16 @@ class CClientTCPSocket : public mrpt::io::CStream
 	template <class MESSAGE>
 	bool sendMessage(const MESSAGE& outMsg, const int timeout_ms = -1)
 	{
-		// (1) Send a "magic word":
-		const char* magic = "MRPTMessage";
-		uint32_t toWrite = strlen(magic);
-		uint32_t written = writeAsync(magic, toWrite, timeout_ms);
-		if (written != toWrite) return false;  // Error!
-		// (2) Send the message type:
-		toWrite = sizeof(outMsg.type);
-		written = writeAsync(&outMsg.type, toWrite, timeout_ms);
-		if (written != toWrite) return false;  // Error!
-		// (3) Send the message's content length:
+		// (1)-(3) Send a "magic word", the message type and the message's
+		// content length, all with a single write:
 		uint32_t contentLen = outMsg.content.size();
-		toWrite = sizeof(contentLen);
-		written = writeAsync(&contentLen, toWrite, timeout_ms);
+		uint8_t hdr[11 + sizeof(outMsg.type) + sizeof(contentLen)];
+		std::memcpy(hdr, "MRPTMessage", 11);
+		std::memcpy(hdr + 11, &outMsg.type, sizeof(outMsg.type));
+		std::memcpy(
+			hdr + 11 + sizeof(outMsg.type), &contentLen, sizeof(contentLen));
+		uint32_t toWrite = sizeof(hdr);
+		uint32_t written = writeAsync(hdr, toWrite, timeout_ms);
 		if (written != toWrite) return false;  // Error!
 		// (4) Send the message's contents:
 		toWrite = contentLen;
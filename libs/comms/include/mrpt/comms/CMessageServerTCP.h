@@ -0,0 +1,166 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/system/COutputLogger.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace mrpt::comms
+{
+/** Parameters of a CMessageServerTCP */
+struct TMessageServerTCPParams
+{
+	/** The port to listen at. Use 0 to let the OS pick a free one, see
+	 * CMessageServerTCP::getListenPort() */
+	unsigned short listenPort{0};
+	/** The interface to bind to: 127.0.0.1 for localhost only, or 0.0.0.0
+	 * for all network interfaces. */
+	std::string IPaddress{"127.0.0.1"};
+	/** Number of event loop threads, each handling a share of the clients.
+	 * Message callbacks are invoked from these threads. */
+	unsigned int num_threads{1};
+	/** Maximum number of connections waiting to be accepted */
+	int max_connections_waiting{128};
+	/** Messages with longer contents are considered a protocol error, and
+	 * the client is disconnected. */
+	uint32_t max_message_length{64 * 1024 * 1024};
+	/** Maximum number of bytes queued for sending to each client, while it
+	 * is not reading fast enough. Beyond that, sendMessage() fails. */
+	size_t max_pending_output{16 * 1024 * 1024};
+	/** Disable the Nagle algorithm in client connections */
+	bool tcp_nodelay{true};
+};
+
+/** A TCP server exchanging messages (like mrpt::serialization::CMessage)
+ * with many clients at once, with the same wire format than
+ * CClientTCPSocket::sendMessage() and CClientTCPSocket::receiveMessage().
+ *
+ * Unlike CServerTCPSocket, which accepts one blocking connection at a time,
+ * all sockets are non-blocking and handled by a few event loop threads
+ * (`epoll` based), so hundreds of clients do not need hundreds of threads:
+ * - Incoming data is buffered per client, and each complete message is
+ *   passed to the callback set with setOnMessage().
+ * - sendMessage() writes the message framing and its contents with a single
+ *   vectored system call, and never blocks: if the client is not reading,
+ *   the unsent data is queued and sent by the event loop later on.
+ *
+ * Callbacks must be set before start(). They are invoked from the event
+ * loop threads, so they should return quickly.
+ *
+ * \note Only implemented for Linux.
+ * \ingroup mrpt_comms_grp
+ */
+class CMessageServerTCP : public mrpt::system::COutputLogger
+{
+   public:
+	/** Unique identifier of each client connection */
+	using client_id_t = uint64_t;
+
+	using on_connect_t = std::function<void(
+		client_id_t, const std::string& remoteIP, unsigned short remotePort)>;
+	using on_disconnect_t = std::function<void(client_id_t)>;
+	/** Callback for incoming messages, with their type and contents */
+	using on_raw_message_t = std::function<void(
+		client_id_t, uint32_t type, const uint8_t* content, size_t length)>;
+
+	/** Creates the socket and starts listening, but connections are not
+	 * accepted until start() is called.
+	 * \exception std::exception On any error, or if not implemented in this
+	 * platform. */
+	explicit CMessageServerTCP(const TMessageServerTCPParams& params = {});
+	/** Stops the server, closing all connections */
+	~CMessageServerTCP() override;
+
+	CMessageServerTCP(const CMessageServerTCP&) = delete;
+	CMessageServerTCP& operator=(const CMessageServerTCP&) = delete;
+
+	void setOnConnect(on_connect_t f) { m_on_connect = std::move(f); }
+	void setOnDisconnect(on_disconnect_t f) { m_on_disconnect = std::move(f); }
+	void setOnRawMessage(on_raw_message_t f) { m_on_message = std::move(f); }
+
+	/** Sets the callback for incoming messages, as objects of class MESSAGE,
+	 * e.g. mrpt::serialization::CMessage.
+	 * The callback signature is `void(client_id_t, const MESSAGE&)`. */
+	template <class MESSAGE, typename Callable>
+	void setOnMessage(Callable&& func)
+	{
+		setOnRawMessage([func{std::forward<Callable>(func)}](
+							client_id_t id, uint32_t type,
+							const uint8_t* content, size_t length) {
+			MESSAGE msg;
+			msg.type = type;
+			msg.content.assign(content, content + length);
+			func(id, msg);
+		});
+	}
+
+	/** Launches the event loop threads */
+	void start();
+	/** Stops the event loop threads and closes all connections. Does not
+	 * invoke the disconnection callback. */
+	void stop();
+
+	/** The actual listening port (useful if TMessageServerTCPParams::listenPort
+	 * was 0) */
+	unsigned short getListenPort() const;
+
+	/** Sends a message (e.g. mrpt::serialization::CMessage) to a client.
+	 * Thread-safe and non-blocking.
+	 * \return false if there is no such client, or too much data is pending
+	 * for it (see TMessageServerTCPParams::max_pending_output). */
+	template <class MESSAGE>
+	bool sendMessage(client_id_t client, const MESSAGE& msg)
+	{
+		return sendRawMessage(
+			client, msg.type, msg.content.data(), msg.content.size());
+	}
+
+	/** Sends a message to all connected clients. \return The number of
+	 * clients it was successfully sent (or queued) to. */
+	template <class MESSAGE>
+	size_t broadcastMessage(const MESSAGE& msg)
+	{
+		return broadcastRawMessage(
+			msg.type, msg.content.data(), msg.content.size());
+	}
+
+	/** Like sendMessage(), given the type and content of the message. */
+	bool sendRawMessage(
+		client_id_t client, uint32_t type, const void* content, size_t length);
+
+	/** Like broadcastMessage(), given the type and content of the message */
+	size_t broadcastRawMessage(
+		uint32_t type, const void* content, size_t length);
+
+	/** Closes a client connection (the disconnection callback will be
+	 * invoked from its event loop thread). \return false if it did not
+	 * exist */
+	bool disconnect(client_id_t client);
+
+	/** Number of connected clients */
+	size_t getClientCount() const;
+
+	/** Size of the framing data before the contents of each message:
+	 * "MRPTMessage", the message type, and the content length. */
+	static constexpr size_t FRAME_HEADER_SIZE = 11 + 4 + 4;
+
+   private:
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+	TMessageServerTCPParams m_params;
+
+	on_connect_t m_on_connect;
+	on_disconnect_t m_on_disconnect;
+	on_raw_message_t m_on_message;
+};
+
+}  // namespace mrpt::comms
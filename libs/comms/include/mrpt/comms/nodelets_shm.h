@@ -0,0 +1,195 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/comms/nodelets.h>
+#include <mrpt/core/pimpl.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+namespace mrpt
+{
+namespace comms
+{
+/** \addtogroup mrpt_comms_grp
+ * @{ */
+
+/** A message received from a ShmTopic. `data` points directly into the
+ * shared memory segment, and it is only valid during the subscriber
+ * callback. */
+struct ShmMessage
+{
+	/** Message payload */
+	const void* data{nullptr};
+	/** Length of `data`, in bytes */
+	size_t size{0};
+	/** Hash of the type name of the published object (0 for raw buffers) */
+	uint64_t type_hash{0};
+	/** Sequence number of the message in its topic. Gaps mean that the
+	 * subscriber was too slow and older messages were overwritten. */
+	uint64_t seq{0};
+};
+
+/** Parameters of the shared memory segment of a ShmTopic. They are fixed by
+ * the first process that creates the topic: other processes must use the
+ * same values, or leave them to zero to use whatever the segment has. */
+struct ShmTopicParams
+{
+	/** Number of message slots in the ring buffer (0: default=16). A
+	 * publisher can always find a free slot as long as there are less
+	 * subscribers than slots, since each one holds at most one slot while
+	 * running its callback. */
+	uint32_t slot_count{0};
+	/** Maximum length of each message, in bytes (0: default=1 MiB) */
+	uint64_t slot_size{0};
+};
+
+/** A pub/sub topic, like mrpt::comms::Topic, backed by a ring buffer in a
+ * named shared memory segment so that publishers and subscribers may live in
+ * different processes.
+ *
+ * - Objects of trivially copyable types (points, poses, fixed-size arrays,
+ *   etc.) are copied once into the shared memory, and subscribers get a
+ *   reference to them without further copies. Variable-length data (point
+ *   clouds, images,...) can be written directly into the shared memory with
+ *   publishInPlace(), or as a raw buffer with publishRaw(), and are received
+ *   with a subscriber of type ShmMessage. Other types must be serialized by
+ *   the user into such buffers.
+ * - Each subscriber runs its callback in its own thread. Publishing never
+ *   waits for subscribers: a subscriber that falls behind by more than
+ *   ShmTopicParams::slot_count messages loses the oldest ones.
+ *
+ * The segment outlives the processes using it. Call ShmTopic::remove() to
+ * delete it once it is not needed anymore. It is only accessible by the user
+ * that created it.
+ *
+ * \note Only implemented for POSIX systems.
+ */
+class ShmTopic : public std::enable_shared_from_this<ShmTopic>
+{
+   private:
+	ShmTopic(const std::string& name, const ShmTopicParams& params);
+
+   public:
+	using Ptr = std::shared_ptr<ShmTopic>;
+
+	~ShmTopic();
+
+	/** Opens the topic with the given name (e.g. "/robot/scan"), creating
+	 * its shared memory segment if it does not exist yet.
+	 * \exception std::exception On any error, or if the existing segment
+	 * has different non-zero parameters */
+	static Ptr create(
+		const std::string& name, const ShmTopicParams& params = {});
+
+	/** Deletes the shared memory segment of a topic. Processes which have
+	 * it already open can still use it, but new ones will create another
+	 * one. \return false if it did not exist. */
+	static bool remove(const std::string& name);
+
+	/** Creates a subscriber for messages of type ARG, which must be either
+	 * a trivially copyable type or ShmMessage (which receives messages of
+	 * any type). The callback is invoked from a new thread, owned by the
+	 * returned object: destroying it stops that thread.
+	 */
+	template <typename ARG, typename Callable>
+	Subscriber::Ptr createSubscriber(Callable&& func)
+	{
+		static_assert(
+			std::is_trivially_copyable<ARG>::value ||
+				std::is_same<ARG, ShmMessage>::value,
+			"ShmTopic only supports trivially copyable types or ShmMessage");
+		if constexpr (std::is_same<ARG, ShmMessage>::value)
+			return createRawSubscriber(std::forward<Callable>(func));
+		else
+		{
+			const uint64_t expected_hash = typeHash<ARG>();
+			return createRawSubscriber(
+				[func{std::forward<Callable>(func)},
+				 expected_hash](const ShmMessage& msg) {
+					if (msg.type_hash != expected_hash ||
+						msg.size != sizeof(ARG))
+					{
+						std::cerr << "Subscriber has wrong type: "
+								  << mrpt::typemeta::TTypeName<ARG>::get()
+								  << std::endl;
+						return;
+					}
+					std::invoke(func, *static_cast<const ARG*>(msg.data));
+				});
+		}
+	}
+
+	/** Publishes an object of a trivially copyable type.
+	 * \return false if the message was dropped (too large, or no free slot)
+	 */
+	template <typename T>
+	bool publish(const T& obj)
+	{
+		static_assert(
+			std::is_trivially_copyable<T>::value,
+			"ShmTopic only supports trivially copyable types");
+		return publishInPlace(
+			sizeof(T), [&obj](void* buf) { std::memcpy(buf, &obj, sizeof(T)); },
+			typeHash<T>());
+	}
+
+	/** Publishes a raw buffer. \sa publishInPlace */
+	bool publishRaw(const void* data, size_t len, uint64_t type_hash = 0);
+
+	/** Publishes a message of `len` bytes, which `fill` must write directly
+	 * into the shared memory buffer it receives (aligned to 64 bytes).
+	 * \return false if the message was dropped (too large, or no free slot)
+	 */
+	bool publishInPlace(
+		size_t len, const std::function<void(void*)>& fill,
+		uint64_t type_hash = 0);
+
+	/** Like createSubscriber<ShmMessage>() */
+	Subscriber::Ptr createRawSubscriber(
+		std::function<void(const ShmMessage&)>&& func);
+
+	const std::string& getName() const { return m_name; }
+	/** The actual parameters of the shared memory segment */
+	ShmTopicParams getParams() const;
+
+	/** Number of messages dropped by publish() calls from this process */
+	uint64_t getPublishDropCount() const { return m_pub_drops; }
+
+	/** The hash stored with messages of type T, derived from its name as
+	 * given by mrpt::typemeta::TTypeName, so it is the same for all
+	 * processes. */
+	template <typename T>
+	static uint64_t typeHash()
+	{
+		// FNV-1a:
+		uint64_t h = 14695981039346656037ULL;
+		for (const char c : std::string(mrpt::typemeta::TTypeName<T>::get()))
+		{
+			h ^= static_cast<uint8_t>(c);
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+
+   private:
+	struct Impl;
+	std::string m_name;
+	mrpt::pimpl<Impl> m_impl;
+	std::atomic<uint64_t> m_pub_drops{0};
+};
+
+/** @} */  // end grouping
+
+}  // namespace comms
+}  // namespace mrpt
@@ -0,0 +1,635 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "comms-precomp.h"  // Precompiled headers
+
+#include <mrpt/comms/CMessageServerTCP.h>
+#include <mrpt/comms/net_utils.h>
+#include <mrpt/config.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/core/format.h>
+
+#ifdef MRPT_OS_LINUX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+using namespace mrpt::comms;
+using namespace mrpt::system;
+
+#ifdef MRPT_OS_LINUX
+namespace
+{
+constexpr char MAGIC[] = "MRPTMessage";
+constexpr size_t MAGIC_LEN = sizeof(MAGIC) - 1;
+static_assert(
+	CMessageServerTCP::FRAME_HEADER_SIZE == MAGIC_LEN + 2 * sizeof(uint32_t),
+	"Unexpected frame header size");
+
+/** Tags of the non-client file descriptors, in epoll_event::data.u64 */
+constexpr uint64_t TAG_LISTEN = 0;
+constexpr uint64_t TAG_WAKEUP = 1;
+/** Maximum number of iovec entries for each sendmsg() */
+constexpr size_t MAX_IOV = 64;
+/** Size of each read() from a client socket */
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr int MAX_READS_PER_EVENT = 16;
+
+void makeFrameHeader(uint8_t* hdr, uint32_t type, uint32_t length)
+{
+	// Same layout than CClientTCPSocket::sendMessage():
+	std::memcpy(hdr, MAGIC, MAGIC_LEN);
+	std::memcpy(hdr + MAGIC_LEN, &type, sizeof(type));
+	std::memcpy(hdr + MAGIC_LEN + sizeof(type), &length, sizeof(length));
+}
+
+struct Connection
+{
+	CMessageServerTCP::client_id_t id{0};
+	int fd{-1};
+	/** Index of the event loop which owns this connection */
+	size_t loop{0};
+	std::string remoteIP;
+	unsigned short remotePort{0};
+
+	/** Protects all the fields below, and the closing of `fd` */
+	std::mutex out_mtx;
+	bool closed{false};
+	/** Whether EPOLLOUT is enabled, i.e. out_queue is not empty */
+	bool want_write{false};
+	/** Unsent data, in order. The first buffer is sent from out_offset */
+	std::deque<std::vector<uint8_t>> out_queue;
+	size_t out_offset{0};
+	size_t out_pending{0};
+
+	/** Received data not parsed yet (only used from the loop thread) */
+	std::vector<uint8_t> in_buf;
+};
+using ConnectionPtr = std::shared_ptr<Connection>;
+
+struct EventLoop
+{
+	EventLoop() = default;
+	EventLoop(const EventLoop&) = delete;
+	EventLoop& operator=(const EventLoop&) = delete;
+	~EventLoop()
+	{
+		if (epfd >= 0) ::close(epfd);
+		if (wakeupfd >= 0) ::close(wakeupfd);
+	}
+
+	int epfd{-1};
+	/** eventfd to wake up the loop: on new connections, or to stop */
+	int wakeupfd{-1};
+	std::thread thread;
+	/** Scratch buffer for read(), left uninitialized on purpose */
+	std::unique_ptr<uint8_t[]> read_buf{new uint8_t[READ_CHUNK]};
+	/** Connections accepted by another thread, pending to be registered */
+	std::mutex new_conns_mtx;
+	std::vector<ConnectionPtr> new_conns;
+	/** Connections handled by this loop, by id */
+	std::map<CMessageServerTCP::client_id_t, ConnectionPtr> conns;
+
+	void wakeup() const
+	{
+		const uint64_t one = 1;
+		if (::write(wakeupfd, &one, sizeof(one)) < 0)
+		{
+			// Nothing to do: the counter is already non-zero
+		}
+	}
+};
+}  // namespace
+
+struct CMessageServerTCP::Impl
+{
+	explicit Impl(CMessageServerTCP& o) : owner(o) {}
+	~Impl()
+	{
+		loops.clear();
+		if (listenfd >= 0) ::close(listenfd);
+	}
+
+	CMessageServerTCP& owner;
+	int listenfd{-1};
+	unsigned short listenPort{0};
+	std::vector<std::unique_ptr<EventLoop>> loops;
+	std::atomic<bool> running{false};
+
+	/** All connections, by id. Also protects next_id and next_loop. */
+	mutable std::mutex conns_mtx;
+	std::map<client_id_t, ConnectionPtr> conns;
+	client_id_t next_id{0};
+	size_t next_loop{0};
+
+	ConnectionPtr find(client_id_t id) const
+	{
+		std::lock_guard<std::mutex> lck(conns_mtx);
+		const auto it = conns.find(id);
+		return it == conns.end() ? ConnectionPtr() : it->second;
+	}
+
+	/** Must be called with c.out_mtx locked */
+	void setWantWrite(Connection& c, bool want)
+	{
+		if (c.want_write == want) return;
+		c.want_write = want;
+		epoll_event ev{};
+		ev.events = EPOLLIN | EPOLLRDHUP | (want ? uint32_t(EPOLLOUT) : 0u);
+		ev.data.u64 = c.id;
+		::epoll_ctl(loops[c.loop]->epfd, EPOLL_CTL_MOD, c.fd, &ev);
+	}
+
+	/** Sends as much queued data as possible. Must be called with c.out_mtx
+	 * locked. \return false on socket errors */
+	bool flushQueue(Connection& c)
+	{
+		while (!c.out_queue.empty())
+		{
+			iovec iov[MAX_IOV];
+			size_t n = 0;
+			for (auto it = c.out_queue.begin();
+				 it != c.out_queue.end() && n < MAX_IOV; ++it, ++n)
+			{
+				const size_t off = (n == 0) ? c.out_offset : 0;
+				iov[n].iov_base = it->data() + off;
+				iov[n].iov_len = it->size() - off;
+			}
+			msghdr msg{};
+			msg.msg_iov = iov;
+			msg.msg_iovlen = n;
+			const ssize_t sent = ::sendmsg(c.fd, &msg, MSG_NOSIGNAL);
+			if (sent < 0)
+			{
+				if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+				if (errno == EINTR) continue;
+				return false;
+			}
+			c.out_pending -= sent;
+			size_t left = sent;
+			while (left > 0)
+			{
+				const size_t avail = c.out_queue.front().size() - c.out_offset;
+				if (left < avail)
+				{
+					c.out_offset += left;
+					break;
+				}
+				left -= avail;
+				c.out_queue.pop_front();
+				c.out_offset = 0;
+			}
+		}
+		setWantWrite(c, !c.out_queue.empty());
+		return true;
+	}
+
+	bool send(Connection& c, uint32_t type, const void* content, size_t length)
+	{
+		uint8_t hdr[FRAME_HEADER_SIZE];
+		makeFrameHeader(hdr, type, static_cast<uint32_t>(length));
+
+		std::lock_guard<std::mutex> lck(c.out_mtx);
+		if (c.closed) return false;
+		if (c.out_pending + FRAME_HEADER_SIZE + length >
+			owner.m_params.max_pending_output)
+			return false;
+
+		size_t sent = 0;
+		if (c.out_queue.empty())
+		{
+			// Header and contents with a single system call:
+			iovec iov[2];
+			iov[0].iov_base = hdr;
+			iov[0].iov_len = FRAME_HEADER_SIZE;
+			iov[1].iov_base = const_cast<void*>(content);
+			iov[1].iov_len = length;
+			msghdr msg{};
+			msg.msg_iov = iov;
+			msg.msg_iovlen = length ? 2 : 1;
+			ssize_t ret;
+			do
+			{
+				ret = ::sendmsg(c.fd, &msg, MSG_NOSIGNAL);
+			} while (ret < 0 && errno == EINTR);
+			if (ret < 0)
+			{
+				if (errno != EAGAIN && errno != EWOULDBLOCK)
+				{
+					// Let the event loop find out and close it:
+					::shutdown(c.fd, SHUT_RDWR);
+					return false;
+				}
+			}
+			else
+				sent = static_cast<size_t>(ret);
+			if (sent == FRAME_HEADER_SIZE + length) return true;
+		}
+
+		// Queue the unsent part, to be sent by the event loop:
+		std::vector<uint8_t> buf;
+		buf.reserve(FRAME_HEADER_SIZE + length - sent);
+		if (sent < FRAME_HEADER_SIZE)
+			buf.insert(buf.end(), hdr + sent, hdr + FRAME_HEADER_SIZE);
+		const auto* data = static_cast<const uint8_t*>(content);
+		const size_t content_sent =
+			sent > FRAME_HEADER_SIZE ? sent - FRAME_HEADER_SIZE : 0;
+		buf.insert(buf.end(), data + content_sent, data + length);
+		c.out_pending += buf.size();
+		c.out_queue.emplace_back(std::move(buf));
+		setWantWrite(c, true);
+		return true;
+	}
+
+	void closeConnection(EventLoop& loop, const ConnectionPtr& c)
+	{
+		::epoll_ctl(loop.epfd, EPOLL_CTL_DEL, c->fd, nullptr);
+		{
+			std::lock_guard<std::mutex> lck(c->out_mtx);
+			c->closed = true;
+			::close(c->fd);
+			c->out_queue.clear();
+		}
+		loop.conns.erase(c->id);
+		{
+			std::lock_guard<std::mutex> lck(conns_mtx);
+			conns.erase(c->id);
+		}
+		if (owner.m_on_disconnect) owner.m_on_disconnect(c->id);
+	}
+
+	void acceptAll()
+	{
+		for (;;)
+		{
+			sockaddr_in addr{};
+			socklen_t addrLen = sizeof(addr);
+			const int fd = ::accept4(
+				listenfd, reinterpret_cast<sockaddr*>(&addr), &addrLen,
+				SOCK_NONBLOCK | SOCK_CLOEXEC);
+			if (fd < 0)
+			{
+				if (errno == EINTR || errno == ECONNABORTED) continue;
+				if (errno != EAGAIN && errno != EWOULDBLOCK)
+					owner.logFmt(
+						LVL_ERROR, "[CMessageServerTCP] accept(): %s\n",
+						net::getLastSocketErrorStr().c_str());
+				return;
+			}
+			if (owner.m_params.tcp_nodelay)
+			{
+				const int one = 1;
+				::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+			}
+
+			auto c = std::make_shared<Connection>();
+			c->fd = fd;
+			char ip[INET_ADDRSTRLEN] = {0};
+			::inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
+			c->remoteIP = ip;
+			c->remotePort = ntohs(addr.sin_port);
+			{
+				std::lock_guard<std::mutex> lck(conns_mtx);
+				c->id = ++next_id;
+				c->loop = next_loop++ % loops.size();
+				conns[c->id] = c;
+			}
+			auto& loop = *loops[c->loop];
+			{
+				std::lock_guard<std::mutex> lck(loop.new_conns_mtx);
+				loop.new_conns.push_back(c);
+			}
+			loop.wakeup();
+		}
+	}
+
+	void registerNewConnections(EventLoop& loop)
+	{
+		std::vector<ConnectionPtr> new_conns;
+		{
+			std::lock_guard<std::mutex> lck(loop.new_conns_mtx);
+			new_conns.swap(loop.new_conns);
+		}
+		for (const auto& c : new_conns)
+		{
+			loop.conns[c->id] = c;
+			if (owner.m_on_connect)
+				owner.m_on_connect(c->id, c->remoteIP, c->remotePort);
+
+			epoll_event ev{};
+			std::lock_guard<std::mutex> lck(c->out_mtx);
+			if (c->closed) continue;
+			ev.events = EPOLLIN | EPOLLRDHUP |
+						(c->want_write ? uint32_t(EPOLLOUT) : 0u);
+			ev.data.u64 = c->id;
+			::epoll_ctl(loop.epfd, EPOLL_CTL_ADD, c->fd, &ev);
+		}
+	}
+
+	/** Reads all available data and dispatches complete messages.
+	 * \return false if the connection must be closed */
+	bool readAndParse(EventLoop& loop, Connection& c)
+	{
+		auto& buf = c.in_buf;
+		bool eof = false;
+		// Bounded number of reads, so one client can not starve the others
+		// (remaining data will trigger another event):
+		for (int k = 0; k < MAX_READS_PER_EVENT; k++)
+		{
+			uint8_t* rd = loop.read_buf.get();
+			const ssize_t n = ::read(c.fd, rd, READ_CHUNK);
+			if (n > 0)
+			{
+				buf.insert(buf.end(), rd, rd + n);
+				continue;
+			}
+			if (n < 0 && errno == EINTR) continue;
+			if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+				eof = true;
+			break;
+		}
+
+		// Parse all complete messages:
+		size_t pos = 0;
+		while (buf.size() - pos >= FRAME_HEADER_SIZE)
+		{
+			const uint8_t* hdr = buf.data() + pos;
+			if (std::memcmp(hdr, MAGIC, MAGIC_LEN) != 0)
+			{
+				owner.logFmt(
+					LVL_WARN,
+					"[CMessageServerTCP] Bad message framing from client "
+					"%u, disconnecting.\n",
+					static_cast<unsigned int>(c.id));
+				return false;
+			}
+			uint32_t type, length;
+			std::memcpy(&type, hdr + MAGIC_LEN, sizeof(type));
+			std::memcpy(
+				&length, hdr + MAGIC_LEN + sizeof(type), sizeof(length));
+			if (length > owner.m_params.max_message_length)
+			{
+				owner.logFmt(
+					LVL_WARN,
+					"[CMessageServerTCP] Too long message (%u bytes) from "
+					"client %u, disconnecting.\n",
+					length, static_cast<unsigned int>(c.id));
+				return false;
+			}
+			if (buf.size() - pos < FRAME_HEADER_SIZE + length) break;
+			if (owner.m_on_message)
+				owner.m_on_message(
+					c.id, type, hdr + FRAME_HEADER_SIZE, length);
+			pos += FRAME_HEADER_SIZE + length;
+		}
+		buf.erase(buf.begin(), buf.begin() + pos);
+		return !eof;
+	}
+
+	void run(EventLoop& loop)
+	{
+		constexpr int MAX_EVENTS = 64;
+		epoll_event events[MAX_EVENTS];
+		while (running)
+		{
+			const int n = ::epoll_wait(loop.epfd, events, MAX_EVENTS, -1);
+			if (n < 0)
+			{
+				if (errno == EINTR) continue;
+				owner.logFmt(
+					LVL_ERROR, "[CMessageServerTCP] epoll_wait(): %s\n",
+					std::strerror(errno));
+				break;
+			}
+			for (int i = 0; i < n && running; i++)
+			{
+				const auto& ev = events[i];
+				if (ev.data.u64 == TAG_LISTEN)
+				{
+					acceptAll();
+					continue;
+				}
+				if (ev.data.u64 == TAG_WAKEUP)
+				{
+					uint64_t cnt;
+					if (::read(loop.wakeupfd, &cnt, sizeof(cnt)) < 0)
+					{
+						// Nothing to do: already reset by a previous read
+					}
+					registerNewConnections(loop);
+					continue;
+				}
+				const auto it = loop.conns.find(ev.data.u64);
+				if (it == loop.conns.end()) continue;
+				const ConnectionPtr c = it->second;
+
+				bool ok = true;
+				if (ev.events & EPOLLOUT)
+				{
+					std::lock_guard<std::mutex> lck(c->out_mtx);
+					ok = flushQueue(*c);
+				}
+				if (ok && (ev.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)))
+					ok = readAndParse(loop, *c);
+				if (ok && (ev.events & EPOLLERR)) ok = false;
+				if (!ok) closeConnection(loop, c);
+			}
+		}
+	}
+};
+
+CMessageServerTCP::CMessageServerTCP(const TMessageServerTCPParams& params)
+	: COutputLogger("CMessageServerTCP"),
+	  m_impl(std::make_unique<Impl>(*this)),
+	  m_params(params)
+{
+	MRPT_START
+	ASSERT_(m_params.num_threads >= 1);
+
+	auto& I = *m_impl;
+	I.listenfd =
+		::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (I.listenfd < 0) THROW_EXCEPTION(net::getLastSocketErrorStr());
+	const int one = 1;
+	::setsockopt(I.listenfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+	sockaddr_in desiredIP{};
+	desiredIP.sin_family = AF_INET;
+	desiredIP.sin_addr.s_addr = inet_addr(m_params.IPaddress.c_str());
+	desiredIP.sin_port = htons(m_params.listenPort);
+	if (::bind(
+			I.listenfd, reinterpret_cast<sockaddr*>(&desiredIP),
+			sizeof(desiredIP)) < 0 ||
+		::listen(I.listenfd, m_params.max_connections_waiting) < 0)
+		THROW_EXCEPTION(net::getLastSocketErrorStr());
+	socklen_t len = sizeof(desiredIP);
+	::getsockname(I.listenfd, reinterpret_cast<sockaddr*>(&desiredIP), &len);
+	I.listenPort = ntohs(desiredIP.sin_port);
+
+	for (unsigned int i = 0; i < m_params.num_threads; i++)
+	{
+		auto loop = std::make_unique<EventLoop>();
+		loop->epfd = ::epoll_create1(EPOLL_CLOEXEC);
+		loop->wakeupfd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		ASSERTMSG_(
+			loop->epfd >= 0 && loop->wakeupfd >= 0,
+			mrpt::format(
+				"Error creating event loop: %s", std::strerror(errno)));
+		epoll_event ev{};
+		ev.events = EPOLLIN;
+		ev.data.u64 = TAG_WAKEUP;
+		::epoll_ctl(loop->epfd, EPOLL_CTL_ADD, loop->wakeupfd, &ev);
+		if (i == 0)
+		{
+			ev.data.u64 = TAG_LISTEN;
+			::epoll_ctl(loop->epfd, EPOLL_CTL_ADD, I.listenfd, &ev);
+		}
+		I.loops.emplace_back(std::move(loop));
+	}
+	// Client ids start after the tags of listen & wakeup fds:
+	I.next_id = TAG_WAKEUP;
+
+	MRPT_LOG_DEBUG_FMT(
+		"[CMessageServerTCP] Listening at %s:%u\n",
+		m_params.IPaddress.c_str(), static_cast<unsigned int>(I.listenPort));
+	MRPT_END
+}
+
+CMessageServerTCP::~CMessageServerTCP()
+{
+	// The sockets are closed by ~Impl() once the threads are stopped:
+	stop();
+}
+
+void CMessageServerTCP::start()
+{
+	auto& I = *m_impl;
+	if (I.running) return;
+	I.running = true;
+	for (auto& loop : I.loops)
+	{
+		EventLoop* l = loop.get();
+		l->thread = std::thread([&I, l]() { I.run(*l); });
+	}
+}
+
+void CMessageServerTCP::stop()
+{
+	auto& I = *m_impl;
+	if (!I.running) return;
+	I.running = false;
+	for (auto& loop : I.loops) loop->wakeup();
+	for (auto& loop : I.loops)
+		if (loop->thread.joinable()) loop->thread.join();
+
+	std::lock_guard<std::mutex> lck(I.conns_mtx);
+	for (auto& kv : I.conns)
+	{
+		auto& c = *kv.second;
+		std::lock_guard<std::mutex> lck2(c.out_mtx);
+		c.closed = true;
+		::close(c.fd);
+	}
+	I.conns.clear();
+	for (auto& loop : I.loops)
+	{
+		loop->conns.clear();
+		loop->new_conns.clear();
+	}
+}
+
+unsigned short CMessageServerTCP::getListenPort() const
+{
+	return m_impl->listenPort;
+}
+
+bool CMessageServerTCP::sendRawMessage(
+	client_id_t client, uint32_t type, const void* content, size_t length)
+{
+	ASSERT_BELOWEQ_(length, size_t(std::numeric_limits<uint32_t>::max()));
+	const auto c = m_impl->find(client);
+	return c && m_impl->send(*c, type, content, length);
+}
+
+size_t CMessageServerTCP::broadcastRawMessage(
+	uint32_t type, const void* content, size_t length)
+{
+	ASSERT_BELOWEQ_(length, size_t(std::numeric_limits<uint32_t>::max()));
+	std::vector<ConnectionPtr> all;
+	{
+		std::lock_guard<std::mutex> lck(m_impl->conns_mtx);
+		all.reserve(m_impl->conns.size());
+		for (const auto& kv : m_impl->conns) all.push_back(kv.second);
+	}
+	size_t n = 0;
+	for (const auto& c : all)
+		if (m_impl->send(*c, type, content, length)) n++;
+	return n;
+}
+
+bool CMessageServerTCP::disconnect(client_id_t client)
+{
+	const auto c = m_impl->find(client);
+	if (!c) return false;
+	std::lock_guard<std::mutex> lck(c->out_mtx);
+	if (c->closed) return false;
+	// The event loop will see the EOF and close it:
+	::shutdown(c->fd, SHUT_RDWR);
+	return true;
+}
+
+size_t CMessageServerTCP::getClientCount() const
+{
+	std::lock_guard<std::mutex> lck(m_impl->conns_mtx);
+	return m_impl->conns.size();
+}
+
+#else  // MRPT_OS_LINUX
+
+struct CMessageServerTCP::Impl
+{
+};
+
+CMessageServerTCP::CMessageServerTCP(const TMessageServerTCPParams& params)
+	: COutputLogger("CMessageServerTCP"), m_params(params)
+{
+	THROW_EXCEPTION("CMessageServerTCP: not implemented in this platform");
+}
+CMessageServerTCP::~CMessageServerTCP() = default;
+void CMessageServerTCP::start() {}
+void CMessageServerTCP::stop() {}
+unsigned short CMessageServerTCP::getListenPort() const { return 0; }
+bool CMessageServerTCP::sendRawMessage(
+	client_id_t, uint32_t, const void*, size_t)
+{
+	return false;
+}
+size_t CMessageServerTCP::broadcastRawMessage(uint32_t, const void*, size_t)
+{
+	return 0;
+}
+bool CMessageServerTCP::disconnect(client_id_t) { return false; }
+size_t CMessageServerTCP::getClientCount() const { return 0; }
+
+#endif  // MRPT_OS_LINUX
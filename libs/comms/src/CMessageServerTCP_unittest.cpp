@@ -0,0 +1,120 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/comms/CClientTCPSocket.h>
+#include <mrpt/comms/CMessageServerTCP.h>
+#include <mrpt/config.h>
+#include <mrpt/serialization/CMessage.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#ifdef MRPT_OS_LINUX
+
+using mrpt::comms::CClientTCPSocket;
+using mrpt::comms::CMessageServerTCP;
+using mrpt::serialization::CMessage;
+
+namespace
+{
+template <typename PRED>
+bool waitFor(PRED pred)
+{
+	for (int i = 0; i < 500 && !pred(); i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	return pred();
+}
+}  // namespace
+
+// Many clients echoing messages through a server with 2 event loops:
+TEST(CMessageServerTCP, echo_many_clients)
+{
+	mrpt::comms::TMessageServerTCPParams params;
+	params.num_threads = 2;
+	CMessageServerTCP server(params);
+	std::atomic<int> nConnected{0}, nDisconnected{0};
+	std::atomic<CMessageServerTCP::client_id_t> lastId{0};
+	server.setOnConnect(
+		[&](auto id, const std::string& ip, unsigned short) {
+			EXPECT_EQ(ip, "127.0.0.1");
+			lastId = id;
+			nConnected++;
+		});
+	server.setOnDisconnect([&](auto) { nDisconnected++; });
+	server.setOnMessage<CMessage>(
+		[&](CMessageServerTCP::client_id_t id, const CMessage& msg) {
+			CMessage reply = msg;
+			reply.type = msg.type + 1;
+			EXPECT_TRUE(server.sendMessage(id, reply));
+		});
+	server.start();
+	ASSERT_NE(server.getListenPort(), 0);
+
+	const int nClients = 8, nMsgs = 20;
+	std::vector<CClientTCPSocket> clients(nClients);
+	for (auto& c : clients) c.connect("127.0.0.1", server.getListenPort());
+	EXPECT_TRUE(waitFor([&]() { return nConnected == nClients; }));
+	EXPECT_EQ(server.getClientCount(), size_t(nClients));
+
+	for (int i = 0; i < nMsgs; i++)
+	{
+		for (int k = 0; k < nClients; k++)
+		{
+			CMessage msg;
+			msg.type = 10 * k;
+			// Also test contents larger than the socket buffers:
+			msg.content.assign(i == 0 ? 1000000 : i, uint8_t(i + k));
+			ASSERT_TRUE(clients[k].sendMessage(msg));
+		}
+		for (int k = 0; k < nClients; k++)
+		{
+			CMessage reply;
+			ASSERT_TRUE(clients[k].receiveMessage(reply, 5000, 5000));
+			EXPECT_EQ(reply.type, uint32_t(10 * k + 1));
+			ASSERT_EQ(reply.content.size(), size_t(i == 0 ? 1000000 : i));
+			EXPECT_EQ(reply.content.back(), uint8_t(i + k));
+		}
+	}
+
+	// Broadcast:
+	CMessage bcast;
+	bcast.type = 1234;
+	EXPECT_EQ(server.broadcastMessage(bcast), size_t(nClients));
+	for (auto& c : clients)
+	{
+		CMessage msg;
+		ASSERT_TRUE(c.receiveMessage(msg, 5000, 5000));
+		EXPECT_EQ(msg.type, 1234U);
+		EXPECT_TRUE(msg.content.empty());
+	}
+
+	// Disconnections from both sides:
+	clients[0].close();
+	EXPECT_TRUE(server.disconnect(lastId));
+	EXPECT_TRUE(waitFor([&]() { return nDisconnected == 2; }));
+	EXPECT_EQ(server.getClientCount(), size_t(nClients - 2));
+}
+
+TEST(CMessageServerTCP, bad_framing_disconnects)
+{
+	CMessageServerTCP server;
+	std::atomic<int> nDisconnected{0};
+	server.setOnDisconnect([&](auto) { nDisconnected++; });
+	server.start();
+
+	CClientTCPSocket client;
+	client.connect("127.0.0.1", server.getListenPort());
+	const char garbage[] = "This is not a MRPT message";
+	client.writeAsync(garbage, sizeof(garbage));
+	EXPECT_TRUE(waitFor([&]() { return nDisconnected == 1; }));
+	EXPECT_EQ(server.getClientCount(), 0U);
+}
+
+#endif
@@ -0,0 +1,497 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "comms-precomp.h"  // Precompiled headers
+
+#include <mrpt/comms/nodelets_shm.h>
+#include <mrpt/config.h>
+#include <mrpt/core/exceptions.h>
+#include <chrono>
+#include <thread>
+
+#if defined(MRPT_OS_LINUX) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#define MRPT_HAS_SHM_TOPICS
+#endif
+
+using namespace mrpt::comms;
+
+#ifdef MRPT_HAS_SHM_TOPICS
+/* Layout of the shared memory segment of a topic:
+ *  - SegmentHeader
+ *  - Index ring: `index_len` entries, one per sequence number (modulo
+ *    `index_len`), with the slot holding that message. Each entry is
+ *    `(seq+1) << 16 | slot`, or 0 if empty.
+ *  - `slot_count` slots, each one a SlotHeader followed by `slot_size` bytes.
+ *
+ * A publisher claims the free slot with the oldest message (no readers, via
+ * the WRITER bit of its lock), writes the payload, assigns the next sequence
+ * number, updates the index and wakes up subscribers. Readers increment the
+ * reader count of a slot while they run the user callback, and skip it if a
+ * writer got it first or the slot holds a newer message.
+ */
+namespace
+{
+constexpr uint64_t SHM_MAGIC = 0x4d5250545348'0001ULL;  // "MRPTSH" v1
+constexpr uint32_t WRITER = 0x80000000u;
+constexpr size_t ALIGN = 64;
+constexpr uint32_t DEFAULT_SLOT_COUNT = 16;
+constexpr uint64_t DEFAULT_SLOT_SIZE = 1 << 20;
+constexpr auto WAIT_PERIOD = std::chrono::milliseconds(100);
+
+size_t round_up(size_t n) { return (n + ALIGN - 1) / ALIGN * ALIGN; }
+
+struct SegmentHeader
+{
+	std::atomic<uint64_t> magic;
+	uint32_t slot_count;
+	uint32_t index_len;
+	uint64_t slot_size;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	/** Next sequence number to assign */
+	std::atomic<uint64_t> next_seq;
+};
+
+struct alignas(ALIGN) SlotHeader
+{
+	/** Number of readers, plus WRITER while being written */
+	std::atomic<uint32_t> lock;
+	/** Sequence number of the message (+1), 0 if none */
+	std::atomic<uint64_t> seq;
+	uint64_t size;
+	uint64_t type_hash;
+};
+static_assert(sizeof(SlotHeader) == ALIGN, "Unexpected SlotHeader size");
+
+std::string shmNameForTopic(const std::string& name)
+{
+	// POSIX shm names must have just one leading slash:
+	std::string s = "/mrpt";
+	if (name.empty() || name[0] != '/') s += '.';
+	for (const char c : name) s += (c == '/') ? '.' : c;
+	return s;
+}
+
+void lockMutex(pthread_mutex_t* m)
+{
+	const int ret = pthread_mutex_lock(m);
+#if defined(MRPT_OS_LINUX)
+	// A process died while holding the mutex. The state it protects (none,
+	// it is only used for the condition variable) is always consistent:
+	if (ret == EOWNERDEAD) pthread_mutex_consistent(m);
+#else
+	(void)ret;
+#endif
+}
+}  // namespace
+
+struct ShmTopic::Impl
+{
+	int fd{-1};
+	void* base{nullptr};
+	size_t length{0};
+
+	~Impl()
+	{
+		if (base) munmap(base, length);
+		if (fd >= 0) ::close(fd);
+	}
+
+	SegmentHeader* hdr{nullptr};
+	std::atomic<uint64_t>* index{nullptr};
+	uint8_t* slots{nullptr};
+	size_t slot_stride{0};
+
+	SlotHeader* slot(size_t i)
+	{
+		return reinterpret_cast<SlotHeader*>(slots + i * slot_stride);
+	}
+	uint8_t* slotData(size_t i)
+	{
+		return reinterpret_cast<uint8_t*>(slot(i)) + sizeof(SlotHeader);
+	}
+	std::atomic<uint64_t>& indexEntry(uint64_t seq)
+	{
+		return index[seq % hdr->index_len];
+	}
+
+	void setupPointers()
+	{
+		hdr = static_cast<SegmentHeader*>(base);
+		index = reinterpret_cast<std::atomic<uint64_t>*>(
+			static_cast<uint8_t*>(base) + round_up(sizeof(SegmentHeader)));
+		slots = reinterpret_cast<uint8_t*>(index) +
+				round_up(sizeof(uint64_t) * hdr->index_len);
+		slot_stride = sizeof(SlotHeader) + round_up(hdr->slot_size);
+	}
+
+	static size_t segmentLength(uint32_t slot_count, uint64_t slot_size)
+	{
+		return round_up(sizeof(SegmentHeader)) +
+			   round_up(sizeof(uint64_t) * 2 * slot_count) +
+			   slot_count * (sizeof(SlotHeader) + round_up(slot_size));
+	}
+
+	void notifyAll()
+	{
+		lockMutex(&hdr->mutex);
+		pthread_cond_broadcast(&hdr->cond);
+		pthread_mutex_unlock(&hdr->mutex);
+	}
+
+	/** Waits until the index entry for `seq` changes, a stop is requested, or
+	 * some time passes. */
+	void waitFor(uint64_t seq, const std::atomic<bool>& stop)
+	{
+		const auto t = std::chrono::system_clock::now() + WAIT_PERIOD;
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+							t.time_since_epoch())
+							.count();
+		timespec ts;
+		ts.tv_sec = ns / 1000000000;
+		ts.tv_nsec = ns % 1000000000;
+
+		lockMutex(&hdr->mutex);
+		while (!stop && (indexEntry(seq).load() >> 16) <= seq)
+		{
+			const int ret =
+				pthread_cond_timedwait(&hdr->cond, &hdr->mutex, &ts);
+#if defined(MRPT_OS_LINUX)
+			if (ret == EOWNERDEAD) pthread_mutex_consistent(&hdr->mutex);
+#endif
+			if (ret == ETIMEDOUT) break;
+		}
+		pthread_mutex_unlock(&hdr->mutex);
+	}
+};
+
+ShmTopic::ShmTopic(const std::string& name, const ShmTopicParams& params)
+	: m_name(name), m_impl(mrpt::make_impl<ShmTopic::Impl>())
+{
+	const std::string shm_name = shmNameForTopic(name);
+	auto& I = *m_impl;
+
+	ShmTopicParams p = params;
+	if (!p.slot_count) p.slot_count = DEFAULT_SLOT_COUNT;
+	if (!p.slot_size) p.slot_size = DEFAULT_SLOT_SIZE;
+	ASSERT_BELOW_(p.slot_count, 0x10000U);
+
+	I.fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	const bool creator = (I.fd >= 0);
+	if (creator)
+	{
+		I.length = Impl::segmentLength(p.slot_count, p.slot_size);
+		if (ftruncate(I.fd, I.length) != 0)
+		{
+			const int err = errno;
+			shm_unlink(shm_name.c_str());
+			THROW_EXCEPTION_FMT(
+				"ShmTopic: cannot resize `%s`: %s", shm_name.c_str(),
+				strerror(err));
+		}
+	}
+	else
+	{
+		if (errno == EEXIST)
+			I.fd = shm_open(shm_name.c_str(), O_RDWR, 0600);
+		if (I.fd < 0)
+		{
+			const int err = errno;
+			THROW_EXCEPTION_FMT(
+				"ShmTopic: cannot open `%s`: %s", shm_name.c_str(),
+				strerror(err));
+		}
+		// The creator may not have set its size yet:
+		struct stat st;
+		for (int retry = 0;; retry++)
+		{
+			if (fstat(I.fd, &st) == 0 && st.st_size > 0) break;
+			if (retry > 100)
+				THROW_EXCEPTION_FMT(
+					"ShmTopic: `%s` was never initialized", shm_name.c_str());
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		I.length = st.st_size;
+	}
+
+	void* base =
+		mmap(nullptr, I.length, PROT_READ | PROT_WRITE, MAP_SHARED, I.fd, 0);
+	if (base == MAP_FAILED)
+	{
+		const int err = errno;
+		THROW_EXCEPTION_FMT(
+			"ShmTopic: cannot map `%s`: %s", shm_name.c_str(), strerror(err));
+	}
+	I.base = base;
+	I.hdr = static_cast<SegmentHeader*>(I.base);
+
+	if (creator)
+	{
+		// ftruncate() fills the segment with zeros, which is the initial
+		// state of all atomics and slots.
+		auto* hdr = I.hdr;
+		hdr->slot_count = p.slot_count;
+		hdr->index_len = 2 * p.slot_count;
+		hdr->slot_size = p.slot_size;
+
+		pthread_mutexattr_t ma;
+		pthread_mutexattr_init(&ma);
+		pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED);
+#if defined(MRPT_OS_LINUX)
+		pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST);
+#endif
+		pthread_mutex_init(&hdr->mutex, &ma);
+		pthread_mutexattr_destroy(&ma);
+
+		pthread_condattr_t ca;
+		pthread_condattr_init(&ca);
+		pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED);
+		pthread_cond_init(&hdr->cond, &ca);
+		pthread_condattr_destroy(&ca);
+
+		hdr->magic.store(SHM_MAGIC, std::memory_order_release);
+	}
+	else
+	{
+		for (int retry = 0;
+			 I.hdr->magic.load(std::memory_order_acquire) != SHM_MAGIC;
+			 retry++)
+		{
+			if (retry > 100)
+				THROW_EXCEPTION_FMT(
+					"ShmTopic: `%s` is not a valid topic segment",
+					shm_name.c_str());
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		const auto* hdr = I.hdr;
+		if ((params.slot_count && params.slot_count != hdr->slot_count) ||
+			(params.slot_size && params.slot_size != hdr->slot_size) ||
+			I.length < Impl::segmentLength(hdr->slot_count, hdr->slot_size))
+			THROW_EXCEPTION_FMT(
+				"ShmTopic: `%s` already exists with different parameters",
+				shm_name.c_str());
+	}
+	I.setupPointers();
+}
+
+ShmTopic::~ShmTopic() = default;
+
+ShmTopic::Ptr ShmTopic::create(
+	const std::string& name, const ShmTopicParams& params)
+{
+	return Ptr(new ShmTopic(name, params));
+}
+
+bool ShmTopic::remove(const std::string& name)
+{
+	return shm_unlink(shmNameForTopic(name).c_str()) == 0;
+}
+
+ShmTopicParams ShmTopic::getParams() const
+{
+	ShmTopicParams p;
+	p.slot_count = m_impl->hdr->slot_count;
+	p.slot_size = m_impl->hdr->slot_size;
+	return p;
+}
+
+bool ShmTopic::publishRaw(const void* data, size_t len, uint64_t type_hash)
+{
+	return publishInPlace(
+		len, [=](void* buf) { std::memcpy(buf, data, len); }, type_hash);
+}
+
+bool ShmTopic::publishInPlace(
+	size_t len, const std::function<void(void*)>& fill, uint64_t type_hash)
+{
+	auto& I = *m_impl;
+	const uint32_t nSlots = I.hdr->slot_count;
+	if (len > I.hdr->slot_size)
+	{
+		m_pub_drops++;
+		return false;
+	}
+
+	// Claim the free slot with the oldest message:
+	int claimed = -1;
+	for (uint32_t attempt = 0; claimed < 0 && attempt < nSlots; attempt++)
+	{
+		int best = -1;
+		uint64_t best_seq = 0;
+		for (uint32_t i = 0; i < nSlots; i++)
+		{
+			auto* s = I.slot(i);
+			if (s->lock.load(std::memory_order_relaxed) != 0) continue;
+			const uint64_t seq = s->seq.load(std::memory_order_relaxed);
+			if (best < 0 || seq < best_seq)
+			{
+				best = i;
+				best_seq = seq;
+			}
+		}
+		if (best < 0) break;  // All slots in use by readers
+
+		uint32_t expected = 0;
+		if (I.slot(best)->lock.compare_exchange_strong(
+				expected, WRITER, std::memory_order_acquire))
+			claimed = best;
+	}
+	if (claimed < 0)
+	{
+		m_pub_drops++;
+		return false;
+	}
+
+	auto* s = I.slot(claimed);
+	uint64_t seq;
+	{
+		// Release the slot on exit, also if `fill` throws (then, it is left
+		// empty and no sequence number is assigned):
+		struct WriterUnlock
+		{
+			SlotHeader* s;
+			~WriterUnlock()
+			{
+				s->lock.fetch_sub(WRITER, std::memory_order_release);
+			}
+		} unlock{s};
+
+		s->seq.store(0, std::memory_order_relaxed);
+		s->size = len;
+		s->type_hash = type_hash;
+		fill(I.slotData(claimed));
+
+		seq = I.hdr->next_seq.fetch_add(1);
+		s->seq.store(seq + 1, std::memory_order_release);
+	}
+	I.indexEntry(seq).store(
+		((seq + 1) << 16) | static_cast<uint64_t>(claimed),
+		std::memory_order_release);
+
+	I.notifyAll();
+	return true;
+}
+
+Subscriber::Ptr ShmTopic::createRawSubscriber(
+	std::function<void(const ShmMessage&)>&& func)
+{
+	struct State
+	{
+		std::atomic<bool> stop{false};
+		std::thread thread;
+	};
+	auto state = std::make_shared<State>();
+	auto topic = shared_from_this();
+
+	uint64_t first_seq = m_impl->hdr->next_seq.load();
+	state->thread = std::thread([topic, state, first_seq,
+								 func{std::move(func)}]() {
+		auto& I = *topic->m_impl;
+		uint64_t seq = first_seq;
+		while (!state->stop)
+		{
+			const uint64_t entry =
+				I.indexEntry(seq).load(std::memory_order_acquire);
+			const uint64_t entry_seq1 = entry >> 16;
+			if (entry_seq1 <= seq)
+			{
+				// Not published yet:
+				I.waitFor(seq, state->stop);
+				// Skip messages whose publisher died before indexing them:
+				if ((I.indexEntry(seq).load() >> 16) <= seq &&
+					I.hdr->next_seq.load() > seq + I.hdr->slot_count)
+					seq++;
+				continue;
+			}
+			if (entry_seq1 > seq + 1)
+			{
+				// Overwritten by a newer message:
+				seq++;
+				continue;
+			}
+
+			auto* s = I.slot(entry & 0xFFFF);
+			const uint32_t prev =
+				s->lock.fetch_add(1, std::memory_order_acquire);
+			if (!(prev & WRITER) &&
+				s->seq.load(std::memory_order_acquire) == seq + 1)
+			{
+				ShmMessage msg;
+				msg.data = I.slotData(entry & 0xFFFF);
+				msg.size = s->size;
+				msg.type_hash = s->type_hash;
+				msg.seq = seq;
+				try
+				{
+					func(msg);
+				}
+				catch (std::exception& e)
+				{
+					std::cerr << "[ShmTopic] Exception in subscriber of `"
+							  << topic->getName() << "`:\n"
+							  << e.what() << std::endl;
+				}
+			}
+			s->lock.fetch_sub(1, std::memory_order_release);
+			seq++;
+		}
+	});
+
+	return Subscriber::create(
+		[](const std::any&) {},
+		// cleanup function
+		[topic, state]() {
+			state->stop = true;
+			topic->m_impl->notifyAll();
+			if (state->thread.get_id() == std::this_thread::get_id())
+				state->thread.detach();
+			else
+				state->thread.join();
+		});
+}
+
+#else  // MRPT_HAS_SHM_TOPICS
+
+struct ShmTopic::Impl
+{
+};
+
+ShmTopic::ShmTopic(const std::string& name, const ShmTopicParams&)
+	: m_name(name)
+{
+	THROW_EXCEPTION("ShmTopic: not implemented in this platform");
+}
+ShmTopic::~ShmTopic() = default;
+ShmTopic::Ptr ShmTopic::create(
+	const std::string& name, const ShmTopicParams& params)
+{
+	return Ptr(new ShmTopic(name, params));
+}
+bool ShmTopic::remove(const std::string&) { return false; }
+ShmTopicParams ShmTopic::getParams() const { return {}; }
+bool ShmTopic::publishRaw(const void*, size_t, uint64_t) { return false; }
+bool ShmTopic::publishInPlace(
+	size_t, const std::function<void(void*)>&, uint64_t)
+{
+	return false;
+}
+Subscriber::Ptr ShmTopic::createRawSubscriber(
+	std::function<void(const ShmMessage&)>&&)
+{
+	return {};
+}
+
+#endif  // MRPT_HAS_SHM_TOPICS
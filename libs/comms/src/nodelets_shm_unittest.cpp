@@ -0,0 +1,184 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/comms/nodelets_shm.h>
+#include <mrpt/config.h>
+#include <mrpt/core/format.h>
+#include <mrpt/math/lightweight_geom_data.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(MRPT_OS_LINUX) || defined(__APPLE__)
+#include <unistd.h>  // getpid()
+
+using namespace mrpt::comms;
+using namespace std::chrono_literals;
+
+namespace
+{
+std::string testTopicName(const char* suffix)
+{
+	return mrpt::format(
+		"/mrpt_unittest/%s/%u", suffix,
+		static_cast<unsigned>(getpid()));
+}
+
+// Waits for a condition, up to some time:
+template <typename COND>
+bool waitUntil(COND&& cond)
+{
+	for (int i = 0; i < 200 && !cond(); i++)
+		std::this_thread::sleep_for(10ms);
+	return cond();
+}
+}  // namespace
+
+TEST(NodeletsShm, pod_pub_sub)
+{
+	const auto name = testTopicName("pod");
+	ShmTopic::remove(name);
+
+	// Two handles to the same segment, as two processes would have:
+	auto pub_topic = ShmTopic::create(name);
+	auto sub_topic = ShmTopic::create(name);
+
+	const mrpt::math::TPose3D p_tx(1.0, 2.0, 3.0, 0.2, 0.4, 0.6);
+	std::atomic<int> nRx{0};
+	std::atomic<bool> ok{true};
+	auto sub = sub_topic->createSubscriber<mrpt::math::TPose3D>(
+		[&](const mrpt::math::TPose3D& p) {
+			if (p != p_tx) ok = false;
+			nRx++;
+		});
+
+	for (int i = 0; i < 5; i++) EXPECT_TRUE(pub_topic->publish(p_tx));
+
+	EXPECT_TRUE(waitUntil([&]() { return nRx == 5; }));
+	EXPECT_TRUE(ok);
+	sub.reset();
+	EXPECT_TRUE(ShmTopic::remove(name));
+}
+
+TEST(NodeletsShm, raw_zero_copy_and_params)
+{
+	const auto name = testTopicName("raw");
+	ShmTopic::remove(name);
+
+	ShmTopicParams params;
+	params.slot_count = 4;
+	params.slot_size = 1000;
+	auto pub_topic = ShmTopic::create(name, params);
+	// Parameters are taken from the existing segment:
+	auto sub_topic = ShmTopic::create(name);
+	EXPECT_EQ(sub_topic->getParams().slot_count, 4U);
+	EXPECT_EQ(sub_topic->getParams().slot_size, 1000U);
+	params.slot_count = 8;
+	EXPECT_THROW(ShmTopic::create(name, params), std::exception);
+
+	std::mutex rx_mtx;
+	std::vector<size_t> rx_sizes;
+	std::vector<uint64_t> rx_seqs;
+	bool contents_ok = true;
+	auto sub = sub_topic->createSubscriber<ShmMessage>(
+		[&](const ShmMessage& msg) {
+			std::lock_guard<std::mutex> lck(rx_mtx);
+			const auto* d = static_cast<const uint8_t*>(msg.data);
+			for (size_t i = 0; i < msg.size; i++)
+				if (d[i] != static_cast<uint8_t>(i)) contents_ok = false;
+			rx_sizes.push_back(msg.size);
+			rx_seqs.push_back(msg.seq);
+		});
+
+	EXPECT_TRUE(pub_topic->publishInPlace(100, [](void* buf) {
+		auto* d = static_cast<uint8_t*>(buf);
+		for (size_t i = 0; i < 100; i++) d[i] = static_cast<uint8_t>(i);
+	}));
+	std::vector<uint8_t> raw(1000);
+	for (size_t i = 0; i < raw.size(); i++) raw[i] = static_cast<uint8_t>(i);
+	EXPECT_TRUE(pub_topic->publishRaw(raw.data(), raw.size()));
+	// Too large:
+	EXPECT_FALSE(pub_topic->publishRaw(raw.data(), 1001));
+	EXPECT_EQ(pub_topic->getPublishDropCount(), 1U);
+
+	EXPECT_TRUE(waitUntil([&]() {
+		std::lock_guard<std::mutex> lck(rx_mtx);
+		return rx_sizes.size() == 2;
+	}));
+	std::lock_guard<std::mutex> lck(rx_mtx);
+	EXPECT_TRUE(contents_ok);
+	EXPECT_EQ(rx_sizes, std::vector<size_t>({100, 1000}));
+	EXPECT_EQ(rx_seqs, std::vector<uint64_t>({0, 1}));
+	EXPECT_TRUE(ShmTopic::remove(name));
+}
+
+TEST(NodeletsShm, slow_subscriber_does_not_block)
+{
+	const auto name = testTopicName("slow");
+	ShmTopic::remove(name);
+
+	ShmTopicParams params;
+	params.slot_count = 4;
+	params.slot_size = sizeof(uint64_t);
+	auto topic = ShmTopic::create(name, params);
+
+	std::atomic<int> nSlow{0}, nFast{0};
+	std::atomic<uint64_t> lastFast{0};
+	auto slow = topic->createSubscriber<uint64_t>([&](const uint64_t&) {
+		std::this_thread::sleep_for(50ms);
+		nSlow++;
+	});
+	auto fast = topic->createSubscriber<uint64_t>([&](const uint64_t& v) {
+		lastFast = v;
+		nFast++;
+	});
+
+	const uint64_t N = 100;
+	const auto t0 = std::chrono::steady_clock::now();
+	for (uint64_t i = 1; i <= N; i++)
+	{
+		topic->publish(i);
+		std::this_thread::sleep_for(1ms);
+	}
+	// Publishing must not have waited for the slow subscriber:
+	EXPECT_LT(std::chrono::steady_clock::now() - t0, 2s);
+
+	EXPECT_TRUE(waitUntil([&]() { return lastFast == N; }));
+	EXPECT_LT(nSlow, static_cast<int>(N));
+	EXPECT_GT(nFast, nSlow.load());
+	slow.reset();
+	fast.reset();
+	EXPECT_TRUE(ShmTopic::remove(name));
+}
+
+TEST(NodeletsShm, throwing_fill_releases_slot)
+{
+	const auto name = testTopicName("throw");
+	ShmTopic::remove(name);
+
+	ShmTopicParams params;
+	params.slot_count = 1;
+	params.slot_size = sizeof(uint64_t);
+	auto topic = ShmTopic::create(name, params);
+
+	EXPECT_THROW(
+		topic->publishInPlace(
+			sizeof(uint64_t),
+			[](void*) { throw std::runtime_error("fill failed"); }),
+		std::runtime_error);
+	// The only slot must be free again:
+	EXPECT_TRUE(topic->publish(uint64_t(1)));
+	EXPECT_EQ(topic->getPublishDropCount(), 0U);
+	EXPECT_TRUE(ShmTopic::remove(name));
+}
+
+#endif
@@ -0,0 +1,272 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/round.h>
+#include <mrpt/core/exceptions.h>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+
+namespace mrpt::containers
+{
+/** A 2D grid of fixed size (in cells) which stores any kind of data at each
+ * cell, and whose area can be scrolled around the plane, e.g. to keep it
+ * centered at a moving robot.
+ *
+ * Cells are stored in a circular buffer indexed by the *global* integer cell
+ * coordinates (modulo the grid size), so scrolling the window with
+ * scrollTo() or recenter() does not move any existing cell in memory: only
+ * the cells newly exposed at the borders are reset, hence the cost is
+ * proportional to the number of those cells instead of the whole grid.
+ *
+ * The access API (cellByPos(), cellByIndex(), x2idx(), idx2x(),...) is the
+ * same than in CDynamicGrid, with cell indices always relative to the
+ * current window (i.e. cell (0,0) is the one at (getXMin(),getYMin())).
+ * Unlike CDynamicGrid, the window limits are always a multiple of the
+ * resolution.
+ *
+ * \tparam T The type of each cell in the 2D grid.
+ * \sa CDynamicGrid
+ * \ingroup mrpt_containers_grp
+ */
+template <class T>
+class CDynamicGridCircular
+{
+   protected:
+	/** The cells, in circular order (see class docs) */
+	std::vector<T> m_map;
+	/** Global cell indices of the window corner (getXMin(),getYMin()) */
+	int m_cx0{0}, m_cy0{0};
+	/** Position of the window corner cell within m_map (in [0,size)) */
+	size_t m_off_x{0}, m_off_y{0};
+	double m_resolution{0};
+	size_t m_size_x{0}, m_size_y{0};
+	/** Number of cells reset in the last scroll. \sa getLastScrollCellCount
+	 */
+	size_t m_last_scroll_cells{0};
+
+	/** Non-negative modulo */
+	static inline size_t pmod(int a, size_t n)
+	{
+		const int r = a % static_cast<int>(n);
+		return static_cast<size_t>(r < 0 ? r + static_cast<int>(n) : r);
+	}
+	/** Index in m_map of a cell given by its window-relative indices */
+	inline size_t phys_index(size_t cx, size_t cy) const
+	{
+		size_t px = m_off_x + cx, py = m_off_y + cy;
+		if (px >= m_size_x) px -= m_size_x;
+		if (py >= m_size_y) py -= m_size_y;
+		return px + py * m_size_x;
+	}
+
+   public:
+	/** Constructor */
+	CDynamicGridCircular(
+		double x_min = -10., double x_max = 10., double y_min = -10.,
+		double y_max = 10., double resolution = 0.1)
+	{
+		setSize(x_min, x_max, y_min, y_max, resolution);
+	}
+
+	/** Destructor */
+	virtual ~CDynamicGridCircular() = default;
+
+	/** Changes the size and position of the grid, ERASING all previous
+	 * contents. If \a fill_value is not nullptr, all cells will have a copy of
+	 * that value afterwards; otherwise their contents are undefined.
+	 */
+	void setSize(
+		const double x_min, const double x_max, const double y_min,
+		const double y_max, const double resolution,
+		const T* fill_value = nullptr)
+	{
+		ASSERT_ABOVE_(resolution, 0);
+		m_resolution = resolution;
+		m_cx0 = mrpt::round(x_min / resolution);
+		m_cy0 = mrpt::round(y_min / resolution);
+		const int cx1 = mrpt::round(x_max / resolution);
+		const int cy1 = mrpt::round(y_max / resolution);
+		m_size_x = cx1 > m_cx0 ? cx1 - m_cx0 : 0;
+		m_size_y = cy1 > m_cy0 ? cy1 - m_cy0 : 0;
+		m_off_x = m_size_x ? pmod(m_cx0, m_size_x) : 0;
+		m_off_y = m_size_y ? pmod(m_cy0, m_size_y) : 0;
+
+		if (fill_value)
+			m_map.assign(m_size_x * m_size_y, *fill_value);
+		else
+			m_map.resize(m_size_x * m_size_y);
+	}
+
+	/** Erase the contents of all the cells. */
+	void clear()
+	{
+		m_map.clear();
+		m_map.resize(m_size_x * m_size_y);
+	}
+
+	/** Fills all the cells with the same value */
+	inline void fill(const T& value)
+	{
+		for (auto& c : m_map) c = value;
+	}
+
+	/** Moves the grid window such as its bottom-left corner is at (new_x_min,
+	 * new_y_min) (rounded to the nearest cell), keeping the contents of all
+	 * cells which remain within the window. Cells entering the window are
+	 * set to \a defaultValueNewCells.
+	 * \sa recenter, scrollCells
+	 */
+	void scrollTo(
+		double new_x_min, double new_y_min, const T& defaultValueNewCells)
+	{
+		scrollCells(
+			mrpt::round(new_x_min / m_resolution) - m_cx0,
+			mrpt::round(new_y_min / m_resolution) - m_cy0,
+			defaultValueNewCells);
+	}
+
+	/** Moves the grid window such as its center is as close as possible to
+	 * (x,y). \sa scrollTo */
+	void recenter(double x, double y, const T& defaultValueNewCells)
+	{
+		scrollCells(
+			mrpt::round(x / m_resolution - 0.5 * m_size_x) - m_cx0,
+			mrpt::round(y / m_resolution - 0.5 * m_size_y) - m_cy0,
+			defaultValueNewCells);
+	}
+
+	/** Moves the grid window by an integer number of cells. \sa scrollTo */
+	void scrollCells(int dx, int dy, const T& defaultValueNewCells)
+	{
+		m_last_scroll_cells = 0;
+		if (!dx && !dy) return;
+		m_cx0 += dx;
+		m_cy0 += dy;
+		if (m_map.empty()) return;
+		m_off_x = pmod(m_cx0, m_size_x);
+		m_off_y = pmod(m_cy0, m_size_y);
+
+		if (static_cast<size_t>(std::abs(dx)) >= m_size_x ||
+			static_cast<size_t>(std::abs(dy)) >= m_size_y)
+		{
+			// Nothing of the old window remains:
+			fill(defaultValueNewCells);
+			m_last_scroll_cells = m_map.size();
+			return;
+		}
+
+		// New rows: [y0,y1) in window-relative indices
+		const size_t ny = std::abs(dy);
+		const size_t y0 = dy > 0 ? m_size_y - ny : 0, y1 = y0 + ny;
+		for (size_t cy = y0; cy < y1; cy++)
+			for (size_t cx = 0; cx < m_size_x; cx++)
+				m_map[phys_index(cx, cy)] = defaultValueNewCells;
+		m_last_scroll_cells += ny * m_size_x;
+
+		// New columns, skipping the rows already reset above:
+		const size_t nx = std::abs(dx);
+		const size_t x0 = dx > 0 ? m_size_x - nx : 0, x1 = x0 + nx;
+		for (size_t cy = 0; cy < m_size_y; cy++)
+		{
+			if (cy >= y0 && cy < y1) continue;
+			for (size_t cx = x0; cx < x1; cx++)
+				m_map[phys_index(cx, cy)] = defaultValueNewCells;
+		}
+		m_last_scroll_cells += nx * (m_size_y - ny);
+	}
+
+	/** Number of cells which were reset in the last call to scrollCells(),
+	 * scrollTo() or recenter() */
+	size_t getLastScrollCellCount() const { return m_last_scroll_cells; }
+
+	/** Returns a pointer to the contents of a cell given by its coordinates, or
+	 * nullptr if it is out of the map extensions.
+	 */
+	inline T* cellByPos(double x, double y)
+	{
+		const int cx = x2idx(x), cy = y2idx(y);
+		if (cx < 0 || cx >= static_cast<int>(m_size_x)) return nullptr;
+		if (cy < 0 || cy >= static_cast<int>(m_size_y)) return nullptr;
+		return &m_map[phys_index(cx, cy)];
+	}
+	/** \overload */
+	inline const T* cellByPos(double x, double y) const
+	{
+		const int cx = x2idx(x), cy = y2idx(y);
+		if (cx < 0 || cx >= static_cast<int>(m_size_x)) return nullptr;
+		if (cy < 0 || cy >= static_cast<int>(m_size_y)) return nullptr;
+		return &m_map[phys_index(cx, cy)];
+	}
+
+	/** Returns a pointer to the contents of a cell given by its cell indexes,
+	 * or nullptr if it is out of the map extensions.
+	 */
+	inline T* cellByIndex(unsigned int cx, unsigned int cy)
+	{
+		if (cx >= m_size_x || cy >= m_size_y) return nullptr;
+		return &m_map[phys_index(cx, cy)];
+	}
+	/** \overload */
+	inline const T* cellByIndex(unsigned int cx, unsigned int cy) const
+	{
+		if (cx >= m_size_x || cy >= m_size_y) return nullptr;
+		return &m_map[phys_index(cx, cy)];
+	}
+
+	/** Returns the horizontal size of grid map in cells count */
+	inline size_t getSizeX() const { return m_size_x; }
+	/** Returns the vertical size of grid map in cells count */
+	inline size_t getSizeY() const { return m_size_y; }
+	/** Returns the "x" coordinate of left side of grid map */
+	inline double getXMin() const { return m_cx0 * m_resolution; }
+	/** Returns the "x" coordinate of right side of grid map */
+	inline double getXMax() const { return (m_cx0 + m_size_x) * m_resolution; }
+	/** Returns the "y" coordinate of top side of grid map */
+	inline double getYMin() const { return m_cy0 * m_resolution; }
+	/** Returns the "y" coordinate of bottom side of grid map */
+	inline double getYMax() const { return (m_cy0 + m_size_y) * m_resolution; }
+	/** Returns the resolution of the grid map */
+	inline double getResolution() const { return m_resolution; }
+	/** Transform a coordinate values into cell indexes */
+	inline int x2idx(double x) const
+	{
+		return static_cast<int>(std::floor(x / m_resolution)) - m_cx0;
+	}
+	inline int y2idx(double y) const
+	{
+		return static_cast<int>(std::floor(y / m_resolution)) - m_cy0;
+	}
+	/** Transform a cell index into a coordinate value of the cell central point
+	 */
+	inline double idx2x(int cx) const
+	{
+		return (m_cx0 + cx + 0.5) * m_resolution;
+	}
+	inline double idx2y(int cy) const
+	{
+		return (m_cy0 + cy + 0.5) * m_resolution;
+	}
+
+	/** Get the entire grid as a matrix, in window order (see
+	 * CDynamicGrid::getAsMatrix()) */
+	template <class MAT>
+	void getAsMatrix(MAT& m) const
+	{
+		m.setSize(m_size_y, m_size_x);
+		for (size_t cy = 0; cy < m_size_y; cy++)
+			for (size_t cx = 0; cx < m_size_x; cx++)
+				m.set_unsafe(cy, cx, m_map[phys_index(cx, cy)]);
+	}
+
+};  // end of CDynamicGridCircular<>
+
+}  // namespace mrpt::containers
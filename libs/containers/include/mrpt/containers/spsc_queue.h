@@ -0,0 +1,125 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace mrpt::containers
+{
+/** A bounded, lock-free, single-producer/single-consumer (SPSC) queue.
+ *
+ * Exactly one thread may call push()/try_push() and exactly one (possibly
+ * different) thread may call pop()/try_pop(). Neither side ever blocks nor
+ * takes a mutex, which makes this container suited to hand data from a
+ * real-time producer (e.g. a sensor driver thread) to a consumer thread.
+ *
+ * The queue keeps track of its high-water mark and of the number of push
+ * attempts rejected because the queue was full, which can be used as
+ * back-pressure statistics.
+ *
+ * \note Defined in #include <mrpt/containers/spsc_queue.h>
+ * \sa CThreadSafeQueue, circular_buffer
+ * \ingroup mrpt_containers_grp
+ */
+template <typename T>
+class spsc_queue
+{
+   public:
+	/** Creates a queue able to hold up to `capacity` elements. */
+	explicit spsc_queue(const std::size_t capacity) : m_data(capacity + 1)
+	{
+		if (capacity < 1) throw std::invalid_argument("capacity must be >0");
+	}
+
+	spsc_queue(const spsc_queue&) = delete;
+	spsc_queue& operator=(const spsc_queue&) = delete;
+
+	/** Maximum number of elements the queue can hold. */
+	std::size_t capacity() const { return m_data.size() - 1; }
+
+	/** Producer side: tries to insert an element.
+	 * \return false if the queue is full (the element is not moved-from).
+	 */
+	bool try_push(T&& d)
+	{
+		const auto w = m_write.load(std::memory_order_relaxed);
+		const auto nxt = next(w);
+		if (nxt == m_read.load(std::memory_order_acquire))
+		{
+			m_rejected.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		m_data[w] = std::move(d);
+		m_write.store(nxt, std::memory_order_release);
+
+		const auto sz = size();
+		if (sz > m_high_water.load(std::memory_order_relaxed))
+			m_high_water.store(sz, std::memory_order_relaxed);
+		return true;
+	}
+	/** \overload */
+	bool try_push(const T& d)
+	{
+		T c = d;
+		return try_push(std::move(c));
+	}
+
+	/** Consumer side: tries to extract the oldest element.
+	 * \return false if the queue is empty.
+	 */
+	bool try_pop(T& out)
+	{
+		const auto r = m_read.load(std::memory_order_relaxed);
+		if (r == m_write.load(std::memory_order_acquire)) return false;
+		out = std::move(m_data[r]);
+		m_data[r] = T();
+		m_read.store(next(r), std::memory_order_release);
+		return true;
+	}
+
+	/** Approximate number of queued elements (exact if called from either
+	 * the producer or the consumer thread while the other one is idle). */
+	std::size_t size() const
+	{
+		const auto w = m_write.load(std::memory_order_acquire);
+		const auto r = m_read.load(std::memory_order_acquire);
+		return w >= r ? w - r : w + m_data.size() - r;
+	}
+	bool empty() const { return size() == 0; }
+
+	/** Largest number of simultaneously queued elements seen so far. */
+	std::size_t high_water_mark() const
+	{
+		return m_high_water.load(std::memory_order_relaxed);
+	}
+	/** Number of try_push() calls which failed since the queue was full. */
+	std::size_t rejected_count() const
+	{
+		return m_rejected.load(std::memory_order_relaxed);
+	}
+
+   private:
+	std::vector<T> m_data;
+	/** Read and write indices, each one only modified by one side. Kept in
+	 * separate cache lines to avoid false sharing between both threads. */
+	alignas(64) std::atomic<std::size_t> m_read{0};
+	alignas(64) std::atomic<std::size_t> m_write{0};
+	alignas(64) std::atomic<std::size_t> m_high_water{0};
+	std::atomic<std::size_t> m_rejected{0};
+
+	std::size_t next(std::size_t i) const
+	{
+		return (++i == m_data.size()) ? 0 : i;
+	}
+};
+
+}  // namespace mrpt::containers
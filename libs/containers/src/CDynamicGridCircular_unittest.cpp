@@ -0,0 +1,93 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/containers/CDynamicGridCircular.h>
+#include <mrpt/core/common.h>
+#include <CTraitsTest.h>
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+
+template class mrpt::CTraitsTest<
+	mrpt::containers::CDynamicGridCircular<double>>;
+
+using mrpt::containers::CDynamicGridCircular;
+
+TEST(CDynamicGridCircular, GetSetAndScroll)
+{
+	CDynamicGridCircular<double> grid{-10.0, 10.0, -10.0, 10.0, 0.1};
+	EXPECT_EQ(grid.getSizeX(), 200U);
+	EXPECT_EQ(grid.getSizeY(), 200U);
+
+	*grid.cellByPos(3.05, 4.05) = 8.0;
+	*grid.cellByPos(-7.05, -7.05) = 9.0;
+	EXPECT_NEAR(*grid.cellByPos(3.05, 4.05), 8.0, 1e-10);
+	EXPECT_NEAR(*grid.cellByPos(-7.05, -7.05), 9.0, 1e-10);
+	EXPECT_TRUE(grid.cellByPos(10.05, 0) == nullptr);
+
+	grid.recenter(5.0, 0.0, 0.0);
+	EXPECT_NEAR(grid.getXMin(), -5.0, 1e-9);
+	EXPECT_NEAR(grid.getXMax(), 15.0, 1e-9);
+	EXPECT_EQ(grid.getLastScrollCellCount(), 50U * 200U);
+	EXPECT_NEAR(*grid.cellByPos(3.05, 4.05), 8.0, 1e-10);
+	EXPECT_TRUE(grid.cellByPos(-7.05, -7.05) == nullptr);
+	EXPECT_NEAR(*grid.cellByPos(12.05, 0.05), 0.0, 1e-10);
+
+	// Back: the cell that left the window must come back reset
+	grid.recenter(0.0, 0.0, -1.0);
+	EXPECT_NEAR(*grid.cellByPos(-7.05, -7.05), -1.0, 1e-10);
+	EXPECT_NEAR(*grid.cellByPos(3.05, 4.05), 8.0, 1e-10);
+}
+
+TEST(CDynamicGridCircular, RandomScrollsKeepContents)
+{
+	// Each cell stores an id of its global cell coordinates, which must be
+	// preserved while the cell is within the window.
+	const double res = 0.5;
+	CDynamicGridCircular<int> grid{-5.0, 5.0, -3.0, 4.0, res};
+	const int NONE = -1;
+	grid.fill(NONE);
+	const auto cellId = [&](unsigned cx, unsigned cy) {
+		const int gx = static_cast<int>(std::floor(grid.idx2x(cx) / res));
+		const int gy = static_cast<int>(std::floor(grid.idx2y(cy) / res));
+		return (gx + 1000) * 10000 + (gy + 1000);
+	};
+
+	std::srand(1234);
+	for (int iter = 0; iter < 200; iter++)
+	{
+		// Verify and (re)write all cells:
+		for (unsigned cy = 0; cy < grid.getSizeY(); cy++)
+			for (unsigned cx = 0; cx < grid.getSizeX(); cx++)
+			{
+				int* c = grid.cellByIndex(cx, cy);
+				ASSERT_TRUE(c != nullptr);
+				if (*c != NONE)
+				{
+					EXPECT_EQ(*c, cellId(cx, cy));
+				}
+				*c = cellId(cx, cy);
+			}
+		const int dx = std::rand() % 13 - 6, dy = std::rand() % 11 - 5;
+		grid.scrollCells(dx, dy, NONE);
+
+		// All the cells must be either new, or keep their values:
+		size_t nNew = 0;
+		for (unsigned cy = 0; cy < grid.getSizeY(); cy++)
+			for (unsigned cx = 0; cx < grid.getSizeX(); cx++)
+			{
+				const int c = *grid.cellByIndex(cx, cy);
+				if (c == NONE)
+					nNew++;
+				else
+					EXPECT_EQ(c, cellId(cx, cy));
+			}
+		EXPECT_EQ(nNew, grid.getLastScrollCellCount());
+	}
+}
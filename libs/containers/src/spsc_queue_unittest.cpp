@@ -0,0 +1,72 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/containers/spsc_queue.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+TEST(spsc_queue, PushPopFull)
+{
+	mrpt::containers::spsc_queue<int> q(3);
+	int ret;
+	EXPECT_FALSE(q.try_pop(ret));
+	EXPECT_TRUE(q.try_push(1));
+	EXPECT_TRUE(q.try_push(2));
+	EXPECT_TRUE(q.try_push(3));
+	EXPECT_FALSE(q.try_push(4));
+	EXPECT_EQ(q.size(), 3U);
+	EXPECT_EQ(q.rejected_count(), 1U);
+	EXPECT_EQ(q.high_water_mark(), 3U);
+
+	for (int i = 1; i <= 3; i++)
+	{
+		EXPECT_TRUE(q.try_pop(ret));
+		EXPECT_EQ(ret, i);
+	}
+	EXPECT_FALSE(q.try_pop(ret));
+	EXPECT_TRUE(q.empty());
+}
+
+TEST(spsc_queue, MoveOnly)
+{
+	mrpt::containers::spsc_queue<std::unique_ptr<int>> q(2);
+	EXPECT_TRUE(q.try_push(std::make_unique<int>(5)));
+	std::unique_ptr<int> ret;
+	EXPECT_TRUE(q.try_pop(ret));
+	ASSERT_TRUE(ret);
+	EXPECT_EQ(*ret, 5);
+}
+
+TEST(spsc_queue, TwoThreadsOrdering)
+{
+	const unsigned int N = 100000;
+	mrpt::containers::spsc_queue<unsigned int> q(64);
+
+	std::thread producer([&]() {
+		for (unsigned int i = 0; i < N; i++)
+			while (!q.try_push(i)) std::this_thread::yield();
+	});
+
+	unsigned int expected = 0;
+	while (expected < N)
+	{
+		unsigned int v;
+		if (!q.try_pop(v))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		ASSERT_EQ(v, expected);
+		expected++;
+	}
+	producer.join();
+	EXPECT_TRUE(q.empty());
+	EXPECT_LE(q.high_water_mark(), q.capacity());
+}
@@ -11,6 +11,8 @@
 #include <mrpt/system/COutputLogger.h>
 #include <mrpt/math/CMatrix.h>
 #include <mrpt/math/ops_matrices.h>
+#include <utility>
+#include <vector>
 
 namespace mrpt
 {
@@ -33,6 +35,12 @@ namespace graphs
  * \tparam num_t The type of matrix elements, thresholds, etc. (typ: float or
  * double). Defaults to the type of matrix elements.
  *
+ * Graphs can be given either as dense weight matrices, or as sparse adjacency
+ * lists (see sparse_adjacency_t), in which case the Fiedler vector is found
+ * with a restarted Lanczos method at a cost roughly linear with the number of
+ * edges, and can be warm-started from the solution to a similar graph (e.g.
+ * the same graph before adding a few new nodes).
+ *
  * \note Prior to MRPT 1.0.0 this class wasn't a template and provided static
  * variables for debugging, which were removed since that version.
  */
@@ -142,6 +150,60 @@ class CGraphPartitioner : public mrpt::system::COutputLogger
 		const GRAPH_MATRIX& in_A, const std::vector<uint32_t>& in_part1,
 		const std::vector<uint32_t>& in_part2);
 
+	/** \name Sparse graphs
+	 * @{ */
+
+	/** A sparse, weighted undirected graph: for each node, the list of its
+	 * neighbors and the weights of the edges. Each edge must appear in the
+	 * lists of both of its nodes with the same weight, and there must be no
+	 * self-loops. */
+	using sparse_adjacency_t =
+		std::vector<std::vector<std::pair<uint32_t, num_t>>>;
+
+	/** Like RecursiveSpectralPartition() for dense matrices, for a sparse
+	 * graph.
+	 * \param inout_fiedler [IN/OUT] If not null, the Fiedler vector of the
+	 * first bisection of a similar graph (e.g. from a previous call, with
+	 * zeros or any other guess for new nodes) is used to warm-start the
+	 * search, and the new one is returned here.
+	 */
+	static void RecursiveSpectralPartition(
+		const sparse_adjacency_t& in_A,
+		std::vector<std::vector<uint32_t>>& out_parts,
+		num_t threshold_Ncut = 1, bool recursive = true,
+		unsigned minSizeClusters = 1,
+		std::vector<num_t>* inout_fiedler = nullptr,
+		const bool verbose = false);
+
+	/** Like SpectralBisection() for dense matrices, for a sparse graph.
+	 * \param inout_fiedler See RecursiveSpectralPartition() */
+	static void SpectralBisection(
+		const sparse_adjacency_t& in_A, std::vector<uint32_t>& out_part1,
+		std::vector<uint32_t>& out_part2, num_t& out_cut_value,
+		std::vector<num_t>* inout_fiedler = nullptr);
+
+	/** Returns the normalized cut of a sparse graph for a given bisection */
+	static num_t nCut(
+		const sparse_adjacency_t& in_A, const std::vector<uint32_t>& in_part1,
+		const std::vector<uint32_t>& in_part2);
+
+	/** Computes the Fiedler vector (the eigenvector of the second smallest
+	 * eigenvalue of the Laplacian) of a sparse graph with a restarted
+	 * Lanczos method.
+	 * \param inout_v [IN/OUT] The initial guess, which is ignored if its
+	 * size does not match the number of nodes. The eigenvector, normalized
+	 * to unit length, on output.
+	 * \param max_restarts Maximum number of Lanczos restarts.
+	 * \param tolerance Convergence threshold on the eigenvector residual,
+	 * relative to the largest eigenvalue of the Laplacian.
+	 * \return The number of matrix-vector products evaluated.
+	 */
+	static size_t FiedlerVector(
+		const sparse_adjacency_t& in_A, std::vector<num_t>& inout_v,
+		unsigned int max_restarts = 100, double tolerance = 1e-6);
+
+	/** @} */
+
 };  // End of class def.
 
 }  // namespace graphs
@@ -13,6 +13,12 @@
 #error "This file can't be included from outside of CGraphPartitioner.h"
 #endif
 
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
 namespace mrpt::graphs
 {
 /*---------------------------------------------------------------
@@ -351,4 +357,277 @@ void CGraphPartitioner<GRAPH_MATRIX, num_t>::exactBisection(
 	}
 }
 
+/*---------------------------------------------------------------
+					FiedlerVector (sparse)
+  ---------------------------------------------------------------*/
+template <class GRAPH_MATRIX, typename num_t>
+size_t CGraphPartitioner<GRAPH_MATRIX, num_t>::FiedlerVector(
+	const sparse_adjacency_t& in_A, std::vector<num_t>& inout_v,
+	unsigned int max_restarts, double tolerance)
+{
+	MRPT_START
+
+	const size_t n = in_A.size();
+	ASSERT_ABOVE_(n, 1U);
+
+	// Lanczos finds the largest eigenvalues of M = c*I - L (L: the
+	// Laplacian), in the subspace orthogonal to the constant vector (the
+	// eigenvector of the zero eigenvalue of L), so its top eigenvector is the
+	// Fiedler vector. c is an upper bound of the eigenvalues of L (Gershgorin)
+	// so M is positive semidefinite.
+	Eigen::VectorXd degree(n);
+	double c = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		double d = 0;
+		for (const auto& e : in_A[i]) d += e.second;
+		degree[i] = d;
+		c = std::max(c, 2 * d);
+	}
+	if (c <= 0) c = 1;  // No edges at all
+
+	auto M_times = [&](const Eigen::VectorXd& x, Eigen::VectorXd& y) {
+		for (size_t i = 0; i < n; i++)
+		{
+			double Wx = 0;
+			for (const auto& e : in_A[i]) Wx += e.second * x[e.first];
+			y[i] = (c - degree[i]) * x[i] + Wx;
+		}
+	};
+	// Removes the component along the constant vector:
+	auto deflate = [](Eigen::VectorXd& x) { x.array() -= x.mean(); };
+
+	Eigen::VectorXd v(n);
+	if (inout_v.size() == n)
+		for (size_t i = 0; i < n; i++) v[i] = inout_v[i];
+	else
+		v.setZero();
+	deflate(v);
+	if (v.norm() < 1e-9)
+	{
+		// No valid initial guess: use an arbitrary, deterministic one.
+		for (size_t i = 0; i < n; i++) v[i] = std::sin(1.0 + 2.4 * i);
+		deflate(v);
+	}
+
+	const size_t m = std::min<size_t>(n - 1, 32);  // Krylov subspace size
+	Eigen::MatrixXd V(n, m);
+	Eigen::VectorXd alpha(m), beta(m), x(n), w(n);
+	size_t nProducts = 0;
+	for (unsigned int restart = 0; restart <= max_restarts; restart++)
+	{
+		V.col(0) = v / v.norm();
+		size_t k = 0;
+		double lastBeta = 0;
+		while (k < m)
+		{
+			x = V.col(k);
+			M_times(x, w);
+			nProducts++;
+			alpha[k] = x.dot(w);
+			// Full reorthogonalization, twice for numerical stability:
+			for (int pass = 0; pass < 2; pass++)
+			{
+				deflate(w);
+				w -= V.leftCols(k + 1) * (V.leftCols(k + 1).transpose() * w);
+			}
+			lastBeta = w.norm();
+			k++;
+			// Invariant subspace found?
+			if (k == m || lastBeta < 1e-12 * c) break;
+			beta[k - 1] = lastBeta;
+			V.col(k) = w / lastBeta;
+		}
+
+		Eigen::MatrixXd T = Eigen::MatrixXd::Zero(k, k);
+		for (size_t i = 0; i < k; i++)
+		{
+			T(i, i) = alpha[i];
+			if (i + 1 < k) T(i, i + 1) = T(i + 1, i) = beta[i];
+		}
+		const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> es(T);
+		// Eigenvalues are sorted in increasing order:
+		const Eigen::VectorXd s = es.eigenvectors().col(k - 1);
+		v = V.leftCols(k) * s;
+		deflate(v);
+
+		// Residual of the Ritz vector: |M*v - theta*v| = beta_k * |s_k|
+		if (lastBeta * std::abs(s[k - 1]) <= tolerance * c) break;
+	}
+
+	v.normalize();
+	inout_v.resize(n);
+	for (size_t i = 0; i < n; i++) inout_v[i] = static_cast<num_t>(v[i]);
+	return nProducts;
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+					SpectralBisection (sparse)
+  ---------------------------------------------------------------*/
+template <class GRAPH_MATRIX, typename num_t>
+void CGraphPartitioner<GRAPH_MATRIX, num_t>::SpectralBisection(
+	const sparse_adjacency_t& in_A, std::vector<uint32_t>& out_part1,
+	std::vector<uint32_t>& out_part2, num_t& out_cut_value,
+	std::vector<num_t>* inout_fiedler)
+{
+	const size_t nodeCount = in_A.size();
+
+	std::vector<num_t> local_fiedler;
+	std::vector<num_t>& fiedler = inout_fiedler ? *inout_fiedler : local_fiedler;
+	FiedlerVector(in_A, fiedler);
+
+	double mean = 0;
+	for (size_t i = 0; i < nodeCount; i++) mean += fiedler[i];
+	mean /= nodeCount;
+
+	out_part1.clear();
+	out_part2.clear();
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		if (fiedler[i] >= mean)
+			out_part1.push_back(i);
+		else
+			out_part2.push_back(i);
+	}
+
+	// Constant eigenvector: Split nodes in two equally sized parts:
+	if (!out_part1.size() || !out_part2.size())
+	{
+		out_part1.clear();
+		out_part2.clear();
+		for (size_t i = 0; i < nodeCount; i++)
+			if (i <= nodeCount / 2)
+				out_part1.push_back(i);
+			else
+				out_part2.push_back(i);
+	}
+
+	out_cut_value = nCut(in_A, out_part1, out_part2);
+}
+
+/*---------------------------------------------------------------
+					RecursiveSpectralPartition (sparse)
+  ---------------------------------------------------------------*/
+template <class GRAPH_MATRIX, typename num_t>
+void CGraphPartitioner<GRAPH_MATRIX, num_t>::RecursiveSpectralPartition(
+	const sparse_adjacency_t& in_A,
+	std::vector<std::vector<uint32_t>>& out_parts, num_t threshold_Ncut,
+	bool recursive, unsigned minSizeClusters,
+	std::vector<num_t>* inout_fiedler, const bool verbose)
+{
+	MRPT_START
+
+	const size_t nodeCount = in_A.size();
+	out_parts.clear();
+	if (!nodeCount) return;
+
+	if (nodeCount == 1)
+	{
+		// Don't split, there is just a node!
+		out_parts.emplace_back(1, 0);
+		return;
+	}
+
+	std::vector<num_t> local_fiedler;
+	std::vector<num_t>& fiedler = inout_fiedler ? *inout_fiedler : local_fiedler;
+
+	std::vector<uint32_t> p1, p2;
+	num_t cut_value;
+	SpectralBisection(in_A, p1, p2, cut_value, &fiedler);
+
+	if (verbose)
+		std::cout << format(
+			"Cut:%u=%u+%u,nCut=%.02f->", (unsigned int)nodeCount,
+			(unsigned int)p1.size(), (unsigned int)p2.size(), cut_value);
+
+	// Is it a useful partition?
+	if (cut_value > threshold_Ncut || p1.size() < minSizeClusters ||
+		p2.size() < minSizeClusters)
+	{
+		if (verbose) std::cout << "->NO!" << std::endl;
+
+		out_parts.resize(1);
+		for (size_t i = 0; i < nodeCount; i++) out_parts[0].push_back(i);
+		return;
+	}
+	if (verbose) std::cout << "->YES!" << std::endl;
+
+	if (!recursive)
+	{
+		// Force bisection only:
+		out_parts.push_back(p1);
+		out_parts.push_back(p2);
+		return;
+	}
+
+	// Split each part, warm-starting with the restriction of the Fiedler
+	// vector of the whole graph, and remap indices of the results:
+	std::vector<uint32_t> newIdx(nodeCount);
+	for (const auto* part : {&p1, &p2})
+	{
+		for (size_t i = 0; i < part->size(); i++) newIdx[(*part)[i]] = i;
+
+		sparse_adjacency_t sub_A(part->size());
+		std::vector<num_t> sub_fiedler(part->size());
+		std::vector<bool> inPart(nodeCount, false);
+		for (const auto i : *part) inPart[i] = true;
+		for (size_t i = 0; i < part->size(); i++)
+		{
+			const auto orig = (*part)[i];
+			sub_fiedler[i] = fiedler[orig];
+			for (const auto& e : in_A[orig])
+				if (inPart[e.first])
+					sub_A[i].emplace_back(newIdx[e.first], e.second);
+		}
+
+		std::vector<std::vector<uint32_t>> sub_parts;
+		RecursiveSpectralPartition(
+			sub_A, sub_parts, threshold_Ncut, recursive, minSizeClusters,
+			&sub_fiedler, verbose);
+		for (auto& sp : sub_parts)
+		{
+			for (auto& idx : sp) idx = (*part)[idx];
+			out_parts.emplace_back(std::move(sp));
+		}
+	}
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+						nCut (sparse)
+  ---------------------------------------------------------------*/
+template <class GRAPH_MATRIX, typename num_t>
+num_t CGraphPartitioner<GRAPH_MATRIX, num_t>::nCut(
+	const sparse_adjacency_t& in_A, const std::vector<uint32_t>& in_part1,
+	const std::vector<uint32_t>& in_part2)
+{
+	// 0: not in any part, 1: part1, 2: part2
+	std::vector<uint8_t> part(in_A.size(), 0);
+	for (const auto i : in_part1) part[i] = 1;
+	for (const auto i : in_part2) part[i] = 2;
+
+	// Edges within a part are visited twice, once from each node:
+	num_t cut_AB = 0, assoc_AA_2 = 0, assoc_BB_2 = 0;
+	for (const auto i : in_part1)
+		for (const auto& e : in_A[i])
+		{
+			if (part[e.first] == 2) cut_AB += e.second;
+			if (part[e.first] == 1) assoc_AA_2 += e.second;
+		}
+	for (const auto i : in_part2)
+		for (const auto& e : in_A[i])
+			if (part[e.first] == 2) assoc_BB_2 += e.second;
+
+	const num_t assoc_AV = assoc_AA_2 / 2 + cut_AB;
+	const num_t assoc_BV = assoc_BB_2 / 2 + cut_AB;
+
+	if (!cut_AB)
+		return 0;
+	else
+		return cut_AB / assoc_AV + cut_AB / assoc_BV;
+}
+
 }  // namespace mrpt::graphs
@@ -0,0 +1,110 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/graphs/CGraphPartitioner.h>
+#include <mrpt/math/CMatrixTemplateNumeric.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+
+using namespace mrpt;
+using namespace mrpt::graphs;
+using namespace mrpt::math;
+using namespace std;
+
+using partitioner_t = CGraphPartitioner<CMatrixDouble>;
+
+namespace
+{
+// A sequence of keyframes in `nClusters` rooms: each node overlaps with the
+// next ones in the same room, and weakly with those of the next room.
+void buildGraph(
+	size_t nClusters, size_t clusterSize, CMatrixDouble& A,
+	partitioner_t::sparse_adjacency_t& adj)
+{
+	const size_t n = nClusters * clusterSize;
+	A.setZero(n, n);
+	for (size_t i = 0; i < n; i++)
+		for (size_t j = i + 1; j < n && j <= i + 4; j++)
+		{
+			const bool sameRoom = (i / clusterSize) == (j / clusterSize);
+			A(i, j) = A(j, i) = sameRoom ? 1.0 / (j - i) : 0.02;
+		}
+	adj.assign(n, {});
+	for (size_t i = 0; i < n; i++)
+		for (size_t j = 0; j < n; j++)
+			if (A(i, j) != 0) adj[i].emplace_back(j, A(i, j));
+}
+
+void sortParts(std::vector<std::vector<uint32_t>>& parts)
+{
+	for (auto& p : parts) std::sort(p.begin(), p.end());
+	std::sort(parts.begin(), parts.end());
+}
+}  // namespace
+
+TEST(CGraphPartitioner, SparseMatchesDense)
+{
+	CMatrixDouble A;
+	partitioner_t::sparse_adjacency_t adj;
+	buildGraph(4, 15, A, adj);
+
+	std::vector<std::vector<uint32_t>> denseParts, sparseParts;
+	partitioner_t::RecursiveSpectralPartition(A, denseParts, 0.2);
+	partitioner_t::RecursiveSpectralPartition(adj, sparseParts, 0.2);
+	sortParts(denseParts);
+	sortParts(sparseParts);
+
+	EXPECT_EQ(denseParts.size(), 4U);
+	EXPECT_EQ(denseParts, sparseParts);
+
+	std::vector<uint32_t> p1, p2;
+	double cutDense, cutSparse;
+	partitioner_t::SpectralBisection(A, p1, p2, cutDense);
+	partitioner_t::SpectralBisection(adj, p1, p2, cutSparse);
+	EXPECT_NEAR(cutDense, cutSparse, 1e-9);
+	EXPECT_NEAR(partitioner_t::nCut(A, p1, p2), cutSparse, 1e-9);
+}
+
+TEST(CGraphPartitioner, FiedlerVectorWarmStart)
+{
+	CMatrixDouble A;
+	partitioner_t::sparse_adjacency_t adj;
+	buildGraph(3, 100, A, adj);
+
+	std::vector<double> cold;
+	const size_t nCold = partitioner_t::FiedlerVector(adj, cold);
+
+	// Check it is an eigenvector of the Laplacian, orthogonal to (1,...,1):
+	CMatrixDouble L;
+	A.laplacian(L);
+	Eigen::VectorXd v(cold.size());
+	for (size_t i = 0; i < cold.size(); i++) v[i] = cold[i];
+	const double lambda = v.dot(L * v);
+	EXPECT_LT((L * v - lambda * v).norm(), 1e-4);
+	EXPECT_NEAR(v.sum(), 0, 1e-6);
+	EXPECT_GT(lambda, 0);
+
+	// A new node, connected to the last one: warm-starting from the
+	// previous solution must be much cheaper.
+	const uint32_t last = adj.size() - 1;
+	adj.emplace_back();
+	adj.back().emplace_back(last, 1.0);
+	adj[last].emplace_back(last + 1, 1.0);
+	std::vector<double> warm = cold;
+	warm.push_back(cold.back());
+	std::vector<double> cold2;
+	const size_t nWarm = partitioner_t::FiedlerVector(adj, warm);
+	const size_t nCold2 = partitioner_t::FiedlerVector(adj, cold2);
+	EXPECT_LT(nWarm, nCold2);
+	EXPECT_GT(nCold, 0U);
+	// Same eigenvector up to the sign:
+	double dot = 0;
+	for (size_t i = 0; i < warm.size(); i++) dot += warm[i] * cold2[i];
+	EXPECT_NEAR(std::abs(dot), 1.0, 1e-4);
+}
@@ -23,7 +23,11 @@
 #include <mrpt/opengl/COpenGLScene.h>
 #include <mrpt/serialization/CMessage.h>
 #include <mrpt/core/aligned_std_map.h>
+#include <mrpt/core/Clock.h>
+#include <mrpt/system/CTimeLogger.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <thread>
 #include <queue>
 
@@ -202,10 +206,19 @@ class CHMTSLAM : public mrpt::system::COutputLogger,
 	 */
 	size_t inputQueueSize();
 
+	/** Blocks until the input queue becomes empty, or the timeout expires, or
+	 * the threads are terminated.
+	 * \return true if the queue is empty.
+	 * \sa isInputQueueEmpty, TOptions::input_queue_max_size
+	 */
+	bool waitForEmptyInputQueue(double max_wait_seconds);
+
 	/** Here the user can enter an action into the system (will go to the SLAM
 	 * process).
 	 *  This class will delete the passed object when required, so DO NOT
 	 * DELETE the passed object after calling this.
+	 *  If the input queue already holds TOptions::input_queue_max_size
+	 * objects, this blocks until the LSLAM thread takes one of them.
 	 * \sa pushObservations,pushObservation
 	 */
 	void pushAction(const mrpt::obs::CActionCollection::Ptr& acts);
@@ -237,13 +250,28 @@ class CHMTSLAM : public mrpt::system::COutputLogger,
 	 */
 	mrpt::serialization::CSerializable::Ptr getNextObjectFromInputQueue();
 
+	/** Common implementation of pushAction(), pushObservations(), etc. */
+	void pushToInputQueue(const mrpt::serialization::CSerializable::Ptr& obj);
+
+	/** An action/observation in the input queue, with the time it was
+	 * pushed, to measure how long it waits for being processed. */
+	struct TInputQueueEntry
+	{
+		mrpt::serialization::CSerializable::Ptr obj;
+		mrpt::Clock::time_point push_time;
+	};
+
 	/** The queue of pending actions/observations supplied by the user waiting
 	 * for being processed. */
-	std::queue<mrpt::serialization::CSerializable::Ptr> m_inputQueue;
+	std::queue<TInputQueueEntry> m_inputQueue;
 
 	/** Critical section for accessing  m_inputQueue */
 	mutable std::mutex m_inputQueue_cs;
 
+	/** Signaled (with m_inputQueue_cs) when an object is pushed to or taken
+	 * from m_inputQueue, and on termination. */
+	std::condition_variable m_inputQueue_cv;
+
 	/** Critical section for accessing m_map */
 	mutable std::mutex m_map_cs;
 
@@ -333,8 +361,26 @@ class CHMTSLAM : public mrpt::system::COutputLogger,
 
 	/** @} */
    protected:
-	/** Termination flag for signaling all threads to terminate */
-	bool m_terminateThreads;
+	/** Termination flag for signaling all threads to terminate
+	 * \sa signalTermination */
+	std::atomic<bool> m_terminateThreads{false};
+
+	/** Used with m_terminate_cv by the threads without input data to wait
+	 * for termination */
+	std::mutex m_terminate_mtx;
+	std::condition_variable m_terminate_cv;
+
+	/** Sets m_terminateThreads and wakes up all threads waiting for data */
+	void signalTermination();
+
+	/** @name Per-stage latency metrics
+		@{ */
+	/** Tracing-mode profiler of the processing stages, see
+	 * getStageLatencies() */
+	mrpt::system::CTimeLogger m_stage_timelogger{true, "CHMTSLAM"};
+	mrpt::system::CTimeLogger::section_id_t m_sec_queue_wait, m_sec_LSLAM,
+		m_sec_AA, m_sec_TBI, m_sec_TLC;
+	/** @} */
 
 	/** Threads termination flags:
 	 */
@@ -381,6 +427,17 @@ class CHMTSLAM : public mrpt::system::COutputLogger,
 	 */
 	bool abortedDueToErrors();
 
+	/** Returns latency statistics of each processing stage, so far:
+	 * - `queue_wait`: Time each action/observation waited in the input queue.
+	 * - `LSLAM`: Local SLAM update of one LMH with one action/observation.
+	 * - `AA`: Area abstraction (graph partitioning).
+	 * - `TBI`: Topological Bayesian inference for one area.
+	 * - `TLC`: Topological loop closure.
+	 */
+	void getStageLatencies(
+		std::map<std::string, mrpt::system::CTimeLogger::TTraceStats>&
+			out_stats) const;
+
 	/** @name High-level map management
 		@{ */
 
@@ -502,6 +559,11 @@ class CHMTSLAM : public mrpt::system::COutputLogger,
 		 */
 		std::vector<std::string> TLC_detectors;
 
+		/** Maximum number of actions/observations in the input queue (0:
+		 * unbounded). Pushing into a full queue blocks the caller until the
+		 * LSLAM thread catches up. Default=100 */
+		size_t input_queue_max_size;
+
 		/** Options passed to this TLC constructor */
 		CTopLCDetector_GridMatching::TOptions TLC_grid_options;
 		/** Options passed to this TLC constructor */
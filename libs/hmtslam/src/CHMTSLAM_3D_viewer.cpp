@@ -43,13 +43,14 @@ void CHMTSLAM::thread_3D_viewer()
 			std::this_thread::get_id());
 
 		// --------------------------------------------
-		//    The main loop
-		//  Executes until termination is signaled
+		//  Nothing to do here: sleep (without polling)
+		//  until termination is signaled
 		// --------------------------------------------
-		while (!obj->m_terminateThreads)
 		{
-			std::this_thread::sleep_for(100ms);
-		};  // end while execute thread
+			std::unique_lock<std::mutex> lock(obj->m_terminate_mtx);
+			obj->m_terminate_cv.wait(
+				lock, [obj]() { return bool(obj->m_terminateThreads); });
+		}
 
 		// Finish thread:
 		// -------------------------
@@ -69,7 +70,7 @@ void CHMTSLAM::thread_3D_viewer()
 		obj->logFmt(mrpt::system::LVL_ERROR, "%s", e.what());
 
 		// DEBUG: Terminate application:
-		obj->m_terminateThreads = true;
+		obj->signalTermination();
 	}
 	catch (...)
 	{
@@ -82,6 +83,6 @@ void CHMTSLAM::thread_3D_viewer()
 			"runtime error!!\n");
 
 		// DEBUG: Terminate application:
-		obj->m_terminateThreads = true;
+		obj->signalTermination();
 	}
 }
@@ -88,6 +88,15 @@ void CHMTSLAM::thread_LSLAM()
 				} while (recMsg);
 			}
 
+			// Wait for new data, or for termination:
+			{
+				std::unique_lock<std::mutex> lock(obj->m_inputQueue_cs);
+				obj->m_inputQueue_cv.wait(lock, [obj]() {
+					return obj->m_terminateThreads ||
+						   !obj->m_inputQueue.empty();
+				});
+			}
+
 			// There are pending elements?
 			if (!obj->isInputQueueEmpty())
 			{
@@ -133,9 +142,13 @@ void CHMTSLAM::thread_LSLAM()
 						// ----------------------------------------------
 						// 1) Process acts & obs by Local SLAM method:
 						// ----------------------------------------------
-						obj->m_LSLAM_method->processOneLMH(
-							&it->second,  // The LMH
-							actions, observations);
+						{
+							CTimeLoggerEntry tle(
+								obj->m_stage_timelogger, obj->m_sec_LSLAM);
+							obj->m_LSLAM_method->processOneLMH(
+								&it->second,  // The LMH
+								actions, observations);
+						}
 
 						// ----------------------------------------------
 						// 2) Invoke Area Abstraction (AA) method
@@ -144,21 +157,21 @@ void CHMTSLAM::thread_LSLAM()
 							5)  // Option: Do this only one out of N new added
 						// poses:
 						{
-							CTicTac tictac2;
-							tictac2.Tic();
-
 							unsigned nPosesToInsert =
 								it->second.m_posesPendingAddPartitioner.size();
+							obj->m_stage_timelogger.enter(obj->m_sec_AA);
 							TMessageLSLAMfromAA::Ptr msgFromAA =
 								CHMTSLAM::areaAbstraction(
 									&it->second,
 									it->second.m_posesPendingAddPartitioner);
+							const double t_AA =
+								obj->m_stage_timelogger.leave(obj->m_sec_AA);
 
 							obj->logFmt(
 								mrpt::system::LVL_DEBUG,
 								"[AreaAbstraction] Took %.03fms to insert %u "
 								"new poses.               AA\n",
-								1000 * tictac2.Tac(), nPosesToInsert);
+								1000 * t_AA, nPosesToInsert);
 
 							// Empty the list, it's done for now:
 							it->second.m_posesPendingAddPartitioner.clear();
@@ -185,21 +198,23 @@ void CHMTSLAM::thread_LSLAM()
 								 areaID != it->second.m_areasPendingTBI.end();
 								 ++areaID)
 							{
-								CTicTac tictac2;
-								tictac2.Tic();
 								if (obj->m_options.random_seed)
 									getRandomGenerator().randomize(
 										obj->m_options.random_seed);
 
+								obj->m_stage_timelogger.enter(obj->m_sec_TBI);
 								TMessageLSLAMfromTBI::Ptr msgFromTBI =
 									CHMTSLAM::TBI_main_method(
 										&it->second, *areaID);
+								const double t_TBI =
+									obj->m_stage_timelogger.leave(
+										obj->m_sec_TBI);
 
 								obj->logFmt(
 									mrpt::system::LVL_DEBUG,
 									"[TBI] Took %.03fms	                    "
 									" TBI\n",
-									1000 * tictac2.Tac());
+									1000 * t_TBI);
 
 								// -----------------------------------------------------------------------
 								//   Process the set of (potentially) several
@@ -231,11 +246,6 @@ void CHMTSLAM::thread_LSLAM()
 				nIter++;
 
 			}  // End if queue isn't empty
-			else
-			{
-				// Wait for new data:
-				std::this_thread::sleep_for(5ms);
-			}
 		};  // end while execute thread
 
 		// Finish thread:
@@ -255,7 +265,7 @@ void CHMTSLAM::thread_LSLAM()
 		if (e.what()) obj->logFmt(mrpt::system::LVL_DEBUG, "%s", e.what());
 
 		// DEBUG: Terminate application:
-		obj->m_terminateThreads = true;
+		obj->signalTermination();
 	}
 	catch (...)
 	{
@@ -273,7 +283,7 @@ void CHMTSLAM::thread_LSLAM()
 		// Release semaphores:
 
 		// DEBUG: Terminate application:
-		obj->m_terminateThreads = true;
+		obj->signalTermination();
 	}
 }
 
@@ -51,13 +51,14 @@ void CHMTSLAM::thread_TBI()
 			std::this_thread::get_id());
 
 		// --------------------------------------------
-		//    The main loop
-		//  Executes until termination is signaled
+		//  Nothing to do here: sleep (without polling)
+		//  until termination is signaled
 		// --------------------------------------------
-		while (!obj->m_terminateThreads)
 		{
-			std::this_thread::sleep_for(100ms);
-		};  // end while execute thread
+			std::unique_lock<std::mutex> lock(obj->m_terminate_mtx);
+			obj->m_terminate_cv.wait(
+				lock, [obj]() { return bool(obj->m_terminateThreads); });
+		}
 
 		// Finish thread:
 		// -------------------------
@@ -76,7 +77,7 @@ void CHMTSLAM::thread_TBI()
 		obj->logFmt(mrpt::system::LVL_ERROR, "%s", e.what());
 
 		// DEBUG: Terminate application:
-		obj->m_terminateThreads = true;
+		obj->signalTermination();
 	}
 	catch (...)
 	{
@@ -91,7 +92,7 @@ void CHMTSLAM::thread_TBI()
 		// Release semaphores:
 
 		// DEBUG: Terminate application:
-		obj->m_terminateThreads = true;
+		obj->signalTermination();
 	}
 }
 
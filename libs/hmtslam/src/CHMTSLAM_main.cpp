@@ -61,6 +61,14 @@ CHMTSLAM::CHMTSLAM()
 	m_terminationFlag_LSLAM = m_terminationFlag_TBI =
 		m_terminationFlag_3D_viewer = false;
 
+	m_stage_timelogger.setMinLoggingLevel(mrpt::system::LVL_ERROR);
+	m_stage_timelogger.setTraceBufferSize(0);
+	m_sec_queue_wait = m_stage_timelogger.registerSection("queue_wait");
+	m_sec_LSLAM = m_stage_timelogger.registerSection("LSLAM");
+	m_sec_AA = m_stage_timelogger.registerSection("AA");
+	m_sec_TBI = m_stage_timelogger.registerSection("TBI");
+	m_sec_TLC = m_stage_timelogger.registerSection("TLC");
+
 	// Create threads:
 	// -----------------------
 	m_hThread_LSLAM = std::thread(&CHMTSLAM::thread_LSLAM, this);
@@ -88,7 +96,7 @@ CHMTSLAM::~CHMTSLAM()
 {
 	// Signal to threads that we are closing:
 	// -------------------------------------------
-	m_terminateThreads = true;
+	signalTermination();
 
 	// Wait for threads:
 	// ----------------------------------
@@ -163,6 +171,43 @@ void CHMTSLAM::clearInputQueue()
 			m_inputQueue.pop();
 		};
 	}
+	m_inputQueue_cv.notify_all();
+}
+
+/*---------------------------------------------------------------
+						signalTermination
+  ---------------------------------------------------------------*/
+void CHMTSLAM::signalTermination()
+{
+	// Set the flag with the mutexes held, so no thread can miss the
+	// notification between checking the flag and starting to wait:
+	{
+		std::lock_guard<std::mutex> lock(m_inputQueue_cs);
+		m_terminateThreads = true;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_terminate_mtx);
+	}
+	m_inputQueue_cv.notify_all();
+	m_terminate_cv.notify_all();
+}
+
+/*---------------------------------------------------------------
+						pushToInputQueue
+  ---------------------------------------------------------------*/
+void CHMTSLAM::pushToInputQueue(const CSerializable::Ptr& obj)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_inputQueue_cs);
+		// Bounded queue: wait for the LSLAM thread to make room
+		m_inputQueue_cv.wait(lock, [this]() {
+			return m_terminateThreads || !m_options.input_queue_max_size ||
+				   m_inputQueue.size() < m_options.input_queue_max_size;
+		});
+		if (m_terminateThreads) return;  // Discard it
+		m_inputQueue.push({obj, mrpt::Clock::now()});
+	}
+	m_inputQueue_cv.notify_all();
 }
 
 /*---------------------------------------------------------------
@@ -177,10 +222,7 @@ void CHMTSLAM::pushAction(const CActionCollection::Ptr& acts)
 		return;
 	}
 
-	{  // Wait for critical section
-		std::lock_guard<std::mutex> lock(m_inputQueue_cs);
-		m_inputQueue.push(acts);
-	}
+	pushToInputQueue(acts);
 }
 
 /*---------------------------------------------------------------
@@ -195,10 +237,7 @@ void CHMTSLAM::pushObservations(const CSensoryFrame::Ptr& sf)
 		return;
 	}
 
-	{  // Wait for critical section
-		std::lock_guard<std::mutex> lock(m_inputQueue_cs);
-		m_inputQueue.push(sf);
-	}
+	pushToInputQueue(sf);
 }
 
 /*---------------------------------------------------------------
@@ -217,10 +256,7 @@ void CHMTSLAM::pushObservation(const CObservation::Ptr& obs)
 	sf->insert(
 		obs);  // memory will be freed when deleting the SF in other thread
 
-	{  // Wait for critical section
-		std::lock_guard<std::mutex> lock(m_inputQueue_cs);
-		m_inputQueue.push(sf);
-	}
+	pushToInputQueue(sf);
 }
 
 /*---------------------------------------------------------------
@@ -278,6 +314,8 @@ CHMTSLAM::TOptions::TOptions()
 
 	TLC_detectors.clear();
 
+	input_queue_max_size = 100;
+
 	stds_Q_no_odo.resize(3);
 	stds_Q_no_odo[0] = stds_Q_no_odo[1] = 0.10f;
 	stds_Q_no_odo[2] = DEG2RAD(4.0f);
@@ -305,6 +343,7 @@ void CHMTSLAM::TOptions::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(VIEW3D_AREA_SPHERES_RADIUS, float, source, section);
 
 	MRPT_LOAD_CONFIG_VAR(random_seed, int, source, section);
+	MRPT_LOAD_CONFIG_VAR(input_queue_max_size, uint64_t, source, section);
 
 	stds_Q_no_odo[2] = RAD2DEG(stds_Q_no_odo[2]);
 	source.read_vector(section, "stds_Q_no_odo", stds_Q_no_odo, stds_Q_no_odo);
@@ -342,6 +381,7 @@ void CHMTSLAM::TOptions::dumpToTextStream(std::ostream& out) const
 	LOADABLEOPTS_DUMP_VAR_DEG(MIN_ODOMETRY_STD_PHI);
 
 	LOADABLEOPTS_DUMP_VAR(random_seed, int);
+	LOADABLEOPTS_DUMP_VAR(input_queue_max_size, int);
 
 	AA_options.dumpToTextStream(out);
 	pf_options.dumpToTextStream(out);
@@ -378,21 +418,45 @@ size_t CHMTSLAM::inputQueueSize()
 	return res;
 }
 
+/*---------------------------------------------------------------
+					waitForEmptyInputQueue
+  ---------------------------------------------------------------*/
+bool CHMTSLAM::waitForEmptyInputQueue(double max_wait_seconds)
+{
+	std::unique_lock<std::mutex> lock(m_inputQueue_cs);
+	return m_inputQueue_cv.wait_for(
+		lock, std::chrono::duration<double>(max_wait_seconds), [this]() {
+			return m_terminateThreads || m_inputQueue.empty();
+		}) &&
+		   m_inputQueue.empty();
+}
+
 /*---------------------------------------------------------------
 					getNextObjectFromInputQueue
   ---------------------------------------------------------------*/
 CSerializable::Ptr CHMTSLAM::getNextObjectFromInputQueue()
 {
 	CSerializable::Ptr obj;
+	mrpt::Clock::time_point push_time;
 
 	{  // Wait for critical section
 		std::lock_guard<std::mutex> lock(m_inputQueue_cs);
 		if (!m_inputQueue.empty())
 		{
-			obj = m_inputQueue.front();
+			obj = m_inputQueue.front().obj;
+			push_time = m_inputQueue.front().push_time;
 			m_inputQueue.pop();
 		}
 	}
+	if (obj)
+	{
+		// Wake up producers waiting for room, or for an empty queue:
+		m_inputQueue_cv.notify_all();
+		m_stage_timelogger.addSectionTime(
+			m_sec_queue_wait,
+			std::chrono::duration<double>(mrpt::Clock::now() - push_time)
+				.count());
+	}
 	return obj;
 }
 
@@ -546,6 +610,16 @@ bool CHMTSLAM::abortedDueToErrors()
 		   m_terminationFlag_3D_viewer;
 }
 
+/*---------------------------------------------------------------
+						getStageLatencies
+  ---------------------------------------------------------------*/
+void CHMTSLAM::getStageLatencies(
+	std::map<std::string, mrpt::system::CTimeLogger::TTraceStats>& out_stats)
+	const
+{
+	m_stage_timelogger.getTraceStats(out_stats);
+}
+
 /*---------------------------------------------------------------
 						registerLoopClosureDetector
   ---------------------------------------------------------------*/
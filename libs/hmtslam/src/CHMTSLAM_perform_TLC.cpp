@@ -40,6 +40,7 @@ void CHMTSLAM::perform_TLC(
 	MRPT_START
 	ASSERT_(Ai != Ae);
 
+	mrpt::system::CTimeLoggerEntry tle(m_stage_timelogger, m_sec_TLC);
 	std::lock_guard<std::mutex> locker(LMH.m_robotPosesGraph.lock);
 
 	logFmt(
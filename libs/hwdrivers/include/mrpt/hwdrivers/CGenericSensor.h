@@ -11,6 +11,7 @@
 
 #include <mrpt/config/CConfigFileBase.h>
 #include <mrpt/obs/CObservation.h>
+#include <mrpt/obs/CObservationPool.h>
 #include <map>
 #include <mutex>
 
@@ -51,6 +52,10 @@ struct TSensorClassId
  *			- "grab_decimation": (Optional) Grab only 1 out of N observations
  *captured
  *by the sensor (default is 1, i.e. do not decimate).
+ *			- "recycle_observations": (Optional) Sensors producing large
+ *observations at high rates reuse the objects (and their buffers) freed by the
+ *consumers, instead of allocating new ones (default is true). See
+ *CGenericSensor::newObservation
  *		- CGenericSensor::initialize
  *		- CGenericSensor::doProcess
  *		- CGenericSensor::getObservations
@@ -137,6 +142,8 @@ class CGenericSensor
 	size_t m_grab_decimation{0};
 	/** See CGenericSensor */
 	std::string m_sensorLabel;
+	/** See CGenericSensor and newObservation() */
+	bool m_recycle_observations{true};
 
 	/** @} */
 
@@ -174,6 +181,20 @@ class CGenericSensor
 	void appendObservations(
 		const std::vector<mrpt::serialization::CSerializable::Ptr>& obj);
 
+	/** Returns an observation object to be filled and passed to
+	 * appendObservation(), recycled from those already released by the
+	 * consumers if "recycle_observations" is enabled, or a new one otherwise.
+	 * Recycled objects keep their previous contents, so the caller must set
+	 * all the fields it uses. \sa mrpt::obs::CObservationPool */
+	template <class OBS>
+	typename OBS::Ptr newObservation()
+	{
+		if (m_recycle_observations)
+			return mrpt::obs::CObservationPool<OBS>::get(this);
+		else
+			return mrpt::make_aligned_shared<OBS>();
+	}
+
 	//! Like appendObservations() but for just one observation.
 	void appendObservation(const mrpt::serialization::CSerializable::Ptr& obj)
 	{
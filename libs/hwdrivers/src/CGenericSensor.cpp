@@ -137,6 +137,8 @@ void CGenericSensor::loadConfig(
 		cfg.read_int(sect, "grab_decimation", int(m_grab_decimation)));
 
 	m_sensorLabel = cfg.read_string(sect, "sensorLabel", m_sensorLabel);
+	m_recycle_observations = cfg.read_bool(
+		sect, "recycle_observations", m_recycle_observations);
 
 	m_grab_decimation_counter = 0;
 
@@ -155,7 +155,7 @@ void COpenNI2Sensor::doProcess()
 	bool thereIs, hwError;
 
 	CObservation3DRangeScan::Ptr newObs =
-		mrpt::make_aligned_shared<CObservation3DRangeScan>();
+		newObservation<CObservation3DRangeScan>();
 
 	assert(getNumDevices() > 0);
 	getNextObservation(*newObs, thereIs, hwError);
@@ -300,11 +300,8 @@ void COpenNI2Sensor::getNextObservation(
 	{
 		out_obs.project3DPointsFromDepthImage();
 
-		if (!m_grab_depth)
-		{
-			out_obs.hasRangeImage = false;
-			out_obs.rangeImage.resize(0, 0);
-		}
+		// Keep the range image memory, for pooled observations to reuse it:
+		if (!m_grab_depth) out_obs.hasRangeImage = false;
 	}
 
 	// preview in real-time?
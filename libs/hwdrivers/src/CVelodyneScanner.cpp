@@ -280,8 +280,11 @@ bool CVelodyneScanner::getNextObservation(
 			// Create smart ptr to new in-progress observation:
 			if (!m_rx_scan)
 			{
-				m_rx_scan = mrpt::make_aligned_shared<
-					mrpt::obs::CObservationVelodyneScan>();
+				m_rx_scan =
+					newObservation<mrpt::obs::CObservationVelodyneScan>();
+				// Recycled objects keep old data (and capacity):
+				m_rx_scan->scan_packets.clear();
+				m_rx_scan->point_cloud.clear();
 				m_rx_scan->sensorLabel =
 					this->m_sensorLabel + std::string("_SCAN");
 				m_rx_scan->sensorPose = m_sensorPose;
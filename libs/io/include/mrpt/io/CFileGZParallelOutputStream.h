@@ -0,0 +1,122 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/io/CStream.h>
+#include <memory>
+
+namespace mrpt::io
+{
+/** Saves data to a gzip-compressed file using several threads.
+ *
+ * Written data is split into blocks of a fixed (uncompressed) size, and each
+ * block is compressed independently as a full gzip member by a pool of
+ * worker threads. Compressed blocks are written to disk in their original
+ * order, so the output file is a sequence of concatenated gzip members, which
+ * is a valid gzip stream readable by CFileGZInputStream or any standard gzip
+ * tool.
+ *
+ * The number of blocks in flight (being filled, compressed or waiting to be
+ * written) is bounded: if the disk or the compressors cannot keep up, Write()
+ * blocks the caller until there is room again. Such stalls are reported in
+ * getStats() as back-pressure statistics.
+ *
+ * \sa CFileGZOutputStream, CFileGZInputStream
+ * \ingroup mrpt_io_grp
+ */
+class CFileGZParallelOutputStream : public CStream
+{
+   public:
+	/** Parameters used when opening a file. */
+	struct TOptions
+	{
+		/** 0:no compression, 1:fastest, 9:best */
+		int compress_level{1};
+		/** Number of compression threads (0: as many as hardware threads) */
+		unsigned int num_threads{0};
+		/** Uncompressed size of each independently compressed block */
+		size_t block_size{1024 * 1024};
+		/** Maximum number of blocks in flight before Write() blocks (0:
+		 * twice the number of threads) */
+		size_t max_pending_blocks{0};
+	};
+
+	/** Throughput and back-pressure statistics. \sa getStats() */
+	struct TStats
+	{
+		/** Uncompressed bytes accepted by Write() */
+		uint64_t bytes_in{0};
+		/** Compressed bytes actually written to disk */
+		uint64_t bytes_out{0};
+		/** Number of compressed blocks written to disk */
+		uint64_t blocks_written{0};
+		/** Blocks currently being compressed or waiting to be written */
+		size_t blocks_in_flight{0};
+		/** Largest value of `blocks_in_flight` seen so far */
+		size_t max_blocks_in_flight{0};
+		/** Number of times Write() had to wait for a free block slot */
+		uint64_t stall_count{0};
+		/** Accumulated time (seconds) spent waiting in those stalls */
+		double stall_time{0};
+	};
+
+	/** Constructor, without opening the file. \sa open */
+	CFileGZParallelOutputStream();
+	/** Constructor: opens an output file with the given options.
+	 * \exception std::exception On error opening the file.
+	 */
+	CFileGZParallelOutputStream(
+		const std::string& fileName, const TOptions& opts);
+
+	CFileGZParallelOutputStream(const CFileGZParallelOutputStream&) = delete;
+	CFileGZParallelOutputStream& operator=(
+		const CFileGZParallelOutputStream&) = delete;
+
+	/** Destructor: flushes all pending data and closes the file. Errors are
+	 * ignored: call close() first to handle them. */
+	~CFileGZParallelOutputStream() override;
+
+	/** Opens a file for write and launches the compression threads.
+	 * \return true on success, false on any error.
+	 */
+	bool open(const std::string& fileName, const TOptions& opts);
+	/** \overload Uses default options */
+	bool open(const std::string& fileName) { return open(fileName, TOptions()); }
+	/** Compresses and writes all pending data, stops the worker threads and
+	 * closes the file.
+	 * \exception std::exception If compressing any block failed. Write()
+	 * also rethrows such errors as soon as they are detected. */
+	void close();
+	/** Returns true if the file was open without errors. */
+	bool fileOpenCorrectly() const;
+	/** Returns true if the file was open without errors. */
+	bool is_open() { return fileOpenCorrectly(); }
+
+	/** Returns a snapshot of the current statistics (thread-safe). */
+	TStats getStats() const;
+
+	/** Returns the number of uncompressed bytes written so far. */
+	uint64_t getPosition() const override;
+	/** This method is not implemented in this class */
+	uint64_t Seek(int64_t, CStream::TSeekOrigin = sFromBeginning) override;
+	/** This method is not implemented in this class */
+	uint64_t getTotalBytesCount() const override;
+	size_t Read(void* Buffer, size_t Count) override;
+	size_t Write(const void* Buffer, size_t Count) override;
+
+   private:
+	struct Impl;
+	/** Not a mrpt::pimpl<> since Impl holds threads and mutexes */
+	std::unique_ptr<Impl> m_impl;
+};
+static_assert(
+	!std::is_copy_constructible_v<CFileGZParallelOutputStream> &&
+		!std::is_copy_assignable_v<CFileGZParallelOutputStream>,
+	"Copy Check");
+}  // namespace mrpt::io
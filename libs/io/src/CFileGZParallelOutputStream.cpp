@@ -0,0 +1,333 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "io-precomp.h"  // Precompiled headers
+
+#include <mrpt/io/CFileGZParallelOutputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/core/exceptions.h>
+
+#include <zlib.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mrpt::io;
+using namespace std;
+
+namespace
+{
+/** Compresses a memory block as a complete, self-contained gzip member. */
+void compress_gz_member(
+	const std::vector<uint8_t>& in, std::vector<uint8_t>& out, int level)
+{
+	z_stream strm;
+	std::memset(&strm, 0, sizeof(strm));
+	// windowBits=15+16: write a gzip header and trailer instead of zlib's.
+	if (deflateInit2(
+			&strm, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		THROW_EXCEPTION("deflateInit2() failed");
+
+	out.resize(deflateBound(&strm, in.size()) + 32);
+	strm.next_in = const_cast<Bytef*>(in.data());
+	strm.avail_in = static_cast<uInt>(in.size());
+	strm.next_out = out.data();
+	strm.avail_out = static_cast<uInt>(out.size());
+
+	const int ret = deflate(&strm, Z_FINISH);
+	const size_t outLen = strm.total_out;
+	deflateEnd(&strm);
+	if (ret != Z_STREAM_END) THROW_EXCEPTION("deflate() failed");
+	out.resize(outLen);
+}
+}  // namespace
+
+struct CFileGZParallelOutputStream::Impl
+{
+	CFileOutputStream f;
+	TOptions opts;
+
+	/** The block currently being filled by Write() */
+	std::vector<uint8_t> cur_block;
+
+	mutable std::mutex mtx;
+	/** Signals new jobs for the compressors, or `quit` */
+	std::condition_variable cv_jobs;
+	/** Signals new compressed blocks for the writer, or `quit` */
+	std::condition_variable cv_done;
+	/** Signals that a block has been written to disk */
+	std::condition_variable cv_space;
+
+	/** Blocks pending compression, with their sequence number */
+	std::deque<std::pair<uint64_t, std::vector<uint8_t>>> jobs;
+	/** Compressed blocks waiting for their turn to be written */
+	std::map<uint64_t, std::vector<uint8_t>> done;
+	uint64_t next_seq_submit{0}, next_seq_write{0};
+	bool quit{false};
+	bool write_error{false};
+	/** The first exception thrown by a compressor thread, if any */
+	std::exception_ptr compress_error;
+
+	TStats stats;
+
+	std::vector<std::thread> compressors;
+	std::thread writer;
+
+	void thread_compressor()
+	{
+		std::vector<uint8_t> out;
+		for (;;)
+		{
+			std::pair<uint64_t, std::vector<uint8_t>> job;
+			{
+				std::unique_lock<std::mutex> lck(mtx);
+				cv_jobs.wait(lck, [this]() { return quit || !jobs.empty(); });
+				if (jobs.empty()) return;  // quit
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+			std::exception_ptr err;
+			try
+			{
+				compress_gz_member(job.second, out, opts.compress_level);
+			}
+			catch (...)
+			{
+				// Reported to the user thread from Write() or close(). An
+				// empty block is still handed to the writer, so it does not
+				// wait forever for this sequence number.
+				err = std::current_exception();
+				out.clear();
+			}
+			{
+				std::lock_guard<std::mutex> lck(mtx);
+				if (err && !compress_error) compress_error = err;
+				done[job.first] = std::move(out);
+			}
+			cv_done.notify_one();
+			out = std::move(job.second);  // Reuse the allocated capacity
+		}
+	}
+
+	void thread_writer()
+	{
+		for (;;)
+		{
+			std::vector<uint8_t> blk;
+			{
+				std::unique_lock<std::mutex> lck(mtx);
+				cv_done.wait(lck, [this]() {
+					return done.count(next_seq_write) != 0 ||
+						   (quit && next_seq_write == next_seq_submit);
+				});
+				auto it = done.find(next_seq_write);
+				if (it == done.end()) return;  // quit, all written.
+				blk = std::move(it->second);
+				done.erase(it);
+			}
+			const size_t nWr = f.Write(blk.data(), blk.size());
+			{
+				std::lock_guard<std::mutex> lck(mtx);
+				if (nWr != blk.size()) write_error = true;
+				next_seq_write++;
+				stats.bytes_out += nWr;
+				stats.blocks_written++;
+				stats.blocks_in_flight = next_seq_submit - next_seq_write;
+			}
+			cv_space.notify_all();
+		}
+	}
+
+	/** Hands `cur_block` to the compressors, waiting if too many blocks are
+	 * in flight. */
+	void submit_current_block()
+	{
+		if (cur_block.empty()) return;
+		std::unique_lock<std::mutex> lck(mtx);
+		const auto in_flight = [this]() {
+			return next_seq_submit - next_seq_write;
+		};
+		if (in_flight() >= opts.max_pending_blocks)
+		{
+			const auto t0 = std::chrono::steady_clock::now();
+			cv_space.wait(lck, [&]() {
+				return in_flight() < opts.max_pending_blocks;
+			});
+			stats.stall_count++;
+			stats.stall_time += std::chrono::duration<double>(
+									std::chrono::steady_clock::now() - t0)
+									.count();
+		}
+		jobs.emplace_back(next_seq_submit++, std::move(cur_block));
+		stats.blocks_in_flight = in_flight();
+		stats.max_blocks_in_flight =
+			std::max(stats.max_blocks_in_flight, stats.blocks_in_flight);
+		lck.unlock();
+		cv_jobs.notify_one();
+
+		cur_block = std::vector<uint8_t>();
+		cur_block.reserve(opts.block_size);
+	}
+
+	void stop_threads()
+	{
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			quit = true;
+		}
+		cv_jobs.notify_all();
+		cv_done.notify_all();
+		for (auto& t : compressors)
+			if (t.joinable()) t.join();
+		compressors.clear();
+		if (writer.joinable()) writer.join();
+	}
+};
+
+CFileGZParallelOutputStream::CFileGZParallelOutputStream()
+	: m_impl(std::make_unique<Impl>())
+{
+}
+
+CFileGZParallelOutputStream::CFileGZParallelOutputStream(
+	const string& fileName, const TOptions& opts)
+	: CFileGZParallelOutputStream()
+{
+	MRPT_START
+	if (!open(fileName, opts))
+		THROW_EXCEPTION_FMT(
+			"Error trying to open file: '%s'", fileName.c_str());
+	MRPT_END
+}
+
+CFileGZParallelOutputStream::~CFileGZParallelOutputStream()
+{
+	try
+	{
+		close();
+	}
+	catch (const std::exception&)
+	{
+	}
+}
+
+bool CFileGZParallelOutputStream::open(
+	const string& fileName, const TOptions& opts)
+{
+	MRPT_START
+
+	close();
+
+	ASSERT_ABOVE_(opts.block_size, 0U);
+	ASSERT_(opts.compress_level >= 0 && opts.compress_level <= 9);
+
+	auto& d = *m_impl;
+	if (!d.f.open(fileName)) return false;
+
+	d.opts = opts;
+	if (d.opts.num_threads == 0)
+		d.opts.num_threads = std::max(1U, std::thread::hardware_concurrency());
+	if (d.opts.max_pending_blocks == 0)
+		d.opts.max_pending_blocks = 2 * d.opts.num_threads;
+
+	d.quit = false;
+	d.write_error = false;
+	d.compress_error = nullptr;
+	d.next_seq_submit = d.next_seq_write = 0;
+	d.stats = TStats();
+	d.cur_block.clear();
+	d.cur_block.reserve(d.opts.block_size);
+
+	for (unsigned int i = 0; i < d.opts.num_threads; i++)
+		d.compressors.emplace_back(&Impl::thread_compressor, &d);
+	d.writer = std::thread(&Impl::thread_writer, &d);
+
+	return true;
+	MRPT_END
+}
+
+void CFileGZParallelOutputStream::close()
+{
+	auto& d = *m_impl;
+	if (!d.f.fileOpenCorrectly()) return;
+
+	d.submit_current_block();
+	d.stop_threads();
+	d.f.close();
+
+	std::exception_ptr err;
+	std::swap(err, d.compress_error);
+	if (err) std::rethrow_exception(err);
+}
+
+bool CFileGZParallelOutputStream::fileOpenCorrectly() const
+{
+	return m_impl->f.fileOpenCorrectly();
+}
+
+CFileGZParallelOutputStream::TStats CFileGZParallelOutputStream::getStats()
+	const
+{
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->stats;
+}
+
+size_t CFileGZParallelOutputStream::Read(void*, size_t)
+{
+	THROW_EXCEPTION("Trying to read from an output file stream.");
+}
+
+size_t CFileGZParallelOutputStream::Write(const void* Buffer, size_t Count)
+{
+	auto& d = *m_impl;
+	if (!d.f.fileOpenCorrectly()) THROW_EXCEPTION("File is not open.");
+	{
+		std::lock_guard<std::mutex> lck(d.mtx);
+		if (d.compress_error) std::rethrow_exception(d.compress_error);
+		if (d.write_error) THROW_EXCEPTION("Error writing to output file.");
+		d.stats.bytes_in += Count;
+	}
+
+	auto ptr = reinterpret_cast<const uint8_t*>(Buffer);
+	size_t remain = Count;
+	while (remain)
+	{
+		const size_t n =
+			std::min(remain, d.opts.block_size - d.cur_block.size());
+		d.cur_block.insert(d.cur_block.end(), ptr, ptr + n);
+		ptr += n;
+		remain -= n;
+		if (d.cur_block.size() >= d.opts.block_size) d.submit_current_block();
+	}
+	return Count;
+}
+
+uint64_t CFileGZParallelOutputStream::getPosition() const
+{
+	if (!m_impl->f.fileOpenCorrectly()) THROW_EXCEPTION("File is not open.");
+	std::lock_guard<std::mutex> lck(m_impl->mtx);
+	return m_impl->stats.bytes_in;
+}
+
+uint64_t CFileGZParallelOutputStream::Seek(int64_t, CStream::TSeekOrigin)
+{
+	THROW_EXCEPTION("Method not available in this class.");
+}
+
+uint64_t CFileGZParallelOutputStream::getTotalBytesCount() const
+{
+	THROW_EXCEPTION("Method not available in this class.");
+}
@@ -9,6 +9,7 @@
 
 #include <mrpt/io/CFileGZOutputStream.h>
 #include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/io/CFileGZParallelOutputStream.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/core/format.h>
 #include <gtest/gtest.h>
@@ -102,3 +103,56 @@ TEST(CFileGZStreams, compareWithTestGZFiles)
 			<< " compress_level:" << compress_level;
 	}
 }
+
+TEST(CFileGZStreams, readwriteTmpFileParallelBlocks)
+{
+	std::vector<uint8_t> tst_data;
+	generate_test_data(tst_data);
+
+	const std::string fil =
+		mrpt::system::getTempFileName() + std::string("_par");
+	const size_t nRepeats = 50;
+
+	// Write with tiny blocks, so the file has many gzip members:
+	{
+		mrpt::io::CFileGZParallelOutputStream::TOptions opts;
+		opts.num_threads = 3;
+		opts.block_size = 333;
+		opts.max_pending_blocks = 2;
+
+		mrpt::io::CFileGZParallelOutputStream fil_out;
+		const bool open_ok = fil_out.open(fil, opts);
+		EXPECT_TRUE(open_ok);
+
+		for (size_t i = 0; i < nRepeats; i++)
+		{
+			const size_t wr_count = fil_out.Write(&tst_data[0], tst_data_len);
+			EXPECT_EQ(wr_count, tst_data_len);
+		}
+		fil_out.close();
+
+		const auto stats = fil_out.getStats();
+		EXPECT_EQ(stats.bytes_in, nRepeats * tst_data_len);
+		EXPECT_EQ(
+			stats.blocks_written, (nRepeats * tst_data_len + 332) / 333);
+		EXPECT_EQ(stats.blocks_in_flight, 0U);
+		EXPECT_LE(stats.max_blocks_in_flight, 2U);
+	}
+	// Read back as a regular gz file:
+	{
+		mrpt::io::CFileGZInputStream fil_in;
+		const bool open_ok = fil_in.open(fil);
+		EXPECT_TRUE(open_ok);
+
+		for (size_t i = 0; i < nRepeats; i++)
+		{
+			uint8_t rd_buf[tst_data_len + 5];
+			const size_t rd_count = fil_in.Read(rd_buf, tst_data_len);
+			EXPECT_EQ(rd_count, tst_data_len);
+			EXPECT_TRUE(std::equal(
+				std::begin(tst_data), std::end(tst_data), std::begin(rd_buf)));
+		}
+		uint8_t dummy;
+		EXPECT_EQ(fil_in.Read(&dummy, 1), 0U);
+	}
+}
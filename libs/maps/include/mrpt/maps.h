@@ -27,11 +27,14 @@ MRPT_WARNING(
 #include <mrpt/maps/CHeightGridMap2D_MRF.h>
 #include <mrpt/maps/CReflectivityGridMap2D.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/maps/CCircularOccupancyGridMap2D.h>
 #include <mrpt/maps/CPointsMap.h>
+#include <mrpt/maps/CPointCloudStreamIO.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/maps/CWeightedPointsMap.h>
 #include <mrpt/maps/COctoMap.h>
 #include <mrpt/maps/CColouredOctoMap.h>
+#include <mrpt/maps/CVoxelMap.h>
 
 //#include <mrpt/maps/PCL_adapters.h>  // NOTE: This file must be included from
 // the user
@@ -0,0 +1,160 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/maps/CMetricMap.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/containers/CDynamicGridCircular.h>
+#include <mrpt/config/CLoadableOptions.h>
+#include <mrpt/obs/obs_frwds.h>
+
+namespace mrpt::maps
+{
+/** A fixed-size 2D occupancy grid, typically kept centered at the robot, for
+ * local navigation and obstacle tracking.
+ *
+ * Cells hold log-odds occupancy values with the same encoding than
+ * COccupancyGridMap2D (see COccupancyGridMap2D::cellType), but they are
+ * stored in a mrpt::containers::CDynamicGridCircular, so the map can be
+ * scrolled with recenter() at a cost proportional to the number of cells
+ * which enter the map area, instead of being rebuilt or resized. Cells
+ * entering the map are set to "unknown" (p=0.5).
+ *
+ * This class implements mrpt::maps::CMetricMap::insertObservation() for
+ * these kinds of observations:
+ *   - mrpt::obs::CObservation2DRangeScan: 2D range scans, inserted as free
+ * rays ending at an occupied cell.
+ *
+ * Use getAsOccupancyGridMap2D() to obtain a regular COccupancyGridMap2D with
+ * the current contents (e.g. for planners expecting that class).
+ *
+ * \sa COccupancyGridMap2D, mrpt::containers::CDynamicGridCircular
+ * \ingroup mrpt_maps_grp
+ */
+class CCircularOccupancyGridMap2D
+	: public mrpt::maps::CMetricMap,
+	  public mrpt::containers::CDynamicGridCircular<
+		  COccupancyGridMap2D::cellType>
+{
+	DEFINE_SERIALIZABLE(CCircularOccupancyGridMap2D)
+   public:
+	using cellType = COccupancyGridMap2D::cellType;
+	using grid_t = mrpt::containers::CDynamicGridCircular<cellType>;
+
+	/** Constructor */
+	CCircularOccupancyGridMap2D(
+		double x_min = -5., double x_max = 5., double y_min = -5.,
+		double y_max = 5., double resolution = 0.05);
+
+	/** Calls the base CMetricMap::clear
+	 * Declared here to avoid ambiguity between the two clear() in both base
+	 * classes.
+	 */
+	inline void clear() { CMetricMap::clear(); }
+
+	/** Moves the map area such as its center is as close as possible to
+	 * (x,y), keeping the contents of the overlapping area. New cells are
+	 * marked as unknown. */
+	inline void recenter(double x, double y)
+	{
+		grid_t::recenter(x, y, COccupancyGridMap2D::p2l(0.5f));
+	}
+
+	/** Read the free-space probability of a cell given its indices, or 0.5
+	 * if out of the map. */
+	inline float getCell(int cx, int cy) const
+	{
+		const cellType* c = cellByIndex(cx, cy);
+		return c ? COccupancyGridMap2D::l2p(*c) : 0.5f;
+	}
+	/** Read the free-space probability of the cell at some coordinates, or
+	 * 0.5 if out of the map. */
+	inline float getPos(double x, double y) const
+	{
+		const cellType* c = cellByPos(x, y);
+		return c ? COccupancyGridMap2D::l2p(*c) : 0.5f;
+	}
+	/** Change the free-space probability of a cell given its indices
+	 * (ignored if out of the map) */
+	inline void setCell(int cx, int cy, float value)
+	{
+		cellType* c = cellByIndex(cx, cy);
+		if (c) *c = COccupancyGridMap2D::p2l(value);
+	}
+	/** Change the free-space probability of the cell at some coordinates
+	 * (ignored if out of the map) */
+	inline void setPos(double x, double y, float value)
+	{
+		cellType* c = cellByPos(x, y);
+		if (c) *c = COccupancyGridMap2D::p2l(value);
+	}
+
+	/** Returns a COccupancyGridMap2D with the same area, resolution and
+	 * contents than this map. */
+	void getAsOccupancyGridMap2D(COccupancyGridMap2D& out) const;
+
+	/** Returns true if no observation has been inserted since the last
+	 * clear() */
+	bool isEmpty() const override;
+
+	/** Parameters related with inserting observations into the map */
+	struct TInsertionOptions : public mrpt::config::CLoadableOptions
+	{
+		void loadFromConfigFile(
+			const mrpt::config::CConfigFileBase& source,
+			const std::string& section) override;  // See base docs
+		void dumpToTextStream(
+			std::ostream& out) const override;  // See base docs
+
+		/** Largest distance at which range measurements are inserted (m) */
+		float maxDistanceInsertion{15.0f};
+		/** Certainty of each "occupied" update, in the range (0.5,1) */
+		float maxOccupancyUpdateCertainty{0.65f};
+		/** Certainty of each "free" update, in the range (0.5,1) */
+		float maxFreenessUpdateCertainty{0.55f};
+		/** Only one out of `decimation` ranges is inserted */
+		uint16_t decimation{1};
+	} insertionOptions;
+
+	/** See docs in base class: in this class it always returns 0 */
+	float compute3DMatchingRatio(
+		const mrpt::maps::CMetricMap* otherMap,
+		const mrpt::poses::CPose3D& otherMapPose,
+		const TMatchingRatioParams& params) const override;
+
+	/** Saves the map as a grayscale image, via getAsOccupancyGridMap2D() */
+	void saveMetricMapRepresentationToFile(
+		const std::string& filNamePrefix) const override;
+
+	/** Returns a 3D object representing the map, as
+	 * COccupancyGridMap2D::getAs3DObject() */
+	void getAs3DObject(mrpt::opengl::CSetOfObjects::Ptr& outObj) const override;
+
+   protected:
+	/** Whether any observation has been inserted */
+	bool m_is_empty{true};
+
+	void internal_clear() override;
+	bool internal_insertObservation(
+		const mrpt::obs::CObservation* obs,
+		const mrpt::poses::CPose3D* robotPose = nullptr) override;
+	double internal_computeObservationLikelihood(
+		const mrpt::obs::CObservation* obs,
+		const mrpt::poses::CPose3D& takenFrom) override;
+	bool internal_canComputeObservationLikelihood(
+		const mrpt::obs::CObservation* obs) const override;
+
+	MAP_DEFINITION_START(CCircularOccupancyGridMap2D)
+	/** See CCircularOccupancyGridMap2D::CCircularOccupancyGridMap2D */
+	double min_x{-5.0}, max_x{5.0}, min_y{-5.0}, max_y{5.0}, resolution{0.05};
+	mrpt::maps::CCircularOccupancyGridMap2D::TInsertionOptions insertionOpts;
+	MAP_DEFINITION_END(CCircularOccupancyGridMap2D)
+};
+
+}  // namespace mrpt::maps
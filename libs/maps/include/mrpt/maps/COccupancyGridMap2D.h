@@ -92,6 +92,7 @@ class COccupancyGridMap2D : public CMetricMap,
    protected:
 	friend class CMultiMetricMap;
 	friend class CMultiMetricMapPDF;
+	friend class CMetricMapSnapshot;
 
 	/** Frees the dynamic memory buffers of map. */
 	void freeMap();
@@ -211,7 +212,59 @@ class COccupancyGridMap2D : public CMetricMap,
 		const mrpt::obs::CObservation* obs,
 		const mrpt::poses::CPose3D* robotPose = nullptr) override;
 
+	/** End point of one ray of a scan, in map coordinates */
+	struct TRayEnd
+	{
+		float x, y;
+		/** False for invalid ranges (no echo) */
+		bool valid;
+		/** Whether the end cell must be updated as occupied */
+		bool occupied;
+	};
+	/** The rays of a scan, from the sensor at (x0,y0) */
+	struct TScanRays
+	{
+		float x0, y0;
+		std::vector<TRayEnd> rays;
+	};
+
+	/** Returns false if the scan must not be inserted (not horizontal, or
+	 * out of mapAltitude), and the sensor 2D pose otherwise. */
+	bool getScanInsertionPose(
+		const mrpt::obs::CObservation2DRangeScan& o,
+		const mrpt::poses::CPose3D& robotPose,
+		mrpt::poses::CPose2D& laserPose, bool& sensorIsBottomwards) const;
+	/** Computes the rays of a scan for the simple rays insertion method,
+	 * enlarging the bounding box `bbox` (xmin,xmax,ymin,ymax) to contain
+	 * them. */
+	void getScanRays(
+		const mrpt::obs::CObservation2DRangeScan& o,
+		const mrpt::poses::CPose2D& laserPose, bool sensorIsBottomwards,
+		TScanRays& out, float bbox[4]) const;
+	/** Enlarges the grid, if needed, to contain the bounding box (xmin,xmax,
+	 * ymin,ymax), plus a margin */
+	void resizeGridToContain(const float bbox[4]);
+	/** Traces the rays of the scans, in order, which must be within the grid.
+	 * With several threads (TInsertionOptions::num_threads), each one traces
+	 * a part of the rays, and then the cell updates are applied by bands of
+	 * rows, keeping for each cell the order of a sequential insertion. */
+	void insertScanRays(const std::vector<TScanRays>& scans);
+
    public:
+	/** Inserts many 2D range scans at once, each one observed from the
+	 * corresponding robot pose. This is faster than calling
+	 * insertObservation() for each scan, since the grid is resized only once
+	 * and all the rays are traced in parallel (see
+	 * TInsertionOptions::num_threads), with the same cell contents than
+	 * inserting them one by one. Scans are skipped under the same conditions
+	 * than in insertObservation(). If
+	 * TInsertionOptions::wideningBeamsWithDistance is set, scans are inserted
+	 * one by one.
+	 * \return The number of inserted scans */
+	size_t insertScans(
+		const std::vector<const mrpt::obs::CObservation2DRangeScan*>& scans,
+		const std::vector<mrpt::poses::CPose3D>& robotPoses);
+
 	/** Read-only access to the raw cell contents (cells are in log-odd units)
 	 */
 	const std::vector<cellType>& getRawMap() const { return this->map; }
@@ -544,6 +597,10 @@ class COccupancyGridMap2D : public CMetricMap,
 		/** Enabled: Rays widen with distance to approximate the real behavior
 		 * of lasers, disabled: insert rays as simple lines (Default=false) */
 		bool wideningBeamsWithDistance{false};
+		/** Number of threads tracing the rays of each scan, with the simple
+		 * rays method (0: as many as cores). Results do not depend on it. Not
+		 * serialized. (Default=1) \sa insertScans */
+		unsigned int num_threads{1};
 	};
 
 	/** With this struct options are provided to the observation insertion
@@ -0,0 +1,172 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mrpt::maps
+{
+class CPointsMap;
+
+/** Streaming readers and writers of point cloud files, which process the
+ * points in blocks, so the files never need to fit in memory at once.
+ *
+ * Readers feed each block of points to a user callback, with the (x,y,z)
+ * coordinates as three separate arrays. Use appendTo() to obtain a callback
+ * which appends the points into a CPointsMap.
+ *
+ * Supported formats:
+ * - PCD (Point Cloud Library): `ascii` and `binary` data (not
+ *   `binary_compressed`). Only the `x`, `y`, `z` fields are read; the rest
+ *   are skipped.
+ * - PLY: `ascii` and `binary_little_endian`. Only the `x`, `y`, `z`
+ *   properties of the `vertex` element are read.
+ * - Plain text files, with "X Y [Z]" per line (see readTextXYZ()).
+ *
+ * Numbers in text formats are parsed with a locale-independent parser, in
+ * parallel over chunks of the file.
+ *
+ * Example:
+ * \code
+ * CSimplePointsMap pts;
+ * CPointCloudStreamIO::readPCD(
+ *   "survey.pcd", CPointCloudStreamIO::appendTo(pts));
+ *
+ * // or, to process a huge file without keeping it in memory:
+ * CPointCloudStreamWriter out(
+ *   "decimated.ply", CPointCloudStreamWriter::PLY_BINARY);
+ * CPointCloudStreamIO::readPCD(
+ *   "survey.pcd",
+ *   [&](const float* xs, const float* ys, const float* zs, size_t n) {
+ *     for (size_t i = 0; i < n; i += 10)
+ *       out.write(xs + i, ys + i, zs + i, 1);
+ *   });
+ * \endcode
+ *
+ * \sa CPointsMap::loadPCDFile(), CPointsMap::load2Dor3D_from_text_file(),
+ *  CPointCloudStreamWriter
+ * \ingroup mrpt_maps_grp
+ */
+class CPointCloudStreamIO
+{
+   public:
+	/** Receives a block of `n` points, as arrays of their coordinates */
+	using block_callback_t = std::function<void(
+		const float* xs, const float* ys, const float* zs, size_t n)>;
+
+	/** Default number of points per block passed to callbacks */
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 16;
+
+	/** Returns a callback which appends each block to the end of `m`, with
+	 * CPointsMap::insertPoints() */
+	static block_callback_t appendTo(CPointsMap& m);
+
+	/** Reads a PCD file, block by block.
+	 * \param[in] num_threads Number of threads parsing `ascii` data (0: as
+	 * many as cores).
+	 * \return The number of points read.
+	 * \exception std::exception On any I/O or format error. */
+	static uint64_t readPCD(
+		const std::string& fileName, const block_callback_t& callback,
+		size_t blockSize = DEFAULT_BLOCK_SIZE, unsigned int num_threads = 0);
+
+	/** Reads the vertices of a PLY file, block by block.
+	 * \param[in] num_threads Number of threads parsing `ascii` data (0: as
+	 * many as cores).
+	 * \return The number of points read.
+	 * \exception std::exception On any I/O or format error. */
+	static uint64_t readPLY(
+		const std::string& fileName, const block_callback_t& callback,
+		size_t blockSize = DEFAULT_BLOCK_SIZE, unsigned int num_threads = 0);
+
+	/** Reads a text file with one point per line, with its coordinates
+	 * ("X Y" if `is_3D` is false, "X Y Z" otherwise) as the first numbers in
+	 * the line, separated by whitespaces or commas. Lines not starting with
+	 * those numbers are ignored, as well as any number after them.
+	 * \param[in] num_threads Number of threads parsing the text (0: as many
+	 * as cores).
+	 * \return The number of points read.
+	 * \exception std::exception If the file cannot be read. */
+	static uint64_t readTextXYZ(
+		const std::string& fileName, const block_callback_t& callback,
+		bool is_3D = true, size_t blockSize = DEFAULT_BLOCK_SIZE,
+		unsigned int num_threads = 0);
+
+	/** Parses the numbers of a text buffer, one row per line, keeping only
+	 * the rows whose first `nCols` fields are valid numbers, and appending
+	 * those fields to `out` (one vector per column). Fields are separated by
+	 * whitespaces or commas. This is the locale-independent, parallel parser
+	 * used by the text readers.
+	 * \param[in] num_threads Number of threads (0: as many as cores).
+	 * \return The number of rows appended. */
+	static size_t parseTextColumns(
+		const char* text, size_t len, size_t nCols,
+		std::vector<std::vector<float>>& out, unsigned int num_threads = 0);
+};
+
+/** Writes point cloud files in a streaming fashion: points are written as
+ * they are passed to write(), and the header (which includes the number of
+ * points) is completed upon close().
+ *
+ * \sa CPointCloudStreamIO
+ * \ingroup mrpt_maps_grp
+ */
+class CPointCloudStreamWriter
+{
+   public:
+	enum TFormat
+	{
+		PCD_ASCII = 0,
+		PCD_BINARY,
+		PLY_ASCII,
+		/** `binary_little_endian` PLY */
+		PLY_BINARY
+	};
+
+	CPointCloudStreamWriter() = default;
+	/** Constructor which calls open() */
+	CPointCloudStreamWriter(const std::string& fileName, TFormat format);
+	/** Calls close() */
+	~CPointCloudStreamWriter();
+	CPointCloudStreamWriter(const CPointCloudStreamWriter&) = delete;
+	CPointCloudStreamWriter& operator=(const CPointCloudStreamWriter&) =
+		delete;
+
+	/** Creates the file and writes a provisional header.
+	 * \exception std::exception If the file cannot be created. */
+	void open(const std::string& fileName, TFormat format);
+	/** Appends `n` points to the file.
+	 * \exception std::exception On any I/O error. */
+	void write(const float* xs, const float* ys, const float* zs, size_t n);
+	/** Writes all the points of a map */
+	void write(const CPointsMap& m);
+	/** Completes the header and closes the file. Called by the destructor if
+	 * the user did not call it.
+	 * \exception std::exception On any I/O error. */
+	void close();
+
+	bool isOpen() const { return m_file != nullptr; }
+	/** Number of points written so far */
+	uint64_t getPointCount() const { return m_count; }
+
+   private:
+	FILE* m_file{nullptr};
+	TFormat m_format{PCD_BINARY};
+	uint64_t m_count{0};
+	std::vector<char> m_buf;
+
+	/** Writes the header at the current position. \return false on error */
+	bool writeHeader();
+};
+
+}  // namespace mrpt::maps
@@ -367,7 +367,8 @@ class CPointsMap : public CMetricMap,
 	}
 
 	/** 2D or 3D generic implementation of \a load2D_from_text_file and
-	 * load3D_from_text_file */
+	 * load3D_from_text_file. The file is parsed in parallel, see
+	 * CPointCloudStreamIO::readTextXYZ() */
 	bool load2Dor3D_from_text_file(const std::string& file, const bool is_3D);
 
 	/**  Save to a text file. Each line will contain "X Y" point coordinates.
@@ -391,13 +392,14 @@ class CPointsMap : public CMetricMap,
 		save3D_to_text_file(fil);
 	}
 
-	/** Save the point cloud as a PCL PCD file, in either ASCII or binary format
-	 * (requires MRPT built against PCL) \return false on any error */
+	/** Save the point cloud as a PCL PCD file, in either ASCII or binary
+	 * format, with CPointCloudStreamWriter. \return false on any error */
 	virtual bool savePCDFile(
 		const std::string& filename, bool save_as_binary) const;
 
-	/** Load the point cloud from a PCL PCD file (requires MRPT built against
-	 * PCL) \return false on any error */
+	/** Load the point cloud from a PCL PCD file, with
+	 * CPointCloudStreamIO::readPCD(). `binary_compressed` files can be only
+	 * loaded if MRPT was built against PCL. \return false on any error */
 	virtual bool loadPCDFile(const std::string& filename);
 
 	/** @} */  // End of: File input/output methods
@@ -630,6 +632,13 @@ class CPointsMap : public CMetricMap,
 		insertPoint(x, y, z);
 	}
 
+	/** Appends `n` points at once, given as arrays of their coordinates. The
+	 * missing fields of child classes (color, weight, etc) are left to their
+	 * default values.
+	 * \sa insertPoint, CPointCloudStreamIO::appendTo */
+	void insertPoints(
+		const float* xs, const float* ys, const float* zs, size_t n);
+
 	/** Set all the points at once from vectors with X,Y and Z coordinates (if Z
 	 * is not provided, it will be set to all zeros).
 	 * \tparam VECTOR can be mrpt::math::CVectorFloat or std::vector<float> or
@@ -103,6 +103,7 @@ class CSimplePointsMap : public CPointsMap
 	friend struct detail::loadFromRangeImpl;
 	template <class Derived>
 	friend struct detail::pointmap_traits;
+	friend class CMetricMapSnapshot;
 
    public:
 	/** @} */
@@ -0,0 +1,360 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mrpt/maps/CMetricMap.h>
+#include <mrpt/config/CLoadableOptions.h>
+#include <mrpt/math/lightweight_geom_data.h>
+#include <mrpt/opengl/COctoMapVoxels.h>
+#include <mrpt/obs/obs_frwds.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mrpt::maps
+{
+/** A three-dimensional probabilistic occupancy grid, implemented natively as
+ * a sparse voxel grid: space is split into blocks of 8x8x8 voxels, which are
+ * only allocated once observed, and kept in hash tables.
+ *
+ * This map uses the same sensor model than mrpt::maps::COctoMap (log-odds
+ * updates with clamping, same default parameters) and offers a compatible
+ * API: getPointOccupancy(), castRay(), insertPointCloud(), insertRay(),
+ * updateVoxel(), getAsOctoMapVoxels(), etc. but does not depend on the
+ * external "octomap" library, and is much faster to update with dense point
+ * clouds (RGB-D cameras, Velodyne scanners):
+ *  - Voxels are accessed in constant time, without traversing a tree.
+ *  - All the rays of a point cloud are traced at once, optionally by several
+ *    threads (see TInsertionOptions::num_threads). As in octomap, each voxel
+ *    is updated once per point cloud: as occupied if any ray ends in it, or
+ *    as free otherwise. Hence, the result does not depend on the number of
+ *    threads, nor on the order of the points.
+ *
+ * On the other hand, the map has a fixed resolution: it is not pruned nor
+ * has multiple levels of detail. The log-odds of each voxel are stored as
+ * 16 bit fixed point numbers. The coordinates of voxels must be within
+ * \f$ \pm 2^{20} \f$ times the resolution from the origin.
+ *
+ * Observations which can be inserted: mrpt::obs::CObservation2DRangeScan,
+ * mrpt::obs::CObservation3DRangeScan, mrpt::obs::CObservationVelodyneScan.
+ *
+ * \sa CMetricMap, COctoMap
+ * \ingroup mrpt_maps_grp
+ */
+class CVoxelMap : public mrpt::maps::CMetricMap
+{
+	// This must be added to any CSerializable derived class:
+	DEFINE_SERIALIZABLE(CVoxelMap)
+
+   public:
+	/** Constructor, defines the resolution of the map (length of each voxel
+	 * side) */
+	CVoxelMap(const double resolution = 0.10);
+	~CVoxelMap() override;
+
+	/** Number of voxels along each side of a block */
+	static constexpr unsigned int BLOCK_SIDE = 8;
+	static constexpr unsigned int BLOCK_VOXELS =
+		BLOCK_SIDE * BLOCK_SIDE * BLOCK_SIDE;
+	/** The log-odds of each voxel, in units of 1/LOGODDS_SCALE, or
+	 * UNKNOWN_VOXEL for voxels never observed */
+	using voxel_t = int16_t;
+	static constexpr float LOGODDS_SCALE = 1000.0f;
+	static constexpr voxel_t UNKNOWN_VOXEL = -32768;
+
+	/** With this struct options are provided to the observation insertion
+	 * process.
+	 * \sa CObservation::insertObservationInto()
+	 */
+	struct TInsertionOptions : public mrpt::config::CLoadableOptions
+	{
+		void loadFromConfigFile(
+			const mrpt::config::CConfigFileBase& source,
+			const std::string& section) override;  // See base docs
+		void dumpToTextStream(
+			std::ostream& out) const override;  // See base docs
+
+		/** Binary dump to stream (all but num_threads) */
+		void writeToStream(mrpt::serialization::CArchive& out) const;
+		/** Binary dump to stream */
+		void readFromStream(mrpt::serialization::CArchive& in);
+
+		/** Maximum range for how long individual beams are inserted (default
+		 * -1: complete beam). Longer beams only mark free space up to this
+		 * distance. */
+		double maxrange{-1.};
+		/** Threshold for occupancy (sensor model) (Default=0.5) */
+		double occupancyThres{0.5};
+		/** Probablility for a "hit" (sensor model) (Default=0.7) */
+		double probHit{0.7};
+		/** Probablility for a "miss" (sensor model) (Default=0.4) */
+		double probMiss{0.4};
+		/** Minimum threshold for occupancy clamping (sensor model)
+		 * (Default=0.1192, -2 in log odds) */
+		double clampingThresMin{0.1192};
+		/** Maximum threshold for occupancy clamping (sensor model)
+		 * (Default=0.971, 3.5 in log odds) */
+		double clampingThresMax{0.971};
+		/** Number of threads tracing the rays of each point cloud (0: as many
+		 * as cores). Results do not depend on it. Not serialized.
+		 * (Default=1) */
+		unsigned int num_threads{1};
+	};
+
+	/** The options used when inserting observations in the map */
+	TInsertionOptions insertionOptions;
+
+	/** Options used when evaluating "computeObservationLikelihood"
+	 * \sa CObservation::computeObservationLikelihood
+	 */
+	struct TLikelihoodOptions : public mrpt::config::CLoadableOptions
+	{
+		void loadFromConfigFile(
+			const mrpt::config::CConfigFileBase& source,
+			const std::string& section) override;  // See base docs
+		void dumpToTextStream(
+			std::ostream& out) const override;  // See base docs
+
+		/** Binary dump to stream */
+		void writeToStream(mrpt::serialization::CArchive& out) const;
+		/** Binary dump to stream */
+		void readFromStream(mrpt::serialization::CArchive& in);
+
+		/** Speed up the likelihood computation by considering only one out
+		 * of N rays (default=1) */
+		uint32_t decimation{1};
+	};
+
+	TLikelihoodOptions likelihoodOptions;
+
+	/** Options for the conversion of a mrpt::maps::CVoxelMap into a
+	 * mrpt::opengl::COctoMapVoxels */
+	struct TRenderingOptions
+	{
+		/** Generate grid lines for all the allocated blocks, useful to draw
+		 * the "structure" of the map (Default: false) */
+		bool generateGridLines{false};
+		/** Generate voxels for the occupied volumes (Default=true) */
+		bool generateOccupiedVoxels{true};
+		/** Set occupied voxels visible (requires generateOccupiedVoxels=true)
+		 * (Default=true) */
+		bool visibleOccupiedVoxels{true};
+		/** Generate voxels for the freespace (Default=true) */
+		bool generateFreeVoxels{true};
+		/** Set free voxels visible (requires generateFreeVoxels=true)
+		 * (Default=true) */
+		bool visibleFreeVoxels{true};
+
+		/** Binary dump to stream */
+		void writeToStream(mrpt::serialization::CArchive& out) const;
+		/** Binary dump to stream */
+		void readFromStream(mrpt::serialization::CArchive& in);
+	};
+
+	TRenderingOptions renderingOptions;
+
+	MAP_DEFINITION_START(CVoxelMap)
+	/** The resolution of the map (default: 0.10 meters) */
+	double resolution{0.10};
+	/** Observations insertion options */
+	mrpt::maps::CVoxelMap::TInsertionOptions insertionOpts;
+	/** Probabilistic observation likelihood options */
+	mrpt::maps::CVoxelMap::TLikelihoodOptions likelihoodOpts;
+	MAP_DEFINITION_END(CVoxelMap)
+
+	/** Returns true if the map is empty/no observation has been inserted */
+	bool isEmpty() const override;
+
+	void saveMetricMapRepresentationToFile(
+		const std::string& filNamePrefix) const override;
+
+	/** Returns a 3D object representing the map.
+	 * \sa renderingOptions
+	 */
+	void getAs3DObject(mrpt::opengl::CSetOfObjects::Ptr& outObj) const override;
+
+	/** Builds a renderizable representation of the map as a
+	 * mrpt::opengl::COctoMapVoxels object.
+	 * \sa renderingOptions
+	 */
+	void getAsOctoMapVoxels(mrpt::opengl::COctoMapVoxels& gl_obj) const;
+
+	/** Get the occupancy probability [0,1] of a point
+	 * \return false if the point is not mapped, in which case the returned
+	 * "prob" is undefined. */
+	bool getPointOccupancy(
+		const float x, const float y, const float z,
+		double& prob_occupancy) const;
+
+	/** Update the map with a 2D or 3D scan, given directly as a point cloud
+	 * and the 3D location of the sensor (the origin of the rays) in this map's
+	 * frame of reference.
+	 * Insertion parameters can be found in \a insertionOptions.
+	 * \sa The generic observation insertion method
+	 * CMetricMap::insertObservation()
+	 */
+	void insertPointCloud(
+		const CPointsMap& ptMap, const float sensor_x, const float sensor_y,
+		const float sensor_z);
+
+	/** Like insertPointCloud(), for the `N` points with coordinates in the
+	 * arrays `xs`, `ys`, `zs`. Points with non-finite coordinates, or out of
+	 * the limits of the map, are ignored. */
+	void insertPointCloud(
+		const float* xs, const float* ys, const float* zs, const size_t N,
+		const float sensor_x, const float sensor_y, const float sensor_z);
+
+	/** Just like insertPointCloud but with a single ray. */
+	void insertRay(
+		const float end_x, const float end_y, const float end_z,
+		const float sensor_x, const float sensor_y, const float sensor_z);
+
+	/** Manually updates the occupancy of the voxel at (x,y,z) as being occupied
+	 * (true) or free (false), using the log-odds parameters in \a
+	 * insertionOptions */
+	void updateVoxel(
+		const double x, const double y, const double z, bool occupied);
+
+	/** Performs raycasting in 3d, with the same semantics than
+	 * COctoMapBase::castRay().
+	 *
+	 * A ray is cast from origin with a given direction, the first occupied
+	 * cell is returned (as center coordinate). If the starting coordinate is
+	 * already occupied, this coordinate will be returned as a hit.
+	 *
+	 * @param origin starting coordinate of ray
+	 * @param direction A vector pointing in the direction of the raycast. Does
+	 * not need to be normalized.
+	 * @param end returns the center of the cell that was hit by the ray, if
+	 * successful
+	 * @param ignoreUnknownCells whether unknown cells are ignored. If false
+	 * (default), the raycast aborts when an unkown cell is hit.
+	 * @param maxRange Maximum range after which the raycast is aborted (<= 0:
+	 * no limit, default)
+	 * @return whether or not an occupied cell was hit
+	 */
+	bool castRay(
+		const mrpt::math::TPoint3D& origin,
+		const mrpt::math::TPoint3D& direction, mrpt::math::TPoint3D& end,
+		bool ignoreUnknownCells = false, double maxRange = -1.0) const;
+
+	double getResolution() const { return m_resolution; }
+	/// \return The number of allocated blocks of BLOCK_VOXELS voxels
+	size_t getNumBlocks() const;
+	/// \return Approximate memory usage of the map in bytes
+	size_t memoryUsage() const;
+	/// minimum value of the bounding box of all allocated blocks in x, y, z
+	void getMetricMin(double& x, double& y, double& z) const;
+	/// maximum value of the bounding box of all allocated blocks in x, y, z
+	void getMetricMax(double& x, double& y, double& z) const;
+
+	/** @name Sensor model parameters, as in COctoMapBase
+	@{ */
+	void setOccupancyThres(double prob)
+	{
+		insertionOptions.occupancyThres = prob;
+	}
+	void setProbHit(double prob) { insertionOptions.probHit = prob; }
+	void setProbMiss(double prob) { insertionOptions.probMiss = prob; }
+	void setClampingThresMin(double thresProb)
+	{
+		insertionOptions.clampingThresMin = thresProb;
+	}
+	void setClampingThresMax(double thresProb)
+	{
+		insertionOptions.clampingThresMax = thresProb;
+	}
+	double getOccupancyThres() const { return insertionOptions.occupancyThres; }
+	float getOccupancyThresLog() const
+	{
+		return logodds(insertionOptions.occupancyThres);
+	}
+	double getProbHit() const { return insertionOptions.probHit; }
+	float getProbHitLog() const { return logodds(insertionOptions.probHit); }
+	double getProbMiss() const { return insertionOptions.probMiss; }
+	float getProbMissLog() const { return logodds(insertionOptions.probMiss); }
+	double getClampingThresMin() const
+	{
+		return insertionOptions.clampingThresMin;
+	}
+	float getClampingThresMinLog() const
+	{
+		return logodds(insertionOptions.clampingThresMin);
+	}
+	double getClampingThresMax() const
+	{
+		return insertionOptions.clampingThresMax;
+	}
+	float getClampingThresMaxLog() const
+	{
+		return logodds(insertionOptions.clampingThresMax);
+	}
+	/** @} */
+
+   protected:
+	static float logodds(double prob)
+	{
+		return static_cast<float>(std::log(prob / (1 - prob)));
+	}
+
+	struct TBlock
+	{
+		TBlock();
+		std::array<voxel_t, BLOCK_VOXELS> voxels;
+		/** Voxels with rays ending in them, or traversing them, while a point
+		 * cloud is being inserted. Otherwise, all zeros. */
+		std::array<uint64_t, BLOCK_VOXELS / 64> occupiedMask, freeMask;
+		/** Whether the masks have any bit set */
+		bool pending{false};
+	};
+	/** Spreads the block keys (packed integer block coordinates) */
+	struct TBlockKeyHash
+	{
+		size_t operator()(const uint64_t k) const
+		{
+			return static_cast<size_t>(k * UINT64_C(0x9E3779B97F4A7C15));
+		}
+	};
+	/** The blocks are split into shards by their key, so threads can create
+	 * and update blocks in different shards at once */
+	struct TShard
+	{
+		std::unordered_map<uint64_t, TBlock, TBlockKeyHash> blocks;
+		/** Bounding box of the blocks, in block coordinates */
+		std::array<uint32_t, 3> bbMin{{UINT32_MAX, UINT32_MAX, UINT32_MAX}},
+			bbMax{{0, 0, 0}};
+	};
+	static constexpr unsigned int NUM_SHARDS = 64;
+
+	double m_resolution;
+	std::array<TShard, NUM_SHARDS> m_shards;
+
+	/** Converts metric coordinates into the (unsigned) coordinates of a
+	 * voxel. \return false if out of the limits of the map */
+	bool coordsToVoxel(double x, double y, double z, uint32_t v[3]) const;
+	/** Returns the block containing a voxel, or nullptr if not allocated */
+	const TBlock* getBlock(const uint32_t v[3]) const;
+	/** Returns the block containing a voxel, allocating it if needed */
+	TBlock& getOrCreateBlock(const uint32_t v[3]);
+	/** Gets the overall bounding box of the blocks, in block coordinates.
+	 * \return false if the map is empty */
+	bool getBlocksBoundingBox(uint32_t bbMin[3], uint32_t bbMax[3]) const;
+
+	void internal_clear() override;
+	bool internal_insertObservation(
+		const mrpt::obs::CObservation* obs,
+		const mrpt::poses::CPose3D* robotPose) override;
+	double internal_computeObservationLikelihood(
+		const mrpt::obs::CObservation* obs,
+		const mrpt::poses::CPose3D& takenFrom) override;
+};  // End of class def.
+}  // namespace mrpt::maps
@@ -0,0 +1,324 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+
+#include <mrpt/maps/CCircularOccupancyGridMap2D.h>
+#include <mrpt/config/CConfigFileBase.h>  // MRPT_LOAD_CONFIG_VAR()
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/serialization/CArchive.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace std;
+
+//  =========== Begin of Map definition ============
+MAP_DEFINITION_REGISTER(
+	"CCircularOccupancyGridMap2D,circularOccupancyGrid",
+	mrpt::maps::CCircularOccupancyGridMap2D)
+
+CCircularOccupancyGridMap2D::TMapDefinition::TMapDefinition() = default;
+
+void CCircularOccupancyGridMap2D::TMapDefinition::
+	loadFromConfigFile_map_specific(
+		const mrpt::config::CConfigFileBase& source,
+		const std::string& sectionNamePrefix)
+{
+	// [<sectionNamePrefix>+"_creationOpts"]
+	const std::string sSectCreation =
+		sectionNamePrefix + string("_creationOpts");
+	MRPT_LOAD_CONFIG_VAR(min_x, double, source, sSectCreation);
+	MRPT_LOAD_CONFIG_VAR(max_x, double, source, sSectCreation);
+	MRPT_LOAD_CONFIG_VAR(min_y, double, source, sSectCreation);
+	MRPT_LOAD_CONFIG_VAR(max_y, double, source, sSectCreation);
+	MRPT_LOAD_CONFIG_VAR(resolution, double, source, sSectCreation);
+
+	insertionOpts.loadFromConfigFile(
+		source, sectionNamePrefix + string("_insertOpts"));
+}
+
+void CCircularOccupancyGridMap2D::TMapDefinition::
+	dumpToTextStream_map_specific(std::ostream& out) const
+{
+	LOADABLEOPTS_DUMP_VAR(min_x, double);
+	LOADABLEOPTS_DUMP_VAR(max_x, double);
+	LOADABLEOPTS_DUMP_VAR(min_y, double);
+	LOADABLEOPTS_DUMP_VAR(max_y, double);
+	LOADABLEOPTS_DUMP_VAR(resolution, double);
+
+	this->insertionOpts.dumpToTextStream(out);
+}
+
+mrpt::maps::CMetricMap*
+	CCircularOccupancyGridMap2D::internal_CreateFromMapDefinition(
+		const mrpt::maps::TMetricMapInitializer& _def)
+{
+	const CCircularOccupancyGridMap2D::TMapDefinition& def =
+		*dynamic_cast<const CCircularOccupancyGridMap2D::TMapDefinition*>(
+			&_def);
+	auto* obj = new CCircularOccupancyGridMap2D(
+		def.min_x, def.max_x, def.min_y, def.max_y, def.resolution);
+	obj->insertionOptions = def.insertionOpts;
+	return obj;
+}
+//  =========== End of Map definition Block =========
+
+IMPLEMENTS_SERIALIZABLE(CCircularOccupancyGridMap2D, CMetricMap, mrpt::maps)
+
+CCircularOccupancyGridMap2D::CCircularOccupancyGridMap2D(
+	double x_min, double x_max, double y_min, double y_max, double resolution)
+	: grid_t(x_min, x_max, y_min, y_max, resolution)
+{
+	internal_clear();
+}
+
+void CCircularOccupancyGridMap2D::internal_clear()
+{
+	fill(COccupancyGridMap2D::p2l(0.5f));
+	m_is_empty = true;
+}
+
+bool CCircularOccupancyGridMap2D::isEmpty() const { return m_is_empty; }
+
+void CCircularOccupancyGridMap2D::getAsOccupancyGridMap2D(
+	COccupancyGridMap2D& out) const
+{
+	out.setSize(
+		getXMin(), getXMax(), getYMin(), getYMax(), getResolution(), 0.5f);
+	out.genericMapParams = genericMapParams;
+	// setSize() rounds limits with float precision: check we got the same
+	// grid before copying cells in raw mode.
+	ASSERT_EQUAL_(out.getSizeX(), m_size_x);
+	ASSERT_EQUAL_(out.getSizeY(), m_size_y);
+	for (size_t cy = 0; cy < m_size_y; cy++)
+	{
+		cellType* row = out.getRow(cy);
+		for (size_t cx = 0; cx < m_size_x; cx++)
+			row[cx] = m_map[phys_index(cx, cy)];
+	}
+}
+
+bool CCircularOccupancyGridMap2D::internal_insertObservation(
+	const CObservation* obs, const CPose3D* robotPose)
+{
+	MRPT_START
+
+	if (!IS_CLASS(obs, CObservation2DRangeScan)) return false;
+	const auto* o = static_cast<const CObservation2DRangeScan*>(obs);
+
+	CPose3D sensorPose3D;
+	if (robotPose)
+		sensorPose3D = *robotPose + o->sensorPose;
+	else
+		sensorPose3D = o->sensorPose;
+	// Scans upside-down are traversed in the opposite direction:
+	const bool sensorIsBottomwards =
+		sensorPose3D.getRotationMatrix()(2, 2) < 0;
+
+	const size_t N = o->scan.size();
+	if (!N) return false;
+	const unsigned int K =
+		std::max<unsigned int>(1, insertionOptions.decimation);
+
+	// Log-odds increments:
+	const cellType logodd_occ = std::max<cellType>(
+		1, COccupancyGridMap2D::p2l(
+			   insertionOptions.maxOccupancyUpdateCertainty));
+	const cellType logodd_free = std::max<cellType>(
+		1,
+		COccupancyGridMap2D::p2l(insertionOptions.maxFreenessUpdateCertainty));
+	const cellType thres_occ =
+		COccupancyGridMap2D::OCCGRID_CELLTYPE_MIN + logodd_occ;
+	const cellType thres_free =
+		COccupancyGridMap2D::OCCGRID_CELLTYPE_MAX - logodd_free;
+
+	const int cx0 = x2idx(sensorPose3D.x()), cy0 = y2idx(sensorPose3D.y());
+	if (!cellByIndex(cx0, cy0)) return false;  // Sensor out of the map
+
+	double A, dA;
+	if (o->rightToLeft ^ sensorIsBottomwards)
+	{
+		A = sensorPose3D.yaw() - 0.5 * o->aperture;
+		dA = o->aperture / N;
+	}
+	else
+	{
+		A = sensorPose3D.yaw() + 0.5 * o->aperture;
+		dA = -o->aperture / N;
+	}
+
+	for (size_t i = 0; i < N; i += K, A += K * dA)
+	{
+		if (!o->validRange[i]) continue;
+		const float R = o->scan[i];
+		const bool hit = R < insertionOptions.maxDistanceInsertion;
+		const float r = hit ? R : insertionOptions.maxDistanceInsertion;
+		const int cx1 = x2idx(sensorPose3D.x() + std::cos(A) * r);
+		const int cy1 = y2idx(sensorPose3D.y() + std::sin(A) * r);
+
+		// Bresenham's line, marking as free all cells but the last one:
+		const int dx = std::abs(cx1 - cx0), dy = -std::abs(cy1 - cy0);
+		const int sx = cx0 < cx1 ? 1 : -1, sy = cy0 < cy1 ? 1 : -1;
+		int err = dx + dy, cx = cx0, cy = cy0;
+		while (cx != cx1 || cy != cy1)
+		{
+			cellType* c = cellByIndex(cx, cy);
+			if (!c) break;  // Left the map area
+			COccupancyGridMap2D::updateCell_fast_free(
+				c, logodd_free, thres_free);
+			const int e2 = 2 * err;
+			if (e2 >= dy)
+			{
+				err += dy;
+				cx += sx;
+			}
+			if (e2 <= dx)
+			{
+				err += dx;
+				cy += sy;
+			}
+		}
+		if (hit)
+		{
+			cellType* c = cellByIndex(cx1, cy1);
+			if (c)
+				COccupancyGridMap2D::updateCell_fast_occupied(
+					c, logodd_occ, thres_occ);
+		}
+	}
+	m_is_empty = false;
+	return true;
+
+	MRPT_END
+}
+
+double CCircularOccupancyGridMap2D::internal_computeObservationLikelihood(
+	const CObservation* obs, const CPose3D& takenFrom)
+{
+	MRPT_UNUSED_PARAM(obs);
+	MRPT_UNUSED_PARAM(takenFrom);
+	THROW_EXCEPTION("Not implemented: use COccupancyGridMap2D instead.");
+}
+
+bool CCircularOccupancyGridMap2D::internal_canComputeObservationLikelihood(
+	const CObservation* obs) const
+{
+	MRPT_UNUSED_PARAM(obs);
+	return false;
+}
+
+float CCircularOccupancyGridMap2D::compute3DMatchingRatio(
+	const mrpt::maps::CMetricMap* otherMap,
+	const mrpt::poses::CPose3D& otherMapPose,
+	const TMatchingRatioParams& params) const
+{
+	MRPT_UNUSED_PARAM(otherMap);
+	MRPT_UNUSED_PARAM(otherMapPose);
+	MRPT_UNUSED_PARAM(params);
+	return 0;
+}
+
+void CCircularOccupancyGridMap2D::saveMetricMapRepresentationToFile(
+	const std::string& filNamePrefix) const
+{
+	COccupancyGridMap2D grid;
+	getAsOccupancyGridMap2D(grid);
+	grid.saveAsBitmapFile(filNamePrefix + std::string("_gridmap.png"));
+}
+
+void CCircularOccupancyGridMap2D::getAs3DObject(
+	mrpt::opengl::CSetOfObjects::Ptr& outObj) const
+{
+	if (!genericMapParams.enableSaveAs3DObject) return;
+	COccupancyGridMap2D grid;
+	getAsOccupancyGridMap2D(grid);
+	grid.getAs3DObject(outObj);
+}
+
+uint8_t CCircularOccupancyGridMap2D::serializeGetVersion() const { return 0; }
+void CCircularOccupancyGridMap2D::serializeTo(
+	mrpt::serialization::CArchive& out) const
+{
+	out << m_resolution << static_cast<int32_t>(m_cx0)
+		<< static_cast<int32_t>(m_cy0) << static_cast<uint32_t>(m_size_x)
+		<< static_cast<uint32_t>(m_size_y);
+	// To assure compatibility: The size of each cell:
+	out << static_cast<uint8_t>(sizeof(cellType));
+	// Cells, in window order:
+	for (size_t cy = 0; cy < m_size_y; cy++)
+		for (size_t cx = 0; cx < m_size_x; cx++)
+			out << m_map[phys_index(cx, cy)];
+
+	out << insertionOptions.maxDistanceInsertion
+		<< insertionOptions.maxOccupancyUpdateCertainty
+		<< insertionOptions.maxFreenessUpdateCertainty
+		<< insertionOptions.decimation;
+	out << m_is_empty << genericMapParams;
+}
+
+void CCircularOccupancyGridMap2D::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			double res;
+			int32_t cx0, cy0;
+			uint32_t nx, ny;
+			in >> res >> cx0 >> cy0 >> nx >> ny;
+			setSize(
+				cx0 * res, (cx0 + nx) * res, cy0 * res, (cy0 + ny) * res, res);
+			ASSERT_EQUAL_(m_size_x, nx);
+			ASSERT_EQUAL_(m_size_y, ny);
+
+			uint8_t cellSize;
+			in >> cellSize;
+			ASSERT_EQUAL_(cellSize, sizeof(cellType));
+			for (size_t cy = 0; cy < m_size_y; cy++)
+				for (size_t cx = 0; cx < m_size_x; cx++)
+					in >> m_map[phys_index(cx, cy)];
+
+			in >> insertionOptions.maxDistanceInsertion >>
+				insertionOptions.maxOccupancyUpdateCertainty >>
+				insertionOptions.maxFreenessUpdateCertainty >>
+				insertionOptions.decimation;
+			in >> m_is_empty >> genericMapParams;
+		}
+		break;
+		default:
+			MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version)
+	};
+}
+
+void CCircularOccupancyGridMap2D::TInsertionOptions::loadFromConfigFile(
+	const mrpt::config::CConfigFileBase& iniFile, const std::string& section)
+{
+	MRPT_LOAD_CONFIG_VAR(maxDistanceInsertion, float, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(maxOccupancyUpdateCertainty, float, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(maxFreenessUpdateCertainty, float, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(decimation, int, iniFile, section);
+}
+
+void CCircularOccupancyGridMap2D::TInsertionOptions::dumpToTextStream(
+	std::ostream& out) const
+{
+	out << mrpt::format(
+		"\n----------- [CCircularOccupancyGridMap2D::TInsertionOptions] "
+		"------------ \n\n");
+	LOADABLEOPTS_DUMP_VAR(maxDistanceInsertion, float);
+	LOADABLEOPTS_DUMP_VAR(maxOccupancyUpdateCertainty, float);
+	LOADABLEOPTS_DUMP_VAR(maxFreenessUpdateCertainty, float);
+	LOADABLEOPTS_DUMP_VAR(decimation, int);
+	out << mrpt::format("\n");
+}
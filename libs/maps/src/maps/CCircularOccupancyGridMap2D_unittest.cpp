@@ -0,0 +1,62 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/maps/CCircularOccupancyGridMap2D.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/poses/CPose3D.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace std;
+
+TEST(CCircularOccupancyGridMap2D, insertScanAndRecenter)
+{
+	// A 180deg scan with all ranges = 2m:
+	CObservation2DRangeScan scan;
+	scan.aperture = M_PIf;
+	scan.resizeScanAndAssign(361, 2.0f, true);
+
+	CCircularOccupancyGridMap2D grid(-5, 5, -5, 5, 0.05);
+	EXPECT_TRUE(grid.isEmpty());
+	const CPose3D robotPose(0.02, 0.02, 0, 0, 0, 0);
+	for (int i = 0; i < 4; i++) grid.insertObservation(&scan, &robotPose);
+	EXPECT_FALSE(grid.isEmpty());
+
+	EXPECT_GT(grid.getPos(1.0, 0.0), 0.6f);  // free
+	EXPECT_LT(grid.getPos(2.03, 0.0), 0.4f);  // occupied
+	EXPECT_NEAR(grid.getPos(3.0, 0.0), 0.5f, 0.01f);  // unknown
+	EXPECT_NEAR(grid.getPos(-1.0, 0.0), 0.5f, 0.01f);  // behind the robot
+
+	// Move 3m ahead: the known area must be kept, new cells are unknown.
+	grid.recenter(3.0, 0.0);
+	EXPECT_NEAR(grid.getXMin(), -2.0, 1e-9);
+	EXPECT_NEAR(grid.getXMax(), 8.0, 1e-9);
+	EXPECT_GT(grid.getPos(1.0, 0.0), 0.6f);
+	EXPECT_LT(grid.getPos(2.03, 0.0), 0.4f);
+	EXPECT_NEAR(grid.getPos(7.0, 0.0), 0.5f, 0.01f);
+	EXPECT_NEAR(grid.getPos(-3.0, 0.0), 0.5f, 0.01f);  // out of the map
+
+	// Conversion to a regular grid:
+	COccupancyGridMap2D g2;
+	grid.getAsOccupancyGridMap2D(g2);
+	EXPECT_EQ(g2.getSizeX(), grid.getSizeX());
+	EXPECT_EQ(g2.getSizeY(), grid.getSizeY());
+	// (Sample at cell centers, since both grids may round coordinates on
+	// cell boundaries differently)
+	for (unsigned cx = 0; cx < grid.getSizeX(); cx += 3)
+		for (unsigned cy = 0; cy < grid.getSizeY(); cy += 3)
+		{
+			const double x = grid.idx2x(cx), y = grid.idx2y(cy);
+			EXPECT_NEAR(g2.getPos(x, y), grid.getPos(x, y), 1e-3)
+				<< "x=" << x << " y=" << y;
+		}
+}
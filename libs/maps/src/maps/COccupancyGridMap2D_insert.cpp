@@ -10,6 +10,7 @@
 #include "maps-precomp.h"  // Precomp header
 
 #include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/maps/CMetricMapEvents.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/CObservationRange.h>
 #include <mrpt/serialization/CArchive.h>
@@ -20,6 +21,10 @@
 #include <alloca.h>
 #endif
 
+#include <functional>
+#include <limits>
+#include <thread>
+
 using namespace mrpt;
 using namespace mrpt::maps;
 using namespace mrpt::obs;
@@ -35,6 +40,42 @@ struct TLocalPoint
 	int cx, cy;
 };
 
+namespace
+{
+/** Log-odds increments of cells observed as free or occupied, for some
+ * insertion options */
+struct TInsertionLogOdds
+{
+	using cellType = COccupancyGridMap2D::cellType;
+
+	explicit TInsertionLogOdds(
+		const COccupancyGridMap2D::TInsertionOptions& opts)
+	{
+		const float maxCertainty = opts.maxOccupancyUpdateCertainty;
+		float maxFreeCertainty = opts.maxFreenessUpdateCertainty;
+		if (maxFreeCertainty == .0f) maxFreeCertainty = maxCertainty;
+		float maxFreeCertaintyNoEcho = opts.maxFreenessInvalidRanges;
+		if (maxFreeCertaintyNoEcho == .0f)
+			maxFreeCertaintyNoEcho = maxCertainty;
+
+		free = std::max<cellType>(
+			1, COccupancyGridMap2D::p2l(maxFreeCertainty));
+		occupied =
+			3 * std::max<cellType>(1, COccupancyGridMap2D::p2l(maxCertainty));
+		noecho_free = std::max<cellType>(
+			1, COccupancyGridMap2D::p2l(maxFreeCertaintyNoEcho));
+
+		thres_occupied = COccupancyGridMap2D::OCCGRID_CELLTYPE_MIN + occupied;
+		thres_free = COccupancyGridMap2D::OCCGRID_CELLTYPE_MAX -
+					 std::max(noecho_free, free);
+	}
+
+	cellType free, occupied, noecho_free;
+	/** Saturation limits */
+	cellType thres_occupied, thres_free;
+};
+}  // namespace
+
 /*---------------------------------------------------------------
 					insertObservation
 
@@ -66,25 +107,13 @@ bool COccupancyGridMap2D::internal_insertObservation(
 	}
 
 	// the occupied and free probabilities:
-	const float maxCertainty = insertionOptions.maxOccupancyUpdateCertainty;
-	float maxFreeCertainty = insertionOptions.maxFreenessUpdateCertainty;
-	if (maxFreeCertainty == .0f) maxFreeCertainty = maxCertainty;
-	float maxFreeCertaintyNoEcho = insertionOptions.maxFreenessInvalidRanges;
-	if (maxFreeCertaintyNoEcho == .0f) maxFreeCertaintyNoEcho = maxCertainty;
-
-	cellType logodd_observation_free =
-		std::max<cellType>(1, p2l(maxFreeCertainty));
-	cellType logodd_observation_occupied =
-		3 * std::max<cellType>(1, p2l(maxCertainty));
-	cellType logodd_noecho_free =
-		std::max<cellType>(1, p2l(maxFreeCertaintyNoEcho));
+	const TInsertionLogOdds lo(insertionOptions);
+	cellType logodd_observation_free = lo.free;
+	cellType logodd_observation_occupied = lo.occupied;
 
 	// saturation limits:
-	cellType logodd_thres_occupied =
-		OCCGRID_CELLTYPE_MIN + logodd_observation_occupied;
-	cellType logodd_thres_free =
-		OCCGRID_CELLTYPE_MAX -
-		std::max(logodd_noecho_free, logodd_observation_free);
+	cellType logodd_thres_occupied = lo.thres_occupied;
+	cellType logodd_thres_free = lo.thres_free;
 
 	if (CLASS_ID(CObservation2DRangeScan) == obs->GetRuntimeClass())
 	{
@@ -94,35 +123,18 @@ bool COccupancyGridMap2D::internal_insertObservation(
 
 			********************************************************************/
 		const auto* o = static_cast<const CObservation2DRangeScan*>(obs);
-		CPose3D sensorPose3D = robotPose3D + o->sensorPose;
-		CPose2D laserPose(sensorPose3D);
-
-		// Insert only HORIZONTAL scans, since the grid is supposed to
-		//  be a horizontal representation of space.
-		bool reallyInsert =
-			o->isPlanarScan(insertionOptions.horizontalTolerance);
+		CPose2D laserPose;
+		bool sensorIsBottomwards;
+		const bool reallyInsert = getScanInsertionPose(
+			*o, robotPose3D, laserPose, sensorIsBottomwards);
 		unsigned int decimation = insertionOptions.decimation;
 
-		// Check the altitude of the map (if feature enabled!)
-		if (insertionOptions.useMapAltitude &&
-			fabs(insertionOptions.mapAltitude - sensorPose3D.z()) > 0.001)
-		{
-			reallyInsert = false;
-		}
-
-		// Manage horizontal scans, but with the sensor bottom-up:
-		//  Use the z-axis direction of the transformed Z axis of the sensor
-		//  coordinates:
-		bool sensorIsBottomwards =
-			sensorPose3D.getHomogeneousMatrixVal<CMatrixDouble44>().get_unsafe(
-				2, 2) < 0;
-
 		if (reallyInsert)
 		{
 			// ---------------------------------------------
 			//		Insert the scan as simple rays:
 			// ---------------------------------------------
-			int cx, cy, N = o->scan.size();
+			int N = o->scan.size();
 			float px, py;
 			double A, dAK;
 
@@ -155,176 +167,14 @@ bool COccupancyGridMap2D::internal_insertObservation(
 			{
 				// Method: Simple rays:
 				// -------------------------------------
+				std::vector<TScanRays> scanRays(1);
+				float bbox[4] = {px, px, py, py};
+				getScanRays(
+					*o, laserPose, sensorIsBottomwards, scanRays[0], bbox);
 
-				// Reserve a temporary block of memory on the stack with
-				// "alloca": this memory has NOT to be deallocated,
-				//  so it's ideal for an efficient, small buffer:
-				auto* scanPoints_x =
-					(float*)mrpt_alloca(sizeof(float) * nRanges);
-				auto* scanPoints_y =
-					(float*)mrpt_alloca(sizeof(float) * nRanges);
-
-				float *scanPoint_x, *scanPoint_y;
-
-				if (o->rightToLeft ^ sensorIsBottomwards)
-				{
-					A = laserPose.phi() - 0.5 * o->aperture;
-					dAK = K * o->aperture / N;
-				}
-				else
-				{
-					A = laserPose.phi() + 0.5 * o->aperture;
-					dAK = -K * o->aperture / N;
-				}
-
-				new_x_max = -(numeric_limits<float>::max)();
-				new_x_min = (numeric_limits<float>::max)();
-				new_y_max = -(numeric_limits<float>::max)();
-				new_y_min = (numeric_limits<float>::max)();
-
-				for (idx = 0, scanPoint_x = scanPoints_x,
-					scanPoint_y = scanPoints_y;
-					 idx < nRanges; idx += K, scanPoint_x++, scanPoint_y++)
-				{
-					if (o->validRange[idx])
-					{
-						curRange = o->scan[idx];
-						float R = min(maxDistanceInsertion, curRange);
-
-						*scanPoint_x = px + cos(A) * R;
-						*scanPoint_y = py + sin(A) * R;
-						last_valid_range = curRange;
-					}
-					else
-					{
-						if (invalidAsFree)
-						{
-							// Invalid range:
-							float R = min(
-								maxDistanceInsertion, 0.5f * last_valid_range);
-							*scanPoint_x = px + cos(A) * R;
-							*scanPoint_y = py + sin(A) * R;
-						}
-						else
-						{
-							*scanPoint_x = px;
-							*scanPoint_y = py;
-						}
-					}
-					A += dAK;
-
-					// Asjust size (will not change if not required):
-					new_x_max = max(new_x_max, *scanPoint_x);
-					new_x_min = min(new_x_min, *scanPoint_x);
-					new_y_max = max(new_y_max, *scanPoint_y);
-					new_y_min = min(new_y_min, *scanPoint_y);
-				}
-
-				// Add an extra margin:
-				float securMargen = 15 * resolution;
-
-				if (new_x_max > x_max - securMargen)
-					new_x_max += 2 * securMargen;
-				else
-					new_x_max = x_max;
-				if (new_x_min < x_min + securMargen)
-					new_x_min -= 2;
-				else
-					new_x_min = x_min;
-
-				if (new_y_max > y_max - securMargen)
-					new_y_max += 2 * securMargen;
-				else
-					new_y_max = y_max;
-				if (new_y_min < y_min + securMargen)
-					new_y_min -= 2;
-				else
-					new_y_min = y_min;
-
-				// -----------------------
-				//   Resize to make room:
-				// -----------------------
-				resizeGrid(new_x_min, new_x_max, new_y_min, new_y_max, 0.5);
-
-				// For updateCell_fast methods:
-				cellType* theMapArray = &map[0];
-				unsigned theMapSize_x = size_x;
-
-				int cx0 =
-					x2idx(px);  // Remember: This must be after the resizeGrid!!
-				int cy0 = y2idx(py);
-
-				// Insert rays:
-				for (idx = 0; idx < nRanges; idx += K)
-				{
-					if (!o->validRange[idx] && !invalidAsFree) continue;
-
-					// Starting position: Laser position
-					cx = cx0;
-					cy = cy0;
-
-					// Target, in cell indexes:
-					int trg_cx = x2idx(scanPoints_x[idx]);
-					int trg_cy = y2idx(scanPoints_y[idx]);
-
-					// The x> comparison implicitly holds if x<0
-					ASSERT_(
-						static_cast<unsigned int>(trg_cx) < size_x &&
-						static_cast<unsigned int>(trg_cy) < size_y);
-
-					// Use "fractional integers" to approximate float operations
-					//  during the ray tracing:
-					int Acx = trg_cx - cx;
-					int Acy = trg_cy - cy;
-
-					int Acx_ = abs(Acx);
-					int Acy_ = abs(Acy);
-
-					int nStepsRay = max(Acx_, Acy_);
-					if (!nStepsRay) continue;  // May be...
-
-					// Integers store "float values * 128"
-					float N_1 = 1.0f / nStepsRay;  // Avoid division twice.
-
-					// Increments at each raytracing step:
-					int frAcx =
-						(Acx < 0 ? -1 : +1) * round((Acx_ << FRBITS) * N_1);
-					int frAcy =
-						(Acy < 0 ? -1 : +1) * round((Acy_ << FRBITS) * N_1);
-
-					int frCX = cx << FRBITS;
-					int frCY = cy << FRBITS;
-					const auto logodd_free = o->validRange[idx]
-												 ? logodd_observation_free
-												 : logodd_noecho_free;
-
-					for (int nStep = 0; nStep < nStepsRay; nStep++)
-					{
-						updateCell_fast_free(
-							cx, cy, logodd_free, logodd_thres_free, theMapArray,
-							theMapSize_x);
-
-						frCX += frAcx;
-						frCY += frAcy;
-
-						cx = frCX >> FRBITS;
-						cy = frCY >> FRBITS;
-					}
-
-					// And finally, the occupied cell at the end:
-					// Only if:
-					//  - It was a valid ray, and
-					//  - The ray was not truncated
-					if (o->validRange[idx] &&
-						o->scan[idx] < maxDistanceInsertion)
-						updateCell_fast_occupied(
-							trg_cx, trg_cy, logodd_observation_occupied,
-							logodd_thres_occupied, theMapArray, theMapSize_x);
-
-				}  // End of each range
-
-				mrpt_alloca_free(scanPoints_x);
-				mrpt_alloca_free(scanPoints_y);
+				// Resize to make room, then insert rays:
+				resizeGridToContain(bbox);
+				insertScanRays(scanRays);
 
 			}  // end insert with simple rays
 			else
@@ -1309,6 +1159,370 @@ bool COccupancyGridMap2D::internal_insertObservation(
 	//	MRPT_END
 }
 
+/*---------------------------------------------------------------
+					getScanInsertionPose
+ ---------------------------------------------------------------*/
+bool COccupancyGridMap2D::getScanInsertionPose(
+	const CObservation2DRangeScan& o, const CPose3D& robotPose,
+	CPose2D& laserPose, bool& sensorIsBottomwards) const
+{
+	const CPose3D sensorPose3D = robotPose + o.sensorPose;
+	laserPose = CPose2D(sensorPose3D);
+
+	// Manage horizontal scans, but with the sensor bottom-up:
+	//  Use the z-axis direction of the transformed Z axis of the sensor
+	//  coordinates:
+	sensorIsBottomwards =
+		sensorPose3D.getHomogeneousMatrixVal<CMatrixDouble44>().get_unsafe(
+			2, 2) < 0;
+
+	// Insert only HORIZONTAL scans, since the grid is supposed to
+	//  be a horizontal representation of space.
+	if (!o.isPlanarScan(insertionOptions.horizontalTolerance)) return false;
+
+	// Check the altitude of the map (if feature enabled!)
+	return !(
+		insertionOptions.useMapAltitude &&
+		fabs(insertionOptions.mapAltitude - sensorPose3D.z()) > 0.001);
+}
+
+/*---------------------------------------------------------------
+						getScanRays
+ ---------------------------------------------------------------*/
+void COccupancyGridMap2D::getScanRays(
+	const CObservation2DRangeScan& o, const CPose2D& laserPose,
+	bool sensorIsBottomwards, TScanRays& out, float bbox[4]) const
+{
+	const float maxDistanceInsertion = insertionOptions.maxDistanceInsertion;
+	const bool invalidAsFree =
+		insertionOptions.considerInvalidRangesAsFreeSpace;
+	const int K = updateInfoChangeOnly.enabled
+					  ? updateInfoChangeOnly.laserRaysSkip
+					  : insertionOptions.decimation;
+	const size_t nRanges = o.scan.size();
+	const int N = static_cast<int>(nRanges);
+
+	const float px = laserPose.x(), py = laserPose.y();
+	out.x0 = px;
+	out.y0 = py;
+	out.rays.clear();
+	out.rays.reserve(nRanges / K + 1);
+
+	double A, dAK;
+	if (o.rightToLeft ^ sensorIsBottomwards)
+	{
+		A = laserPose.phi() - 0.5 * o.aperture;
+		dAK = K * o.aperture / N;
+	}
+	else
+	{
+		A = laserPose.phi() + 0.5 * o.aperture;
+		dAK = -K * o.aperture / N;
+	}
+
+	float last_valid_range = maxDistanceInsertion;
+	for (size_t idx = 0; idx < nRanges; idx += K, A += dAK)
+	{
+		TRayEnd r;
+		r.valid = o.validRange[idx] != 0;
+		if (r.valid)
+		{
+			const float curRange = o.scan[idx];
+			const float R = min(maxDistanceInsertion, curRange);
+			r.x = px + cos(A) * R;
+			r.y = py + sin(A) * R;
+			// Only mark occupied cells if the ray was not truncated:
+			r.occupied = curRange < maxDistanceInsertion;
+			last_valid_range = curRange;
+		}
+		else if (invalidAsFree)
+		{
+			// Invalid range:
+			const float R =
+				min(maxDistanceInsertion, 0.5f * last_valid_range);
+			r.x = px + cos(A) * R;
+			r.y = py + sin(A) * R;
+			r.occupied = false;
+		}
+		else
+			continue;
+
+		out.rays.push_back(r);
+		bbox[0] = min(bbox[0], r.x);
+		bbox[1] = max(bbox[1], r.x);
+		bbox[2] = min(bbox[2], r.y);
+		bbox[3] = max(bbox[3], r.y);
+	}
+}
+
+/*---------------------------------------------------------------
+					resizeGridToContain
+ ---------------------------------------------------------------*/
+void COccupancyGridMap2D::resizeGridToContain(const float bbox[4])
+{
+	float new_x_min = bbox[0], new_x_max = bbox[1];
+	float new_y_min = bbox[2], new_y_max = bbox[3];
+
+	// Add an extra margin:
+	const float securMargen = 15 * resolution;
+
+	if (new_x_max > x_max - securMargen)
+		new_x_max += 2 * securMargen;
+	else
+		new_x_max = x_max;
+	if (new_x_min < x_min + securMargen)
+		new_x_min -= 2;
+	else
+		new_x_min = x_min;
+
+	if (new_y_max > y_max - securMargen)
+		new_y_max += 2 * securMargen;
+	else
+		new_y_max = y_max;
+	if (new_y_min < y_min + securMargen)
+		new_y_min -= 2;
+	else
+		new_y_min = y_min;
+
+	resizeGrid(new_x_min, new_x_max, new_y_min, new_y_max, 0.5);
+}
+
+namespace
+{
+/** A ray, in cell indices */
+struct TRayCells
+{
+	int cx0, cy0, cx1, cy1;
+	bool valid, occupied;
+};
+
+/** Visits the cells of a ray, from (cx,cy) up to the target cell (not
+ * included), using "fractional integers" to approximate float operations.
+ * \return false if the ray has no length */
+template <typename FUNCTOR>
+inline bool traceRay(int cx, int cy, int trg_cx, int trg_cy, FUNCTOR&& f)
+{
+	const int Acx = trg_cx - cx;
+	const int Acy = trg_cy - cy;
+	const int Acx_ = abs(Acx);
+	const int Acy_ = abs(Acy);
+
+	const int nStepsRay = max(Acx_, Acy_);
+	if (!nStepsRay) return false;
+
+	const float N_1 = 1.0f / nStepsRay;  // Avoid division twice.
+
+	// Increments at each raytracing step:
+	const int frAcx = (Acx < 0 ? -1 : +1) * round((Acx_ << FRBITS) * N_1);
+	const int frAcy = (Acy < 0 ? -1 : +1) * round((Acy_ << FRBITS) * N_1);
+
+	int frCX = cx << FRBITS;
+	int frCY = cy << FRBITS;
+	for (int nStep = 0; nStep < nStepsRay; nStep++)
+	{
+		f(cx, cy);
+		frCX += frAcx;
+		frCY += frAcy;
+		cx = frCX >> FRBITS;
+		cy = frCY >> FRBITS;
+	}
+	return true;
+}
+
+/** One cell update, stored by the threads tracing rays */
+struct TCellUpdate
+{
+	enum : uint8_t
+	{
+		FREE = 0,
+		FREE_NO_ECHO,
+		OCCUPIED
+	};
+	uint32_t idx;
+	uint8_t type;
+};
+}  // namespace
+
+/*---------------------------------------------------------------
+						insertScanRays
+ ---------------------------------------------------------------*/
+void COccupancyGridMap2D::insertScanRays(const std::vector<TScanRays>& scans)
+{
+	MRPT_START
+
+	// Rays, in cell indices. Remember: This must be after resizeGrid()!
+	std::vector<TRayCells> rays;
+	for (const auto& s : scans)
+	{
+		const int cx0 = x2idx(s.x0), cy0 = y2idx(s.y0);
+		for (const auto& r : s.rays)
+		{
+			const TRayCells rc{
+				cx0, cy0, x2idx(r.x), y2idx(r.y), r.valid, r.occupied};
+			// The x> comparison implicitly holds if x<0
+			ASSERT_(
+				static_cast<unsigned int>(rc.cx1) < size_x &&
+				static_cast<unsigned int>(rc.cy1) < size_y);
+			rays.push_back(rc);
+		}
+	}
+	if (rays.empty()) return;
+
+	const TInsertionLogOdds lo(insertionOptions);
+	cellType* theMapArray = &map[0];
+	const unsigned theMapSize_x = size_x;
+
+	const size_t MIN_RAYS_PER_THREAD = 256;
+	unsigned int num_threads = insertionOptions.num_threads;
+	if (num_threads == 0)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	num_threads = static_cast<unsigned int>(std::max<size_t>(
+		1, std::min<size_t>(
+			   {num_threads, rays.size() / MIN_RAYS_PER_THREAD, size_y})));
+
+	if (num_threads == 1)
+	{
+		for (const auto& r : rays)
+		{
+			const cellType logodd_free = r.valid ? lo.free : lo.noecho_free;
+			const bool traced =
+				traceRay(r.cx0, r.cy0, r.cx1, r.cy1, [&](int cx, int cy) {
+					updateCell_fast_free(
+						cx, cy, logodd_free, lo.thres_free, theMapArray,
+						theMapSize_x);
+				});
+			// And finally, the occupied cell at the end:
+			if (traced && r.occupied)
+				updateCell_fast_occupied(
+					r.cx1, r.cy1, lo.occupied, lo.thres_occupied, theMapArray,
+					theMapSize_x);
+		}
+		return;
+	}
+
+	ASSERT_BELOW_(
+		uint64_t(size_x) * size_y,
+		uint64_t(std::numeric_limits<uint32_t>::max()));
+	const auto runThreads = [num_threads](const std::function<void(
+											  unsigned int)>& job) {
+		std::vector<std::thread> threads;
+		for (unsigned int t = 1; t < num_threads; t++)
+			threads.emplace_back(job, t);
+		job(0);
+		for (auto& th : threads) th.join();
+	};
+
+	// 1) Each thread traces a range of consecutive rays, and stores the cell
+	// updates split by the band of rows they fall into:
+	const unsigned int bandRows = (size_y + num_threads - 1) / num_threads;
+	const size_t raysPerThread = (rays.size() + num_threads - 1) / num_threads;
+	std::vector<std::vector<std::vector<TCellUpdate>>> updates(
+		num_threads, std::vector<std::vector<TCellUpdate>>(num_threads));
+	runThreads([&](unsigned int t) {
+		auto& bands = updates[t];
+		const auto push = [&](int cx, int cy, uint8_t type) {
+			bands[cy / bandRows].push_back(
+				{static_cast<uint32_t>(cx + cy * theMapSize_x), type});
+		};
+		const size_t i1 = std::min(rays.size(), (t + 1) * raysPerThread);
+		for (size_t i = t * raysPerThread; i < i1; i++)
+		{
+			const auto& r = rays[i];
+			const uint8_t freeType =
+				r.valid ? TCellUpdate::FREE : TCellUpdate::FREE_NO_ECHO;
+			const bool traced = traceRay(
+				r.cx0, r.cy0, r.cx1, r.cy1,
+				[&](int cx, int cy) { push(cx, cy, freeType); });
+			if (traced && r.occupied)
+				push(r.cx1, r.cy1, TCellUpdate::OCCUPIED);
+		}
+	});
+
+	// 2) Each thread applies the updates of one band of rows, in the order of
+	// the rays, so the result is exactly that of a sequential insertion:
+	runThreads([&](unsigned int band) {
+		for (unsigned int t = 0; t < num_threads; t++)
+		{
+			for (const auto& u : updates[t][band])
+			{
+				cellType* cell = theMapArray + u.idx;
+				if (u.type == TCellUpdate::OCCUPIED)
+					updateCell_fast_occupied(
+						cell, lo.occupied, lo.thres_occupied);
+				else
+					updateCell_fast_free(
+						cell,
+						u.type == TCellUpdate::FREE ? lo.free : lo.noecho_free,
+						lo.thres_free);
+			}
+		}
+	});
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+						insertScans
+ ---------------------------------------------------------------*/
+size_t COccupancyGridMap2D::insertScans(
+	const std::vector<const CObservation2DRangeScan*>& scans,
+	const std::vector<CPose3D>& robotPoses)
+{
+	MRPT_START
+
+	ASSERT_EQUAL_(scans.size(), robotPoses.size());
+	size_t nInserted = 0;
+	if (!genericMapParams.enableObservationInsertion) return nInserted;
+
+	if (insertionOptions.wideningBeamsWithDistance)
+	{
+		for (size_t i = 0; i < scans.size(); i++)
+			if (insertObservation(scans[i], &robotPoses[i])) nInserted++;
+		return nInserted;
+	}
+
+	// Compute all the rays, and their bounding box:
+	std::vector<TScanRays> scanRays;
+	std::vector<size_t> inserted;
+	float bbox[4] = {x_max, x_min, y_max, y_min};
+	for (size_t i = 0; i < scans.size(); i++)
+	{
+		ASSERT_(scans[i]);
+		CPose2D laserPose;
+		bool sensorIsBottomwards;
+		if (!getScanInsertionPose(
+				*scans[i], robotPoses[i], laserPose, sensorIsBottomwards))
+			continue;
+
+		scanRays.emplace_back();
+		getScanRays(
+			*scans[i], laserPose, sensorIsBottomwards, scanRays.back(), bbox);
+		const float px = laserPose.x(), py = laserPose.y();
+		bbox[0] = min(bbox[0], px);
+		bbox[1] = max(bbox[1], px);
+		bbox[2] = min(bbox[2], py);
+		bbox[3] = max(bbox[3], py);
+		inserted.push_back(i);
+	}
+	if (inserted.empty()) return nInserted;
+
+	// For the precomputed likelihood trick:
+	precomputedLikelihoodToBeRecomputed = true;
+
+	resizeGridToContain(bbox);
+	insertScanRays(scanRays);
+
+	for (const size_t i : inserted)
+	{
+		OnPostSuccesfulInsertObs(scans[i]);
+		publishEvent(
+			mrptEventMetricMapInsert(this, scans[i], &robotPoses[i]));
+	}
+	return inserted.size();
+
+	MRPT_END
+}
+
 /*---------------------------------------------------------------
 	Initilization of values, don't needed to be called directly.
   ---------------------------------------------------------------*/
@@ -1338,6 +1552,12 @@ void COccupancyGridMap2D::TInsertionOptions::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(CFD_features_gaussian_size, float, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(CFD_features_median_size, float, iniFile, section);
 	MRPT_LOAD_CONFIG_VAR(wideningBeamsWithDistance, bool, iniFile, section);
+	// Read as unsigned, so negative values wrap around and are rejected here
+	// instead of silently becoming a huge thread count:
+	const uint64_t nThreads =
+		iniFile.read_uint64_t(section, "num_threads", num_threads);
+	ASSERT_BELOWEQ_(nThreads, 1024U);
+	num_threads = static_cast<unsigned int>(nThreads);
 }
 
 /*---------------------------------------------------------------
@@ -1362,6 +1582,7 @@ void COccupancyGridMap2D::TInsertionOptions::dumpToTextStream(
 	LOADABLEOPTS_DUMP_VAR(CFD_features_gaussian_size, float)
 	LOADABLEOPTS_DUMP_VAR(CFD_features_median_size, float)
 	LOADABLEOPTS_DUMP_VAR(wideningBeamsWithDistance, bool)
+	LOADABLEOPTS_DUMP_VAR(num_threads, int)
 
 	out << mrpt::format("\n");
 }
@@ -104,3 +104,62 @@ TEST(COccupancyGridMap2DTests, insert2DScan)
 		// should have a high "freeness"
 	}
 }
+
+TEST(COccupancyGridMap2DTests, insertScansParallel)
+{
+	// Synthetic scans, from several poses:
+	const size_t nScans = 20, nRays = 361;
+	std::vector<CObservation2DRangeScan> scans(nScans);
+	std::vector<const CObservation2DRangeScan*> scanPtrs;
+	std::vector<CPose3D> poses;
+	for (size_t i = 0; i < nScans; i++)
+	{
+		std::vector<float> ranges(nRays);
+		std::vector<char> valid(nRays, 1);
+		for (size_t k = 0; k < nRays; k++)
+		{
+			ranges[k] = 3.0f + 2.5f * std::sin(0.05f * k + i);
+			if ((k + i) % 37 == 0) valid[k] = 0;
+		}
+		ranges[i] = 30.0f;  // Truncated by maxDistanceInsertion
+		scans[i].aperture = M_PIf;
+		scans[i].loadFromVectors(nRays, &ranges[0], &valid[0]);
+		scanPtrs.push_back(&scans[i]);
+		poses.emplace_back(0.3 * i, -0.2 * i, 0, 0.1 * i, 0, 0);
+	}
+
+	// Sequential vs. parallel insertion of each scan:
+	COccupancyGridMap2D grid1(-5.0f, 5.0f, -5.0f, 5.0f, 0.05f);
+	COccupancyGridMap2D grid4 = grid1;
+	grid4.insertionOptions.num_threads = 4;
+	for (size_t i = 0; i < nScans; i++)
+	{
+		EXPECT_TRUE(grid1.insertObservation(scanPtrs[i], &poses[i]));
+		EXPECT_TRUE(grid4.insertObservation(scanPtrs[i], &poses[i]));
+	}
+	ASSERT_EQ(grid1.getSizeX(), grid4.getSizeX());
+	ASSERT_EQ(grid1.getSizeY(), grid4.getSizeY());
+	EXPECT_EQ(grid1.getRawMap(), grid4.getRawMap());
+
+	// Batch insertion, where the grid is resized only once:
+	COccupancyGridMap2D gridBatch(-5.0f, 5.0f, -5.0f, 5.0f, 0.05f);
+	gridBatch.insertionOptions.num_threads = 3;
+	EXPECT_EQ(gridBatch.insertScans(scanPtrs, poses), nScans);
+	EXPECT_FALSE(gridBatch.isEmpty());
+	size_t nCompared = 0;
+	for (unsigned int cy = 0; cy < grid1.getSizeY(); cy++)
+	{
+		for (unsigned int cx = 0; cx < grid1.getSizeX(); cx++)
+		{
+			const float x = grid1.idx2x(cx), y = grid1.idx2y(cy);
+			const int bx = gridBatch.x2idx(x), by = gridBatch.y2idx(y);
+			if (bx < 0 || by < 0 ||
+				static_cast<unsigned>(bx) >= gridBatch.getSizeX() ||
+				static_cast<unsigned>(by) >= gridBatch.getSizeY())
+				continue;
+			ASSERT_EQ(grid1.getCell(cx, cy), gridBatch.getCell(bx, by));
+			nCompared++;
+		}
+	}
+	EXPECT_GT(nCompared, 40000U);
+}
@@ -0,0 +1,882 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+
+#include <mrpt/maps/CPointCloudStreamIO.h>
+#include <mrpt/maps/CPointsMap.h>
+#include <mrpt/config.h>
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <thread>
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+using namespace mrpt::maps;
+
+namespace
+{
+// Bytes of text read from the file at once, then parsed in parallel:
+constexpr size_t TEXT_CHUNK_SIZE = 32 << 20;
+constexpr uint64_t ALL_LINES = std::numeric_limits<uint64_t>::max();
+
+using file_ptr_t = std::unique_ptr<FILE, int (*)(FILE*)>;
+
+file_ptr_t openForReading(const std::string& fileName)
+{
+	file_ptr_t f(std::fopen(fileName.c_str(), "rb"), &std::fclose);
+	if (!f) THROW_EXCEPTION_FMT("Cannot open file `%s`", fileName.c_str());
+	return f;
+}
+
+/** Reads one header line, without the trailing "\r\n" */
+bool readLine(FILE* f, std::string& line)
+{
+	line.clear();
+	int c;
+	while ((c = std::fgetc(f)) != EOF && c != '\n')
+		line.push_back(static_cast<char>(c));
+	if (!line.empty() && line.back() == '\r') line.pop_back();
+	return c != EOF || !line.empty();
+}
+
+/*------------------------------------------------------------------
+					Locale-independent number parser
+ ------------------------------------------------------------------*/
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool isSeparator(char c)
+{
+	return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+constexpr double POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+							1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+							1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr int MAX_POW10 = 22;
+
+/** Tokens which are not plain decimal numbers ("nan", "inf",...) are left to
+ * strtod(). */
+const char* parseSpecialNumber(const char* p, const char* end, float& out)
+{
+	char tok[32];
+	size_t n = 0;
+	while (p + n < end && !isSeparator(p[n]) && n < sizeof(tok) - 1)
+	{
+		tok[n] = p[n];
+		n++;
+	}
+	tok[n] = '\0';
+	char* tokEnd;
+	const double v = std::strtod(tok, &tokEnd);
+	if (n == 0 || tokEnd != tok + n) return nullptr;
+	out = static_cast<float>(v);
+	return p + n;
+}
+
+/** Parses the number starting at `p`, which must end at a separator or at
+ * `end`. \return The end of the number, or nullptr if it is not valid. */
+const char* parseNumber(const char* p, const char* end, float& out)
+{
+	// Above this, further digits do not change the (float) result:
+	constexpr uint64_t MAX_MANTISSA = 100000000000000000ULL;
+
+	const char* const start = p;
+	bool neg = false;
+	if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+
+	uint64_t mantissa = 0;
+	int exp10 = 0;
+	bool anyDigit = false;
+	for (; p < end && isDigit(*p); p++, anyDigit = true)
+	{
+		if (mantissa < MAX_MANTISSA)
+			mantissa = mantissa * 10 + (*p - '0');
+		else
+			exp10++;
+	}
+	if (p < end && *p == '.')
+	{
+		for (p++; p < end && isDigit(*p); p++, anyDigit = true)
+		{
+			if (mantissa < MAX_MANTISSA)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				exp10--;
+			}
+		}
+	}
+	if (!anyDigit) return parseSpecialNumber(start, end, out);
+
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		const char* q = p + 1;
+		bool expNeg = false;
+		if (q < end && (*q == '-' || *q == '+')) expNeg = (*q++ == '-');
+		if (q < end && isDigit(*q))
+		{
+			int e = 0;
+			for (; q < end && isDigit(*q); q++)
+				if (e < 10000) e = e * 10 + (*q - '0');
+			exp10 += expNeg ? -e : e;
+			p = q;
+		}
+	}
+	if (p < end && !isSeparator(*p)) return nullptr;
+
+	double v = static_cast<double>(mantissa);
+	if (mantissa != 0 && exp10 != 0)
+	{
+		if (exp10 > 0)
+			v *= exp10 <= MAX_POW10 ? POW10[exp10] : std::pow(10.0, exp10);
+		else if (exp10 >= -MAX_POW10)
+			v /= POW10[-exp10];
+		else
+			v *= std::pow(10.0, exp10);
+	}
+	out = static_cast<float>(neg ? -v : v);
+	return p;
+}
+
+/** Parses the lines in [p,end), see CPointCloudStreamIO::parseTextColumns()
+ */
+size_t parseRows(
+	const char* p, const char* end, size_t nCols,
+	std::vector<std::vector<float>>& out)
+{
+	std::vector<float> row(nCols);
+	size_t nRows = 0;
+	while (p < end)
+	{
+		const char* eol =
+			static_cast<const char*>(std::memchr(p, '\n', end - p));
+		if (!eol) eol = end;
+
+		const char* q = p;
+		while (q < eol && isSeparator(*q)) q++;
+		size_t c = 0;
+		for (; c < nCols; c++)
+		{
+			q = parseNumber(q, eol, row[c]);
+			if (!q) break;
+			while (q < eol && isSeparator(*q)) q++;
+		}
+		if (c == nCols)
+		{
+			for (c = 0; c < nCols; c++) out[c].push_back(row[c]);
+			nRows++;
+		}
+		p = eol + 1;
+	}
+	return nRows;
+}
+
+/** Reads the rest of the file in large chunks of whole lines, skipping the
+ * first `skipLines` lines, and stopping after `maxLines` lines. */
+void forEachTextChunk(
+	FILE* f, uint64_t skipLines, uint64_t maxLines,
+	const std::function<void(const char*, size_t)>& onChunk)
+{
+	const bool limited = (maxLines != ALL_LINES);
+	std::vector<char> buf;
+	size_t carry = 0;
+	bool done = false;
+	while (!done)
+	{
+		buf.resize(carry + TEXT_CHUNK_SIZE);
+		const size_t nRead =
+			std::fread(buf.data() + carry, 1, TEXT_CHUNK_SIZE, f);
+		done = (nRead < TEXT_CHUNK_SIZE);
+
+		const char* p = buf.data();
+		const char* const end = p + carry + nRead;
+		// Leave the last, incomplete, line for the next chunk:
+		const char* cut = end;
+		if (!done)
+			while (cut > p && cut[-1] != '\n') cut--;
+
+		const auto nextLine = [cut](const char* q) {
+			const char* eol =
+				static_cast<const char*>(std::memchr(q, '\n', cut - q));
+			return eol ? eol + 1 : cut;
+		};
+		for (; skipLines && p < cut; skipLines--) p = nextLine(p);
+		if (limited && !skipLines)
+		{
+			const char* q = p;
+			for (; maxLines && q < cut; maxLines--) q = nextLine(q);
+			if (!maxLines)
+			{
+				cut = q;
+				done = true;
+			}
+		}
+		if (!skipLines && cut > p) onChunk(p, cut - p);
+
+		carry = end - cut;
+		if (!done) std::memmove(buf.data(), cut, carry);
+	}
+}
+
+/** Passes the coordinates of parsed rows to the callback, in blocks. `iz`
+ * is -1 if there is no z coordinate. */
+void deliverRows(
+	const std::vector<std::vector<float>>& cols, int ix, int iy, int iz,
+	size_t nRows, size_t blockSize,
+	const CPointCloudStreamIO::block_callback_t& callback)
+{
+	std::vector<float> zeros;
+	if (iz < 0) zeros.assign(std::min(nRows, blockSize), 0.0f);
+	for (size_t i = 0; i < nRows; i += blockSize)
+	{
+		const size_t n = std::min(blockSize, nRows - i);
+		callback(
+			&cols[ix][i], &cols[iy][i], iz < 0 ? zeros.data() : &cols[iz][i],
+			n);
+	}
+}
+
+/** Reads and parses the text data of a file, see deliverRows() */
+uint64_t readTextRows(
+	FILE* f, uint64_t skipLines, uint64_t maxLines, size_t nCols, int ix,
+	int iy, int iz, size_t blockSize, unsigned int num_threads,
+	const CPointCloudStreamIO::block_callback_t& callback)
+{
+	uint64_t nTotal = 0;
+	std::vector<std::vector<float>> cols;
+	forEachTextChunk(
+		f, skipLines, maxLines, [&](const char* text, size_t len) {
+			for (auto& c : cols) c.clear();
+			const size_t n = CPointCloudStreamIO::parseTextColumns(
+				text, len, nCols, cols, num_threads);
+			deliverRows(cols, ix, iy, iz, n, blockSize, callback);
+			nTotal += n;
+		});
+	return nTotal;
+}
+
+/*------------------------------------------------------------------
+						Binary records
+ ------------------------------------------------------------------*/
+enum class TScalar : uint8_t
+{
+	NONE = 0,
+	I8,
+	U8,
+	I16,
+	U16,
+	I32,
+	U32,
+	F32,
+	F64
+};
+
+size_t scalarSize(TScalar t)
+{
+	switch (t)
+	{
+		case TScalar::I8:
+		case TScalar::U8:
+			return 1;
+		case TScalar::I16:
+		case TScalar::U16:
+			return 2;
+		case TScalar::I32:
+		case TScalar::U32:
+		case TScalar::F32:
+			return 4;
+		case TScalar::F64:
+			return 8;
+		default:
+			return 0;
+	};
+}
+
+template <typename T>
+inline float readAs(const uint8_t* p)
+{
+	T v;
+	std::memcpy(&v, p, sizeof(T));
+	return static_cast<float>(v);
+}
+
+float readScalar(const uint8_t* p, TScalar t)
+{
+	switch (t)
+	{
+		case TScalar::I8:
+			return readAs<int8_t>(p);
+		case TScalar::U8:
+			return readAs<uint8_t>(p);
+		case TScalar::I16:
+			return readAs<int16_t>(p);
+		case TScalar::U16:
+			return readAs<uint16_t>(p);
+		case TScalar::I32:
+			return readAs<int32_t>(p);
+		case TScalar::U32:
+			return readAs<uint32_t>(p);
+		case TScalar::F32:
+			return readAs<float>(p);
+		case TScalar::F64:
+			return readAs<double>(p);
+		default:
+			return 0;
+	};
+}
+
+/** Layout of the fixed-size records of binary files */
+struct TRecordLayout
+{
+	size_t recordSize{0};
+	size_t offset[3]{0, 0, 0};
+	/** NONE for a missing coordinate (z only) */
+	TScalar type[3]{TScalar::NONE, TScalar::NONE, TScalar::NONE};
+};
+
+uint64_t readBinaryRecords(
+	FILE* f, const TRecordLayout& L, uint64_t N, size_t blockSize,
+	const CPointCloudStreamIO::block_callback_t& callback)
+{
+#if MRPT_IS_BIG_ENDIAN
+	THROW_EXCEPTION("Binary point cloud files require a little endian host");
+#endif
+	ASSERT_(L.recordSize > 0);
+	blockSize = static_cast<size_t>(std::min<uint64_t>(blockSize, N));
+	std::vector<uint8_t> buf(L.recordSize * blockSize);
+	std::vector<float> xyz[3];
+	for (auto& v : xyz) v.assign(blockSize, 0.0f);
+
+	uint64_t nDone = 0;
+	while (nDone < N)
+	{
+		const size_t n =
+			static_cast<size_t>(std::min<uint64_t>(blockSize, N - nDone));
+		if (std::fread(buf.data(), L.recordSize, n, f) != n)
+			THROW_EXCEPTION("Unexpected end of file in point cloud data");
+
+		for (int k = 0; k < 3; k++)
+		{
+			if (L.type[k] == TScalar::NONE) continue;
+			const uint8_t* src = buf.data() + L.offset[k];
+			float* dst = xyz[k].data();
+			if (L.type[k] == TScalar::F32)
+				for (size_t i = 0; i < n; i++, src += L.recordSize)
+					std::memcpy(dst + i, src, sizeof(float));
+			else
+				for (size_t i = 0; i < n; i++, src += L.recordSize)
+					dst[i] = readScalar(src, L.type[k]);
+		}
+		callback(xyz[0].data(), xyz[1].data(), xyz[2].data(), n);
+		nDone += n;
+	}
+	return nDone;
+}
+
+std::vector<std::string> tokenize(const std::string& line)
+{
+	std::istringstream ss(line);
+	std::vector<std::string> toks;
+	for (std::string t; ss >> t;) toks.push_back(t);
+	return toks;
+}
+
+uint64_t toUInt(const std::string& s)
+{
+	char* end;
+	const auto v = std::strtoull(s.c_str(), &end, 10);
+	if (s.empty() || *end != '\0')
+		THROW_EXCEPTION_FMT("Invalid number in header: `%s`", s.c_str());
+	return v;
+}
+
+TScalar pcdScalar(char type, uint64_t size)
+{
+	if (type == 'F' && size == 4) return TScalar::F32;
+	if (type == 'F' && size == 8) return TScalar::F64;
+	if (type == 'I' && size == 1) return TScalar::I8;
+	if (type == 'I' && size == 2) return TScalar::I16;
+	if (type == 'I' && size == 4) return TScalar::I32;
+	if (type == 'U' && size == 1) return TScalar::U8;
+	if (type == 'U' && size == 2) return TScalar::U16;
+	if (type == 'U' && size == 4) return TScalar::U32;
+	return TScalar::NONE;
+}
+
+TScalar plyScalar(const std::string& t)
+{
+	if (t == "char" || t == "int8") return TScalar::I8;
+	if (t == "uchar" || t == "uint8") return TScalar::U8;
+	if (t == "short" || t == "int16") return TScalar::I16;
+	if (t == "ushort" || t == "uint16") return TScalar::U16;
+	if (t == "int" || t == "int32") return TScalar::I32;
+	if (t == "uint" || t == "uint32") return TScalar::U32;
+	if (t == "float" || t == "float32") return TScalar::F32;
+	if (t == "double" || t == "float64") return TScalar::F64;
+	return TScalar::NONE;
+}
+
+const char* const COORD_NAMES[3] = {"x", "y", "z"};
+
+/** Writes `v` at `p` (as "%.8g", but always with '.' as decimal point, so
+ * files can be read back whatever the current C locale is), followed by
+ * `sep`. \return The end of the written text. */
+char* writeFloat(char* p, char* end, float v, char sep)
+{
+#if defined(__cpp_lib_to_chars)
+	p = std::to_chars(p, end - 1, v, std::chars_format::general, 8).ptr;
+#else
+	const int n = std::snprintf(p, end - 1 - p, "%.8g", v);
+	const char dp = *std::localeconv()->decimal_point;
+	if (dp != '.') std::replace(p, p + n, dp, '.');
+	p += n;
+#endif
+	*p++ = sep;
+	return p;
+}
+
+}  // namespace
+
+/*---------------------------------------------------------------
+						parseTextColumns
+ ---------------------------------------------------------------*/
+size_t CPointCloudStreamIO::parseTextColumns(
+	const char* text, size_t len, size_t nCols,
+	std::vector<std::vector<float>>& out, unsigned int num_threads)
+{
+	ASSERT_(nCols > 0);
+	out.resize(nCols);
+	const char* const end = text + len;
+
+	const size_t MIN_BYTES_PER_THREAD = 1 << 20;
+	if (num_threads == 0)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	num_threads = static_cast<unsigned int>(std::max<size_t>(
+		1, std::min<size_t>(num_threads, len / MIN_BYTES_PER_THREAD)));
+	if (num_threads == 1) return parseRows(text, end, nCols, out);
+
+	// Split the text at line boundaries:
+	std::vector<const char*> bounds(num_threads + 1, end);
+	bounds[0] = text;
+	for (unsigned int t = 1; t < num_threads; t++)
+	{
+		const char* p = std::max(bounds[t - 1], text + t * (len / num_threads));
+		const char* eol =
+			static_cast<const char*>(std::memchr(p, '\n', end - p));
+		bounds[t] = eol ? eol + 1 : end;
+	}
+
+	std::vector<std::vector<std::vector<float>>> partial(
+		num_threads, std::vector<std::vector<float>>(nCols));
+	std::vector<size_t> nRows(num_threads, 0);
+	std::vector<std::thread> threads;
+	for (unsigned int t = 1; t < num_threads; t++)
+		threads.emplace_back([&, t]() {
+			nRows[t] = parseRows(bounds[t], bounds[t + 1], nCols, partial[t]);
+		});
+	nRows[0] = parseRows(bounds[0], bounds[1], nCols, out);
+	for (auto& th : threads) th.join();
+
+	size_t nTotal = nRows[0];
+	for (unsigned int t = 1; t < num_threads; t++)
+	{
+		for (size_t c = 0; c < nCols; c++)
+			out[c].insert(
+				out[c].end(), partial[t][c].begin(), partial[t][c].end());
+		nTotal += nRows[t];
+	}
+	return nTotal;
+}
+
+CPointCloudStreamIO::block_callback_t CPointCloudStreamIO::appendTo(
+	CPointsMap& m)
+{
+	return [&m](const float* xs, const float* ys, const float* zs, size_t n) {
+		m.insertPoints(xs, ys, zs, n);
+	};
+}
+
+/*---------------------------------------------------------------
+						readTextXYZ
+ ---------------------------------------------------------------*/
+uint64_t CPointCloudStreamIO::readTextXYZ(
+	const std::string& fileName, const block_callback_t& callback,
+	bool is_3D, size_t blockSize, unsigned int num_threads)
+{
+	MRPT_START
+	ASSERT_(blockSize > 0);
+	auto f = openForReading(fileName);
+	return readTextRows(
+		f.get(), 0, ALL_LINES, is_3D ? 3 : 2, 0, 1, is_3D ? 2 : -1, blockSize,
+		num_threads, callback);
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+							readPCD
+ ---------------------------------------------------------------*/
+uint64_t CPointCloudStreamIO::readPCD(
+	const std::string& fileName, const block_callback_t& callback,
+	size_t blockSize, unsigned int num_threads)
+{
+	MRPT_START
+	ASSERT_(blockSize > 0);
+	auto f = openForReading(fileName);
+
+	std::vector<std::string> fields, types;
+	std::vector<uint64_t> sizes, counts;
+	uint64_t width = 0, height = 1, nPoints = 0;
+	bool hasPoints = false;
+	std::string data;
+	for (std::string line; data.empty();)
+	{
+		if (!readLine(f.get(), line))
+			THROW_EXCEPTION_FMT(
+				"Missing DATA entry in PCD header of `%s`", fileName.c_str());
+		auto toks = tokenize(line);
+		if (toks.empty() || toks[0][0] == '#') continue;
+		const std::string key = toks[0];
+		toks.erase(toks.begin());
+		if (key == "FIELDS")
+			fields = toks;
+		else if (key == "TYPE")
+			types = toks;
+		else if (key == "SIZE")
+			for (const auto& t : toks) sizes.push_back(toUInt(t));
+		else if (key == "COUNT")
+			for (const auto& t : toks) counts.push_back(toUInt(t));
+		else if (key == "WIDTH" && !toks.empty())
+			width = toUInt(toks[0]);
+		else if (key == "HEIGHT" && !toks.empty())
+			height = toUInt(toks[0]);
+		else if (key == "POINTS" && !toks.empty())
+		{
+			nPoints = toUInt(toks[0]);
+			hasPoints = true;
+		}
+		else if (key == "DATA" && !toks.empty())
+			data = toks[0];
+	}
+	if (!hasPoints) nPoints = width * height;
+	if (counts.empty()) counts.assign(fields.size(), 1);
+	if (sizes.size() != fields.size() || types.size() != fields.size() ||
+		counts.size() != fields.size())
+		THROW_EXCEPTION_FMT(
+			"Inconsistent FIELDS, SIZE, TYPE, COUNT in PCD file `%s`",
+			fileName.c_str());
+
+	// Find the x,y,z fields, and their position in each point record:
+	int column[3] = {-1, -1, -1};
+	TRecordLayout L;
+	size_t nColumns = 0;
+	for (size_t i = 0; i < fields.size(); i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			if (fields[i] != COORD_NAMES[k]) continue;
+			column[k] = static_cast<int>(nColumns);
+			L.offset[k] = L.recordSize;
+			L.type[k] = pcdScalar(types[i][0], sizes[i]);
+			if (L.type[k] == TScalar::NONE)
+				THROW_EXCEPTION_FMT(
+					"Unsupported type for field `%s` in PCD file `%s`",
+					fields[i].c_str(), fileName.c_str());
+		}
+		nColumns += counts[i];
+		L.recordSize += sizes[i] * counts[i];
+	}
+	if (column[0] < 0 || column[1] < 0)
+		THROW_EXCEPTION_FMT(
+			"PCD file `%s` has no x,y fields", fileName.c_str());
+
+	if (data == "ascii")
+	{
+		return readTextRows(
+			f.get(), 0, ALL_LINES,
+			static_cast<size_t>(*std::max_element(column, column + 3)) + 1,
+			column[0], column[1], column[2], blockSize, num_threads,
+			callback);
+	}
+	else if (data == "binary")
+		return readBinaryRecords(f.get(), L, nPoints, blockSize, callback);
+	else
+		THROW_EXCEPTION_FMT(
+			"Unsupported PCD data format `%s` in `%s`", data.c_str(),
+			fileName.c_str());
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+							readPLY
+ ---------------------------------------------------------------*/
+uint64_t CPointCloudStreamIO::readPLY(
+	const std::string& fileName, const block_callback_t& callback,
+	size_t blockSize, unsigned int num_threads)
+{
+	MRPT_START
+	ASSERT_(blockSize > 0);
+	auto f = openForReading(fileName);
+
+	struct TElement
+	{
+		std::string name;
+		uint64_t count{0};
+		bool hasLists{false};
+		std::vector<std::string> propNames;
+		std::vector<TScalar> propTypes;
+	};
+	std::vector<TElement> elements;
+	std::string format;
+	std::string line;
+	if (!readLine(f.get(), line) || line != "ply")
+		THROW_EXCEPTION_FMT("`%s` is not a PLY file", fileName.c_str());
+	for (;;)
+	{
+		if (!readLine(f.get(), line))
+			THROW_EXCEPTION_FMT(
+				"Unexpected end of PLY header in `%s`", fileName.c_str());
+		const auto toks = tokenize(line);
+		if (toks.empty()) continue;
+		if (toks[0] == "end_header") break;
+		if (toks[0] == "format" && toks.size() >= 2)
+			format = toks[1];
+		else if (toks[0] == "element" && toks.size() >= 3)
+		{
+			elements.emplace_back();
+			elements.back().name = toks[1];
+			elements.back().count = toUInt(toks[2]);
+		}
+		else if (toks[0] == "property" && !elements.empty())
+		{
+			auto& e = elements.back();
+			if (toks.size() >= 2 && toks[1] == "list")
+				e.hasLists = true;
+			else if (toks.size() >= 3)
+			{
+				e.propTypes.push_back(plyScalar(toks[1]));
+				e.propNames.push_back(toks[2]);
+			}
+		}
+	}
+	if (format != "ascii" && format != "binary_little_endian")
+		THROW_EXCEPTION_FMT(
+			"Unsupported PLY format `%s` in `%s`", format.c_str(),
+			fileName.c_str());
+	const bool binary = (format != "ascii");
+
+	// Elements before the vertices are skipped:
+	uint64_t skipLines = 0, skipBytes = 0;
+	size_t iVertex = 0;
+	for (; iVertex < elements.size(); iVertex++)
+	{
+		const auto& e = elements[iVertex];
+		if (e.name == "vertex") break;
+		if (binary && e.hasLists)
+			THROW_EXCEPTION_FMT(
+				"Unsupported PLY file `%s`: variable-length elements before "
+				"the vertices",
+				fileName.c_str());
+		skipLines += e.count;
+		size_t recordSize = 0;
+		for (const auto t : e.propTypes) recordSize += scalarSize(t);
+		skipBytes += e.count * recordSize;
+	}
+	if (iVertex == elements.size())
+		THROW_EXCEPTION_FMT("PLY file `%s` has no vertices", fileName.c_str());
+	const auto& vertex = elements[iVertex];
+	if (vertex.hasLists)
+		THROW_EXCEPTION_FMT(
+			"Unsupported PLY file `%s`: vertices with list properties",
+			fileName.c_str());
+
+	int column[3] = {-1, -1, -1};
+	TRecordLayout L;
+	for (size_t i = 0; i < vertex.propNames.size(); i++)
+	{
+		if (vertex.propTypes[i] == TScalar::NONE)
+			THROW_EXCEPTION_FMT(
+				"Unsupported PLY property type in `%s`", fileName.c_str());
+		for (int k = 0; k < 3; k++)
+		{
+			if (vertex.propNames[i] != COORD_NAMES[k]) continue;
+			column[k] = static_cast<int>(i);
+			L.offset[k] = L.recordSize;
+			L.type[k] = vertex.propTypes[i];
+		}
+		L.recordSize += scalarSize(vertex.propTypes[i]);
+	}
+	if (column[0] < 0 || column[1] < 0)
+		THROW_EXCEPTION_FMT(
+			"PLY file `%s` has no x,y vertex properties", fileName.c_str());
+
+	if (!binary)
+		return readTextRows(
+			f.get(), skipLines, vertex.count,
+			static_cast<size_t>(*std::max_element(column, column + 3)) + 1,
+			column[0], column[1], column[2], blockSize, num_threads,
+			callback);
+
+	std::vector<uint8_t> dummy(64 * 1024);
+	while (skipBytes > 0)
+	{
+		const size_t n =
+			static_cast<size_t>(std::min<uint64_t>(skipBytes, dummy.size()));
+		if (std::fread(dummy.data(), 1, n, f.get()) != n)
+			THROW_EXCEPTION_FMT(
+				"Unexpected end of PLY file `%s`", fileName.c_str());
+		skipBytes -= n;
+	}
+	return readBinaryRecords(f.get(), L, vertex.count, blockSize, callback);
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+					CPointCloudStreamWriter
+ ---------------------------------------------------------------*/
+CPointCloudStreamWriter::CPointCloudStreamWriter(
+	const std::string& fileName, TFormat format)
+{
+	open(fileName, format);
+}
+
+CPointCloudStreamWriter::~CPointCloudStreamWriter()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+	}
+}
+
+void CPointCloudStreamWriter::open(const std::string& fileName, TFormat format)
+{
+	MRPT_START
+	close();
+#if MRPT_IS_BIG_ENDIAN
+	if (format == PCD_BINARY || format == PLY_BINARY)
+		THROW_EXCEPTION(
+			"Binary point cloud files require a little endian host");
+#endif
+	m_file = std::fopen(fileName.c_str(), "wb");
+	if (!m_file)
+		THROW_EXCEPTION_FMT("Cannot create file `%s`", fileName.c_str());
+	m_format = format;
+	m_count = 0;
+	if (!writeHeader())
+		THROW_EXCEPTION_FMT("Error writing to `%s`", fileName.c_str());
+	MRPT_END
+}
+
+bool CPointCloudStreamWriter::writeHeader()
+{
+	// The number of points is written with a fixed width, so the header can
+	// be overwritten in close() with the final count:
+	const auto n = static_cast<unsigned long long>(m_count);
+	const bool binary = (m_format == PCD_BINARY || m_format == PLY_BINARY);
+	int ret;
+	if (m_format == PCD_ASCII || m_format == PCD_BINARY)
+		ret = std::fprintf(
+			m_file,
+			"# .PCD v0.7 - Point Cloud Data file format\n"
+			"VERSION 0.7\n"
+			"FIELDS x y z\n"
+			"SIZE 4 4 4\n"
+			"TYPE F F F\n"
+			"COUNT 1 1 1\n"
+			"WIDTH %010llu\n"
+			"HEIGHT 1\n"
+			"VIEWPOINT 0 0 0 1 0 0 0\n"
+			"POINTS %010llu\n"
+			"DATA %s\n",
+			n, n, binary ? "binary" : "ascii");
+	else
+		ret = std::fprintf(
+			m_file,
+			"ply\n"
+			"format %s 1.0\n"
+			"comment Generated by MRPT\n"
+			"element vertex %010llu\n"
+			"property float x\n"
+			"property float y\n"
+			"property float z\n"
+			"end_header\n",
+			binary ? "binary_little_endian" : "ascii", n);
+	return ret > 0;
+}
+
+void CPointCloudStreamWriter::write(
+	const float* xs, const float* ys, const float* zs, size_t n)
+{
+	MRPT_START
+	ASSERT_(m_file);
+	// Formats store the number of points as a 32bit integer:
+	ASSERT_BELOW_(m_count + n, uint64_t(std::numeric_limits<uint32_t>::max()));
+
+	const size_t BLOCK = 4096;
+	const bool binary = (m_format == PCD_BINARY || m_format == PLY_BINARY);
+	for (size_t i0 = 0; i0 < n; i0 += BLOCK)
+	{
+		const size_t nb = std::min(BLOCK, n - i0);
+		size_t len = 0;
+		if (binary)
+		{
+			m_buf.resize(nb * 3 * sizeof(float));
+			float* dst = reinterpret_cast<float*>(m_buf.data());
+			for (size_t i = i0; i < i0 + nb; i++)
+			{
+				*dst++ = xs[i];
+				*dst++ = ys[i];
+				*dst++ = zs[i];
+			}
+			len = m_buf.size();
+		}
+		else
+		{
+			const size_t MAX_LINE = 3 * 16 + 3;
+			m_buf.resize(nb * MAX_LINE + 1);
+			char* const buf = m_buf.data();
+			char *p = buf, *const end = buf + m_buf.size();
+			for (size_t i = i0; i < i0 + nb; i++)
+			{
+				p = writeFloat(p, end, xs[i], ' ');
+				p = writeFloat(p, end, ys[i], ' ');
+				p = writeFloat(p, end, zs[i], '\n');
+			}
+			len = p - buf;
+		}
+		if (std::fwrite(m_buf.data(), 1, len, m_file) != len)
+			THROW_EXCEPTION("Error writing point cloud file");
+	}
+	m_count += n;
+	MRPT_END
+}
+
+void CPointCloudStreamWriter::write(const CPointsMap& m)
+{
+	write(
+		m.getPointsBufferRef_x().data(), m.getPointsBufferRef_y().data(),
+		m.getPointsBufferRef_z().data(), m.size());
+}
+
+void CPointCloudStreamWriter::close()
+{
+	if (!m_file) return;
+	FILE* f = m_file;
+	const bool ok = (std::fseek(f, 0, SEEK_SET) == 0) && writeHeader();
+	m_file = nullptr;
+	if (std::fclose(f) != 0 || !ok)
+		THROW_EXCEPTION("Error closing point cloud file");
+}
@@ -0,0 +1,225 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/maps/CPointCloudStreamIO.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/system/filesystem.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <fstream>
+
+using namespace mrpt::maps;
+
+namespace
+{
+struct TCloud
+{
+	std::vector<float> x, y, z;
+	size_t maxBlock = 0;
+
+	CPointCloudStreamIO::block_callback_t appender()
+	{
+		return [this](
+				   const float* xs, const float* ys, const float* zs,
+				   size_t n) {
+			x.insert(x.end(), xs, xs + n);
+			y.insert(y.end(), ys, ys + n);
+			z.insert(z.end(), zs, zs + n);
+			maxBlock = std::max(maxBlock, n);
+		};
+	}
+};
+
+TCloud randomCloud(size_t N)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(1234);
+	TCloud c;
+	for (size_t i = 0; i < N; i++)
+	{
+		c.x.push_back(rng.drawUniform(-1000.0, 1000.0));
+		c.y.push_back(rng.drawUniform(-1e-3, 1e-3));
+		c.z.push_back(rng.drawUniform(-10.0, 10.0));
+	}
+	return c;
+}
+
+void writeFile(const std::string& fil, const std::string& contents)
+{
+	std::ofstream f(fil, std::ios::binary);
+	f << contents;
+}
+}  // namespace
+
+TEST(CPointCloudStreamIO, writeAndReadBack)
+{
+	const size_t N = 10007, BLOCK = 1000;
+	const TCloud c = randomCloud(N);
+
+	for (const auto fmt :
+		 {CPointCloudStreamWriter::PCD_ASCII,
+		  CPointCloudStreamWriter::PCD_BINARY,
+		  CPointCloudStreamWriter::PLY_ASCII,
+		  CPointCloudStreamWriter::PLY_BINARY})
+	{
+		const bool isPCD = (fmt == CPointCloudStreamWriter::PCD_ASCII ||
+							fmt == CPointCloudStreamWriter::PCD_BINARY);
+		const bool binary = (fmt == CPointCloudStreamWriter::PCD_BINARY ||
+							 fmt == CPointCloudStreamWriter::PLY_BINARY);
+		const std::string fil =
+			mrpt::system::getTempFileName() + (isPCD ? ".pcd" : ".ply");
+		{
+			CPointCloudStreamWriter w(fil, fmt);
+			// Written in two parts:
+			w.write(c.x.data(), c.y.data(), c.z.data(), 5000);
+			w.write(
+				c.x.data() + 5000, c.y.data() + 5000, c.z.data() + 5000,
+				N - 5000);
+			EXPECT_EQ(w.getPointCount(), N);
+		}
+
+		TCloud r;
+		const uint64_t nRead =
+			isPCD ? CPointCloudStreamIO::readPCD(fil, r.appender(), BLOCK)
+				  : CPointCloudStreamIO::readPLY(fil, r.appender(), BLOCK);
+		mrpt::system::deleteFile(fil);
+
+		EXPECT_EQ(nRead, N);
+		ASSERT_EQ(r.x.size(), N);
+		EXPECT_LE(r.maxBlock, BLOCK);
+		for (size_t i = 0; i < N; i++)
+		{
+			if (binary)
+			{
+				EXPECT_EQ(r.x[i], c.x[i]);
+				EXPECT_EQ(r.y[i], c.y[i]);
+				EXPECT_EQ(r.z[i], c.z[i]);
+			}
+			else
+			{
+				EXPECT_FLOAT_EQ(r.x[i], c.x[i]);
+				EXPECT_FLOAT_EQ(r.y[i], c.y[i]);
+				EXPECT_FLOAT_EQ(r.z[i], c.z[i]);
+			}
+		}
+	}
+}
+
+TEST(CPointCloudStreamIO, readPCDWithOtherFields)
+{
+	const std::string fil = mrpt::system::getTempFileName() + ".pcd";
+	writeFile(
+		fil,
+		"# .PCD v0.7\n"
+		"VERSION 0.7\n"
+		"FIELDS intensity x y z normal\n"
+		"SIZE 4 8 8 8 4\n"
+		"TYPE U F F F F\n"
+		"COUNT 1 1 1 1 3\n"
+		"WIDTH 2\n"
+		"HEIGHT 1\n"
+		"POINTS 2\n"
+		"DATA ascii\n"
+		"7 1.5 -2 3e2 0 0 1\n"
+		"9 nan 0.25 -.5 0 1 0\n");
+	TCloud r;
+	EXPECT_EQ(CPointCloudStreamIO::readPCD(fil, r.appender()), 2U);
+	mrpt::system::deleteFile(fil);
+	ASSERT_EQ(r.x.size(), 2U);
+	EXPECT_FLOAT_EQ(r.x[0], 1.5f);
+	EXPECT_FLOAT_EQ(r.y[0], -2.0f);
+	EXPECT_FLOAT_EQ(r.z[0], 300.0f);
+	EXPECT_TRUE(std::isnan(r.x[1]));
+	EXPECT_FLOAT_EQ(r.y[1], 0.25f);
+	EXPECT_FLOAT_EQ(r.z[1], -0.5f);
+}
+
+TEST(CPointCloudStreamIO, readPLYSkipsFaces)
+{
+	const std::string fil = mrpt::system::getTempFileName() + ".ply";
+	writeFile(
+		fil,
+		"ply\r\n"
+		"format ascii 1.0\r\n"
+		"element vertex 3\r\n"
+		"property double z\r\n"
+		"property double y\r\n"
+		"property double x\r\n"
+		"element face 1\r\n"
+		"property list uchar int vertex_indices\r\n"
+		"end_header\r\n"
+		"3 2 1\r\n"
+		"6 5 4\r\n"
+		"9 8 7\r\n"
+		"3 0 1 2\r\n");
+	TCloud r;
+	EXPECT_EQ(CPointCloudStreamIO::readPLY(fil, r.appender()), 3U);
+	mrpt::system::deleteFile(fil);
+	ASSERT_EQ(r.x.size(), 3U);
+	EXPECT_EQ(r.x, std::vector<float>({1, 4, 7}));
+	EXPECT_EQ(r.y, std::vector<float>({2, 5, 8}));
+	EXPECT_EQ(r.z, std::vector<float>({3, 6, 9}));
+}
+
+TEST(CPointCloudStreamIO, parseTextColumns)
+{
+	const std::string txt =
+		"% comment\n"
+		"1 2 3\n"
+		"  -1.25e-1\t+2.5E1 , 1000000000000000000000 extra\r\n"
+		"4 5\n"
+		"7 8 9x\n"
+		"\n"
+		"0.1 0.2 0.3";
+	std::vector<std::vector<float>> cols;
+	ASSERT_EQ(
+		CPointCloudStreamIO::parseTextColumns(
+			txt.data(), txt.size(), 3, cols),
+		3U);
+	EXPECT_EQ(cols[0], std::vector<float>({1.0f, -0.125f, 0.1f}));
+	EXPECT_EQ(cols[1], std::vector<float>({2.0f, 25.0f, 0.2f}));
+	EXPECT_EQ(cols[2], std::vector<float>({3.0f, 1e21f, 0.3f}));
+
+	// Parallel parsing gives the same result, in the same order:
+	std::string big;
+	for (int i = 0; i < 300000; i++)
+		big += std::to_string(i) + " " + std::to_string(-i) + ".5\n";
+	std::vector<std::vector<float>> c1, c8;
+	const auto n1 = CPointCloudStreamIO::parseTextColumns(
+		big.data(), big.size(), 2, c1, 1);
+	const auto n8 = CPointCloudStreamIO::parseTextColumns(
+		big.data(), big.size(), 2, c8, 8);
+	EXPECT_EQ(n1, 300000U);
+	EXPECT_EQ(n8, n1);
+	EXPECT_EQ(c1, c8);
+}
+
+TEST(CPointCloudStreamIO, pointsMapFiles)
+{
+	const TCloud c = randomCloud(1000);
+	CSimplePointsMap m;
+	m.insertPoints(c.x.data(), c.y.data(), c.z.data(), c.x.size());
+	ASSERT_EQ(m.size(), c.x.size());
+
+	const std::string fil = mrpt::system::getTempFileName() + ".pcd";
+	ASSERT_TRUE(m.savePCDFile(fil, true));
+	CSimplePointsMap m2;
+	ASSERT_TRUE(m2.loadPCDFile(fil));
+	mrpt::system::deleteFile(fil);
+	EXPECT_EQ(m2.getPointsBufferRef_x(), m.getPointsBufferRef_x());
+	EXPECT_EQ(m2.getPointsBufferRef_z(), m.getPointsBufferRef_z());
+
+	const std::string txt = mrpt::system::getTempFileName() + ".txt";
+	ASSERT_TRUE(m.save3D_to_text_file(txt));
+	CSimplePointsMap m3;
+	ASSERT_TRUE(m3.load3D_from_text_file(txt));
+	mrpt::system::deleteFile(txt);
+	EXPECT_EQ(m3.size(), m.size());
+}
@@ -13,15 +13,19 @@
 #include <mrpt/system/CTicTac.h>
 #include <mrpt/system/CTimeLogger.h>
 #include <mrpt/system/os.h>
+#include <mrpt/system/filesystem.h>
 #include <mrpt/math/geometry.h>
 #include <mrpt/serialization/CArchive.h>
 
 #include <mrpt/maps/CPointsMap.h>
+#include <mrpt/maps/CPointCloudStreamIO.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 
 #include <mrpt/opengl/CPointCloud.h>
 #include <mrpt/opengl/CPointCloudColoured.h>
 
+#include <iostream>
+
 // Observations:
 #include <mrpt/obs/CObservationRange.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
@@ -112,53 +116,22 @@ bool CPointsMap::load2Dor3D_from_text_file(
 {
 	MRPT_START
 
-	mark_as_modified();
-
-	FILE* f = os::fopen(file.c_str(), "rt");
-	if (!f) return false;
-
-	char str[1024];
-	char *ptr, *ptr1, *ptr2, *ptr3;
+	if (!mrpt::system::fileExists(file)) return false;
 
 	// Clear current map:
 	this->clear();
 
-	while (!feof(f))
+	try
 	{
-		// Read one string line:
-		str[0] = 0;
-		if (!fgets(str, sizeof(str), f)) break;
-
-		// Find the first digit:
-		ptr = str;
-		while (ptr[0] && (ptr[0] == ' ' || ptr[0] == '\t' || ptr[0] == '\r' ||
-						  ptr[0] == '\n'))
-			ptr++;
-
-		// And try to parse it:
-		float xx = strtod(ptr, &ptr1);
-		if (ptr1 != str)
-		{
-			float yy = strtod(ptr1, &ptr2);
-			if (ptr2 != ptr1)
-			{
-				if (!is_3D)
-				{
-					this->insertPoint(xx, yy, 0);
-				}
-				else
-				{
-					float zz = strtod(ptr2, &ptr3);
-					if (ptr3 != ptr2)
-					{
-						this->insertPoint(xx, yy, zz);
-					}
-				}
-			}
-		}
+		CPointCloudStreamIO::readTextXYZ(
+			file, CPointCloudStreamIO::appendTo(*this), is_3D);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CPointsMap::load2Dor3D_from_text_file] " << e.what()
+				  << std::endl;
+		return false;
 	}
-
-	os::fclose(f);
 	return true;
 
 	MRPT_END
@@ -568,13 +541,14 @@ void CPointsMap::changeCoordinatesReference(const CPose2D& newBase)
 {
 	const size_t N = m_x.size();
 
-	const CPose3D newBase3D(newBase);
-
-	for (size_t i = 0; i < N; i++)
-		newBase3D.composePoint(
-			m_x[i], m_y[i], m_z[i],  // In
-			m_x[i], m_y[i], m_z[i]  // Out
+	if (N)
+	{
+		const CPose3D newBase3D(newBase);
+		newBase3D.composePoints(
+			&m_x[0], &m_y[0], &m_z[0],  // In
+			&m_x[0], &m_y[0], &m_z[0], N  // Out
 		);
+	}
 
 	mark_as_modified();
 }
@@ -586,10 +560,10 @@ void CPointsMap::changeCoordinatesReference(const CPose3D& newBase)
 {
 	const size_t N = m_x.size();
 
-	for (size_t i = 0; i < N; i++)
-		newBase.composePoint(
-			m_x[i], m_y[i], m_z[i],  // In
-			m_x[i], m_y[i], m_z[i]  // Out
+	if (N)
+		newBase.composePoints(
+			&m_x[0], &m_y[0], &m_z[0],  // In
+			&m_x[0], &m_y[0], &m_z[0], N  // Out
 		);
 
 	mark_as_modified();
@@ -1101,27 +1075,44 @@ void CPointsMap::determineMatching3D(
 	vector<float> x_locals(nLocalPoints), y_locals(nLocalPoints),
 		z_locals(nLocalPoints);
 
-	for (unsigned int localIdx = params.offset_other_map_points;
-		 localIdx < nLocalPoints;
-		 localIdx += params.decimation_other_map_points)
+	const size_t off = params.offset_other_map_points;
+	if (params.decimation_other_map_points == 1 && off < nLocalPoints)
 	{
-		float x_local, y_local, z_local;
-		otherMapPose.composePoint(
-			otherMap->m_x[localIdx], otherMap->m_y[localIdx],
-			otherMap->m_z[localIdx], x_local, y_local, z_local);
-
-		x_locals[localIdx] = x_local;
-		y_locals[localIdx] = y_local;
-		z_locals[localIdx] = z_local;
-
-		// Find the bounding box:
-		local_x_min = min(local_x_min, x_local);
-		local_x_max = max(local_x_max, x_local);
-		local_y_min = min(local_y_min, y_local);
-		local_y_max = max(local_y_max, y_local);
-		local_z_min = min(local_z_min, z_local);
-		local_z_max = max(local_z_max, z_local);
+		// All points from the offset on: use the batched transform
+		TPoint3Df bb_min, bb_max;
+		otherMapPose.composePoints(
+			&otherMap->m_x[off], &otherMap->m_y[off], &otherMap->m_z[off],
+			&x_locals[off], &y_locals[off], &z_locals[off], nLocalPoints - off,
+			&bb_min, &bb_max);
+		local_x_min = bb_min.x;
+		local_x_max = bb_max.x;
+		local_y_min = bb_min.y;
+		local_y_max = bb_max.y;
+		local_z_min = bb_min.z;
+		local_z_max = bb_max.z;
 	}
+	else
+		for (unsigned int localIdx = params.offset_other_map_points;
+			 localIdx < nLocalPoints;
+			 localIdx += params.decimation_other_map_points)
+		{
+			float x_local, y_local, z_local;
+			otherMapPose.composePoint(
+				otherMap->m_x[localIdx], otherMap->m_y[localIdx],
+				otherMap->m_z[localIdx], x_local, y_local, z_local);
+
+			x_locals[localIdx] = x_local;
+			y_locals[localIdx] = y_local;
+			z_locals[localIdx] = z_local;
+
+			// Find the bounding box:
+			local_x_min = min(local_x_min, x_local);
+			local_x_max = max(local_x_max, x_local);
+			local_y_min = min(local_y_min, y_local);
+			local_y_max = max(local_y_max, y_local);
+			local_z_min = min(local_z_min, z_local);
+			local_z_max = max(local_z_max, z_local);
+		}
 
 	// Find the bounding box:
 	float global_x_min, global_x_max, global_y_min, global_y_max, global_z_min,
@@ -1693,34 +1684,47 @@ void CPointsMap::addFrom(const CPointsMap& anotherMap)
 bool CPointsMap::savePCDFile(
 	const std::string& filename, bool save_as_binary) const
 {
-#if MRPT_HAS_PCL
-	pcl::PointCloud<pcl::PointXYZ> cloud;
-	this->getPCLPointCloud(cloud);
-
-	return 0 == pcl::io::savePCDFile(filename, cloud, save_as_binary);
-
-#else
-	MRPT_UNUSED_PARAM(filename);
-	MRPT_UNUSED_PARAM(save_as_binary);
-	THROW_EXCEPTION("Operation not available: MRPT was built without PCL");
-#endif
+	try
+	{
+		CPointCloudStreamWriter f(
+			filename, save_as_binary ? CPointCloudStreamWriter::PCD_BINARY
+									 : CPointCloudStreamWriter::PCD_ASCII);
+		f.write(*this);
+		f.close();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[CPointsMap::savePCDFile] " << e.what() << std::endl;
+		return false;
+	}
+	return true;
 }
 
-/** Load the point cloud from a PCL PCD file (requires MRPT built against PCL)
+/** Load the point cloud from a PCL PCD file
  * \return false on any error */
 bool CPointsMap::loadPCDFile(const std::string& filename)
 {
+	this->clear();
+	try
+	{
+		CPointCloudStreamIO::readPCD(
+			filename, CPointCloudStreamIO::appendTo(*this));
+	}
+	catch (const std::exception& e)
+	{
+		this->clear();
 #if MRPT_HAS_PCL
-	pcl::PointCloud<pcl::PointXYZ> cloud;
-	if (0 != pcl::io::loadPCDFile(filename, cloud)) return false;
-
-	this->getPCLPointCloud(cloud);
-
-	return true;
+		// Formats not supported by readPCD(), e.g. `binary_compressed`:
+		MRPT_UNUSED_PARAM(e);
+		pcl::PointCloud<pcl::PointXYZ> cloud;
+		if (0 != pcl::io::loadPCDFile(filename, cloud)) return false;
+		this->setFromPCLPointCloud(cloud);
 #else
-	MRPT_UNUSED_PARAM(filename);
-	THROW_EXCEPTION("Operation not available: MRPT was built without PCL");
+		std::cerr << "[CPointsMap::loadPCDFile] " << e.what() << std::endl;
+		return false;
 #endif
+	}
+	return true;
 }
 
 /*---------------------------------------------------------------
@@ -1749,6 +1753,21 @@ void CPointsMap::applyDeletionMask(const std::vector<bool>& mask)
 	mark_as_modified();
 }
 
+/*---------------------------------------------------------------
+					insertPoints
+ ---------------------------------------------------------------*/
+void CPointsMap::insertPoints(
+	const float* xs, const float* ys, const float* zs, size_t n)
+{
+	if (!n) return;
+	const size_t N = size();
+	this->resize(N + n);
+	std::copy(xs, xs + n, &m_x[N]);
+	std::copy(ys, ys + n, &m_y[N]);
+	std::copy(zs, zs + n, &m_z[N]);
+	mark_as_modified();
+}
+
 /*---------------------------------------------------------------
 					insertAnotherMap
  ---------------------------------------------------------------*/
@@ -1761,20 +1780,12 @@ void CPointsMap::insertAnotherMap(
 	// Set the new size:
 	this->resize(N_this + N_other);
 
-	mrpt::math::TPoint3Df pt;
-	size_t src, dst;
-	for (src = 0, dst = N_this; src < N_other; src++, dst++)
-	{
-		// Load the next point:
-		otherMap->getPointFast(src, pt.x, pt.y, pt.z);
-
-		// Translation:
-		double gx, gy, gz;
-		otherPose.composePoint(pt.x, pt.y, pt.z, gx, gy, gz);
-
-		// Add to this map:
-		this->setPointFast(dst, gx, gy, gz);
-	}
+	// Transform all the points at once, directly into the new slots (all
+	// setPointFast() implementations only store x,y,z):
+	if (N_other)
+		otherPose.composePoints(
+			&otherMap->m_x[0], &otherMap->m_y[0], &otherMap->m_z[0],
+			&m_x[N_this], &m_y[N_this], &m_z[N_this], N_other);
 
 	// Also copy other data fields (color, ...)
 	addFrom_classSpecific(*otherMap, N_this);
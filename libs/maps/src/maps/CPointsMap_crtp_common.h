@@ -30,7 +30,9 @@ struct loadFromRangeImpl
 		// underwent a move or copy operator, which may change the reserved mem
 		// of std::vector's, which need to be >=4*N for SEE instructions to work
 		// without "undefined behavior" of accessing out of vector memory:
-		const_cast<mrpt::obs::CObservation2DRangeScan&>(rangeScan).resizeScan(
+		// Only the capacity is touched, so this does not discard the scan
+		// cached points map, which may be the very map being filled here.
+		const_cast<mrpt::obs::CObservation2DRangeScan&>(rangeScan).reserveScan(
 			rangeScan.getScanSize());
 
 		// If robot pose is supplied, compute sensor pose relative to it.
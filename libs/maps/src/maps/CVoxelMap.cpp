@@ -0,0 +1,1122 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h"  // Precomp header
+
+#include <mrpt/maps/CVoxelMap.h>
+#include <mrpt/maps/CPointsMap.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CObservation3DRangeScan.h>
+#include <mrpt/obs/CObservationVelodyneScan.h>
+#include <mrpt/opengl/COpenGLScene.h>
+#include <mrpt/serialization/CArchive.h>
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace mrpt;
+using namespace mrpt::maps;
+using namespace mrpt::img;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace mrpt::math;
+using namespace mrpt::opengl;
+
+//  =========== Begin of Map definition ============
+MAP_DEFINITION_REGISTER("CVoxelMap,voxelMap", mrpt::maps::CVoxelMap)
+
+CVoxelMap::TMapDefinition::TMapDefinition() = default;
+void CVoxelMap::TMapDefinition::loadFromConfigFile_map_specific(
+	const mrpt::config::CConfigFileBase& source,
+	const std::string& sectionNamePrefix)
+{
+	// [<sectionNamePrefix>+"_creationOpts"]
+	const std::string sSectCreation =
+		sectionNamePrefix + string("_creationOpts");
+	MRPT_LOAD_CONFIG_VAR(resolution, double, source, sSectCreation);
+
+	insertionOpts.loadFromConfigFile(
+		source, sectionNamePrefix + string("_insertOpts"));
+	likelihoodOpts.loadFromConfigFile(
+		source, sectionNamePrefix + string("_likelihoodOpts"));
+}
+
+void CVoxelMap::TMapDefinition::dumpToTextStream_map_specific(
+	std::ostream& out) const
+{
+	LOADABLEOPTS_DUMP_VAR(resolution, double);
+
+	this->insertionOpts.dumpToTextStream(out);
+	this->likelihoodOpts.dumpToTextStream(out);
+}
+
+mrpt::maps::CMetricMap* CVoxelMap::internal_CreateFromMapDefinition(
+	const mrpt::maps::TMetricMapInitializer& _def)
+{
+	const CVoxelMap::TMapDefinition& def =
+		*dynamic_cast<const CVoxelMap::TMapDefinition*>(&_def);
+	auto* obj = new CVoxelMap(def.resolution);
+	obj->insertionOptions = def.insertionOpts;
+	obj->likelihoodOptions = def.likelihoodOpts;
+	return obj;
+}
+//  =========== End of Map definition Block =========
+
+IMPLEMENTS_SERIALIZABLE(CVoxelMap, CMetricMap, mrpt::maps)
+
+namespace
+{
+// Voxel coordinates are stored as unsigned integers of 21 bits, shifted by
+// this offset. Block coordinates are those of their voxels / BLOCK_SIDE.
+constexpr int32_t VOXEL_OFFSET = 1 << 20;
+constexpr unsigned int BLOCK_BITS = 3;
+static_assert(
+	(1U << BLOCK_BITS) == CVoxelMap::BLOCK_SIDE, "Wrong BLOCK_BITS");
+constexpr unsigned int BLOCK_COORD_BITS = 21 - BLOCK_BITS;
+constexpr unsigned int SHARD_BITS = 6;
+
+inline uint64_t blockKey(const uint32_t v[3])
+{
+	return uint64_t(v[0] >> BLOCK_BITS) |
+		   (uint64_t(v[1] >> BLOCK_BITS) << BLOCK_COORD_BITS) |
+		   (uint64_t(v[2] >> BLOCK_BITS) << (2 * BLOCK_COORD_BITS));
+}
+/** The coordinates of the first voxel of a block */
+inline void blockKeyToVoxel(const uint64_t key, uint32_t v[3])
+{
+	const uint64_t mask = (uint64_t(1) << BLOCK_COORD_BITS) - 1;
+	for (int a = 0; a < 3; a++)
+		v[a] = static_cast<uint32_t>((key >> (a * BLOCK_COORD_BITS)) & mask)
+			   << BLOCK_BITS;
+}
+inline unsigned int shardOf(const uint64_t key)
+{
+	// Top bits of the same hash than CVoxelMap::TBlockKeyHash
+	return static_cast<unsigned int>(
+		(key * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - SHARD_BITS));
+}
+/** Index of a voxel within its block */
+inline unsigned int voxelIndex(const uint32_t v[3])
+{
+	const uint32_t m = CVoxelMap::BLOCK_SIDE - 1;
+	return (v[0] & m) | ((v[1] & m) << BLOCK_BITS) |
+		   ((v[2] & m) << (2 * BLOCK_BITS));
+}
+/** A voxel and whether it's updated as occupied, packed in 64 bits */
+inline uint64_t packVoxelUpdate(const uint32_t v[3], bool occupied)
+{
+	return uint64_t(v[0]) | (uint64_t(v[1]) << 21) | (uint64_t(v[2]) << 42) |
+		   (uint64_t(occupied ? 1 : 0) << 63);
+}
+inline bool unpackVoxelUpdate(const uint64_t u, uint32_t v[3])
+{
+	const uint64_t mask = (uint64_t(1) << 21) - 1;
+	v[0] = static_cast<uint32_t>(u & mask);
+	v[1] = static_cast<uint32_t>((u >> 21) & mask);
+	v[2] = static_cast<uint32_t>((u >> 42) & mask);
+	return (u >> 63) != 0;
+}
+
+/** Converts a point in voxel units to voxel coordinates.
+ * \return false if out of the limits of the map, or not finite */
+inline bool voxelOf(const double p[3], uint32_t v[3])
+{
+	for (int a = 0; a < 3; a++)
+	{
+		const double c = std::floor(p[a]);
+		// (written so NaN's are also rejected)
+		if (!(c >= -VOXEL_OFFSET && c < VOXEL_OFFSET)) return false;
+		v[a] = static_cast<uint32_t>(static_cast<int32_t>(c) + VOXEL_OFFSET);
+	}
+	return true;
+}
+
+/** Calls f(v) for each voxel v traversed by the segment p0->p1 (in voxel
+ * units), from that of p0 and excluding that of p1 (Amanatides & Woo's
+ * algorithm). Both points must be within the limits of the map. */
+template <typename FUNCTOR>
+void traceSegment(const double p0[3], const double p1[3], FUNCTOR&& f)
+{
+	const double inf = std::numeric_limits<double>::infinity();
+	uint32_t v[3];
+	int32_t step[3];
+	double tMax[3], tDelta[3];
+	size_t nSteps = 0;
+	for (int a = 0; a < 3; a++)
+	{
+		const auto cur = static_cast<int32_t>(std::floor(p0[a]));
+		const auto last = static_cast<int32_t>(std::floor(p1[a]));
+		v[a] = static_cast<uint32_t>(cur + VOXEL_OFFSET);
+		nSteps += std::abs(last - cur);
+		const double d = p1[a] - p0[a];
+		step[a] = last > cur ? 1 : (last < cur ? -1 : 0);
+		if (!step[a])
+		{
+			tMax[a] = tDelta[a] = inf;
+			continue;
+		}
+		const double next = step[a] > 0 ? cur + 1 : cur;
+		tMax[a] = (next - p0[a]) / d;
+		tDelta[a] = step[a] / d;
+	}
+	// Each step moves to a neighbor voxel, towards that of p1:
+	for (size_t i = 0; i < nSteps; i++)
+	{
+		f(v);
+		int a = tMax[1] < tMax[0] ? 1 : 0;
+		a = tMax[2] < tMax[a] ? 2 : a;
+		v[a] += step[a];
+		tMax[a] += tDelta[a];
+	}
+}
+
+/** The sensor model, in the fixed point units of the voxels */
+struct TSensorModel
+{
+	explicit TSensorModel(const CVoxelMap::TInsertionOptions& o)
+		: hit(toFixed(o.probHit)),
+		  miss(toFixed(o.probMiss)),
+		  clampMin(toFixed(o.clampingThresMin)),
+		  clampMax(toFixed(o.clampingThresMax)),
+		  occupiedThres(toFixed(o.occupancyThres))
+	{
+	}
+	int32_t hit, miss, clampMin, clampMax, occupiedThres;
+
+	static int32_t toFixed(double prob)
+	{
+		const double l =
+			std::round(std::log(prob / (1 - prob)) * CVoxelMap::LOGODDS_SCALE);
+		const double lim = -double(CVoxelMap::UNKNOWN_VOXEL) - 1;
+		return static_cast<int32_t>(std::max(-lim, std::min(lim, l)));
+	}
+	void update(CVoxelMap::voxel_t& v, const int32_t delta) const
+	{
+		const int32_t l =
+			(v == CVoxelMap::UNKNOWN_VOXEL ? 0 : int32_t(v)) + delta;
+		v = static_cast<CVoxelMap::voxel_t>(
+			std::max(clampMin, std::min(clampMax, l)));
+	}
+};
+
+inline double voxelToProb(const CVoxelMap::voxel_t v)
+{
+	return 1.0 - 1.0 / (1.0 + std::exp(v / CVoxelMap::LOGODDS_SCALE));
+}
+
+void runThreads(
+	const unsigned int num_threads,
+	const std::function<void(unsigned int)>& job)
+{
+	std::vector<std::thread> threads;
+	for (unsigned int t = 1; t < num_threads; t++)
+		threads.emplace_back(job, t);
+	job(0);
+	for (auto& th : threads) th.join();
+}
+
+/** Blocks the threads calling wait() until all `n` of them have called it.
+ * It can be reused once all of them have been released. */
+class ThreadBarrier
+{
+   public:
+	explicit ThreadBarrier(unsigned int n) : m_n(n) {}
+
+	void wait()
+	{
+		std::unique_lock<std::mutex> lck(m_mtx);
+		const uint64_t generation = m_generation;
+		if (++m_count == m_n)
+		{
+			m_count = 0;
+			m_generation++;
+			m_cv.notify_all();
+		}
+		else
+			m_cv.wait(lck, [&]() { return generation != m_generation; });
+	}
+
+   private:
+	const unsigned int m_n;
+	unsigned int m_count{0};
+	uint64_t m_generation{0};
+	std::mutex m_mtx;
+	std::condition_variable m_cv;
+};
+
+/** Builds the point cloud of an observation, in the map frame, and the
+ * location of the sensor.
+ * \return false if the observation kind is not applicable. */
+bool buildPointCloudForObservation(
+	const CObservation* obs, const CPose3D* robotPose,
+	const unsigned int num_threads, TPoint3D& sensorPt, std::vector<float>& xs,
+	std::vector<float>& ys, std::vector<float>& zs)
+{
+	CPose3D robotPose3D;
+	if (robotPose)  // Default values are (0,0,0)
+		robotPose3D = (*robotPose);
+	CPose3D sensorPose(UNINITIALIZED_POSE);
+
+	if (IS_CLASS(obs, CObservation2DRangeScan))
+	{
+		const auto* o = static_cast<const CObservation2DRangeScan*>(obs);
+		sensorPose.composeFrom(robotPose3D, o->sensorPose);
+
+		// Points of the scan, wrt the robot:
+		const auto* scanPts = o->buildAuxPointsMap<mrpt::maps::CPointsMap>();
+		size_t N;
+		const float *lx, *ly, *lz;
+		scanPts->getPointsBuffer(N, lx, ly, lz);
+		xs.resize(N);
+		ys.resize(N);
+		zs.resize(N);
+		if (N)
+			robotPose3D.composePoints(
+				lx, ly, lz, &xs[0], &ys[0], &zs[0], N, nullptr, nullptr,
+				num_threads);
+	}
+	else if (IS_CLASS(obs, CObservation3DRangeScan))
+	{
+		const auto* o = static_cast<const CObservation3DRangeScan*>(obs);
+		if (!o->hasPoints3D) return false;
+		sensorPose.composeFrom(robotPose3D, o->sensorPose);
+
+		o->load();  // Just to make sure the points are loaded from an external
+		// source, if that's the case...
+
+		// Points wrt the sensor, without the invalid (0,0,0) ones:
+		const size_t nPts = o->points3D_x.size();
+		xs.clear();
+		ys.clear();
+		zs.clear();
+		xs.reserve(nPts);
+		ys.reserve(nPts);
+		zs.reserve(nPts);
+		for (size_t i = 0; i < nPts; i++)
+		{
+			const float x = o->points3D_x[i], y = o->points3D_y[i],
+						z = o->points3D_z[i];
+			if (x == 0 && y == 0 && z == 0) continue;
+			xs.push_back(x);
+			ys.push_back(y);
+			zs.push_back(z);
+		}
+		if (!xs.empty())
+			sensorPose.composePoints(
+				&xs[0], &ys[0], &zs[0], &xs[0], &ys[0], &zs[0], xs.size(),
+				nullptr, nullptr, num_threads);
+	}
+	else if (IS_CLASS(obs, CObservationVelodyneScan))
+	{
+		const auto* o = static_cast<const CObservationVelodyneScan*>(obs);
+		sensorPose.composeFrom(robotPose3D, o->sensorPose);
+
+		// Automatically generate pointcloud if needed:
+		if (!o->point_cloud.size())
+			const_cast<CObservationVelodyneScan*>(o)->generatePointCloud();
+
+		// Points wrt the sensor:
+		const auto& pc = o->point_cloud;
+		const size_t N = pc.size();
+		xs.resize(N);
+		ys.resize(N);
+		zs.resize(N);
+		if (N)
+			sensorPose.composePoints(
+				&pc.x[0], &pc.y[0], &pc.z[0], &xs[0], &ys[0], &zs[0], N,
+				nullptr, nullptr, num_threads);
+	}
+	else
+		return false;
+
+	sensorPt = TPoint3D(sensorPose.x(), sensorPose.y(), sensorPose.z());
+	return true;
+}
+}  // namespace
+
+/*---------------------------------------------------------------
+						Constructor
+  ---------------------------------------------------------------*/
+CVoxelMap::CVoxelMap(const double resolution) : m_resolution(resolution)
+{
+	ASSERT_ABOVE_(resolution, 0);
+}
+
+CVoxelMap::~CVoxelMap() = default;
+
+CVoxelMap::TBlock::TBlock()
+{
+	voxels.fill(UNKNOWN_VOXEL);
+	occupiedMask.fill(0);
+	freeMask.fill(0);
+}
+
+uint8_t CVoxelMap::serializeGetVersion() const { return 0; }
+void CVoxelMap::serializeTo(mrpt::serialization::CArchive& out) const
+{
+	out << m_resolution;
+	this->insertionOptions.writeToStream(out);
+	this->likelihoodOptions.writeToStream(out);
+	this->renderingOptions.writeToStream(out);
+	out << genericMapParams;
+
+	out.WriteAs<uint64_t>(getNumBlocks());
+	for (const auto& shard : m_shards)
+	{
+		for (const auto& kb : shard.blocks)
+		{
+			out.WriteAs<uint64_t>(kb.first);
+			out.WriteBufferFixEndianness(kb.second.voxels.data(), BLOCK_VOXELS);
+		}
+	}
+}
+
+void CVoxelMap::serializeFrom(
+	mrpt::serialization::CArchive& in, uint8_t version)
+{
+	switch (version)
+	{
+		case 0:
+		{
+			in >> m_resolution;
+			ASSERT_ABOVE_(m_resolution, 0);
+			this->insertionOptions.readFromStream(in);
+			this->likelihoodOptions.readFromStream(in);
+			this->renderingOptions.readFromStream(in);
+			in >> genericMapParams;
+
+			this->clear();
+
+			const auto nBlocks = in.ReadAs<uint64_t>();
+			for (uint64_t i = 0; i < nBlocks; i++)
+			{
+				uint32_t v[3];
+				blockKeyToVoxel(in.ReadAs<uint64_t>(), v);
+				TBlock& blk = getOrCreateBlock(v);
+				in.ReadBufferFixEndianness(blk.voxels.data(), BLOCK_VOXELS);
+			}
+		}
+		break;
+		default:
+			MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version)
+	};
+}
+
+void CVoxelMap::internal_clear()
+{
+	for (auto& shard : m_shards) shard = TShard();
+}
+
+bool CVoxelMap::isEmpty() const { return getNumBlocks() == 0; }
+
+size_t CVoxelMap::getNumBlocks() const
+{
+	size_t n = 0;
+	for (const auto& shard : m_shards) n += shard.blocks.size();
+	return n;
+}
+
+size_t CVoxelMap::memoryUsage() const
+{
+	size_t n = sizeof(*this);
+	for (const auto& shard : m_shards)
+		n += shard.blocks.size() *
+				 (sizeof(TBlock) + sizeof(uint64_t) + 2 * sizeof(void*)) +
+			 shard.blocks.bucket_count() * sizeof(void*);
+	return n;
+}
+
+bool CVoxelMap::coordsToVoxel(double x, double y, double z, uint32_t v[3])
+	const
+{
+	const double invRes = 1.0 / m_resolution;
+	const double p[3] = {x * invRes, y * invRes, z * invRes};
+	return voxelOf(p, v);
+}
+
+const CVoxelMap::TBlock* CVoxelMap::getBlock(const uint32_t v[3]) const
+{
+	const uint64_t key = blockKey(v);
+	const auto& blocks = m_shards[shardOf(key)].blocks;
+	const auto it = blocks.find(key);
+	return it == blocks.end() ? nullptr : &it->second;
+}
+
+CVoxelMap::TBlock& CVoxelMap::getOrCreateBlock(const uint32_t v[3])
+{
+	const uint64_t key = blockKey(v);
+	TShard& shard = m_shards[shardOf(key)];
+	const auto ret = shard.blocks.try_emplace(key);
+	if (ret.second)
+	{
+		for (int a = 0; a < 3; a++)
+		{
+			const uint32_t b = v[a] >> BLOCK_BITS;
+			shard.bbMin[a] = std::min(shard.bbMin[a], b);
+			shard.bbMax[a] = std::max(shard.bbMax[a], b);
+		}
+	}
+	return ret.first->second;
+}
+
+bool CVoxelMap::getBlocksBoundingBox(uint32_t bbMin[3], uint32_t bbMax[3])
+	const
+{
+	bool any = false;
+	for (const auto& shard : m_shards)
+	{
+		if (shard.blocks.empty()) continue;
+		for (int a = 0; a < 3; a++)
+		{
+			bbMin[a] =
+				any ? std::min(bbMin[a], shard.bbMin[a]) : shard.bbMin[a];
+			bbMax[a] =
+				any ? std::max(bbMax[a], shard.bbMax[a]) : shard.bbMax[a];
+		}
+		any = true;
+	}
+	return any;
+}
+
+void CVoxelMap::getMetricMin(double& x, double& y, double& z) const
+{
+	uint32_t bbMin[3], bbMax[3];
+	if (!getBlocksBoundingBox(bbMin, bbMax))
+	{
+		x = y = z = 0;
+		return;
+	}
+	const auto toMetric = [this](uint32_t b) {
+		return (int64_t(b << BLOCK_BITS) - VOXEL_OFFSET) * m_resolution;
+	};
+	x = toMetric(bbMin[0]);
+	y = toMetric(bbMin[1]);
+	z = toMetric(bbMin[2]);
+}
+
+void CVoxelMap::getMetricMax(double& x, double& y, double& z) const
+{
+	uint32_t bbMin[3], bbMax[3];
+	if (!getBlocksBoundingBox(bbMin, bbMax))
+	{
+		x = y = z = 0;
+		return;
+	}
+	const auto toMetric = [this](uint32_t b) {
+		return (int64_t((b + 1) << BLOCK_BITS) - VOXEL_OFFSET) * m_resolution;
+	};
+	x = toMetric(bbMax[0]);
+	y = toMetric(bbMax[1]);
+	z = toMetric(bbMax[2]);
+}
+
+bool CVoxelMap::getPointOccupancy(
+	const float x, const float y, const float z, double& prob_occupancy) const
+{
+	uint32_t v[3];
+	if (!coordsToVoxel(x, y, z, v)) return false;
+	const TBlock* blk = getBlock(v);
+	if (!blk) return false;
+	const voxel_t val = blk->voxels[voxelIndex(v)];
+	if (val == UNKNOWN_VOXEL) return false;
+	prob_occupancy = voxelToProb(val);
+	return true;
+}
+
+void CVoxelMap::updateVoxel(
+	const double x, const double y, const double z, bool occupied)
+{
+	uint32_t v[3];
+	if (!coordsToVoxel(x, y, z, v)) return;
+	const TSensorModel sm(insertionOptions);
+	sm.update(
+		getOrCreateBlock(v).voxels[voxelIndex(v)], occupied ? sm.hit : sm.miss);
+}
+
+void CVoxelMap::insertRay(
+	const float end_x, const float end_y, const float end_z,
+	const float sensor_x, const float sensor_y, const float sensor_z)
+{
+	insertPointCloud(
+		&end_x, &end_y, &end_z, 1, sensor_x, sensor_y, sensor_z);
+}
+
+void CVoxelMap::insertPointCloud(
+	const CPointsMap& ptMap, const float sensor_x, const float sensor_y,
+	const float sensor_z)
+{
+	size_t N;
+	const float *xs, *ys, *zs;
+	ptMap.getPointsBuffer(N, xs, ys, zs);
+	insertPointCloud(xs, ys, zs, N, sensor_x, sensor_y, sensor_z);
+}
+
+void CVoxelMap::insertPointCloud(
+	const float* xs, const float* ys, const float* zs, const size_t N,
+	const float sensor_x, const float sensor_y, const float sensor_z)
+{
+	MRPT_START
+
+	const double invRes = 1.0 / m_resolution;
+	const double p0[3] = {sensor_x * invRes, sensor_y * invRes,
+						  sensor_z * invRes};
+	uint32_t sensorVoxel[3];
+	if (!voxelOf(p0, sensorVoxel))
+		THROW_EXCEPTION_FMT(
+			"Sensor location (%f,%f,%f) is out of the limits of the map",
+			sensor_x, sensor_y, sensor_z);
+	if (!N) return;
+
+	// Max. range, in voxel units:
+	const double maxrange = insertionOptions.maxrange * invRes;
+
+	const size_t MIN_RAYS_PER_THREAD = 1024;
+	unsigned int num_threads = insertionOptions.num_threads;
+	if (num_threads == 0)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	num_threads = static_cast<unsigned int>(std::max<size_t>(
+		1, std::min<size_t>(num_threads, N / MIN_RAYS_PER_THREAD)));
+
+	// Rays are processed in chunks, so the lists of voxel updates (one per
+	// thread and shard) do not grow without bounds:
+	const size_t RAYS_PER_CHUNK_AND_THREAD = 4096;
+	const unsigned int RECENT_CACHE_BITS = 12;
+	const size_t RECENT_CACHE_SIZE = size_t(1) << RECENT_CACHE_BITS;
+	const size_t chunk = RAYS_PER_CHUNK_AND_THREAD * num_threads;
+	std::vector<std::vector<std::vector<uint64_t>>> updates(
+		num_threads, std::vector<std::vector<uint64_t>>(NUM_SHARDS));
+	// Blocks with voxels marked in their masks, for each shard:
+	std::vector<std::vector<TBlock*>> pending(NUM_SHARDS);
+
+	const TSensorModel sm(insertionOptions);
+
+	// The threads are created once per point cloud, and go through all the
+	// chunks in lockstep:
+	ThreadBarrier barrier(num_threads);
+	runThreads(num_threads, [&](unsigned int t) {
+		auto& upd = updates[t];
+		// Marking a voxel twice has no effect, so updates already pushed
+		// recently (e.g. near the sensor, traversed by most rays) are
+		// skipped, with a small direct-mapped cache:
+		std::vector<uint64_t> recent(
+			RECENT_CACHE_SIZE, std::numeric_limits<uint64_t>::max());
+		const auto push = [&](const uint32_t v[3], bool occupied) {
+			const uint64_t u = packVoxelUpdate(v, occupied);
+			uint64_t& r = recent[static_cast<size_t>(
+				(u * UINT64_C(0x9E3779B97F4A7C15)) >>
+				(64 - RECENT_CACHE_BITS))];
+			if (r == u) return;
+			r = u;
+			upd[shardOf(blockKey(v))].push_back(u);
+		};
+
+		for (size_t i0 = 0; i0 < N; i0 += chunk)
+		{
+			const size_t i1 = std::min(N, i0 + chunk);
+			const size_t raysPerThread =
+				(i1 - i0 + num_threads - 1) / num_threads;
+
+			// 1) Each thread traces a range of rays, and stores the voxel
+			// updates split by the shard of their blocks:
+			for (auto& u : upd) u.clear();
+			const size_t j1 = std::min(i1, i0 + (t + 1) * raysPerThread);
+			for (size_t j = i0 + t * raysPerThread; j < j1; j++)
+			{
+				double p1[3] = {xs[j] * invRes, ys[j] * invRes, zs[j] * invRes};
+				uint32_t endVoxel[3];
+				if (!voxelOf(p1, endVoxel)) continue;
+
+				bool hit = true;
+				if (maxrange > 0)
+				{
+					const double d[3] = {p1[0] - p0[0], p1[1] - p0[1],
+										 p1[2] - p0[2]};
+					const double len =
+						std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+					if (len > maxrange)
+					{
+						// Only free space up to the max. range:
+						for (int a = 0; a < 3; a++)
+							p1[a] = p0[a] + d[a] * maxrange / len;
+						hit = false;
+					}
+				}
+				traceSegment(
+					p0, p1, [&](const uint32_t v[3]) { push(v, false); });
+				if (hit) push(endVoxel, true);
+			}
+			barrier.wait();
+
+			// 2) Each thread marks the voxels of its shards in their blocks,
+			// allocating them as needed:
+			for (unsigned int s = t; s < NUM_SHARDS; s += num_threads)
+			{
+				uint64_t lastKey = std::numeric_limits<uint64_t>::max();
+				TBlock* blk = nullptr;
+				for (const auto& thUpd : updates)
+				{
+					for (const uint64_t u : thUpd[s])
+					{
+						uint32_t v[3];
+						const bool occupied = unpackVoxelUpdate(u, v);
+						const uint64_t key = blockKey(v);
+						if (key != lastKey)
+						{
+							lastKey = key;
+							blk = &getOrCreateBlock(v);
+							if (!blk->pending)
+							{
+								blk->pending = true;
+								pending[s].push_back(blk);
+							}
+						}
+						const unsigned int idx = voxelIndex(v);
+						(occupied ? blk->occupiedMask
+								  : blk->freeMask)[idx >> 6] |= uint64_t(1)
+															   << (idx & 63);
+					}
+				}
+			}
+			// The updates of all threads are read above, so they cannot be
+			// cleared for the next chunk until everybody is done:
+			barrier.wait();
+		}
+
+		// 3) Update each marked voxel once: as occupied if any ray ended in
+		// it, as free otherwise:
+		for (unsigned int s = t; s < NUM_SHARDS; s += num_threads)
+		{
+			for (TBlock* blk : pending[s])
+			{
+				for (unsigned int w = 0; w < BLOCK_VOXELS / 64; w++)
+				{
+					const uint64_t occ = blk->occupiedMask[w],
+								   fre = blk->freeMask[w];
+					if (!(occ | fre)) continue;
+					for (unsigned int b = 0; b < 64; b++)
+					{
+						const uint64_t m = uint64_t(1) << b;
+						if (occ & m)
+							sm.update(blk->voxels[w * 64 + b], sm.hit);
+						else if (fre & m)
+							sm.update(blk->voxels[w * 64 + b], sm.miss);
+					}
+					blk->occupiedMask[w] = blk->freeMask[w] = 0;
+				}
+				blk->pending = false;
+			}
+		}
+	});
+
+	MRPT_END
+}
+
+bool CVoxelMap::castRay(
+	const mrpt::math::TPoint3D& origin, const mrpt::math::TPoint3D& direction,
+	mrpt::math::TPoint3D& end, bool ignoreUnknownCells, double maxRange) const
+{
+	const double norm = direction.norm();
+	if (norm == 0) return false;
+
+	uint32_t bbMin[3], bbMax[3];
+	if (!getBlocksBoundingBox(bbMin, bbMax)) return false;
+
+	// Everything in voxel units:
+	const double invRes = 1.0 / m_resolution;
+	const double p0[3] = {origin.x * invRes, origin.y * invRes,
+						  origin.z * invRes};
+	const double dir[3] = {direction.x / norm, direction.y / norm,
+						   direction.z / norm};
+	uint32_t v[3];
+	if (!voxelOf(p0, v)) return false;
+
+	// Beyond this distance, there is nothing else to hit:
+	double tLimit;
+	if (maxRange > 0)
+		tLimit = maxRange * invRes;
+	else
+	{
+		double d2 = 0;
+		for (int a = 0; a < 3; a++)
+		{
+			const double lo = double(bbMin[a] << BLOCK_BITS) - VOXEL_OFFSET,
+						 hi = double((bbMax[a] + 1) << BLOCK_BITS) -
+							  VOXEL_OFFSET;
+			const double d =
+				std::max(std::abs(p0[a] - lo), std::abs(p0[a] - hi));
+			d2 += d * d;
+		}
+		tLimit = std::sqrt(d2);
+	}
+
+	const double inf = std::numeric_limits<double>::infinity();
+	int step[3];
+	double tMax[3], tDelta[3];
+	for (int a = 0; a < 3; a++)
+	{
+		step[a] = dir[a] > 0 ? 1 : (dir[a] < 0 ? -1 : 0);
+		if (!step[a])
+		{
+			tMax[a] = tDelta[a] = inf;
+			continue;
+		}
+		const double c = std::floor(p0[a]);
+		const double next = step[a] > 0 ? c + 1 : c;
+		tMax[a] = (next - p0[a]) / dir[a];
+		tDelta[a] = step[a] / dir[a];
+	}
+
+	const voxel_t occupiedThres =
+		static_cast<voxel_t>(TSensorModel::toFixed(getOccupancyThres()));
+	uint64_t lastKey = std::numeric_limits<uint64_t>::max();
+	const TBlock* blk = nullptr;
+	for (;;)
+	{
+		const uint64_t key = blockKey(v);
+		if (key != lastKey)
+		{
+			lastKey = key;
+			blk = getBlock(v);
+		}
+		const voxel_t val = blk ? blk->voxels[voxelIndex(v)] : UNKNOWN_VOXEL;
+		if ((val != UNKNOWN_VOXEL && val >= occupiedThres) ||
+			(val == UNKNOWN_VOXEL && !ignoreUnknownCells))
+		{
+			end.x = (int64_t(v[0]) - VOXEL_OFFSET + 0.5) * m_resolution;
+			end.y = (int64_t(v[1]) - VOXEL_OFFSET + 0.5) * m_resolution;
+			end.z = (int64_t(v[2]) - VOXEL_OFFSET + 0.5) * m_resolution;
+			return val != UNKNOWN_VOXEL;
+		}
+
+		// Next voxel:
+		const int a = tMax[0] < tMax[1] ? (tMax[0] < tMax[2] ? 0 : 2)
+										: (tMax[1] < tMax[2] ? 1 : 2);
+		if (tMax[a] > tLimit) return false;
+		const int64_t next = int64_t(v[a]) + step[a];
+		if (next < 0 || next >= 2 * VOXEL_OFFSET) return false;
+		v[a] = static_cast<uint32_t>(next);
+		tMax[a] += tDelta[a];
+	}
+}
+
+bool CVoxelMap::internal_insertObservation(
+	const mrpt::obs::CObservation* obs, const CPose3D* robotPose)
+{
+	TPoint3D sensorPt;
+	std::vector<float> xs, ys, zs;
+	if (!buildPointCloudForObservation(
+			obs, robotPose, insertionOptions.num_threads, sensorPt, xs, ys,
+			zs))
+		return false;  // Nothing to do.
+	insertPointCloud(
+		xs.data(), ys.data(), zs.data(), xs.size(), sensorPt.x, sensorPt.y,
+		sensorPt.z);
+	return true;
+}
+
+double CVoxelMap::internal_computeObservationLikelihood(
+	const mrpt::obs::CObservation* obs, const mrpt::poses::CPose3D& takenFrom)
+{
+	TPoint3D sensorPt;
+	std::vector<float> xs, ys, zs;
+	if (!buildPointCloudForObservation(
+			obs, &takenFrom, 1, sensorPt, xs, ys, zs))
+		return 0;  // Nothing to do.
+
+	const size_t decim = std::max<uint32_t>(1, likelihoodOptions.decimation);
+	double log_lik = 0;
+	for (size_t i = 0; i < xs.size(); i += decim)
+	{
+		double prob;
+		if (getPointOccupancy(xs[i], ys[i], zs[i], prob))
+			log_lik += std::log(prob);
+	}
+	return log_lik;
+}
+
+void CVoxelMap::saveMetricMapRepresentationToFile(
+	const std::string& filNamePrefix) const
+{
+	MRPT_START
+
+	// Save as 3D Scene:
+	mrpt::opengl::COpenGLScene scene;
+	mrpt::opengl::CSetOfObjects::Ptr obj3D =
+		mrpt::make_aligned_shared<mrpt::opengl::CSetOfObjects>();
+
+	this->getAs3DObject(obj3D);
+
+	scene.insert(obj3D);
+
+	const std::string fil = filNamePrefix + std::string("_3D.3Dscene");
+	scene.saveToFile(fil);
+
+	MRPT_END
+}
+
+void CVoxelMap::getAs3DObject(mrpt::opengl::CSetOfObjects::Ptr& outObj) const
+{
+	auto gl_obj = mrpt::opengl::COctoMapVoxels::Create();
+	this->getAsOctoMapVoxels(*gl_obj);
+	outObj->insert(gl_obj);
+}
+
+/** Builds a renderizable representation of the map as a
+ * mrpt::opengl::COctoMapVoxels object. */
+void CVoxelMap::getAsOctoMapVoxels(mrpt::opengl::COctoMapVoxels& gl_obj) const
+{
+	const TColorf general_color = gl_obj.getColor();
+	const TColor general_color_u(
+		general_color.R * 255, general_color.G * 255, general_color.B * 255,
+		general_color.A * 255);
+
+	gl_obj.clear();
+	gl_obj.resizeVoxelSets(2);  // 2 sets of voxels: occupied & free
+
+	gl_obj.showVoxels(
+		VOXEL_SET_OCCUPIED, renderingOptions.visibleOccupiedVoxels);
+	gl_obj.showVoxels(VOXEL_SET_FREESPACE, renderingOptions.visibleFreeVoxels);
+
+	mrpt::math::TPoint3D bbmin, bbmax;
+	this->getMetricMin(bbmin.x, bbmin.y, bbmin.z);
+	this->getMetricMax(bbmax.x, bbmax.y, bbmax.z);
+	const double zmin = bbmin.z, inv_dz = 1 / (bbmax.z - bbmin.z + 0.01);
+
+	const voxel_t occupiedThres =
+		static_cast<voxel_t>(TSensorModel::toFixed(getOccupancyThres()));
+	const double L = BLOCK_SIDE * m_resolution;
+
+	for (const auto& shard : m_shards)
+	{
+		for (const auto& kb : shard.blocks)
+		{
+			uint32_t v0[3];
+			blockKeyToVoxel(kb.first, v0);
+			const mrpt::math::TPoint3D blockMin(
+				(int64_t(v0[0]) - VOXEL_OFFSET) * m_resolution,
+				(int64_t(v0[1]) - VOXEL_OFFSET) * m_resolution,
+				(int64_t(v0[2]) - VOXEL_OFFSET) * m_resolution);
+
+			if (renderingOptions.generateGridLines)
+				gl_obj.push_back_GridCube(COctoMapVoxels::TGridCube(
+					blockMin, blockMin + mrpt::math::TPoint3D(L, L, L)));
+
+			for (unsigned int idx = 0; idx < BLOCK_VOXELS; idx++)
+			{
+				const voxel_t val = kb.second.voxels[idx];
+				if (val == UNKNOWN_VOXEL) continue;
+				const bool isOccupied = val >= occupiedThres;
+				if ((isOccupied && !renderingOptions.generateOccupiedVoxels) ||
+					(!isOccupied && !renderingOptions.generateFreeVoxels))
+					continue;
+
+				const unsigned int m = BLOCK_SIDE - 1;
+				const unsigned int ix = idx & m, iy = (idx >> BLOCK_BITS) & m,
+								   iz = (idx >> (2 * BLOCK_BITS)) & m;
+				const mrpt::math::TPoint3D vx_center(
+					blockMin.x + (ix + 0.5) * m_resolution,
+					blockMin.y + (iy + 0.5) * m_resolution,
+					blockMin.z + (iz + 0.5) * m_resolution);
+				const double occ = voxelToProb(val);
+
+				mrpt::img::TColor vx_color;
+				double coefc, coeft;
+				switch (gl_obj.getVisualizationMode())
+				{
+					case COctoMapVoxels::FIXED:
+						vx_color = general_color_u;
+						break;
+					case COctoMapVoxels::COLOR_FROM_HEIGHT:
+						coefc = 255 * inv_dz * (vx_center.z - zmin);
+						vx_color = TColor(
+							coefc * general_color.R, coefc * general_color.G,
+							coefc * general_color.B, 255.0 * general_color.A);
+						break;
+					case COctoMapVoxels::COLOR_FROM_OCCUPANCY:
+						coefc = 240 * (1 - occ) + 15;
+						vx_color = TColor(
+							coefc * general_color.R, coefc * general_color.G,
+							coefc * general_color.B, 255.0 * general_color.A);
+						break;
+					case COctoMapVoxels::TRANSPARENCY_FROM_OCCUPANCY:
+						coeft = std::max(0.0, 255 - 510 * (1 - occ));
+						vx_color = TColor(
+							255 * general_color.R, 255 * general_color.G,
+							255 * general_color.B, coeft);
+						break;
+					case COctoMapVoxels::TRANS_AND_COLOR_FROM_OCCUPANCY:
+						coefc = 240 * (1 - occ) + 15;
+						vx_color = TColor(
+							coefc * general_color.R, coefc * general_color.G,
+							coefc * general_color.B, 50);
+						break;
+					case COctoMapVoxels::MIXED:
+						coefc = 255 * inv_dz * (vx_center.z - zmin);
+						coeft = std::max(0.0, 255 - 510 * (1 - occ));
+						vx_color = TColor(
+							coefc * general_color.R, coefc * general_color.G,
+							coefc * general_color.B, coeft);
+						break;
+					default:
+						THROW_EXCEPTION("Unknown coloring scheme!");
+				}
+
+				gl_obj.push_back_Voxel(
+					isOccupied ? VOXEL_SET_OCCUPIED : VOXEL_SET_FREESPACE,
+					COctoMapVoxels::TVoxel(vx_center, m_resolution, vx_color));
+			}
+		}
+	}
+
+	// if we use transparency, sort cubes by "Z" as an approximation to
+	// far-to-near render ordering:
+	if (gl_obj.isCubeTransparencyEnabled()) gl_obj.sort_voxels_by_z();
+
+	gl_obj.setBoundingBox(bbmin, bbmax);
+}
+
+/*---------------------------------------------------------------
+				TInsertionOptions
+ ---------------------------------------------------------------*/
+void CVoxelMap::TInsertionOptions::writeToStream(
+	mrpt::serialization::CArchive& out) const
+{
+	const int8_t version = 0;
+	out << version;
+	out << maxrange << occupancyThres << probHit << probMiss
+		<< clampingThresMin << clampingThresMax;
+}
+
+void CVoxelMap::TInsertionOptions::readFromStream(
+	mrpt::serialization::CArchive& in)
+{
+	int8_t version;
+	in >> version;
+	switch (version)
+	{
+		case 0:
+		{
+			in >> maxrange >> occupancyThres >> probHit >> probMiss >>
+				clampingThresMin >> clampingThresMax;
+		}
+		break;
+		default:
+			MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version)
+	}
+}
+
+void CVoxelMap::TInsertionOptions::dumpToTextStream(std::ostream& out) const
+{
+	out << mrpt::format(
+		"\n----------- [CVoxelMap::TInsertionOptions] ------------ \n\n");
+
+	LOADABLEOPTS_DUMP_VAR(maxrange, double);
+	LOADABLEOPTS_DUMP_VAR(occupancyThres, double);
+	LOADABLEOPTS_DUMP_VAR(probHit, double);
+	LOADABLEOPTS_DUMP_VAR(probMiss, double);
+	LOADABLEOPTS_DUMP_VAR(clampingThresMin, double);
+	LOADABLEOPTS_DUMP_VAR(clampingThresMax, double);
+	LOADABLEOPTS_DUMP_VAR(num_threads, int);
+
+	out << mrpt::format("\n");
+}
+
+void CVoxelMap::TInsertionOptions::loadFromConfigFile(
+	const mrpt::config::CConfigFileBase& iniFile, const std::string& section)
+{
+	MRPT_LOAD_CONFIG_VAR(maxrange, double, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(occupancyThres, double, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(probHit, double, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(probMiss, double, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(clampingThresMin, double, iniFile, section);
+	MRPT_LOAD_CONFIG_VAR(clampingThresMax, double, iniFile, section);
+	// Read as unsigned, so negative values wrap around and are rejected here
+	// instead of silently becoming a huge thread count:
+	const uint64_t nThreads =
+		iniFile.read_uint64_t(section, "num_threads", num_threads);
+	ASSERT_BELOWEQ_(nThreads, 1024U);
+	num_threads = static_cast<unsigned int>(nThreads);
+}
+
+/*---------------------------------------------------------------
+				TLikelihoodOptions
+ ---------------------------------------------------------------*/
+void CVoxelMap::TLikelihoodOptions::writeToStream(
+	mrpt::serialization::CArchive& out) const
+{
+	const int8_t version = 0;
+	out << version;
+	out << decimation;
+}
+
+void CVoxelMap::TLikelihoodOptions::readFromStream(
+	mrpt::serialization::CArchive& in)
+{
+	int8_t version;
+	in >> version;
+	switch (version)
+	{
+		case 0:
+		{
+			in >> decimation;
+		}
+		break;
+		default:
+			MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version)
+	}
+}
+
+void CVoxelMap::TLikelihoodOptions::dumpToTextStream(std::ostream& out) const
+{
+	out << mrpt::format(
+		"\n----------- [CVoxelMap::TLikelihoodOptions] ------------ \n\n");
+
+	LOADABLEOPTS_DUMP_VAR(decimation, int);
+}
+
+void CVoxelMap::TLikelihoodOptions::loadFromConfigFile(
+	const mrpt::config::CConfigFileBase& iniFile, const std::string& section)
+{
+	MRPT_LOAD_CONFIG_VAR(decimation, int, iniFile, section);
+}
+
+/*---------------------------------------------------------------
+				TRenderingOptions
+ ---------------------------------------------------------------*/
+void CVoxelMap::TRenderingOptions::writeToStream(
+	mrpt::serialization::CArchive& out) const
+{
+	const int8_t version = 0;
+	out << version;
+	out << generateGridLines << generateOccupiedVoxels << visibleOccupiedVoxels
+		<< generateFreeVoxels << visibleFreeVoxels;
+}
+
+void CVoxelMap::TRenderingOptions::readFromStream(
+	mrpt::serialization::CArchive& in)
+{
+	int8_t version;
+	in >> version;
+	switch (version)
+	{
+		case 0:
+		{
+			in >> generateGridLines >> generateOccupiedVoxels >>
+				visibleOccupiedVoxels >> generateFreeVoxels >>
+				visibleFreeVoxels;
+		}
+		break;
+		default:
+			MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version)
+	}
+}
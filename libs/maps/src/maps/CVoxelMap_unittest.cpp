@@ -0,0 +1,149 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/maps/CVoxelMap.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/opengl/COctoMapVoxels.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt::maps;
+using namespace mrpt::math;
+
+namespace
+{
+// Points on the walls of a 6x4x3 m room, seen from (0,0,1)
+CSimplePointsMap roomPoints(size_t N)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+	CSimplePointsMap pts;
+	for (size_t i = 0; i < N; i++)
+	{
+		const double x = rng.drawUniform(-3.0, 3.0),
+					 y = rng.drawUniform(-2.0, 2.0),
+					 z = rng.drawUniform(0.0, 3.0);
+		switch (i % 3)
+		{
+			case 0:
+				pts.insertPoint(x < 0 ? -3.01 : 3.01, y, z);
+				break;
+			case 1:
+				pts.insertPoint(x, y < 0 ? -2.01 : 2.01, z);
+				break;
+			default:
+				pts.insertPoint(x, y, z < 1.5 ? 0.01 : 2.99);
+		};
+	}
+	return pts;
+}
+}  // namespace
+
+TEST(CVoxelMap, updateVoxels)
+{
+	CVoxelMap map(0.1);
+	EXPECT_TRUE(map.isEmpty());
+
+	map.updateVoxel(1, 1, 1, true);
+	map.updateVoxel(1.5, 1, 1, true);
+	map.updateVoxel(1.5, 1, 1, true);
+	map.updateVoxel(-1, -1, 1, false);
+	EXPECT_FALSE(map.isEmpty());
+
+	double occup;
+	EXPECT_TRUE(map.getPointOccupancy(1, 1, 1, occup));
+	EXPECT_NEAR(occup, 0.7, 1e-3);
+	EXPECT_TRUE(map.getPointOccupancy(1.5, 1, 1, occup));
+	EXPECT_GT(occup, 0.8);
+	EXPECT_TRUE(map.getPointOccupancy(-1, -1, 1, occup));
+	EXPECT_NEAR(occup, 0.4, 1e-3);
+	EXPECT_FALSE(map.getPointOccupancy(0, 0, 0, occup));
+
+	// Clamping:
+	for (int i = 0; i < 100; i++) map.updateVoxel(-1, -1, 1, false);
+	EXPECT_TRUE(map.getPointOccupancy(-1, -1, 1, occup));
+	EXPECT_NEAR(occup, map.getClampingThresMin(), 1e-3);
+}
+
+TEST(CVoxelMap, insertPointCloudAndCastRay)
+{
+	const auto pts = roomPoints(20000);
+	CVoxelMap map(0.1);
+	map.insertPointCloud(pts, 0, 0, 1);
+
+	double occup;
+	// Walls, free space, and unknown space beyond the walls:
+	EXPECT_TRUE(map.getPointOccupancy(3.05, 0, 1, occup));
+	EXPECT_GT(occup, 0.5);
+	EXPECT_TRUE(map.getPointOccupancy(1.5, 0.5, 1.2, occup));
+	EXPECT_LT(occup, 0.5);
+	EXPECT_FALSE(map.getPointOccupancy(4.0, 0, 1, occup));
+
+	TPoint3D hit;
+	EXPECT_TRUE(map.castRay(TPoint3D(0, 0, 1), TPoint3D(1, 0, 0), hit));
+	EXPECT_NEAR(hit.x, 3.05, 1e-6);
+	EXPECT_NEAR(hit.y, 0.05, 1e-6);
+	EXPECT_NEAR(hit.z, 1.05, 1e-6);
+	EXPECT_TRUE(map.castRay(TPoint3D(0, 0, 1), TPoint3D(0, -2, 0), hit));
+	EXPECT_NEAR(hit.y, -2.05, 1e-6);
+	// Limited range:
+	EXPECT_FALSE(
+		map.castRay(TPoint3D(0, 0, 1), TPoint3D(1, 0, 0), hit, false, 2.0));
+	// From the outside, through unknown space:
+	EXPECT_FALSE(map.castRay(TPoint3D(5, 0, 1), TPoint3D(-1, 0, 0), hit));
+	EXPECT_TRUE(
+		map.castRay(TPoint3D(5, 0, 1), TPoint3D(-1, 0, 0), hit, true));
+	EXPECT_NEAR(hit.x, 3.05, 1e-6);
+	// Away from the map:
+	EXPECT_FALSE(
+		map.castRay(TPoint3D(5, 0, 1), TPoint3D(1, 0, 0), hit, true));
+
+	// Rays longer than maxrange only mark free space:
+	CVoxelMap map2(0.1);
+	map2.insertionOptions.maxrange = 2.5;
+	map2.insertPointCloud(pts, 0, 0, 1);
+	EXPECT_TRUE(map2.getPointOccupancy(2.45, 0.05, 1.05, occup));
+	EXPECT_LT(occup, 0.5);
+	EXPECT_FALSE(map2.getPointOccupancy(3.05, 0, 1, occup));
+
+	// Rendering:
+	mrpt::opengl::COctoMapVoxels gl;
+	map.getAsOctoMapVoxels(gl);
+	EXPECT_GT(gl.getVoxelCount(mrpt::opengl::VOXEL_SET_OCCUPIED), 1000U);
+	EXPECT_GT(gl.getVoxelCount(mrpt::opengl::VOXEL_SET_FREESPACE), 1000U);
+}
+
+TEST(CVoxelMap, parallelInsertion)
+{
+	const auto pts = roomPoints(50000);
+
+	CVoxelMap map1(0.05), map4(0.05);
+	map4.insertionOptions.num_threads = 4;
+	for (int i = 0; i < 2; i++)
+	{
+		map1.insertPointCloud(pts, 0.1f * i, 0, 1);
+		map4.insertPointCloud(pts, 0.1f * i, 0, 1);
+	}
+	ASSERT_EQ(map1.getNumBlocks(), map4.getNumBlocks());
+
+	// Same contents, whatever the number of threads:
+	size_t nKnown = 0;
+	for (float x = -3.5f; x < 3.5f; x += 0.05f)
+		for (float y = -2.5f; y < 2.5f; y += 0.05f)
+			for (float z = -0.5f; z < 3.5f; z += 0.1f)
+			{
+				double p1 = -1, p4 = -1;
+				const bool k1 = map1.getPointOccupancy(x, y, z, p1);
+				const bool k4 = map4.getPointOccupancy(x, y, z, p4);
+				ASSERT_EQ(k1, k4);
+				ASSERT_EQ(p1, p4);
+				if (k1) nKnown++;
+			}
+	EXPECT_GT(nKnown, 10000U);
+}
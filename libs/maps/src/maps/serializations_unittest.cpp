@@ -33,11 +33,13 @@ TEST_CLASS_MOVE_COPY_CTORS(CWirelessPowerGridMap2D);
 TEST_CLASS_MOVE_COPY_CTORS(CHeightGridMap2D);
 TEST_CLASS_MOVE_COPY_CTORS(CReflectivityGridMap2D);
 TEST_CLASS_MOVE_COPY_CTORS(COccupancyGridMap2D);
+TEST_CLASS_MOVE_COPY_CTORS(CCircularOccupancyGridMap2D);
 TEST_CLASS_MOVE_COPY_CTORS(CSimplePointsMap);
 TEST_CLASS_MOVE_COPY_CTORS(CRandomFieldGridMap3D);
 TEST_CLASS_MOVE_COPY_CTORS(CWeightedPointsMap);
 TEST_CLASS_MOVE_COPY_CTORS(COctoMap);
 TEST_CLASS_MOVE_COPY_CTORS(CColouredOctoMap);
+TEST_CLASS_MOVE_COPY_CTORS(CVoxelMap);
 
 // Create a set of classes, then serialize and deserialize to test possible
 // bugs:
@@ -52,11 +54,13 @@ TEST(SerializeTestMaps, WriteReadToMem)
 		CLASS_ID(CHeightGridMap2D),
 		CLASS_ID(CReflectivityGridMap2D),
 		CLASS_ID(COccupancyGridMap2D),
+		CLASS_ID(CCircularOccupancyGridMap2D),
 		CLASS_ID(CSimplePointsMap),
 		CLASS_ID(CRandomFieldGridMap3D),
 		CLASS_ID(CWeightedPointsMap),
 		CLASS_ID(COctoMap),
-		CLASS_ID(CColouredOctoMap)};
+		CLASS_ID(CColouredOctoMap),
+		CLASS_ID(CVoxelMap)};
 
 	for (auto& lstClasse : lstClasses)
 	{
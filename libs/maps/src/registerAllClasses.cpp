@@ -28,6 +28,7 @@ MRPT_INITIALIZER(registerAllClasses_mrpt_maps)
 	registerClass(CLASS_ID(CColouredPointsMap));
 	registerClass(CLASS_ID(CWeightedPointsMap));
 	registerClass(CLASS_ID(COccupancyGridMap2D));
+	registerClass(CLASS_ID(CCircularOccupancyGridMap2D));
 	registerClass(CLASS_ID(CGasConcentrationGridMap2D));
 	registerClass(CLASS_ID(CWirelessPowerGridMap2D));
 	registerClass(CLASS_ID(CRandomFieldGridMap3D));
@@ -37,6 +38,7 @@ MRPT_INITIALIZER(registerAllClasses_mrpt_maps)
 
 	registerClass(CLASS_ID(COctoMap));
 	registerClass(CLASS_ID(CColouredOctoMap));
+	registerClass(CLASS_ID(CVoxelMap));
 
 	registerClass(CLASS_ID(CAngularObservationMesh));
 	registerClass(CLASS_ID(CPlanarLaserScan));
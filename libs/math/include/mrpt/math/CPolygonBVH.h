@@ -0,0 +1,74 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/math/geometry.h>
+#include <cstdint>
+#include <vector>
+
+namespace mrpt::math
+{
+/** A bounding volume hierarchy (BVH) of axis-aligned boxes over a set of 3D
+ * polygons, used to accelerate ray tracing against large polygon meshes.
+ *
+ * The tree only stores node bounding boxes and polygon indices: the
+ * polygons themselves are kept by the caller, which must pass the very same
+ * vector given to build() in each call to traceRay().
+ *
+ * traceRay() gives the same results than mrpt::math::traceRay(), but with a
+ * cost logarithmic (instead of linear) in the number of polygons. It is a
+ * const method that can be safely called from several threads at once.
+ *
+ * \sa mrpt::math::traceRay
+ * \ingroup geometry_grp
+ */
+class CPolygonBVH
+{
+   public:
+	/** Builds the hierarchy for the given set of polygons. */
+	void build(const std::vector<TPolygonWithPlane>& polys);
+	/** Empties the hierarchy */
+	void clear();
+	/** Returns true if build() has not been called or it was empty */
+	bool empty() const { return m_nodes.empty(); }
+	/** Number of nodes in the tree */
+	size_t size() const { return m_nodes.size(); }
+
+	/** Finds the closest polygon hit by a ray with origin in the pose
+	 * position and direction along its +X axis.
+	 * \param polys Must be the same vector passed to build()
+	 * \param[out] dist Distance to the hit point (undefined if none)
+	 * \return true if any polygon is hit
+	 */
+	bool traceRay(
+		const std::vector<TPolygonWithPlane>& polys,
+		const mrpt::math::TPose3D& pose, double& dist) const;
+
+	/** \overload For a line with a unit director vector */
+	bool traceRay(
+		const std::vector<TPolygonWithPlane>& polys, const TLine3D& ray,
+		double& dist) const;
+
+   private:
+	struct TNode
+	{
+		/** Bounding box */
+		double bb_min[3], bb_max[3];
+		/** For inner nodes: index of the 2nd child (the 1st one is the next
+		 * node). For leaves: first index in m_indices */
+		uint32_t idx;
+		/** Number of polygons (0 for inner nodes) */
+		uint32_t count;
+	};
+	std::vector<TNode> m_nodes;
+	/** Polygon indices, sorted such that each leaf is a contiguous range */
+	std::vector<uint32_t> m_indices;
+};
+
+}  // namespace mrpt::math
@@ -10,6 +10,7 @@
 
 #include <map>
 #include <vector>
+#include <stdexcept>
 
 namespace mrpt::math
 {
@@ -11,6 +11,7 @@
 // nanoflann library:
 #include <nanoflann.hpp>
 #include <mrpt/math/lightweight_geom_data.h>
+#include <cstdio>
 #include <memory>  // unique_ptr
 
 namespace mrpt::math
@@ -725,6 +726,63 @@ class KDTreeCapable
 
 	/* @} */
 
+	/** @name Save/load of the KD-tree
+		@{ */
+
+	/** Writes the 3D KD-tree (building it first, if required) into a binary
+	 * file, so it can be later restored with kdTreeLoadIndex3D() instead of
+	 * being rebuilt. The data points are not saved. The format depends on the
+	 * platform (word size and endianness).
+	 * \exception std::exception On any I/O error. */
+	void kdTreeSaveIndex3D(FILE* f) const
+	{
+		MRPT_START
+		rebuild_kdTree_3D();
+		const uint64_t N = m_kdtree3d_data.m_num_points;
+		if (std::fwrite(&N, sizeof(N), 1, f) != 1)
+			THROW_EXCEPTION("Error writing the KD-tree");
+		if (N) m_kdtree3d_data.index->saveIndex(f);
+		if (std::ferror(f)) THROW_EXCEPTION("Error writing the KD-tree");
+		MRPT_END
+	}
+
+	/** Restores a 3D KD-tree saved with kdTreeSaveIndex3D(), which must have
+	 * been built for exactly the same data points than those now in the
+	 * derived class. Call it after setting all the points, since changing
+	 * them marks the KD-tree as outdated.
+	 * \exception std::exception On any I/O error, or if the number of points
+	 * does not match. */
+	void kdTreeLoadIndex3D(FILE* f) const
+	{
+		MRPT_START
+		using tree3d_t = typename TKDTreeDataHolder<3>::kdtree_index_t;
+
+		uint64_t N;
+		if (std::fread(&N, sizeof(N), 1, f) != 1)
+			THROW_EXCEPTION("Error reading the KD-tree");
+		if (N != derived().kdtree_get_point_count())
+			THROW_EXCEPTION("The KD-tree was built for a different data set");
+
+		m_kdtree2d_data.clear();
+		m_kdtree3d_data.clear();
+		m_kdtreeNd_data.clear();
+		m_kdtree3d_data.m_num_points = N;
+		m_kdtree3d_data.m_dim = 3;
+		m_kdtree3d_data.query_point.resize(3);
+		if (N)
+		{
+			m_kdtree3d_data.index.reset(new tree3d_t(
+				3, derived(),
+				nanoflann::KDTreeSingleIndexAdaptorParams(
+					kdtree_search_params.leaf_max_size)));
+			m_kdtree3d_data.index->loadIndex(f);
+		}
+		m_kdtree_is_uptodate = true;
+		MRPT_END
+	}
+
+	/** @} */
+
    protected:
 	/** To be called by child classes when KD tree data changes. */
 	inline void kdtree_mark_as_outdated() const
@@ -0,0 +1,256 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "math-precomp.h"  // Precompiled headers
+
+#include <mrpt/math/CPolygonBVH.h>
+#include <mrpt/core/exceptions.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace mrpt::math;
+
+namespace
+{
+/** Max. number of polygons in a leaf */
+constexpr size_t BVH_LEAF_SIZE = 4;
+/** Size of the traversal stack in traceRay(), which holds at most one entry
+ * per tree level plus one */
+constexpr int BVH_STACK_SIZE = 64;
+/** Nodes at this depth are always leaves, whatever their size, so the
+ * traversal stack can never overflow */
+constexpr size_t BVH_MAX_DEPTH = BVH_STACK_SIZE - 2;
+
+struct TBuildItem
+{
+	TPoint3D bb_min, bb_max, centroid;
+};
+
+/** Slab test. Returns the entry distance, or a negative value if the ray
+ * misses the box (or it's farther than `best`). */
+double rayBoxEntry(
+	const double* bmin, const double* bmax, const TLine3D& ray,
+	const double* inv_dir, double best)
+{
+	double tmin = 0, tmax = best;
+	for (int k = 0; k < 3; k++)
+	{
+		if (inv_dir[k] == 0)
+		{
+			// Ray parallel to this slab:
+			if (ray.pBase[k] < bmin[k] || ray.pBase[k] > bmax[k]) return -1;
+			continue;
+		}
+		double t1 = (bmin[k] - ray.pBase[k]) * inv_dir[k];
+		double t2 = (bmax[k] - ray.pBase[k]) * inv_dir[k];
+		if (t1 > t2) std::swap(t1, t2);
+		if (t1 > tmin) tmin = t1;
+		if (t2 < tmax) tmax = t2;
+		if (tmin > tmax) return -1;
+	}
+	return tmin;
+}
+
+/** Ray-polygon test, equivalent to the one in mrpt::math::traceRay() but
+ * reusing the precomputed 2D projection of the polygon. */
+bool rayPolygon(
+	const TPolygonWithPlane& p, const TLine3D& ray, double& d, double best)
+{
+	const double* n = p.plane.coefs;
+	const double denom = n[0] * ray.director[0] + n[1] * ray.director[1] +
+						 n[2] * ray.director[2];
+	if (std::abs(denom) < getEpsilon()) return false;
+	d = -(n[0] * ray.pBase[0] + n[1] * ray.pBase[1] + n[2] * ray.pBase[2] +
+		  n[3]) /
+		denom;
+	if (d < 0 || d > best) return false;
+
+	const TPoint3D pt(
+		ray.pBase[0] + d * ray.director[0], ray.pBase[1] + d * ray.director[1],
+		ray.pBase[2] + d * ray.director[2]);
+	TPoint3D local;
+	p.inversePose.composePoint(pt, local);
+	return p.poly2D.contains(TPoint2D(local.x, local.y));
+}
+}  // namespace
+
+void CPolygonBVH::clear()
+{
+	m_nodes.clear();
+	m_indices.clear();
+}
+
+void CPolygonBVH::build(const std::vector<TPolygonWithPlane>& polys)
+{
+	clear();
+	const size_t N = polys.size();
+	if (!N) return;
+
+	std::vector<TBuildItem> items(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		auto& it = items[i];
+		const auto& poly = polys[i].poly;
+		it.bb_min = TPoint3D(
+			std::numeric_limits<double>::max(),
+			std::numeric_limits<double>::max(),
+			std::numeric_limits<double>::max());
+		it.bb_max = TPoint3D(
+			-std::numeric_limits<double>::max(),
+			-std::numeric_limits<double>::max(),
+			-std::numeric_limits<double>::max());
+		for (const auto& pt : poly)
+			for (int k = 0; k < 3; k++)
+			{
+				it.bb_min[k] = std::min(it.bb_min[k], pt[k]);
+				it.bb_max[k] = std::max(it.bb_max[k], pt[k]);
+			}
+		for (int k = 0; k < 3; k++)
+			it.centroid[k] = 0.5 * (it.bb_min[k] + it.bb_max[k]);
+	}
+
+	m_indices.resize(N);
+	for (size_t i = 0; i < N; i++) m_indices[i] = static_cast<uint32_t>(i);
+	m_nodes.reserve(2 * N / BVH_LEAF_SIZE + 1);
+
+	// Recursive top-down construction, splitting at the median of the
+	// centroids along the axis of largest extent:
+	struct Builder
+	{
+		const std::vector<TBuildItem>& items;
+		std::vector<TNode>& nodes;
+		std::vector<uint32_t>& idxs;
+
+		void operator()(size_t begin, size_t end, size_t depth)
+		{
+			const size_t nodeIdx = nodes.size();
+			nodes.emplace_back();
+			TNode n;
+			TPoint3D c_min, c_max;
+			for (int k = 0; k < 3; k++)
+			{
+				n.bb_min[k] = c_min[k] = std::numeric_limits<double>::max();
+				n.bb_max[k] = c_max[k] = -std::numeric_limits<double>::max();
+			}
+			for (size_t i = begin; i < end; i++)
+			{
+				const auto& it = items[idxs[i]];
+				for (int k = 0; k < 3; k++)
+				{
+					n.bb_min[k] = std::min(n.bb_min[k], it.bb_min[k]);
+					n.bb_max[k] = std::max(n.bb_max[k], it.bb_max[k]);
+					c_min[k] = std::min(c_min[k], it.centroid[k]);
+					c_max[k] = std::max(c_max[k], it.centroid[k]);
+				}
+			}
+			if (end - begin <= BVH_LEAF_SIZE || depth >= BVH_MAX_DEPTH)
+			{
+				n.idx = static_cast<uint32_t>(begin);
+				n.count = static_cast<uint32_t>(end - begin);
+				nodes[nodeIdx] = n;
+				return;
+			}
+			int axis = 0;
+			for (int k = 1; k < 3; k++)
+				if (c_max[k] - c_min[k] > c_max[axis] - c_min[axis]) axis = k;
+
+			const size_t mid = (begin + end) / 2;
+			std::nth_element(
+				idxs.begin() + begin, idxs.begin() + mid, idxs.begin() + end,
+				[&](uint32_t a, uint32_t b) {
+					return items[a].centroid[axis] < items[b].centroid[axis];
+				});
+
+			(*this)(begin, mid, depth + 1);
+			n.idx = static_cast<uint32_t>(nodes.size());
+			n.count = 0;
+			(*this)(mid, end, depth + 1);
+			nodes[nodeIdx] = n;
+		}
+	};
+	Builder{items, m_nodes, m_indices}(0, N, 0);
+}
+
+bool CPolygonBVH::traceRay(
+	const std::vector<TPolygonWithPlane>& polys,
+	const mrpt::math::TPose3D& pose, double& dist) const
+{
+	TLine3D lin;
+	createFromPoseX(pose, lin);
+	lin.unitarize();
+	return traceRay(polys, lin, dist);
+}
+
+bool CPolygonBVH::traceRay(
+	const std::vector<TPolygonWithPlane>& polys, const TLine3D& ray,
+	double& dist) const
+{
+	dist = HUGE_VAL;
+	if (m_nodes.empty()) return false;
+	ASSERTDEB_(polys.size() == m_indices.size());
+
+	double inv_dir[3];
+	for (int k = 0; k < 3; k++)
+		inv_dir[k] = std::abs(ray.director[k]) > 0 ? 1.0 / ray.director[k] : 0;
+
+	bool hit = false;
+	// Stack of (node, entry distance):
+	std::pair<uint32_t, double> stack[BVH_STACK_SIZE];
+	int sp = 0;
+	const double t0 =
+		rayBoxEntry(m_nodes[0].bb_min, m_nodes[0].bb_max, ray, inv_dir, dist);
+	if (t0 < 0) return false;
+	stack[sp++] = {0, t0};
+
+	while (sp > 0)
+	{
+		const auto cur = stack[--sp];
+		if (cur.second > dist) continue;  // Already found something closer
+		const TNode& n = m_nodes[cur.first];
+		if (n.count)
+		{
+			for (uint32_t i = n.idx; i < n.idx + n.count; i++)
+			{
+				double d;
+				if (rayPolygon(polys[m_indices[i]], ray, d, dist))
+				{
+					hit = true;
+					dist = d;
+				}
+			}
+			continue;
+		}
+		// Inner node: visit the nearest child first.
+		const uint32_t c1 = cur.first + 1, c2 = n.idx;
+		const double d1 = rayBoxEntry(
+			m_nodes[c1].bb_min, m_nodes[c1].bb_max, ray, inv_dir, dist);
+		const double d2 = rayBoxEntry(
+			m_nodes[c2].bb_min, m_nodes[c2].bb_max, ray, inv_dir, dist);
+		ASSERTDEB_(sp + 2 <= BVH_STACK_SIZE);
+		if (d1 >= 0 && d2 >= 0)
+		{
+			if (d1 < d2)
+			{
+				stack[sp++] = {c2, d2};
+				stack[sp++] = {c1, d1};
+			}
+			else
+			{
+				stack[sp++] = {c1, d1};
+				stack[sp++] = {c2, d2};
+			}
+		}
+		else if (d1 >= 0)
+			stack[sp++] = {c1, d1};
+		else if (d2 >= 0)
+			stack[sp++] = {c2, d2};
+	}
+	return hit;
+}
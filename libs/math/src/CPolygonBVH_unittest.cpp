@@ -0,0 +1,86 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/math/CPolygonBVH.h>
+#include <mrpt/random.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt::math;
+
+TEST(CPolygonBVH, SameResultsAsBruteForce)
+{
+	auto& rnd = mrpt::random::getRandomGenerator();
+	rnd.randomize(123);
+
+	// Random small triangles within a 10x10x10 cube:
+	std::vector<TPolygon3D> tris;
+	for (int i = 0; i < 2000; i++)
+	{
+		const TPoint3D c(
+			rnd.drawUniform(-5, 5), rnd.drawUniform(-5, 5),
+			rnd.drawUniform(-5, 5));
+		TPolygon3D t(3);
+		for (int v = 0; v < 3; v++)
+			t[v] = TPoint3D(
+				c.x + rnd.drawUniform(-0.5, 0.5),
+				c.y + rnd.drawUniform(-0.5, 0.5),
+				c.z + rnd.drawUniform(-0.5, 0.5));
+		tris.push_back(t);
+	}
+	std::vector<TPolygonWithPlane> polys;
+	TPolygonWithPlane::getPlanes(tris, polys);
+
+	CPolygonBVH bvh;
+	EXPECT_TRUE(bvh.empty());
+	bvh.build(polys);
+	EXPECT_FALSE(bvh.empty());
+
+	int nHits = 0;
+	for (int i = 0; i < 500; i++)
+	{
+		const TPose3D ray(
+			rnd.drawUniform(-6, 6), rnd.drawUniform(-6, 6),
+			rnd.drawUniform(-6, 6), rnd.drawUniform(-M_PI, M_PI),
+			rnd.drawUniform(-1.5, 1.5), 0);
+		double d_bf, d_bvh;
+		const bool hit_bf = traceRay(polys, ray, d_bf);
+		const bool hit_bvh = bvh.traceRay(polys, ray, d_bvh);
+		EXPECT_EQ(hit_bf, hit_bvh) << "ray: " << ray.asString();
+		if (hit_bf && hit_bvh)
+		{
+			EXPECT_NEAR(d_bf, d_bvh, 1e-6) << "ray: " << ray.asString();
+			nHits++;
+		}
+	}
+	// Make sure the test is meaningful:
+	EXPECT_GT(nHits, 50);
+}
+
+TEST(CPolygonBVH, EmptyAndAxisAlignedRays)
+{
+	CPolygonBVH bvh;
+	std::vector<TPolygonWithPlane> polys;
+	bvh.build(polys);
+	double d;
+	EXPECT_FALSE(bvh.traceRay(polys, TPose3D(0, 0, 0, 0, 0, 0), d));
+
+	// A unit square in the plane x=2:
+	TPolygon3D sq(4);
+	sq[0] = TPoint3D(2, -1, -1);
+	sq[1] = TPoint3D(2, 1, -1);
+	sq[2] = TPoint3D(2, 1, 1);
+	sq[3] = TPoint3D(2, -1, 1);
+	polys.emplace_back(sq);
+	bvh.build(polys);
+
+	EXPECT_TRUE(bvh.traceRay(polys, TPose3D(0, 0, 0, 0, 0, 0), d));
+	EXPECT_NEAR(d, 2.0, 1e-9);
+	EXPECT_FALSE(bvh.traceRay(polys, TPose3D(0, 0, 0, M_PI, 0, 0), d));
+	EXPECT_FALSE(bvh.traceRay(polys, TPose3D(0, 3, 0, 0, 0, 0), d));
+}
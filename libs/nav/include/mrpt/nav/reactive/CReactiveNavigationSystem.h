@@ -9,6 +9,7 @@
 #pragma once
 
 #include "CAbstractPTGBasedReactive.h"
+#include <mrpt/nav/tpspace/CObstacleDistanceField.h>
 
 namespace mrpt::nav
 {
@@ -100,6 +101,17 @@ class CReactiveNavigationSystem : public CAbstractPTGBasedReactive
 			max_obstacles_height{
 				10.0};  // The range of "z" coordinates for obstacles
 		// to be considered
+		/** If true, obstacles are rasterized once per navigation step into a
+		 * CObstacleDistanceField and all PTG paths are evaluated against it,
+		 * at a cost independent of the number of obstacle points (Default:
+		 * false, evaluate each obstacle point against each PTG).
+		 * \sa CParameterizedTrajectoryGenerator::updateTPObstacleFromDistanceField
+		 */
+		bool use_distance_field{false};
+		/** Cell size of the distance field (meters), if
+		 * `use_distance_field`=true. Collision checks are conservative by
+		 * about 1.5 times this value. */
+		double distance_field_resolution{0.05};
 
 		void loadFromConfigFile(
 			const mrpt::config::CConfigFileBase& c,
@@ -146,6 +158,23 @@ class CReactiveNavigationSystem : public CAbstractPTGBasedReactive
 	mrpt::maps::CSimplePointsMap m_WS_Obstacles;
 	/** Obstacle points, before filtering (if filtering is enabled). */
 	mrpt::maps::CSimplePointsMap m_WS_Obstacles_original;
+	/** Distance field of the obstacles (only if
+	 * params_reactive_nav.use_distance_field=true), in the frame of the
+	 * last PTG origin passed to STEP3_WSpaceToTPSpace() */
+	mrpt::nav::CObstacleDistanceField m_WS_distance_field;
+	/** Obstacles (in the same frame than m_WS_distance_field) too close to
+	 * the robot to be part of the distance field. See
+	 * CParameterizedTrajectoryGenerator::getDistanceFieldExclusionRadius() */
+	std::vector<mrpt::math::TPoint2D> m_WS_distance_field_near_obs;
+	/** Whether m_WS_distance_field is up to date with m_WS_Obstacles */
+	bool m_WS_distance_field_valid{false};
+	mrpt::math::TPose2D m_WS_distance_field_pose;
+	double m_WS_distance_field_exclusion_radius{.0};
+	/** Updates m_WS_distance_field for the given pose of the PTG origin, if
+	 * needed */
+	void updateDistanceField(
+		const mrpt::poses::CPose2D& rel_pose_PTG_origin_wrt_sense,
+		const CParameterizedTrajectoryGenerator& ptg);
 	// See docs in parent class
 	void STEP3_WSpaceToTPSpace(
 		const size_t ptg_idx, std::vector<double>& out_TPObstacles,
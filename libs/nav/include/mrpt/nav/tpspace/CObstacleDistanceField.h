@@ -0,0 +1,81 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/containers/CDynamicGrid.h>
+#include <mrpt/math/lightweight_geom_data.h>
+#include <vector>
+
+namespace mrpt::nav
+{
+/** A robot-local 2D grid with the Euclidean distance from each cell center to
+ * the closest obstacle, used to evaluate PTG paths against a set of obstacles
+ * at a cost proportional to the number of path samples, instead of the
+ * number of obstacle points.
+ *
+ * Obstacles are rasterized into cells and an exact Euclidean distance
+ * transform (two separable passes of the lower envelope of parabolas, by
+ * Felzenszwalb & Huttenlocher) is computed once per navigation cycle with
+ * compute(). Distances are saturated at `max_distance`. Note that since
+ * obstacles and queries are both quantized to cell centers, the true
+ * distance may be smaller than distanceAt() by up to getCellMargin().
+ *
+ * \sa CParameterizedTrajectoryGenerator::updateTPObstacleFromDistanceField
+ * \ingroup nav_tpspace
+ */
+class CObstacleDistanceField : public mrpt::containers::CDynamicGrid<float>
+{
+   public:
+	/** Creates an empty field covering [-half_size,half_size] in both x and y
+	 * (meters), with the given cell size (meters).  */
+	CObstacleDistanceField(
+		double half_size = 6.0, double resolution = 0.05,
+		double max_distance = 3.0);
+
+	/** Changes the area and resolution of the field, erasing its contents.
+	 * `half_size` is rounded up to a whole number of cells. */
+	void setLimits(double half_size, double resolution, double max_distance);
+
+	/** Rasterizes the obstacles (in the same frame than the field) and
+	 * computes the distance of all cells. Obstacles out of the grid area are
+	 * ignored. */
+	void compute(const std::vector<mrpt::math::TPoint2D>& obstacles);
+
+	/** Distance from (x,y) to the closest obstacle (saturated at
+	 * getMaxDistance()), or getMaxDistance() for points out of the grid. */
+	inline float distanceAt(double x, double y) const
+	{
+		const int cx = x2idx(x), cy = y2idx(y);
+		if (cx < 0 || cy < 0 || cx >= static_cast<int>(m_size_x) ||
+			cy >= static_cast<int>(m_size_y))
+			return m_max_distance;
+		return m_map[cx + cy * m_size_x];
+	}
+
+	/** Largest difference between distanceAt() and the exact distance to the
+	 * obstacles due to quantization (the diagonal of one cell) */
+	inline double getCellMargin() const { return m_resolution * M_SQRT2; }
+	/** Saturation distance of the field (m) */
+	inline float getMaxDistance() const { return m_max_distance; }
+	/** Number of obstacles rasterized in the last call to compute() */
+	inline size_t getObstacleCount() const { return m_num_obstacles; }
+
+   protected:
+	float m_max_distance{3.0f};
+	size_t m_num_obstacles{0};
+	/** Working buffers for the 1D transform */
+	std::vector<float> m_f, m_d;
+	std::vector<int> m_v;
+	std::vector<float> m_z;
+
+	/** 1D squared distance transform of m_f[0:n-1] into m_d */
+	void dt1d(size_t n);
+};
+
+}  // namespace mrpt::nav
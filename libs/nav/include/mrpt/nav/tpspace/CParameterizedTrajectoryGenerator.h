@@ -31,6 +31,8 @@ namespace mrpt
 {
 namespace nav
 {
+class CObstacleDistanceField;
+
 /** Defines behaviors for where there is an obstacle *inside* the robot shape
  *right at the beginning of a PTG trajectory.
  *\ingroup nav_tpspace
@@ -443,6 +445,50 @@ class CParameterizedTrajectoryGenerator
 	void updateClearancePost(
 		ClearanceDiagram& cd, const std::vector<double>& TP_obstacles) const;
 
+	/** @name Collision checking against a distance field
+	 * @{ */
+
+	/** Returns a set of points (in the robot frame) such as the union of
+	 * circles of radius `pt_radius` centered at them covers the border of the
+	 * robot shape. `spacing` is the suggested distance between samples.
+	 * Default implementation: a circle of radius getMaxRobotRadius(). */
+	virtual void getRobotShapeSamples(
+		const double spacing, std::vector<mrpt::math::TPoint2D>& pts,
+		double& pt_radius) const;
+
+	/** Obstacles closer than this distance to the PTG origin must NOT be
+	 * included in a CObstacleDistanceField passed to
+	 * updateTPObstacleFromDistanceField(), but evaluated one by one with
+	 * updateTPObstacle() and updateClearance() instead. This keeps the
+	 * behavior for obstacles inside or touching the robot shape (see
+	 * COLLISION_BEHAVIOR) and guarantees that the initial robot pose is
+	 * collision-free in the distance field. */
+	double getDistanceFieldExclusionRadius(
+		const CObstacleDistanceField& df) const;
+
+	/** Like calling updateTPObstacle() for all the obstacles rasterized in a
+	 * distance field (in coordinates relative to the PTG origin), but with a
+	 * cost proportional to the number of path steps instead of the number of
+	 * obstacles: each path is followed until the first pose where the robot
+	 * shape (see getRobotShapeSamples()) gets closer than one cell diagonal to
+	 * an obstacle, skipping poses which cannot collide given the free space
+	 * around the last checked one.
+	 * Results are conservative wrt updateTPObstacle() by up to one cell
+	 * diagonal, plus the sampling of the shape.
+	 * \note `tp_obstacles` must be initialized with initTPObstacles() before
+	 * call.
+	 * \sa getDistanceFieldExclusionRadius()
+	 */
+	void updateTPObstacleFromDistanceField(
+		const CObstacleDistanceField& df,
+		std::vector<double>& tp_obstacles) const;
+
+	/** Like calling updateClearance() for all the obstacles in a distance
+	 * field. \sa updateTPObstacleFromDistanceField() */
+	void updateClearanceFromDistanceField(
+		const CObstacleDistanceField& df, ClearanceDiagram& cd) const;
+	/** @} */
+
    protected:
 	double refDistance{.0};
 	/** The number of discrete values for "alpha" between -PI and +PI. */
@@ -519,6 +565,9 @@ class CPTG_RobotShape_Polygonal : public CParameterizedTrajectoryGenerator
 		const double ox, const double oy) const override;
 	/** @} */
 	bool isPointInsideRobotShape(const double x, const double y) const override;
+	void getRobotShapeSamples(
+		const double spacing, std::vector<mrpt::math::TPoint2D>& pts,
+		double& pt_radius) const override;
 	void add_robotShape_to_setOfLines(
 		mrpt::opengl::CSetOfLines& gl_shape,
 		const mrpt::poses::CPose2D& origin =
@@ -566,6 +615,9 @@ class CPTG_RobotShape_Circular : public CParameterizedTrajectoryGenerator
 		const mrpt::poses::CPose2D& origin =
 			mrpt::poses::CPose2D()) const override;
 	bool isPointInsideRobotShape(const double x, const double y) const override;
+	void getRobotShapeSamples(
+		const double spacing, std::vector<mrpt::math::TPoint2D>& pts,
+		double& pt_radius) const override;
 
    protected:
 	/** Will be called whenever the robot shape is set / updated */
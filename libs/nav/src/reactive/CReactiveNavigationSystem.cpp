@@ -192,6 +192,8 @@ bool CReactiveNavigationSystem::implementSenseObstacles(
 			ret = m_robot.senseObstacles(m_WS_Obstacles, obstacles_timestamp);
 		}
 
+		m_WS_distance_field_valid = false;
+
 		// Optional filtering of obstacles:
 		m_WS_Obstacles_original = m_WS_Obstacles;
 		if (ret && m_WS_filter)
@@ -234,6 +236,25 @@ void CReactiveNavigationSystem::STEP3_WSpaceToTPSpace(
 
 	const float OBS_MAX_XY = params_abstract_ptg_navigator.ref_distance * 1.1f;
 
+	if (params_reactive_nav.use_distance_field)
+	{
+		updateDistanceField(rel_pose_PTG_origin_wrt_sense, *ptg);
+
+		// Obstacles near the robot: evaluated one by one
+		for (const auto& o : m_WS_distance_field_near_obs)
+		{
+			ptg->updateTPObstacle(o.x, o.y, out_TPObstacles);
+			if (eval_clearance) ptg->updateClearance(o.x, o.y, out_clearance);
+		}
+		// All the rest: at once
+		ptg->updateTPObstacleFromDistanceField(
+			m_WS_distance_field, out_TPObstacles);
+		if (eval_clearance)
+			ptg->updateClearanceFromDistanceField(
+				m_WS_distance_field, out_clearance);
+		return;
+	}
+
 	// Merge all the (k,d) for which the robot collides with each obstacle
 	// point:
 	size_t nObs;
@@ -258,6 +279,65 @@ void CReactiveNavigationSystem::STEP3_WSpaceToTPSpace(
 	}
 }
 
+void CReactiveNavigationSystem::updateDistanceField(
+	const mrpt::poses::CPose2D& rel_pose_PTG_origin_wrt_sense,
+	const CParameterizedTrajectoryGenerator& ptg)
+{
+	// Same bound than in STEP3_WSpaceToTPSpace():
+	const float OBS_MAX_XY = params_abstract_ptg_navigator.ref_distance * 1.1f;
+	const double res = params_reactive_nav.distance_field_resolution;
+
+	// (setLimits() rounds up the size to whole cells; the tolerance is for
+	// round-off errors only)
+	if (m_WS_distance_field.getResolution() != res ||
+		m_WS_distance_field.getXMax() < OBS_MAX_XY - 1e-3 * res)
+	{
+		m_WS_distance_field.setLimits(OBS_MAX_XY, res, OBS_MAX_XY);
+		m_WS_distance_field_valid = false;
+	}
+
+	// All PTGs normally share the same robot shape and pose, so the field
+	// is computed only once per navigation step:
+	const double excl_radius =
+		ptg.getDistanceFieldExclusionRadius(m_WS_distance_field);
+	const auto rel_pose = rel_pose_PTG_origin_wrt_sense.asTPose();
+	if (m_WS_distance_field_valid && rel_pose == m_WS_distance_field_pose &&
+		excl_radius == m_WS_distance_field_exclusion_radius)
+		return;
+
+	CTimeLoggerEntry tle(m_timelogger, "STEP3_WSpaceToTPSpace.distanceField");
+
+	size_t nObs;
+	const float *xs, *ys, *zs;
+	m_WS_Obstacles.getPointsBuffer(nObs, xs, ys, zs);
+
+	std::vector<mrpt::math::TPoint2D> far_obs;
+	far_obs.reserve(nObs);
+	m_WS_distance_field_near_obs.clear();
+	const double excl_radius2 = excl_radius * excl_radius;
+	for (size_t obs = 0; obs < nObs; obs++)
+	{
+		const double oz = zs[obs];
+		if (oz < params_reactive_nav.min_obstacles_height ||
+			oz > params_reactive_nav.max_obstacles_height)
+			continue;
+		mrpt::math::TPoint2D o;
+		rel_pose_PTG_origin_wrt_sense.composePoint(xs[obs], ys[obs], o.x, o.y);
+		if (o.x <= -OBS_MAX_XY || o.x >= OBS_MAX_XY || o.y <= -OBS_MAX_XY ||
+			o.y >= OBS_MAX_XY)
+			continue;
+		if (o.x * o.x + o.y * o.y < excl_radius2)
+			m_WS_distance_field_near_obs.push_back(o);
+		else
+			far_obs.push_back(o);
+	}
+	m_WS_distance_field.compute(far_obs);
+
+	m_WS_distance_field_valid = true;
+	m_WS_distance_field_pose = rel_pose;
+	m_WS_distance_field_exclusion_radius = excl_radius;
+}
+
 /** Generates a pointcloud of obstacles, and the robot shape, to be saved in the
  * logging record for the current timestep
  * \callergraph */
@@ -284,6 +364,8 @@ void CReactiveNavigationSystem::TReactiveNavigatorParams::loadFromConfigFile(
 {
 	MRPT_LOAD_CONFIG_VAR_REQUIRED_CS(min_obstacles_height, double);
 	MRPT_LOAD_CONFIG_VAR_REQUIRED_CS(max_obstacles_height, double);
+	MRPT_LOAD_CONFIG_VAR_CS(use_distance_field, bool);
+	MRPT_LOAD_CONFIG_VAR_CS(distance_field_resolution, double);
 }
 
 void CReactiveNavigationSystem::TReactiveNavigatorParams::saveToConfigFile(
@@ -297,6 +379,13 @@ void CReactiveNavigationSystem::TReactiveNavigatorParams::saveToConfigFile(
 		max_obstacles_height,
 		"Maximum `z` coordinate of obstacles to be considered fo collision "
 		"checking");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		use_distance_field,
+		"Evaluate PTGs against a distance field of obstacles, instead of "
+		"each obstacle point");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		distance_field_resolution,
+		"Cell size of the distance field, if `use_distance_field`=true [m]");
 }
 
 CReactiveNavigationSystem::TReactiveNavigatorParams::TReactiveNavigatorParams()
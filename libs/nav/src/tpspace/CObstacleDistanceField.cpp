@@ -0,0 +1,124 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "nav-precomp.h"  // Precomp header
+
+#include <mrpt/nav/tpspace/CObstacleDistanceField.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace mrpt::nav;
+
+CObstacleDistanceField::CObstacleDistanceField(
+	double half_size, double resolution, double max_distance)
+{
+	setLimits(half_size, resolution, max_distance);
+}
+
+void CObstacleDistanceField::setLimits(
+	double half_size, double resolution, double max_distance)
+{
+	ASSERT_ABOVE_(half_size, 0);
+	ASSERT_ABOVE_(resolution, 0);
+	ASSERT_ABOVE_(max_distance, 0);
+	m_max_distance = static_cast<float>(max_distance);
+	// Round up to whole cells, since setSize() rounds to the nearest one and
+	// would leave out the border:
+	const double hs = resolution * std::ceil(half_size / resolution);
+	setSize(-hs, hs, -hs, hs, resolution, &m_max_distance);
+	m_num_obstacles = 0;
+}
+
+// Lower envelope of parabolas rooted at (q, m_f[q]). See: P. Felzenszwalb,
+// D. Huttenlocher, "Distance Transforms of Sampled Functions", 2012.
+void CObstacleDistanceField::dt1d(size_t n)
+{
+	const float INF = std::numeric_limits<float>::infinity();
+	m_d.resize(n);
+	m_v.resize(n);
+	m_z.resize(n + 1);
+
+	int k = -1;
+	for (size_t iq = 0; iq < n; iq++)
+	{
+		if (m_f[iq] == INF) continue;
+		const int q = static_cast<int>(iq);
+		float s = -INF;
+		while (k >= 0)
+		{
+			const int p = m_v[k];
+			s = ((m_f[q] + q * q) - (m_f[p] + p * p)) / (2.0f * (q - p));
+			if (s > m_z[k]) break;
+			k--;
+		}
+		k++;
+		m_v[k] = q;
+		m_z[k] = k == 0 ? -INF : s;
+		m_z[k + 1] = INF;
+	}
+	if (k < 0)
+	{
+		std::fill(m_d.begin(), m_d.end(), INF);
+		return;
+	}
+	int j = 0;
+	for (size_t iq = 0; iq < n; iq++)
+	{
+		const float q = static_cast<float>(iq);
+		while (m_z[j + 1] < q) j++;
+		const float dq = q - m_v[j];
+		m_d[iq] = dq * dq + m_f[m_v[j]];
+	}
+}
+
+void CObstacleDistanceField::compute(
+	const std::vector<mrpt::math::TPoint2D>& obstacles)
+{
+	const float INF = std::numeric_limits<float>::infinity();
+	const size_t nx = m_size_x, ny = m_size_y;
+	if (!nx || !ny) return;
+
+	// Rasterize: squared distances (in cells) are 0 at obstacles:
+	m_map.assign(nx * ny, INF);
+	m_num_obstacles = 0;
+	for (const auto& o : obstacles)
+	{
+		const int cx = x2idx(o.x), cy = y2idx(o.y);
+		if (cx < 0 || cy < 0 || cx >= static_cast<int>(nx) ||
+			cy >= static_cast<int>(ny))
+			continue;
+		m_map[cx + cy * nx] = 0;
+		m_num_obstacles++;
+	}
+	if (!m_num_obstacles)
+	{
+		fill(m_max_distance);
+		return;
+	}
+
+	// Columns:
+	m_f.resize(std::max(nx, ny));
+	for (size_t cx = 0; cx < nx; cx++)
+	{
+		for (size_t cy = 0; cy < ny; cy++) m_f[cy] = m_map[cx + cy * nx];
+		dt1d(ny);
+		for (size_t cy = 0; cy < ny; cy++) m_map[cx + cy * nx] = m_d[cy];
+	}
+	// Rows, then convert to saturated metric distances:
+	const float res = static_cast<float>(m_resolution);
+	for (size_t cy = 0; cy < ny; cy++)
+	{
+		float* row = &m_map[cy * nx];
+		std::copy(row, row + nx, m_f.begin());
+		dt1d(nx);
+		for (size_t cx = 0; cx < nx; cx++)
+			row[cx] = std::min(m_max_distance, res * std::sqrt(m_d[cx]));
+	}
+}
@@ -116,3 +116,23 @@ double CPTG_RobotShape_Circular::evalClearanceToRobotShape(
 {
 	return mrpt::hypot_fast(ox, oy) - m_robotRadius;
 }
+
+void CPTG_RobotShape_Circular::getRobotShapeSamples(
+	const double spacing, std::vector<mrpt::math::TPoint2D>& pts,
+	double& pt_radius) const
+{
+	ASSERT_ABOVE_(spacing, 0);
+	// Samples along the circle, such as any point of the border is within
+	// spacing/2 of one of them (arcs between samples are not longer than
+	// spacing):
+	const size_t N =
+		std::max<size_t>(3, std::ceil(2 * M_PI * m_robotRadius / spacing));
+	pts.resize(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		const double ang = i * 2 * M_PI / N;
+		pts[i] = mrpt::math::TPoint2D(
+			m_robotRadius * cos(ang), m_robotRadius * sin(ang));
+	}
+	pt_radius = 0.5 * spacing;
+}
@@ -168,3 +168,27 @@ double CPTG_RobotShape_Polygonal::evalClearanceToRobotShape(
 
 	return d;
 }
+
+void CPTG_RobotShape_Polygonal::getRobotShapeSamples(
+	const double spacing, std::vector<mrpt::math::TPoint2D>& pts,
+	double& pt_radius) const
+{
+	ASSERT_ABOVE_(spacing, 0);
+	pts.clear();
+	// Samples along each edge, such as any point of the border is within
+	// spacing/2 of one of them:
+	const size_t N = m_robotShape.size();
+	for (size_t i = 0; i < N; i++)
+	{
+		const auto& a = m_robotShape[i];
+		const auto& b = m_robotShape[(i + 1) % N];
+		const double len = (b - a).norm();
+		const size_t nSteps = std::max<size_t>(1, std::ceil(len / spacing));
+		for (size_t s = 0; s < nSteps; s++)
+		{
+			const double t = (s + 0.5) / nSteps;
+			pts.emplace_back(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y));
+		}
+	}
+	pt_radius = 0.5 * spacing;
+}
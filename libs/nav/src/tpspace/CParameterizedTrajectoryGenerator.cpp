@@ -11,9 +11,11 @@
 
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/nav/tpspace/CParameterizedTrajectoryGenerator.h>
+#include <mrpt/nav/tpspace/CObstacleDistanceField.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/os.h>
 #include <mrpt/opengl/CSetOfLines.h>
+#include <limits>
 
 using namespace mrpt::nav;
 
@@ -568,6 +570,158 @@ void CParameterizedTrajectoryGenerator::evalClearanceSingleObstacle(
 	}
 }
 
+// Distance between robot shape samples, for a given field resolution:
+static double shapeSamplesSpacing(const CObstacleDistanceField& df)
+{
+	return 2.0 * df.getResolution();
+}
+
+void CParameterizedTrajectoryGenerator::getRobotShapeSamples(
+	const double spacing, std::vector<mrpt::math::TPoint2D>& pts,
+	double& pt_radius) const
+{
+	pts.assign(1, mrpt::math::TPoint2D(0, 0));
+	pt_radius = getMaxRobotRadius();
+}
+
+double CParameterizedTrajectoryGenerator::getDistanceFieldExclusionRadius(
+	const CObstacleDistanceField& df) const
+{
+	std::vector<mrpt::math::TPoint2D> pts;
+	double pt_radius;
+	getRobotShapeSamples(shapeSamplesSpacing(df), pts, pt_radius);
+	double max_norm = 0;
+	for (const auto& p : pts) mrpt::keep_max(max_norm, p.norm());
+	// distanceAt() may underestimate by one margin, and the collision test
+	// in updateTPObstacleFromDistanceField() adds another one:
+	return max_norm + pt_radius + 2 * df.getCellMargin();
+}
+
+void CParameterizedTrajectoryGenerator::updateTPObstacleFromDistanceField(
+	const CObstacleDistanceField& df, std::vector<double>& tp_obstacles) const
+{
+	ASSERT_EQUAL_(tp_obstacles.size(), m_alphaValuesCount);
+
+	std::vector<mrpt::math::TPoint2D> samples;
+	double pt_radius;
+	getRobotShapeSamples(shapeSamplesSpacing(df), samples, pt_radius);
+	const double margin = df.getCellMargin();
+	// Radius of the samples around the robot center, and of their circles:
+	double R = 0;
+	for (const auto& p : samples) mrpt::keep_max(R, p.norm());
+	const double R_cover = R + pt_radius;
+
+	for (uint16_t k = 0; k < m_alphaValuesCount; k++)
+	{
+		const size_t nSteps = getPathStepCount(k);
+		// Free space around the robot at `last_checked`: any pose whose
+		// displacement wrt it is smaller cannot collide.
+		double free_radius = .0;
+		mrpt::math::TPose2D pose, last_checked;
+
+		// Step 0 is collision-free (see getDistanceFieldExclusionRadius())
+		for (size_t step = 1; step < nSteps; step++)
+		{
+			const double dist = getPathDist(k, step);
+			if (dist >= tp_obstacles[k]) break;  // No need to go further
+			getPathPose(k, step, pose);
+
+			if (free_radius > 0)
+			{
+				// Upper bound of the displacement of any shape sample:
+				const double motion =
+					mrpt::hypot_fast(
+						pose.x - last_checked.x, pose.y - last_checked.y) +
+					R * std::abs(mrpt::math::angDistance(
+							pose.phi, last_checked.phi));
+				if (motion < free_radius) continue;
+			}
+
+			last_checked = pose;
+			// If positive, no sample can fail the test below:
+			free_radius =
+				df.distanceAt(pose.x, pose.y) - 3 * margin - R_cover;
+			if (free_radius > 0) continue;
+			free_radius = 0;
+
+			// Full check of the shape:
+			const double ccos = cos(pose.phi), csin = sin(pose.phi);
+			bool collision = false;
+			for (const auto& s : samples)
+			{
+				const double gx = pose.x + ccos * s.x - csin * s.y;
+				const double gy = pose.y + csin * s.x + ccos * s.y;
+				if (df.distanceAt(gx, gy) - margin < pt_radius)
+				{
+					collision = true;
+					break;
+				}
+			}
+			if (collision)
+			{
+				mrpt::keep_min(tp_obstacles[k], dist);
+				break;
+			}
+		}
+	}
+}
+
+void CParameterizedTrajectoryGenerator::updateClearanceFromDistanceField(
+	const CObstacleDistanceField& df, ClearanceDiagram& cd) const
+{
+	ASSERT_(cd.get_actual_num_paths() == m_alphaValuesCount);
+
+	std::vector<mrpt::math::TPoint2D> samples;
+	double pt_radius;
+	getRobotShapeSamples(shapeSamplesSpacing(df), samples, pt_radius);
+	const double margin = df.getCellMargin();
+
+	for (uint16_t decim_k = 0; decim_k < cd.get_decimated_num_paths();
+		 decim_k++)
+	{
+		const auto k = cd.decimated_k_to_real_k(decim_k);
+		auto& dist2clearance = cd.get_path_clearance_decimated(decim_k);
+
+		// Same path sampling than evalClearanceSingleObstacle():
+		const size_t numPathSteps = getPathStepCount(k);
+		ASSERT_(numPathSteps > dist2clearance.size());
+		const double numStepsPerIncr =
+			(numPathSteps - 1.0) / (dist2clearance.size());
+		double step_pointer_dbl = 0.0;
+		bool had_collision = false;
+
+		for (auto& e : dist2clearance)
+		{
+			step_pointer_dbl += numStepsPerIncr;
+			const size_t step = mrpt::round(step_pointer_dbl);
+			if (had_collision)
+			{
+				e.second = .0;
+				continue;
+			}
+
+			mrpt::math::TPose2D pose;
+			getPathPose(k, step, pose);
+			const double ccos = cos(pose.phi), csin = sin(pose.phi);
+			double clearance = std::numeric_limits<double>::max();
+			for (const auto& s : samples)
+			{
+				const double gx = pose.x + ccos * s.x - csin * s.y;
+				const double gy = pose.y + csin * s.x + ccos * s.y;
+				mrpt::keep_min(
+					clearance, df.distanceAt(gx, gy) - margin - pt_radius);
+			}
+			if (clearance <= .0)
+			{
+				had_collision = true;
+				e.second = .0;
+			}
+			else
+				mrpt::keep_min(e.second, clearance / refDistance);
+		}
+	}
+}
+
 CParameterizedTrajectoryGenerator::TNavDynamicState::TNavDynamicState()
 	: curVelLocal(0, 0, 0), relTarget(20.0, 0, 0)
 
@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 
 #include <mrpt/nav/tpspace/CParameterizedTrajectoryGenerator.h>
+#include <mrpt/nav/tpspace/CObstacleDistanceField.h>
 #include <mrpt/config/CConfigFile.h>
 #include <mrpt/system/filesystem.h>
 #include <gtest/gtest.h>
@@ -184,6 +185,46 @@ TEST(NavTests, PTGs_tests)
 			EXPECT_TRUE(any_change_all);
 		}
 
+		// TEST: TP_obstacles from a distance field vs. per obstacle point
+		{
+			CObstacleDistanceField df(refDist * 1.1, 0.05, refDist * 1.1);
+			const double excl_radius = ptg->getDistanceFieldExclusionRadius(df);
+
+			std::vector<mrpt::math::TPoint2D> obs;
+			for (double ang = 0; ang < 2 * M_PI; ang += 0.05)
+			{
+				const double r = (0.3 + 0.2 * std::cos(5 * ang)) * refDist;
+				if (r < excl_radius) continue;
+				obs.emplace_back(r * std::cos(ang), r * std::sin(ang));
+			}
+			df.compute(obs);
+			EXPECT_EQ(df.getObstacleCount(), obs.size());
+
+			std::vector<double> TP_obs_pts, TP_obs_df;
+			ptg->initTPObstacles(TP_obs_pts);
+			TP_obs_df = TP_obs_pts;
+			for (const auto& o : obs)
+				ptg->updateTPObstacle(o.x, o.y, TP_obs_pts);
+			ptg->updateTPObstacleFromDistanceField(df, TP_obs_df);
+
+			// The distance field must be conservative, save the
+			// discretization of the per-point method in some PTGs. It may be
+			// too conservative for paths grazing obstacles, but not for most
+			// of them:
+			const double tol = 0.5;
+			size_t num_blocked = 0, num_similar = 0;
+			for (size_t k = 0; k < num_paths; k++)
+			{
+				EXPECT_LT(TP_obs_df[k], TP_obs_pts[k] + tol)
+					<< "PTG: " << sPTGDesc << "\nk=" << k;
+				if (TP_obs_df[k] > TP_obs_pts[k] - tol) num_similar++;
+				if (TP_obs_df[k] < 0.9 * refDist) num_blocked++;
+				num_tests_run++;
+			}
+			EXPECT_GT(num_similar, 0.75 * num_paths) << "PTG: " << sPTGDesc;
+			EXPECT_GT(num_blocked, 0U) << "PTG: " << sPTGDesc;
+		}
+
 		printf(
 			"PTG `%50s` run %6u tests.\n", sPTGDesc.c_str(),
 			(unsigned int)num_tests_run);
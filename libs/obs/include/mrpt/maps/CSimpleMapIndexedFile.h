@@ -0,0 +1,125 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/maps/CSimpleMap.h>
+#include <mrpt/math/lightweight_geom_data.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mrpt::maps
+{
+/** Read-only access to a simplemap stored in an indexed, uncompressed file,
+ * whose keyframes (the `<pose PDF, sensory frame>` pairs of a CSimpleMap) are
+ * only deserialized on demand.
+ *
+ * Opening a file only reads its index: the file offset and the mean pose of
+ * each keyframe. Then, keyframes can be loaded one by one with getKeyframe(),
+ * or the subset of keyframes within a region found with findInBox() or
+ * findInRadius() and loaded into a CSimpleMap with loadKeyframes(), e.g. to
+ * build metric maps of just that region. Files are created from a CSimpleMap
+ * with saveSimpleMap().
+ *
+ * In Linux and MacOS the file is memory-mapped, so the operating system only
+ * reads the pages of the loaded keyframes and keeps them in its cache; in
+ * other platforms, keyframes are read with regular file I/O.
+ *
+ * File format (little endian, as written by mrpt::serialization::CArchive):
+ * - Header: `uint64_t` magic number, `uint32_t` format version,
+ *   `uint32_t` (reserved), `uint64_t` number of keyframes `N` and
+ *   `uint64_t` offset of the index.
+ * - The `N` keyframes: each one, a serialized CPose3DPDF object followed by a
+ *   serialized mrpt::obs::CSensoryFrame object.
+ * - The index: for each keyframe, its `uint64_t` offset and `uint64_t` length
+ *   in bytes, and the 6 `double` components of its mean pose (x, y, z, yaw,
+ *   pitch, roll).
+ *
+ * Loading keyframes is thread-safe.
+ *
+ * \sa CSimpleMap
+ * \ingroup mrpt_obs_grp
+ */
+class CSimpleMapIndexedFile
+{
+   public:
+	/** Creates an object without any open file. \sa open */
+	CSimpleMapIndexedFile();
+	/** Opens a file, or throws if it cannot be open or is not an indexed
+	 * simplemap file. \sa open */
+	explicit CSimpleMapIndexedFile(const std::string& fileName);
+	~CSimpleMapIndexedFile();
+
+	CSimpleMapIndexedFile(const CSimpleMapIndexedFile&) = delete;
+	CSimpleMapIndexedFile& operator=(const CSimpleMapIndexedFile&) = delete;
+
+	/** Writes a simplemap into an indexed file.
+	 * \exception std::exception On any I/O error. */
+	static void saveSimpleMap(
+		const CSimpleMap& sm, const std::string& fileName);
+
+	/** Returns true if the file exists and it is an indexed simplemap file
+	 * (checking its magic number only). */
+	static bool isIndexedFile(const std::string& fileName);
+
+	/** Opens a file and loads its index, closing any previous one.
+	 * \exception std::exception On any I/O error, or if the file is not a
+	 * valid indexed simplemap file. */
+	void open(const std::string& fileName);
+	/** Closes the file, if any was open */
+	void close();
+	bool isOpen() const;
+
+	/** Number of keyframes in the file */
+	size_t size() const { return m_index.size(); }
+	bool empty() const { return m_index.empty(); }
+
+	/** The mean of the pose PDF of the i'th keyframe, read from the index
+	 * (without loading the keyframe).
+	 * \exception std::exception On index out of bounds. */
+	const mrpt::math::TPose3D& getKeyframePose(size_t index) const;
+
+	/** Loads the i'th keyframe from the file. Either output can be a nullptr.
+	 * \exception std::exception On index out of bounds or I/O errors. */
+	void getKeyframe(
+		size_t index, mrpt::poses::CPose3DPDF::Ptr& out_posePDF,
+		mrpt::obs::CSensoryFrame::Ptr& out_SF) const;
+
+	/** Returns the indices (in increasing order) of the keyframes whose mean
+	 * pose lies within the given axis-aligned box (limits included). */
+	std::vector<size_t> findInBox(
+		const mrpt::math::TPoint3D& bbox_min,
+		const mrpt::math::TPoint3D& bbox_max) const;
+	/** Returns the indices (in increasing order) of the keyframes whose mean
+	 * pose lies at a distance of `radius` or less from `center`. */
+	std::vector<size_t> findInRadius(
+		const mrpt::math::TPoint3D& center, const double radius) const;
+
+	/** Loads the given keyframes, in that order, into a simplemap (clearing
+	 * its previous contents). */
+	void loadKeyframes(
+		const std::vector<size_t>& indices, CSimpleMap& out_sm) const;
+	/** Loads all the keyframes into a simplemap */
+	void loadAll(CSimpleMap& out_sm) const;
+
+   private:
+	struct TIndexEntry
+	{
+		uint64_t offset, length;
+		mrpt::math::TPose3D pose;
+	};
+	std::vector<TIndexEntry> m_index;
+
+	/** File handle and, if supported, memory mapping (see .cpp) */
+	struct Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace mrpt::maps
@@ -121,6 +121,7 @@ class TSetOfMetricMapInitializers : public mrpt::config::CLoadableOptions
 	 *  occupancyGrid_count=<Number of mrpt::maps::COccupancyGridMap2D maps>
 	 *  octoMap_count=<Number of mrpt::maps::COctoMap maps>
 	 *  colourOctoMap_count=<Number of mrpt::slam::CColourOctoMap maps>
+	 *  voxelMap_count=<Number of mrpt::maps::CVoxelMap maps>
 	 *  gasGrid_count=<Number of mrpt::maps::CGasConcentrationGridMap2D maps>
 	 *  wifiGrid_count=<Number of mrpt::maps::CWirelessPowerGridMap2D maps>
 	 *  landmarksMap_count=<0 or 1, for creating a mrpt::maps::CLandmarksMap
@@ -170,6 +171,19 @@ class TSetOfMetricMapInitializers : public mrpt::config::CLoadableOptions
 	 *  <See COctoMap::TLikelihoodOptions>
 	 *
 	 * // ====================================================
+	 * //  Creation Options for VoxelMap ##:
+	 * [<sectionName>+"_voxelMap_##_creationOpts"]
+	 *  resolution=<value>
+	 *
+	 * // Insertion Options for VoxelMap ##:
+	 * [<sectionName>+"_voxelMap_##_insertOpts"]
+	 *  <See CVoxelMap::TInsertionOptions>
+	 *
+	 * // Likelihood Options for VoxelMap ##:
+	 * [<sectionName>+"_voxelMap_##_likelihoodOpts"]
+	 *  <See CVoxelMap::TLikelihoodOptions>
+	 *
+	 * // ====================================================
 	 * //  Creation Options for ColourOctoMap ##:
 	 * [<sectionName>+"_colourOctoMap_##_creationOpts"]
 	 *  resolution=<value>
@@ -62,3 +62,4 @@ MRPT_WARNING(
 // Very basic classes for maps:
 #include <mrpt/maps/CMetricMap.h>
 #include <mrpt/maps/CSimpleMap.h>
+#include <mrpt/maps/CSimpleMapIndexedFile.h>
@@ -163,6 +163,15 @@ class CObservation : public mrpt::serialization::CSerializable
 
 	/** @} */
 
+	/** Discards any data derived from the observation contents and cached
+	 * for later use (e.g. auxiliary points maps), so it is rebuilt upon
+	 * demand. Must be called when the contents are modified, e.g. for objects
+	 * recycled by CObservationPool.
+	 */
+	virtual void resetCachedData()
+	{ /* Default implementation: do nothing */
+	}
+
 };  // End of class def.
 
 }  // namespace obs
@@ -87,6 +87,9 @@ class CObservation2DRangeScan : public CObservation
 		@{ */
 	/** Resizes all data vectors to allocate a given number of scan rays */
 	void resizeScan(const size_t len);
+	/** Reserves memory in all data vectors for a given number of scan rays,
+	 * without changing their size nor the cached points map. */
+	void reserveScan(const size_t len);
 	/** Resizes all data vectors to allocate a given number of scan rays and
 	 * assign default values. */
 	void resizeScanAndAssign(
@@ -198,6 +201,9 @@ class CObservation2DRangeScan : public CObservation
 		return static_cast<const POINTSMAP*>(m_cachedMap.get());
 	}
 
+	// See base class docs
+	void resetCachedData() override { m_cachedMap.reset(); }
+
 	/** @} */
 
 	/** Return true if the laser scanner is "horizontal", so it has an absolute
@@ -219,6 +225,7 @@ class CObservation2DRangeScan : public CObservation
 	void setSensorPose(const mrpt::poses::CPose3D& newSensorPose) override
 	{
 		sensorPose = newSensorPose;
+		m_cachedMap.reset();
 	}
 	void getDescriptionAsText(std::ostream& o) const override;
 
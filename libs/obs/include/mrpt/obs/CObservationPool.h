@@ -0,0 +1,88 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/system/CGenericMemoryPool.h>
+#include <cstddef>
+
+namespace mrpt::obs
+{
+/** A pool of recycled observation objects of type OBS, for sources of
+ * observations at high rates (e.g. sensor drivers). Objects returned by get()
+ * are not freed when their last smart pointer goes out of scope: they go back
+ * to the pool, keeping the capacity of their vectors, images, etc. so they
+ * can be refilled later without memory allocations.
+ *
+ * Recycled objects keep the contents they had, so whoever fills them must
+ * overwrite all the fields it uses. Cached data derived from those contents
+ * is discarded (see CObservation::resetCachedData()). To avoid mixing
+ * objects from different producers, which may fill different fields, each
+ * one should pass a different `owner` (e.g. its `this` pointer): get() only
+ * recycles objects created with the same owner.
+ *
+ * Built on mrpt::system::CGenericMemoryPool, hence the pool of each OBS type
+ * is a thread-safe singleton, and objects released during the program
+ * destruction phase are just freed.
+ *
+ * \sa mrpt::hwdrivers::CGenericSensor
+ * \ingroup mrpt_obs_grp
+ */
+template <class OBS>
+class CObservationPool
+{
+   public:
+	/** Default maximum number of objects in the pool, for all owners. */
+	static constexpr size_t DEFAULT_MAX_SIZE = 16;
+
+	/** Returns a recycled object from the given owner, or a new one if there
+	 * is none available. */
+	static typename OBS::Ptr get(const void* owner = nullptr)
+	{
+		OBS* obj = nullptr;
+		if (auto* pool = pool_t::getInstance(DEFAULT_MAX_SIZE); pool)
+			obj = pool->request_memory(TParams{owner});
+		if (obj)
+			obj->resetCachedData();
+		else
+			obj = new OBS();
+		return typename OBS::Ptr(obj, TRecycler{owner});
+	}
+
+	/** Changes the maximum number of objects kept in the pool (for all
+	 * owners). Beyond that, the oldest ones are freed. */
+	static void setMaxSize(size_t max_objects)
+	{
+		if (auto* pool = pool_t::getInstance(DEFAULT_MAX_SIZE); pool)
+			pool->setMemoryPoolMaxSize(max_objects);
+	}
+
+   private:
+	struct TParams
+	{
+		const void* owner;
+		bool isSuitable(const TParams& req) const { return owner == req.owner; }
+	};
+	using pool_t = mrpt::system::CGenericMemoryPool<TParams, OBS>;
+
+	/** Deleter of the smart pointers returned by get() */
+	struct TRecycler
+	{
+		const void* owner;
+		void operator()(OBS* obj) const
+		{
+			auto* pool = pool_t::getInstance(DEFAULT_MAX_SIZE);
+			if (pool)
+				pool->dump_to_pool(TParams{owner}, obj);
+			else
+				delete obj;
+		}
+	};
+};
+
+}  // namespace mrpt::obs
@@ -89,6 +89,7 @@ void CObservation2DRangeScan::truncateByDistanceAndAngle(
 		else if (*itScan < min_distance || ang > max_angle)
 			*itValid = false;
 	}
+	m_cachedMap.reset();
 }
 
 void CObservation2DRangeScan::serializeFrom(
@@ -323,6 +324,7 @@ void CObservation2DRangeScan::filterByExclusionAreas(
 			}
 		}  // for each area
 	}  // for each point
+	m_cachedMap.reset();
 
 	MRPT_END
 }
@@ -404,6 +406,7 @@ void CObservation2DRangeScan::filterByExclusionAngles(
 				m_validRange[i] = false;
 		}
 	}
+	m_cachedMap.reset();
 
 	MRPT_END
 }
@@ -509,6 +512,7 @@ void CObservation2DRangeScan::setScanRange(const size_t i, const float val)
 {
 	ASSERT_BELOW_(i, m_scan.size());
 	m_scan[i] = val;
+	m_cachedMap.reset();
 }
 
 int CObservation2DRangeScan::getScanIntensity(const size_t i) const
@@ -532,13 +536,23 @@ void CObservation2DRangeScan::setScanRangeValidity(
 {
 	ASSERT_BELOW_(i, m_validRange.size());
 	m_validRange[i] = val ? 1 : 0;
+	m_cachedMap.reset();
 }
 
 void CObservation2DRangeScan::resizeScan(const size_t len)
 {
+	if (len == m_scan.size()) return;
 	m_scan.resize(len);
 	m_intensity.resize(len);
 	m_validRange.resize(len);
+	m_cachedMap.reset();
+}
+
+void CObservation2DRangeScan::reserveScan(const size_t len)
+{
+	m_scan.reserve(len);
+	m_intensity.reserve(len);
+	m_validRange.reserve(len);
 }
 
 void CObservation2DRangeScan::resizeScanAndAssign(
@@ -548,6 +562,7 @@ void CObservation2DRangeScan::resizeScanAndAssign(
 	m_scan.assign(len, rangeVal);
 	m_validRange.assign(len, rangeValidity);
 	m_intensity.assign(len, rangeIntensity);
+	m_cachedMap.reset();
 }
 
 size_t CObservation2DRangeScan::getScanSize() const { return m_scan.size(); }
@@ -562,4 +577,5 @@ void CObservation2DRangeScan::loadFromVectors(
 		m_scan[i] = scanRanges[i];
 		m_validRange[i] = scanValidity[i];
 	}
+	m_cachedMap.reset();
 }
@@ -37,8 +37,8 @@ using mrpt::config::CConfigFileMemory;
 // This must be added to any CSerializable class implementation file.
 IMPLEMENTS_SERIALIZABLE(CObservation3DRangeScan, CObservation, mrpt::obs)
 
-// Static LUT:
-static CObservation3DRangeScan::TCached3DProjTables lut_3dproj;
+// Static LUT (one per thread, so observations can be projected in parallel):
+static thread_local CObservation3DRangeScan::TCached3DProjTables lut_3dproj;
 CObservation3DRangeScan::TCached3DProjTables&
 	CObservation3DRangeScan::get_3dproj_lut()
 {
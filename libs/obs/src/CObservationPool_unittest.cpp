@@ -0,0 +1,81 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/obs/CObservationPool.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <gtest/gtest.h>
+
+using mrpt::obs::CObservation2DRangeScan;
+using mrpt::obs::CObservationPool;
+
+TEST(CObservationPool, recycle)
+{
+	using pool_t = CObservationPool<CObservation2DRangeScan>;
+	const int owner1 = 0, owner2 = 0;
+
+	const CObservation2DRangeScan* addr;
+	{
+		auto o = pool_t::get(&owner1);
+		o->resizeScan(1000);
+		addr = o.get();
+	}
+	// Other owners get new objects:
+	{
+		auto o = pool_t::get(&owner2);
+		EXPECT_NE(o.get(), addr);
+		EXPECT_EQ(o->getScanSize(), 0U);
+	}
+	// The same owner gets the recycled object, as it was:
+	{
+		auto o = pool_t::get(&owner1);
+		EXPECT_EQ(o.get(), addr);
+		EXPECT_EQ(o->getScanSize(), 1000U);
+		// Also, while it's in use, a new one is created:
+		auto o2 = pool_t::get(&owner1);
+		EXPECT_NE(o2.get(), addr);
+	}
+}
+
+TEST(CObservationPool, recycledScanDiscardsCachedPointsMap)
+{
+	using pool_t = CObservationPool<CObservation2DRangeScan>;
+	const int owner = 0;
+
+	const auto fillScan = [](CObservation2DRangeScan& o, float range) {
+		o.aperture = M_PIf;
+		o.resizeScanAndAssign(11, range, true);
+	};
+	const auto centralPointX = [](const CObservation2DRangeScan& o) {
+		const auto* pts = o.buildAuxPointsMap<mrpt::maps::CPointsMap>();
+		EXPECT_TRUE(pts != nullptr);
+		EXPECT_EQ(pts->size(), o.getScanSize());
+		float x, y;
+		pts->getPoint(5, x, y);  // The central ray, pointing forward
+		return x;
+	};
+
+	const CObservation2DRangeScan* addr;
+	{
+		auto o = pool_t::get(&owner);
+		fillScan(*o, 1.0f);
+		EXPECT_NEAR(centralPointX(*o), 1.0f, 1e-4f);
+		addr = o.get();
+	}
+	{
+		auto o = pool_t::get(&owner);
+		EXPECT_EQ(o.get(), addr);
+		EXPECT_TRUE(o->getAuxPointsMap<mrpt::maps::CPointsMap>() == nullptr);
+		fillScan(*o, 2.0f);
+		EXPECT_NEAR(centralPointX(*o), 2.0f, 1e-4f);
+		// Modifying single ranges also discards the cache:
+		o->setScanRange(5, 3.0f);
+		EXPECT_NEAR(centralPointX(*o), 3.0f, 1e-4f);
+	}
+}
@@ -0,0 +1,324 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "obs-precomp.h"  // Precompiled headers
+
+#include <mrpt/maps/CSimpleMapIndexedFile.h>
+#include <mrpt/config.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mutex>
+
+#if defined(MRPT_OS_LINUX) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MRPT_SIMPLEMAP_USE_MMAP
+#endif
+
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace mrpt::serialization;
+
+namespace
+{
+constexpr uint64_t SMAP_IDX_MAGIC = 0x4d5250545349'4458ULL;  // "MRPTSIDX"
+constexpr uint32_t SMAP_IDX_VERSION = 1;
+// Bytes of the header, and of each index entry:
+constexpr uint64_t HEADER_LEN = 8 + 4 + 4 + 8 + 8;
+constexpr uint64_t ENTRY_LEN = 8 + 8 + 6 * 8;
+}  // namespace
+
+struct CSimpleMapIndexedFile::Impl
+{
+	std::string fileName;
+#ifdef MRPT_SIMPLEMAP_USE_MMAP
+	const uint8_t* data{nullptr};
+	uint64_t dataLen{0};
+#else
+	mrpt::io::CFileInputStream file;
+	std::mutex fileMtx;
+#endif
+
+	/** Deserializes the keyframe stored in [offset, offset+length) */
+	void readKeyframe(
+		uint64_t offset, uint64_t length, CPose3DPDF::Ptr& pdf,
+		CSensoryFrame::Ptr& sf)
+	{
+		mrpt::io::CMemoryStream buf;
+#ifdef MRPT_SIMPLEMAP_USE_MMAP
+		ASSERT_(offset + length <= dataLen);
+		buf.assignMemoryNotOwn(data + offset, length);
+#else
+		buf.changeSize(length);
+		{
+			std::lock_guard<std::mutex> lck(fileMtx);
+			file.Seek(offset);
+			if (file.Read(buf.getRawBufferData(), length) != length)
+				THROW_EXCEPTION_FMT(
+					"Error reading keyframe from `%s`", fileName.c_str());
+		}
+#endif
+		auto arch = archiveFrom(buf);
+		pdf = arch.ReadObject<CPose3DPDF>();
+		sf = arch.ReadObject<CSensoryFrame>();
+	}
+};
+
+CSimpleMapIndexedFile::CSimpleMapIndexedFile() = default;
+CSimpleMapIndexedFile::CSimpleMapIndexedFile(const std::string& fileName)
+{
+	open(fileName);
+}
+CSimpleMapIndexedFile::~CSimpleMapIndexedFile() { close(); }
+
+/*---------------------------------------------------------------
+					saveSimpleMap
+ ---------------------------------------------------------------*/
+void CSimpleMapIndexedFile::saveSimpleMap(
+	const CSimpleMap& sm, const std::string& fileName)
+{
+	MRPT_START
+
+	mrpt::io::CFileOutputStream f;
+	if (!f.open(fileName))
+		THROW_EXCEPTION_FMT("Cannot create file `%s`", fileName.c_str());
+	auto arch = archiveFrom(f);
+
+	const uint64_t N = sm.size();
+	const auto writeHeader = [&](const uint64_t indexOffset) {
+		arch << SMAP_IDX_MAGIC << SMAP_IDX_VERSION << uint32_t(0) << N
+			 << indexOffset;
+	};
+	// Placeholder, rewritten once the index offset is known:
+	writeHeader(0);
+
+	std::vector<TIndexEntry> index(N);
+	for (size_t i = 0; i < N; i++)
+	{
+		CPose3DPDF::Ptr pdf;
+		CSensoryFrame::Ptr sf;
+		sm.get(i, pdf, sf);
+		ASSERT_(pdf && sf);
+
+		index[i].offset = f.getPosition();
+		arch << *pdf << *sf;
+		index[i].length = f.getPosition() - index[i].offset;
+		index[i].pose = pdf->getMeanVal().asTPose();
+	}
+
+	const uint64_t indexOffset = f.getPosition();
+	for (const auto& e : index)
+		arch << e.offset << e.length << e.pose.x << e.pose.y << e.pose.z
+			 << e.pose.yaw << e.pose.pitch << e.pose.roll;
+
+	f.Seek(0);
+	writeHeader(indexOffset);
+	f.close();
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+					isIndexedFile
+ ---------------------------------------------------------------*/
+bool CSimpleMapIndexedFile::isIndexedFile(const std::string& fileName)
+{
+	mrpt::io::CFileInputStream f;
+	if (!f.open(fileName)) return false;
+	try
+	{
+		uint64_t magic;
+		auto arch = archiveFrom(f);
+		arch >> magic;
+		return magic == SMAP_IDX_MAGIC;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+/*---------------------------------------------------------------
+						open
+ ---------------------------------------------------------------*/
+void CSimpleMapIndexedFile::open(const std::string& fileName)
+{
+	MRPT_START
+
+	close();
+	auto impl = std::make_unique<Impl>();
+	impl->fileName = fileName;
+
+	// Read the header and the index with regular file I/O:
+	std::vector<TIndexEntry> index;
+	uint64_t fileLen;
+	{
+		mrpt::io::CFileInputStream f;
+		if (!f.open(fileName))
+			THROW_EXCEPTION_FMT("Cannot open file `%s`", fileName.c_str());
+		fileLen = f.getTotalBytesCount();
+		if (fileLen < HEADER_LEN)
+			THROW_EXCEPTION_FMT(
+				"File `%s` is not an indexed simplemap", fileName.c_str());
+
+		auto arch = archiveFrom(f);
+		uint64_t magic, N, indexOffset;
+		uint32_t version, reserved;
+		arch >> magic >> version >> reserved >> N >> indexOffset;
+		if (magic != SMAP_IDX_MAGIC)
+			THROW_EXCEPTION_FMT(
+				"File `%s` is not an indexed simplemap", fileName.c_str());
+		if (version != SMAP_IDX_VERSION)
+			THROW_EXCEPTION_FMT(
+				"Unsupported indexed simplemap version %u in `%s`",
+				static_cast<unsigned>(version), fileName.c_str());
+		if (indexOffset < HEADER_LEN || indexOffset > fileLen ||
+			N > (fileLen - indexOffset) / ENTRY_LEN)
+			THROW_EXCEPTION_FMT(
+				"Corrupted index in file `%s`", fileName.c_str());
+
+		f.Seek(indexOffset);
+		index.resize(N);
+		for (auto& e : index)
+		{
+			arch >> e.offset >> e.length >> e.pose.x >> e.pose.y >>
+				e.pose.z >> e.pose.yaw >> e.pose.pitch >> e.pose.roll;
+			if (e.offset < HEADER_LEN || e.offset > indexOffset ||
+				e.length > indexOffset - e.offset)
+				THROW_EXCEPTION_FMT(
+					"Corrupted index in file `%s`", fileName.c_str());
+		}
+	}
+
+#ifdef MRPT_SIMPLEMAP_USE_MMAP
+	const int fd = ::open(fileName.c_str(), O_RDONLY);
+	if (fd < 0)
+		THROW_EXCEPTION_FMT("Cannot open file `%s`", fileName.c_str());
+	void* p = ::mmap(nullptr, fileLen, PROT_READ, MAP_SHARED, fd, 0);
+	// The mapping keeps its own reference to the file:
+	::close(fd);
+	if (p == MAP_FAILED)
+		THROW_EXCEPTION_FMT("Cannot map file `%s`", fileName.c_str());
+	impl->data = static_cast<const uint8_t*>(p);
+	impl->dataLen = fileLen;
+#else
+	if (!impl->file.open(fileName))
+		THROW_EXCEPTION_FMT("Cannot open file `%s`", fileName.c_str());
+#endif
+
+	m_index = std::move(index);
+	m_impl = std::move(impl);
+
+	MRPT_END
+}
+
+void CSimpleMapIndexedFile::close()
+{
+#ifdef MRPT_SIMPLEMAP_USE_MMAP
+	if (m_impl && m_impl->data)
+		::munmap(const_cast<uint8_t*>(m_impl->data), m_impl->dataLen);
+#endif
+	m_impl.reset();
+	m_index.clear();
+}
+
+bool CSimpleMapIndexedFile::isOpen() const { return m_impl != nullptr; }
+
+const mrpt::math::TPose3D& CSimpleMapIndexedFile::getKeyframePose(
+	size_t index) const
+{
+	if (index >= m_index.size()) THROW_EXCEPTION("Index out of bounds");
+	return m_index[index].pose;
+}
+
+/*---------------------------------------------------------------
+						getKeyframe
+ ---------------------------------------------------------------*/
+void CSimpleMapIndexedFile::getKeyframe(
+	size_t index, CPose3DPDF::Ptr& out_posePDF,
+	CSensoryFrame::Ptr& out_SF) const
+{
+	MRPT_START
+
+	if (index >= m_index.size()) THROW_EXCEPTION("Index out of bounds");
+	ASSERT_(m_impl);
+
+	CPose3DPDF::Ptr pdf;
+	CSensoryFrame::Ptr sf;
+	m_impl->readKeyframe(m_index[index].offset, m_index[index].length, pdf, sf);
+	out_posePDF = pdf;
+	out_SF = sf;
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+					findInBox / findInRadius
+ ---------------------------------------------------------------*/
+std::vector<size_t> CSimpleMapIndexedFile::findInBox(
+	const mrpt::math::TPoint3D& bbox_min,
+	const mrpt::math::TPoint3D& bbox_max) const
+{
+	std::vector<size_t> found;
+	for (size_t i = 0; i < m_index.size(); i++)
+	{
+		const auto& p = m_index[i].pose;
+		if (p.x >= bbox_min.x && p.x <= bbox_max.x && p.y >= bbox_min.y &&
+			p.y <= bbox_max.y && p.z >= bbox_min.z && p.z <= bbox_max.z)
+			found.push_back(i);
+	}
+	return found;
+}
+
+std::vector<size_t> CSimpleMapIndexedFile::findInRadius(
+	const mrpt::math::TPoint3D& center, const double radius) const
+{
+	const double r2 = radius * radius;
+	std::vector<size_t> found;
+	for (size_t i = 0; i < m_index.size(); i++)
+	{
+		const auto& p = m_index[i].pose;
+		const double dx = p.x - center.x, dy = p.y - center.y,
+					 dz = p.z - center.z;
+		if (dx * dx + dy * dy + dz * dz <= r2) found.push_back(i);
+	}
+	return found;
+}
+
+/*---------------------------------------------------------------
+						loadKeyframes
+ ---------------------------------------------------------------*/
+void CSimpleMapIndexedFile::loadKeyframes(
+	const std::vector<size_t>& indices, CSimpleMap& out_sm) const
+{
+	MRPT_START
+
+	out_sm.clear();
+	for (const size_t i : indices)
+	{
+		CPose3DPDF::Ptr pdf;
+		CSensoryFrame::Ptr sf;
+		getKeyframe(i, pdf, sf);
+		out_sm.insert(pdf, sf);
+	}
+
+	MRPT_END
+}
+
+void CSimpleMapIndexedFile::loadAll(CSimpleMap& out_sm) const
+{
+	std::vector<size_t> all(m_index.size());
+	for (size_t i = 0; i < all.size(); i++) all[i] = i;
+	loadKeyframes(all, out_sm);
+}
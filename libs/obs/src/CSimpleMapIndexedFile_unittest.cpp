@@ -0,0 +1,94 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/maps/CSimpleMapIndexedFile.h>
+#include <mrpt/system/filesystem.h>
+#include <gtest/gtest.h>
+
+// Defined in tests/test_main.cpp
+namespace mrpt
+{
+extern std::string MRPT_GLOBAL_UNITTEST_SRC_DIR;
+}
+
+using namespace mrpt::maps;
+
+TEST(CSimpleMapIndexedFile, saveAndLoad)
+{
+#if MRPT_IS_BIG_ENDIAN
+	MRPT_TODO("Debug this issue in big endian platforms")
+	return;  // Skip this test for now (see CSimpleMap_unittest.cpp)
+#endif
+
+	const std::string fil =
+		mrpt::MRPT_GLOBAL_UNITTEST_SRC_DIR +
+		std::string("/share/mrpt/datasets/localization_demo.simplemap.gz");
+	CSimpleMap sm;
+	ASSERT_TRUE(sm.loadFromFile(fil));
+
+	const std::string idxFile =
+		mrpt::system::getTempFileName() + std::string(".simplemapidx");
+	CSimpleMapIndexedFile::saveSimpleMap(sm, idxFile);
+	EXPECT_TRUE(CSimpleMapIndexedFile::isIndexedFile(idxFile));
+	EXPECT_FALSE(CSimpleMapIndexedFile::isIndexedFile(fil));
+
+	CSimpleMapIndexedFile idx(idxFile);
+	ASSERT_EQ(idx.size(), sm.size());
+
+	// Single keyframes, in random order:
+	for (size_t i : {5U, 71U, 0U, 33U})
+	{
+		mrpt::poses::CPose3DPDF::Ptr pdf, pdf2;
+		mrpt::obs::CSensoryFrame::Ptr sf, sf2;
+		sm.get(i, pdf, sf);
+		idx.getKeyframe(i, pdf2, sf2);
+		ASSERT_TRUE(pdf2 && sf2);
+		EXPECT_EQ(pdf->GetRuntimeClass(), pdf2->GetRuntimeClass());
+		const auto p = pdf->getMeanVal(), p2 = pdf2->getMeanVal();
+		EXPECT_NEAR((p - p2).norm(), 0.0, 1e-9);
+		EXPECT_NEAR(idx.getKeyframePose(i).x, p.x(), 1e-9);
+		EXPECT_NEAR(idx.getKeyframePose(i).y, p.y(), 1e-9);
+
+		ASSERT_EQ(sf->size(), sf2->size());
+		for (size_t k = 0; k < sf->size(); k++)
+		{
+			const auto o = sf->getObservationByIndex(k),
+					   o2 = sf2->getObservationByIndex(k);
+			EXPECT_EQ(o->GetRuntimeClass(), o2->GetRuntimeClass());
+			EXPECT_EQ(o->timestamp, o2->timestamp);
+		}
+	}
+
+	// Spatial queries, against a brute-force search:
+	const mrpt::math::TPoint3D c(idx.getKeyframePose(10));
+	const double R = 3.0;
+	const auto inRadius = idx.findInRadius(c, R);
+	EXPECT_FALSE(inRadius.empty());
+	size_t nExpected = 0;
+	for (size_t i = 0; i < idx.size(); i++)
+		if (mrpt::math::TPoint3D(idx.getKeyframePose(i)).distanceTo(c) <= R)
+			nExpected++;
+	EXPECT_EQ(inRadius.size(), nExpected);
+
+	const auto inBox = idx.findInBox(
+		mrpt::math::TPoint3D(c.x - R, c.y - R, c.z - R),
+		mrpt::math::TPoint3D(c.x + R, c.y + R, c.z + R));
+	EXPECT_GE(inBox.size(), inRadius.size());
+
+	CSimpleMap region;
+	idx.loadKeyframes(inRadius, region);
+	EXPECT_EQ(region.size(), inRadius.size());
+
+	CSimpleMap all;
+	idx.loadAll(all);
+	EXPECT_EQ(all.size(), sm.size());
+
+	idx.close();
+	mrpt::system::deleteFile(idxFile);
+}
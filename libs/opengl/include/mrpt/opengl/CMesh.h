@@ -11,6 +11,7 @@
 
 #include <mrpt/opengl/CRenderizableDisplayList.h>
 #include <mrpt/math/CMatrix.h>
+#include <mrpt/math/CPolygonBVH.h>
 #include <mrpt/img/CImage.h>
 #include <mrpt/img/color_maps.h>
 #include <mrpt/opengl/CSetOfTriangles.h>
@@ -97,6 +98,8 @@ class CMesh : public CRenderizableDisplayList
 	 * be recalculated */
 	mutable bool polygonsUpToDate{false};
 	mutable std::vector<mrpt::math::TPolygonWithPlane> tmpPolys;
+	/** Bounding volume hierarchy over tmpPolys, for fast ray tracing */
+	mutable mrpt::math::CPolygonBVH polysBVH;
 
    public:
 	void setGridLimits(float xmin, float xmax, float ymin, float ymax)
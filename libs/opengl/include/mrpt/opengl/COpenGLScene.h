@@ -10,6 +10,8 @@
 
 #include <mrpt/opengl/CRenderizable.h>
 #include <mrpt/opengl/COpenGLViewport.h>
+#include <mrpt/img/TCamera.h>
+#include <mrpt/math/CMatrixTemplateNumeric.h>
 
 namespace mrpt
 {
@@ -207,6 +209,32 @@ class COpenGLScene : public mrpt::serialization::CSerializable
 	 */
 	bool traceRay(const mrpt::poses::CPose3D& o, double& dist) const;
 
+	/** Traces a batch of rays, splitting the work among several threads.
+	 * Each ray starts at the position of its pose and goes along its +X
+	 * axis, as in traceRay().
+	 * \param[out] dists The distance for each ray, or 0 if nothing was hit.
+	 * \param num_threads Number of threads (0: as many as hardware threads)
+	 * \note Objects must not be modified from other threads meanwhile.
+	 * \sa traceRaysDepthImage
+	 */
+	void traceRays(
+		const std::vector<mrpt::poses::CPose3D>& rays,
+		std::vector<double>& dists, unsigned int num_threads = 0) const;
+
+	/** Simulates a depth camera: traces one ray per pixel of a pinhole camera
+	 * with the given intrinsic parameters (distortion is ignored).
+	 * The camera optical axis is the +X axis of `cameraPose`, with image rows
+	 * going along -Z and columns along -Y (the usual MRPT convention for range
+	 * sensors).
+	 * \param[out] depth A `cam.nrows` x `cam.ncols` matrix with the depth
+	 * (distance along +X) of each pixel, or 0 where nothing was hit.
+	 * \param num_threads Number of threads (0: as many as hardware threads)
+	 * \sa traceRays
+	 */
+	void traceRaysDepthImage(
+		const mrpt::poses::CPose3D& cameraPose, const mrpt::img::TCamera& cam,
+		mrpt::math::CMatrixFloat& depth, unsigned int num_threads = 0) const;
+
 	/** Evaluates the bounding box of the scene in the given viewport (default:
 	 * "main"). */
 	void getBoundingBox(
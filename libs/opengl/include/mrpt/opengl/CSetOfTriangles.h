@@ -10,6 +10,7 @@
 
 #include <mrpt/opengl/CRenderizableDisplayList.h>
 #include <mrpt/math/geometry.h>
+#include <mrpt/math/CPolygonBVH.h>
 
 namespace mrpt::opengl
 {
@@ -72,6 +73,10 @@ class CSetOfTriangles : public CRenderizableDisplayList
 	 * Polygon cache.
 	 */
 	mutable std::vector<mrpt::math::TPolygonWithPlane> tmpPolygons;
+	/**
+	 * Bounding volume hierarchy over tmpPolygons, used by traceRay().
+	 */
+	mutable mrpt::math::CPolygonBVH polygonsBVH;
 
    public:
 	/**
@@ -543,7 +543,7 @@ void CMesh::setUV(
 bool CMesh::traceRay(const mrpt::poses::CPose3D& o, double& dist) const
 {
 	if (!trianglesUpToDate || !polygonsUpToDate) updatePolygons();
-	return mrpt::math::traceRay(tmpPolys, (o - this->m_pose).asTPose(), dist);
+	return polysBVH.traceRay(tmpPolys, (o - this->m_pose).asTPose(), dist);
 }
 
 static math::TPolygon3D tmpPoly(3);
@@ -569,6 +569,7 @@ void CMesh::updatePolygons() const
 	transform(
 		actualMesh.begin(), actualMesh.end(), tmpPolys.begin(),
 		createPolygonFromTriangle);
+	polysBVH.build(tmpPolys);
 	polygonsUpToDate = true;
 	CRenderizableDisplayList::notifyChange();
 }
@@ -19,6 +19,11 @@
 
 #include "opengl_internals.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
 using namespace mrpt;
 using namespace mrpt::opengl;
 using namespace mrpt::serialization::metaprogramming;
@@ -293,6 +298,98 @@ bool COpenGLScene::traceRay(const mrpt::poses::CPose3D& o, double& dist) const
 	return found;
 }
 
+namespace
+{
+/** Runs `job(i)` for i in [0,N), split in chunks among `num_threads` threads
+ */
+template <class JOB>
+void run_parallel(size_t N, unsigned int num_threads, JOB job)
+{
+	if (num_threads == 0)
+		num_threads = std::max(1U, std::thread::hardware_concurrency());
+	num_threads = static_cast<unsigned int>(
+		std::min<size_t>(num_threads, std::max<size_t>(N / 64, 1)));
+	if (num_threads <= 1)
+	{
+		for (size_t i = 0; i < N; i++) job(i);
+		return;
+	}
+	// Chunks are handed out dynamically, since the cost of each ray varies
+	// a lot with what it hits:
+	const size_t CHUNK = 64;
+	std::atomic<size_t> next{0};
+	auto worker = [&]() {
+		for (;;)
+		{
+			const size_t i0 = next.fetch_add(CHUNK);
+			if (i0 >= N) break;
+			const size_t i1 = std::min(N, i0 + CHUNK);
+			for (size_t i = i0; i < i1; i++) job(i);
+		}
+	};
+	std::vector<std::thread> threads;
+	for (unsigned int t = 1; t < num_threads; t++) threads.emplace_back(worker);
+	worker();
+	for (auto& t : threads) t.join();
+}
+}  // namespace
+
+void COpenGLScene::traceRays(
+	const std::vector<mrpt::poses::CPose3D>& rays, std::vector<double>& dists,
+	unsigned int num_threads) const
+{
+	MRPT_START
+	const size_t N = rays.size();
+	dists.assign(N, 0.0);
+	if (!N) return;
+
+	// Objects build their ray-tracing caches (polygons, BVH) lazily in their
+	// first call to traceRay(): do it here, before going multi-threaded.
+	double d;
+	if (traceRay(rays[0], d)) dists[0] = d;
+
+	run_parallel(N, num_threads, [&](size_t i) {
+		double dist;
+		if (traceRay(rays[i], dist)) dists[i] = dist;
+	});
+	MRPT_END
+}
+
+void COpenGLScene::traceRaysDepthImage(
+	const mrpt::poses::CPose3D& cameraPose, const mrpt::img::TCamera& cam,
+	mrpt::math::CMatrixFloat& depth, unsigned int num_threads) const
+{
+	MRPT_START
+	const size_t nRows = cam.nrows, nCols = cam.ncols;
+	ASSERT_ABOVE_(cam.fx(), 0);
+	ASSERT_ABOVE_(cam.fy(), 0);
+
+	std::vector<mrpt::poses::CPose3D> rays(nRows * nCols);
+	// 1/|dir|, to convert from distance along the ray to depth along +X:
+	std::vector<double> dist2depth(rays.size());
+	for (size_t r = 0, i = 0; r < nRows; r++)
+		for (size_t c = 0; c < nCols; c++, i++)
+		{
+			const double dy = -(c - cam.cx()) / cam.fx();
+			const double dz = -(r - cam.cy()) / cam.fy();
+			const double n = std::sqrt(1 + dy * dy + dz * dz);
+			rays[i] = cameraPose + mrpt::poses::CPose3D(
+									   0, 0, 0, std::atan2(dy, 1.0),
+									   -std::atan2(dz, std::sqrt(1 + dy * dy)),
+									   0);
+			dist2depth[i] = 1.0 / n;
+		}
+
+	std::vector<double> dists;
+	traceRays(rays, dists, num_threads);
+
+	depth.setSize(nRows, nCols);
+	for (size_t r = 0, i = 0; r < nRows; r++)
+		for (size_t c = 0; c < nCols; c++, i++)
+			depth(r, c) = static_cast<float>(dists[i] * dist2depth[i]);
+	MRPT_END
+}
+
 bool COpenGLScene::saveToFile(const std::string& fil) const
 {
 	try
@@ -146,7 +146,7 @@ bool CSetOfTriangles::traceRay(
 	const mrpt::poses::CPose3D& o, double& dist) const
 {
 	if (!polygonsUpToDate) updatePolygons();
-	return mrpt::math::traceRay(
+	return polygonsBVH.traceRay(
 		tmpPolygons, (o - this->m_pose).asTPose(), dist);
 }
 
@@ -358,6 +358,7 @@ void CSetOfTriangles::updatePolygons() const
 			tmp[j].z = t.z[j];
 			tmpPolygons[i] = tmp;
 		}
+	polygonsBVH.build(tmpPolygons);
 	polygonsUpToDate = true;
 	CRenderizableDisplayList::notifyChange();
 }
@@ -329,6 +329,26 @@ class CPose3D : public CPose<CPose3D>, public mrpt::serialization::CSerializable
 		gz = static_cast<float>(ggz);
 	}
 
+	/** Computes \f$ G_i = P \oplus L_i \f$ for many 3D points at once, given
+	 * as separate arrays of single precision coordinates, like those of
+	 * mrpt::maps::CPointsMap. The output arrays can be the same than the
+	 * input ones, to transform the points in place.
+	 *
+	 * Much faster than composePoint() for each point: it uses SSE2 (if
+	 * available), with this pose in single precision, and optionally several
+	 * threads for large point clouds.
+	 * \param[out] out_bbox_min,out_bbox_max If provided, the bounding box of
+	 * the output points.
+	 * \param num_threads Number of threads (0: as many as hardware threads).
+	 * Each thread processes at least 100000 points.
+	 */
+	void composePoints(
+		const float* lx, const float* ly, const float* lz, float* gx,
+		float* gy, float* gz, const size_t N,
+		mrpt::math::TPoint3Df* out_bbox_min = nullptr,
+		mrpt::math::TPoint3Df* out_bbox_max = nullptr,
+		unsigned int num_threads = 1) const;
+
 	/**  Computes the 3D point L such as \f$ L = G \ominus this \f$.
 	 *  If pointers are provided, the corresponding Jacobians are returned.
 	 *  "out_jacobian_df_dse3" stands for the Jacobian with respect to the 6D
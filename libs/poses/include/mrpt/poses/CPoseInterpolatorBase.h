@@ -13,6 +13,8 @@
 #include <mrpt/poses/SE_traits.h>
 #include <mrpt/math/lightweight_geom_data.h>
 #include <mrpt/poses/poses_frwds.h>
+#include <map>
+#include <vector>
 
 namespace mrpt::poses
 {
@@ -136,6 +138,22 @@ class CPoseInterpolatorBase
 		const mrpt::Clock::time_point& t, cpose_t& out_interp,
 		bool& out_valid_interp) const;
 
+	/** Returns the poses at many times at once, with the same results than
+	 * calling interpolate() for each of them, but much faster if the times
+	 * are sorted in ascending order (e.g. those of the points of a LiDAR
+	 * scan): the path is then traversed only once, and all the terms which
+	 * only depend on the poses around each interval (e.g. the SLERP
+	 * quaternions in SE(3)) are computed once for all the times within it.
+	 * Unsorted times are also accepted, only slower.
+	 * \param ts The times of the poses to interpolate.
+	 * \param out_interp The output poses, one for each time.
+	 * \param out_valid_interp Whether each pose could be interpolated.
+	 */
+	void interpolateMany(
+		const std::vector<mrpt::Clock::time_point>& ts,
+		std::vector<pose_t>& out_interp,
+		std::vector<bool>& out_valid_interp) const;
+
 	/** Clears the current sequence of poses */
 	void clear();
 
@@ -212,6 +230,20 @@ class CPoseInterpolatorBase
 		const TInterpolatorMethod method, const mrpt::Clock::time_point& td,
 		pose_t& out_interp) const;
 
+	/** Like impl_interpolation(), for `n` times between p2 and p3 */
+	void impl_interpolation_many(
+		const TTimePosePair& p1, const TTimePosePair& p2,
+		const TTimePosePair& p3, const TTimePosePair& p4,
+		const TInterpolatorMethod method, const mrpt::Clock::time_point* ts,
+		const size_t n, pose_t* out_interp) const;
+
+	/** Gets the poses before (p1,p2) and after (p3,p4) a time, given the
+	 * first path element after that time. \return false if the
+	 * interpolation is not possible at that time. */
+	bool impl_get_neighbours(
+		const_iterator it_ge1, TTimePosePair& p1, TTimePosePair& p2,
+		TTimePosePair& p3, TTimePosePair& p4) const;
+
 };  // End of class def.
 }  // namespace mrpt::poses
 MRPT_ENUM_TYPE_BEGIN(mrpt::poses::TInterpolatorMethod)
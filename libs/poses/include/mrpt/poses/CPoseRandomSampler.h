@@ -12,6 +12,7 @@
 #include <mrpt/poses/CPose2D.h>
 #include <mrpt/poses/CPosePDF.h>
 #include <mrpt/poses/CPose3DPDF.h>
+#include <mrpt/poses/TPose2DParticlesSoA.h>
 #include <mrpt/math/CMatrixTemplateNumeric.h>
 #include <mrpt/math/math_frwds.h>
 #include <memory>  // unique_ptr
@@ -110,6 +111,13 @@ class CPoseRandomSampler
 	 */
 	CPose3D& drawSample(CPose3D& p) const;
 
+	/** Generates `N` 2D samples from the selected PDF at once, into the
+	 * poses of `out` (weights are set to zero). For Gaussian PDFs, each pose
+	 * component is computed in a vectorizable loop, with the same random
+	 * numbers than N calls to drawSample().
+	 * \sa setPosePDF */
+	void drawSamples(size_t N, TPose2DParticlesSoA& out) const;
+
 	/** Return true if samples can be generated, which only requires a previous
 	 * call to setPosePDF */
 	bool isPrepared() const;
@@ -0,0 +1,92 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/core/aligned_std_vector.h>
+#include <mrpt/math/lightweight_geom_data.h>
+#include <cstddef>
+
+namespace mrpt::poses
+{
+/** A set of weighted 2D pose particles, stored as a structure of arrays (one
+ * contiguous array per pose component and for the log-weights), instead of
+ * the array of structs of CPosePDFParticles. Loops over all particles can
+ * then be vectorized by the compiler.
+ *
+ * Particle filters keep their particles as usual, and use this for bulk
+ * operations: load the particles with loadFrom(), process them (e.g. with
+ * CPoseRandomSampler::drawSamples() and composeWith()), and write them back
+ * with storeTo().
+ *
+ * \ingroup poses_pdf_grp
+ * \sa CPosePDFParticles, mrpt::bayes::CParticleFilterCapable::computeESS
+ */
+struct TPose2DParticlesSoA
+{
+	using vector_t = mrpt::aligned_std_vector<double>;
+
+	vector_t x, y, phi;
+	/** Logarithmic weights */
+	vector_t log_w;
+
+	size_t size() const { return x.size(); }
+	bool empty() const { return x.empty(); }
+	/** Resizes all the arrays (new elements are zero) */
+	void resize(size_t N);
+
+	mrpt::math::TPose2D pose(size_t i) const
+	{
+		return mrpt::math::TPose2D(x[i], y[i], phi[i]);
+	}
+	void setPose(size_t i, const mrpt::math::TPose2D& p)
+	{
+		x[i] = p.x;
+		y[i] = p.y;
+		phi[i] = p.phi;
+	}
+
+	/** Loads poses and weights from a container of particles with a `d`
+	 * member of type TPose2D and a `log_w` member, like
+	 * CPosePDFParticles::m_particles. */
+	template <class PARTICLE_LIST>
+	void loadFrom(const PARTICLE_LIST& parts)
+	{
+		resize(parts.size());
+		size_t i = 0;
+		for (const auto& p : parts)
+		{
+			setPose(i, p.d);
+			log_w[i++] = p.log_w;
+		}
+	}
+
+	/** Writes poses and weights back into a container of particles, which
+	 * must have the same size. \sa loadFrom */
+	template <class PARTICLE_LIST>
+	void storeTo(PARTICLE_LIST& parts) const
+	{
+		size_t i = 0;
+		for (auto& p : parts)
+		{
+			p.d = pose(i);
+			p.log_w = log_w[i++];
+		}
+	}
+
+	/** Composes each pose with an increment in its local frame:
+	 * \f$ p_i \leftarrow p_i \oplus \Delta_i \f$, as in
+	 * mrpt::poses::CPose2D::operator+. `incr` must have the same size than
+	 * this object, and its weights are ignored. */
+	void composeWith(const TPose2DParticlesSoA& incr);
+
+	/** Wraps all angles `phi` into the range ]-pi,pi] */
+	void normalizePhi();
+};
+
+}  // namespace mrpt::poses
@@ -38,6 +38,12 @@
 #include <mrpt/serialization/CSerializable.h>  // for CSeriali...
 #include <mrpt/serialization/CSchemeArchiveBase.h>
 #include <mrpt/core/bits_math.h>  // for square
+#if MRPT_HAS_SSE2
+#include <mrpt/core/SSE_types.h>
+#endif
+#include <array>
+#include <thread>
+#include <vector>
 #include <mrpt/math/utils_matlab.h>
 #include <mrpt/otherlibs/sophus/so3.hpp>
 #include <mrpt/otherlibs/sophus/se3.hpp>
@@ -490,6 +496,140 @@ void CPose3D::composePoint(
 	}
 }
 
+namespace
+{
+// Transforms the points [i0,i1), with the rotation matrix (row-major)
+// and translation of a pose in `T[12]`, and updates the bounding box
+// `bbox[6]` (min x,y,z; max x,y,z).
+void composePointsRange(
+	const float* T, const float* lx, const float* ly, const float* lz,
+	float* gx, float* gy, float* gz, size_t i, const size_t i1, float* bbox)
+{
+#if MRPT_HAS_SSE2
+	const __m128 r00 = _mm_set1_ps(T[0]), r01 = _mm_set1_ps(T[1]),
+				 r02 = _mm_set1_ps(T[2]), r10 = _mm_set1_ps(T[3]),
+				 r11 = _mm_set1_ps(T[4]), r12 = _mm_set1_ps(T[5]),
+				 r20 = _mm_set1_ps(T[6]), r21 = _mm_set1_ps(T[7]),
+				 r22 = _mm_set1_ps(T[8]), tx = _mm_set1_ps(T[9]),
+				 ty = _mm_set1_ps(T[10]), tz = _mm_set1_ps(T[11]);
+	__m128 min_x = _mm_set1_ps(bbox[0]), min_y = _mm_set1_ps(bbox[1]),
+		   min_z = _mm_set1_ps(bbox[2]), max_x = _mm_set1_ps(bbox[3]),
+		   max_y = _mm_set1_ps(bbox[4]), max_z = _mm_set1_ps(bbox[5]);
+	for (; i + 4 <= i1; i += 4)
+	{
+		const __m128 x = _mm_loadu_ps(lx + i), y = _mm_loadu_ps(ly + i),
+					 z = _mm_loadu_ps(lz + i);
+		const __m128 ox = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(r00, x), _mm_mul_ps(r01, y)),
+			_mm_add_ps(_mm_mul_ps(r02, z), tx));
+		const __m128 oy = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(r10, x), _mm_mul_ps(r11, y)),
+			_mm_add_ps(_mm_mul_ps(r12, z), ty));
+		const __m128 oz = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(r20, x), _mm_mul_ps(r21, y)),
+			_mm_add_ps(_mm_mul_ps(r22, z), tz));
+		_mm_storeu_ps(gx + i, ox);
+		_mm_storeu_ps(gy + i, oy);
+		_mm_storeu_ps(gz + i, oz);
+		min_x = _mm_min_ps(min_x, ox);
+		min_y = _mm_min_ps(min_y, oy);
+		min_z = _mm_min_ps(min_z, oz);
+		max_x = _mm_max_ps(max_x, ox);
+		max_y = _mm_max_ps(max_y, oy);
+		max_z = _mm_max_ps(max_z, oz);
+	}
+	// Recover the min/max:
+	alignas(MRPT_MAX_ALIGN_BYTES) float tmp[6][4];
+	_mm_store_ps(tmp[0], min_x);
+	_mm_store_ps(tmp[1], min_y);
+	_mm_store_ps(tmp[2], min_z);
+	_mm_store_ps(tmp[3], max_x);
+	_mm_store_ps(tmp[4], max_y);
+	_mm_store_ps(tmp[5], max_z);
+	for (int k = 0; k < 3; k++)
+	{
+		bbox[k] = std::min(
+			std::min(tmp[k][0], tmp[k][1]), std::min(tmp[k][2], tmp[k][3]));
+		bbox[k + 3] = std::max(
+			std::max(tmp[k + 3][0], tmp[k + 3][1]),
+			std::max(tmp[k + 3][2], tmp[k + 3][3]));
+	}
+#endif
+	// Non-SSE2 version, or remaining points:
+	for (; i < i1; i++)
+	{
+		const float x = lx[i], y = ly[i], z = lz[i];
+		gx[i] = T[0] * x + T[1] * y + T[2] * z + T[9];
+		gy[i] = T[3] * x + T[4] * y + T[5] * z + T[10];
+		gz[i] = T[6] * x + T[7] * y + T[8] * z + T[11];
+		mrpt::keep_min(bbox[0], gx[i]);
+		mrpt::keep_min(bbox[1], gy[i]);
+		mrpt::keep_min(bbox[2], gz[i]);
+		mrpt::keep_max(bbox[3], gx[i]);
+		mrpt::keep_max(bbox[4], gy[i]);
+		mrpt::keep_max(bbox[5], gz[i]);
+	}
+}
+}  // namespace
+
+void CPose3D::composePoints(
+	const float* lx, const float* ly, const float* lz, float* gx, float* gy,
+	float* gz, const size_t N, mrpt::math::TPoint3Df* out_bbox_min,
+	mrpt::math::TPoint3Df* out_bbox_max, unsigned int num_threads) const
+{
+	float T[12];
+	for (int r = 0; r < 3; r++)
+	{
+		for (int c = 0; c < 3; c++)
+			T[3 * r + c] = static_cast<float>(m_ROT.get_unsafe(r, c));
+		T[9 + r] = static_cast<float>(m_coords[r]);
+	}
+
+	const size_t MIN_POINTS_PER_THREAD = 100000;
+	if (num_threads == 0)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	num_threads = static_cast<unsigned int>(std::max<size_t>(
+		1, std::min<size_t>(num_threads, N / MIN_POINTS_PER_THREAD)));
+
+	const float fmax = std::numeric_limits<float>::max();
+	std::vector<std::array<float, 6>> bboxes(
+		num_threads, {{fmax, fmax, fmax, -fmax, -fmax, -fmax}});
+	if (num_threads == 1)
+		composePointsRange(T, lx, ly, lz, gx, gy, gz, 0, N, &bboxes[0][0]);
+	else
+	{
+		// Blocks of consecutive points, multiple of 4 in size:
+		const size_t block =
+			((N + num_threads - 1) / num_threads + 3) & ~size_t(3);
+		std::vector<std::thread> threads;
+		for (unsigned int t = 1; t < num_threads; t++)
+			threads.emplace_back([&, t]() {
+				composePointsRange(
+					T, lx, ly, lz, gx, gy, gz, t * block,
+					std::min(N, (t + 1) * block), &bboxes[t][0]);
+			});
+		composePointsRange(
+			T, lx, ly, lz, gx, gy, gz, 0, block, &bboxes[0][0]);
+		for (auto& th : threads) th.join();
+	}
+
+	if (out_bbox_min || out_bbox_max)
+	{
+		for (unsigned int t = 1; t < num_threads; t++)
+			for (int k = 0; k < 3; k++)
+			{
+				mrpt::keep_min(bboxes[0][k], bboxes[t][k]);
+				mrpt::keep_max(bboxes[0][k + 3], bboxes[t][k + 3]);
+			}
+		if (out_bbox_min)
+			*out_bbox_min = mrpt::math::TPoint3Df(
+				bboxes[0][0], bboxes[0][1], bboxes[0][2]);
+		if (out_bbox_max)
+			*out_bbox_max = mrpt::math::TPoint3Df(
+				bboxes[0][3], bboxes[0][4], bboxes[0][5]);
+	}
+}
+
 // TODO: Use SSE2? OTOH, this forces mem align...
 #if MRPT_HAS_SSE2 && defined(MRPT_USE_SSE2)
 /*static inline __m128 transformSSE(const __m128* matrix, const __m128& in)
@@ -228,6 +228,133 @@ void CPoseInterpolatorBase<3>::impl_interpolation(
 	};  // end switch
 }
 
+// Specialization for DIM=3: SLERP methods compute the quaternions of the
+// interval ends and the angle between them once, then process the times in
+// blocks, with the same operations than mrpt::math::slerp() for each one.
+template <>
+void CPoseInterpolatorBase<3>::impl_interpolation_many(
+	const TTimePosePair& p1, const TTimePosePair& p2, const TTimePosePair& p3,
+	const TTimePosePair& p4, const TInterpolatorMethod method,
+	const mrpt::Clock::time_point* ts, const size_t n, pose_t* out_interp) const
+{
+	using mrpt::math::TPose3D;
+
+	if (method != imLinearSlerp && method != imSplineSlerp)
+	{
+		for (size_t k = 0; k < n; k++)
+			impl_interpolation(p1, p2, p3, p4, method, ts[k], out_interp[k]);
+		return;
+	}
+
+	using doubleDuration = std::chrono::duration<double>;
+	const auto toSeconds = [](const mrpt::Clock::time_point& t) {
+		return std::chrono::duration_cast<doubleDuration>(t.time_since_epoch())
+			.count();
+	};
+	mrpt::math::CArrayDouble<4> tsArr, X, Y, Z;
+	const TTimePosePair* pp[4] = {&p1, &p2, &p3, &p4};
+	for (int i = 0; i < 4; i++)
+	{
+		tsArr[i] = toSeconds(pp[i]->first);
+		X[i] = pp[i]->second.x;
+		Y[i] = pp[i]->second.y;
+		Z[i] = pp[i]->second.z;
+	}
+
+	// SLERP terms:
+	mrpt::math::CQuaternionDouble q0(mrpt::math::UNINITIALIZED_QUATERNION),
+		q1(mrpt::math::UNINITIALIZED_QUATERNION);
+	TPose3D(0, 0, 0, p2.second.yaw, p2.second.pitch, p2.second.roll)
+		.getAsQuaternion(q0);
+	TPose3D(0, 0, 0, p3.second.yaw, p3.second.pitch, p3.second.roll)
+		.getAsQuaternion(q1);
+	double cosHalfTheta =
+		q0[0] * q1[0] + q0[1] * q1[1] + q0[2] * q1[2] + q0[3] * q1[3];
+	enum
+	{
+		SAME,
+		LERP,
+		SLERP
+	} mode = SLERP;
+	double halfTheta = 0, sinHalfTheta = 1;
+	if (std::abs(cosHalfTheta) >= 1.0)
+		mode = SAME;
+	else
+	{
+		if (cosHalfTheta < 0)  // Always follow the shortest path
+		{
+			for (int i = 0; i < 4; i++) q1[i] = -q1[i];
+			cosHalfTheta = -cosHalfTheta;
+		}
+		halfTheta = acos(cosHalfTheta);
+		sinHalfTheta = std::sqrt(1.0 - mrpt::square(cosHalfTheta));
+		if (std::abs(sinHalfTheta) < 0.001) mode = LERP;
+	}
+
+	constexpr size_t BLOCK = 64;
+	double td[BLOCK], ratio[BLOCK], A[BLOCK], B[BLOCK], q[4][BLOCK];
+	const double t1 = tsArr[1], Ax = tsArr[2] - tsArr[1];
+	for (size_t k0 = 0; k0 < n; k0 += BLOCK)
+	{
+		const size_t m = std::min(BLOCK, n - k0);
+		for (size_t i = 0; i < m; i++)
+		{
+			td[i] = toSeconds(ts[k0 + i]);
+			ratio[i] = (td[i] - t1) / Ax;
+		}
+		switch (mode)
+		{
+			case SAME:
+				for (size_t i = 0; i < m; i++)
+				{
+					A[i] = 1;
+					B[i] = 0;
+				}
+				break;
+			case LERP:
+				for (size_t i = 0; i < m; i++)
+				{
+					A[i] = 1 - ratio[i];
+					B[i] = ratio[i];
+				}
+				break;
+			case SLERP:
+				for (size_t i = 0; i < m; i++)
+				{
+					A[i] = sin((1 - ratio[i]) * halfTheta) / sinHalfTheta;
+					B[i] = sin(ratio[i] * halfTheta) / sinHalfTheta;
+				}
+				break;
+		};
+		// Quaternion blending, vectorized:
+		for (int c = 0; c < 4; c++)
+			for (size_t i = 0; i < m; i++)
+				q[c][i] = A[i] * q0[c] + B[i] * q1[c];
+
+		mrpt::math::CQuaternionDouble qi(mrpt::math::UNINITIALIZED_QUATERNION);
+		for (size_t i = 0; i < m; i++)
+		{
+			pose_t& out = out_interp[k0 + i];
+			for (int c = 0; c < 4; c++) qi[c] = q[c][i];
+			qi.rpy(out.roll, out.pitch, out.yaw);
+			if (method == imLinearSlerp)
+			{
+				// As math::interpolate2points():
+				const double Atd = td[i] - t1;
+				out.x = X[1] + (X[2] - X[1]) * Atd / Ax;
+				out.y = Y[1] + (Y[2] - Y[1]) * Atd / Ax;
+				out.z = Z[1] + (Z[2] - Z[1]) * Atd / Ax;
+			}
+			else
+			{
+				out.x = math::spline(td[i], tsArr, X);
+				out.y = math::spline(td[i], tsArr, Y);
+				out.z = math::spline(td[i], tsArr, Z);
+			}
+		}
+	}
+}
+
 // Explicit instantations:
 template class CPoseInterpolatorBase<3>;
 }  // namespace mrpt::poses
@@ -9,6 +9,7 @@
 
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/poses/CPose3DInterpolator.h>
+#include <mrpt/random/RandomGenerators.h>
 #include <mrpt/system/datetime.h>
 #include <CTraitsTest.h>
 #include <gtest/gtest.h>
@@ -51,3 +52,59 @@ TEST(CPose3DInterpolator, interp)
 			.sum(),
 		1e-4);
 }
+
+TEST(CPose3DInterpolator, interpolateMany)
+{
+	using namespace mrpt::poses;
+	using mrpt::math::TPose3D;
+	using namespace std::chrono_literals;
+
+	auto& rnd = mrpt::random::getRandomGenerator();
+	rnd.randomize(1);
+	const auto t0 = mrpt::Clock::now();
+	CPose3DInterpolator pose_path;
+	for (int i = 0; i < 20; i++)
+		pose_path.insert(
+			t0 + i * 100ms,
+			TPose3D(
+				rnd.drawUniform(-5, 5), rnd.drawUniform(-5, 5),
+				rnd.drawUniform(-5, 5), rnd.drawUniform(-M_PI, M_PI),
+				rnd.drawUniform(-1.5, 1.5), rnd.drawUniform(-M_PI, M_PI)));
+	// A segment with the same orientation at both ends:
+	pose_path.insert(t0 + 2000ms, TPose3D(1, 2, 3, 0.1, 0.2, 0.3));
+	pose_path.insert(t0 + 2100ms, TPose3D(2, 3, 4, 0.1, 0.2, 0.3));
+
+	// Sorted times, before, within (including exact matches) and after the
+	// path; then a few unsorted ones:
+	std::vector<mrpt::Clock::time_point> ts;
+	for (int i = -10; i < 2300; i++) ts.push_back(t0 + i * 1ms);
+	for (int i = 0; i < 30; i++) ts.push_back(t0 + (i * 37 % 2200) * 1ms);
+
+	// (imSplineSlerp can not be used in the first and last intervals)
+	std::vector<mrpt::Clock::time_point> ts_inner;
+	for (const auto& t : ts)
+		if (t >= t0 + 100ms && t < t0 + 2000ms) ts_inner.push_back(t);
+
+	for (const auto method :
+		 {imLinearSlerp, imSplineSlerp, imLinear2Neig, imSpline})
+	{
+		pose_path.setInterpolationMethod(method);
+		if (method == imSplineSlerp) ts.swap(ts_inner);
+		std::vector<TPose3D> poses;
+		std::vector<bool> valids;
+		pose_path.interpolateMany(ts, poses, valids);
+		ASSERT_EQ(poses.size(), ts.size());
+		ASSERT_EQ(valids.size(), ts.size());
+		for (size_t i = 0; i < ts.size(); i++)
+		{
+			TPose3D p;
+			bool valid;
+			pose_path.interpolate(ts[i], p, valid);
+			EXPECT_EQ(valid, valids[i]) << " i=" << i;
+			for (int k = 0; k < 6; k++)
+				EXPECT_NEAR(p[k], poses[i][k], 1e-9)
+					<< " method=" << int(method) << " i=" << i;
+		}
+		if (method == imSplineSlerp) ts.swap(ts_inner);
+	}
+}
@@ -992,3 +992,54 @@ TEST_F(Pose3DTests, Jacob_dAexpeD_de)
 				i[0], i[1], i[2], DEG2RAD(i[3]), DEG2RAD(i[4]), DEG2RAD(i[5]),
 				j[0], j[1], j[2], DEG2RAD(j[3]), DEG2RAD(j[4]), DEG2RAD(j[5]));
 }
+
+TEST_F(Pose3DTests, composePoints)
+{
+	const CPose3D p(1.0, -2.0, 3.0, DEG2RAD(30), DEG2RAD(-10), DEG2RAD(75));
+	// Sizes with and without remainders, and enough for several threads:
+	for (const size_t N : {0, 1, 7, 1003, 300001})
+	{
+		std::vector<float> xs(N), ys(N), zs(N), gx(N), gy(N), gz(N);
+		for (size_t i = 0; i < N; i++)
+		{
+			xs[i] = 0.01f * (i % 1000);
+			ys[i] = -0.02f * (i % 777);
+			zs[i] = 0.5f * std::sin(0.001 * i);
+		}
+		mrpt::math::TPoint3Df bbMin, bbMax;
+		p.composePoints(
+			xs.data(), ys.data(), zs.data(), gx.data(), gy.data(), gz.data(),
+			N, &bbMin, &bbMax, 4);
+
+		mrpt::math::TPoint3Df gMin(1e9f, 1e9f, 1e9f),
+			gMax(-1e9f, -1e9f, -1e9f);
+		for (size_t i = 0; i < N; i++)
+		{
+			double x, y, z;
+			p.composePoint(xs[i], ys[i], zs[i], x, y, z);
+			EXPECT_NEAR(x, gx[i], 1e-4);
+			EXPECT_NEAR(y, gy[i], 1e-4);
+			EXPECT_NEAR(z, gz[i], 1e-4);
+			const mrpt::math::TPoint3Df g(gx[i], gy[i], gz[i]);
+			for (int k = 0; k < 3; k++)
+			{
+				mrpt::keep_min(gMin[k], g[k]);
+				mrpt::keep_max(gMax[k], g[k]);
+			}
+		}
+		if (!N) continue;
+		for (int k = 0; k < 3; k++)
+		{
+			EXPECT_EQ(gMin[k], bbMin[k]);
+			EXPECT_EQ(gMax[k], bbMax[k]);
+		}
+
+		// In place:
+		p.composePoints(
+			xs.data(), ys.data(), zs.data(), xs.data(), ys.data(), zs.data(),
+			N);
+		EXPECT_EQ(xs, gx);
+		EXPECT_EQ(ys, gy);
+		EXPECT_EQ(zs, gz);
+	}
+}
@@ -73,8 +73,47 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 	{
 		out_interp[k] = 0;
 	}
+	// Out of range?
+	auto it_ge1 = m_path.lower_bound(t);
+
+	// Exact match?
+	if (it_ge1 != m_path.end() && it_ge1->first == t)
+	{
+		out_interp = it_ge1->second;
+		out_valid_interp = true;
+		return out_interp;
+	}
+
 	TTimePosePair p1, p2, p3, p4;
-	p1.second = p2.second = p3.second = p4.second = out_interp;
+	if (!impl_get_neighbours(it_ge1, p1, p2, p3, p4))
+	{
+		out_valid_interp = false;
+		return out_interp;
+	}
+
+	// Do interpolation:
+	// ------------------------------------------
+	// First Previous point:  p1
+	// Second Previous point: p2
+	// First Next point:	  p3
+	// Second Next point:     p4
+	// Time where to interpolate:  t
+
+	impl_interpolation(p1, p2, p3, p4, m_method, t, out_interp);
+
+	out_valid_interp = true;
+	return out_interp;
+
+}  // end interpolate
+
+template <int DIM>
+bool CPoseInterpolatorBase<DIM>::impl_get_neighbours(
+	const_iterator it_ge1, TTimePosePair& p1, TTimePosePair& p2,
+	TTimePosePair& p3, TTimePosePair& p4) const
+{
+	pose_t zero;
+	for (size_t k = 0; k < pose_t::static_size; k++) zero[k] = 0;
+	p1.second = p2.second = p3.second = p4.second = zero;
 
 	// We'll look for 4 consecutive time points.
 	// Check if the selected method needs all 4 points or just the central 2 of
@@ -92,34 +131,15 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 			break;
 	};
 
-	// Out of range?
-	auto it_ge1 = m_path.lower_bound(t);
-
-	// Exact match?
-	if (it_ge1 != m_path.end() && it_ge1->first == t)
-	{
-		out_interp = it_ge1->second;
-		out_valid_interp = true;
-		return out_interp;
-	}
-
 	// Are we in the beginning or the end of the path?
-	if (it_ge1 == m_path.end() || it_ge1 == m_path.begin())
-	{
-		out_valid_interp = false;
-		return out_interp;
-	}  // end
+	if (it_ge1 == m_path.end() || it_ge1 == m_path.begin()) return false;
 
 	p3 = *it_ge1;  // Third pair
 	auto it_ge2 = it_ge1;
 	++it_ge2;
 	if (it_ge2 == m_path.end())
 	{
-		if (interp_method_requires_4pts)
-		{
-			out_valid_interp = false;
-			return out_interp;
-		}
+		if (interp_method_requires_4pts) return false;
 	}
 	else
 	{
@@ -130,11 +150,7 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 
 	if (it_ge1 == m_path.begin())
 	{
-		if (interp_method_requires_4pts)
-		{
-			out_valid_interp = false;
-			return out_interp;
-		}
+		if (interp_method_requires_4pts) return false;
 	}
 	else
 	{
@@ -151,28 +167,77 @@ typename CPoseInterpolatorBase<DIM>::pose_t&
 										   ? (p4.first - p3.first)
 										   : mrpt::Clock::duration(0);
 
-	if (maxTimeInterpolation.count() > 0 &&
+	return !(
+		maxTimeInterpolation.count() > 0 &&
 		(dt12 > maxTimeInterpolation || dt23 > maxTimeInterpolation ||
-		 dt34 > maxTimeInterpolation))
+		 dt34 > maxTimeInterpolation));
+}
+
+/*---------------------------------------------------------------
+						interpolateMany
+  ---------------------------------------------------------------*/
+template <int DIM>
+void CPoseInterpolatorBase<DIM>::interpolateMany(
+	const std::vector<mrpt::Clock::time_point>& ts,
+	std::vector<pose_t>& out_interp, std::vector<bool>& out_valid_interp) const
+{
+	const size_t N = ts.size();
+	out_interp.resize(N);
+	out_valid_interp.assign(N, false);
+
+	pose_t zero;
+	for (size_t k = 0; k < pose_t::static_size; k++) zero[k] = 0;
+
+	auto it = m_path.begin();
+	for (size_t i = 0; i < N;)
 	{
-		out_valid_interp = false;
-		return out_interp;
-	}
+		const auto& t = ts[i];
+		// First path element at or after t: move forward from the previous
+		// one while times are sorted, search again otherwise.
+		if (i == 0 || t < ts[i - 1])
+			it = m_path.lower_bound(t);
+		else
+			while (it != m_path.end() && it->first < t) ++it;
 
-	// Do interpolation:
-	// ------------------------------------------
-	// First Previous point:  p1
-	// Second Previous point: p2
-	// First Next point:	  p3
-	// Second Next point:     p4
-	// Time where to interpolate:  t
+		// Exact match?
+		if (it != m_path.end() && it->first == t)
+		{
+			out_interp[i] = it->second;
+			out_valid_interp[i++] = true;
+			continue;
+		}
 
-	impl_interpolation(p1, p2, p3, p4, m_method, t, out_interp);
+		// All the following times within the same interval:
+		size_t j = i + 1;
+		while (j < N && ts[j] >= ts[j - 1] &&
+			   (it == m_path.end() || ts[j] < it->first))
+			j++;
 
-	out_valid_interp = true;
-	return out_interp;
+		TTimePosePair p1, p2, p3, p4;
+		if (impl_get_neighbours(it, p1, p2, p3, p4))
+		{
+			impl_interpolation_many(
+				p1, p2, p3, p4, m_method, &ts[i], j - i, &out_interp[i]);
+			for (size_t k = i; k < j; k++) out_valid_interp[k] = true;
+		}
+		else
+		{
+			for (size_t k = i; k < j; k++) out_interp[k] = zero;
+		}
+		i = j;
+	}
+}
 
-}  // end interpolate
+// Generic implementation: one by one. Specialized where it pays off.
+template <int DIM>
+void CPoseInterpolatorBase<DIM>::impl_interpolation_many(
+	const TTimePosePair& p1, const TTimePosePair& p2, const TTimePosePair& p3,
+	const TTimePosePair& p4, const TInterpolatorMethod method,
+	const mrpt::Clock::time_point* ts, const size_t n, pose_t* out_interp) const
+{
+	for (size_t k = 0; k < n; k++)
+		impl_interpolation(p1, p2, p3, p4, method, ts[k], out_interp[k]);
+}
 
 template <int DIM>
 bool CPoseInterpolatorBase<DIM>::getPreviousPoseWithMinDistance(
@@ -17,6 +17,7 @@
 #include <mrpt/poses/CPose3DPDFParticles.h>
 #include <mrpt/poses/CPose3DPDFSOG.h>
 #include <mrpt/random.h>
+#include <algorithm>
 
 using namespace mrpt;
 using namespace mrpt::math;
@@ -250,6 +251,48 @@ CPose3D& CPoseRandomSampler::drawSample(CPose3D& p) const
 	MRPT_END
 }
 
+/*---------------------------------------------------------------
+					drawSamples
+  ---------------------------------------------------------------*/
+void CPoseRandomSampler::drawSamples(size_t N, TPose2DParticlesSoA& out) const
+{
+	MRPT_START
+	out.resize(N);
+	std::fill(out.log_w.begin(), out.log_w.end(), 0.0);
+	if (m_pdf2D && IS_CLASS(m_pdf2D.get(), CPosePDFGaussian))
+	{
+		// Draw all the normalized random numbers first, in the same order
+		// than N calls to do_sample_2D():
+		std::vector<double> rnd(3 * N);
+		auto& rng = getRandomGenerator();
+		for (auto& r : rnd) r = rng.drawGaussian1D_normalized();
+
+		// mean + Z * rnd, one component at a time:
+		const auto& Z = m_fastdraw_gauss_Z3;
+		const auto& M = m_fastdraw_gauss_M_2D;
+		const double* r = rnd.data();
+		double* outs[3] = {out.x.data(), out.y.data(), out.phi.data()};
+		const double means[3] = {M.x(), M.y(), M.phi()};
+		for (size_t d = 0; d < 3; d++)
+		{
+			const double z0 = Z.get_unsafe(d, 0), z1 = Z.get_unsafe(d, 1),
+						 z2 = Z.get_unsafe(d, 2), m = means[d];
+			double* o = outs[d];
+			for (size_t i = 0; i < N; i++)
+				o[i] = m + z0 * r[3 * i] + z1 * r[3 * i + 1] +
+					   z2 * r[3 * i + 2];
+		}
+		out.normalizePhi();
+	}
+	else
+	{
+		CPose2D p;
+		for (size_t i = 0; i < N; i++)
+			out.setPose(i, drawSample(p).asTPose());
+	}
+	MRPT_END
+}
+
 /*---------------------------------------------------------------
 				  do_sample_2D: Sample from a 2D PDF
   ---------------------------------------------------------------*/
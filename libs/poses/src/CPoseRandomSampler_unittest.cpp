@@ -12,3 +12,40 @@
 #include <gtest/gtest.h>
 
 template class mrpt::CTraitsTest<mrpt::poses::CPoseRandomSampler>;
+
+#include <mrpt/poses/CPosePDFGaussian.h>
+#include <mrpt/random.h>
+
+TEST(CPoseRandomSampler, drawSamples_2D_gaussian)
+{
+	using namespace mrpt::poses;
+	mrpt::math::CMatrixDouble33 cov;
+	cov.setZero();
+	cov(0, 0) = 0.1;
+	cov(1, 1) = 0.2;
+	cov(0, 1) = cov(1, 0) = 0.05;
+	cov(2, 2) = 0.3;
+	CPosePDFGaussian pdf(CPose2D(1.0, 2.0, 3.0), cov);
+
+	CPoseRandomSampler sampler;
+	sampler.setPosePDF(pdf);
+
+	// Same samples than one at a time:
+	const size_t N = 100;
+	mrpt::random::getRandomGenerator().randomize(1234);
+	TPose2DParticlesSoA bulk;
+	sampler.drawSamples(N, bulk);
+	ASSERT_EQ(bulk.size(), N);
+
+	mrpt::random::getRandomGenerator().randomize(1234);
+	for (size_t i = 0; i < N; i++)
+	{
+		CPose2D p;
+		sampler.drawSample(p);
+		EXPECT_NEAR(bulk.x[i], p.x(), 1e-9);
+		EXPECT_NEAR(bulk.y[i], p.y(), 1e-9);
+		EXPECT_NEAR(bulk.phi[i], p.phi(), 1e-9);
+		EXPECT_LE(bulk.phi[i], M_PI);
+		EXPECT_GT(bulk.phi[i], -M_PI);
+	}
+}
@@ -0,0 +1,61 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "poses-precomp.h"  // Precompiled headers
+
+#include <mrpt/poses/TPose2DParticlesSoA.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/math/wrap2pi.h>
+#include <cmath>
+
+using namespace mrpt::poses;
+
+void TPose2DParticlesSoA::resize(size_t N)
+{
+	x.resize(N);
+	y.resize(N);
+	phi.resize(N);
+	log_w.resize(N);
+}
+
+void TPose2DParticlesSoA::composeWith(const TPose2DParticlesSoA& incr)
+{
+	ASSERT_EQUAL_(incr.size(), size());
+	const size_t N = size();
+	double* px = x.data();
+	double* py = y.data();
+	double* pphi = phi.data();
+	const double* dx = incr.x.data();
+	const double* dy = incr.y.data();
+	const double* dphi = incr.phi.data();
+
+	for (size_t i = 0; i < N; i++)
+	{
+		const double c = std::cos(pphi[i]), s = std::sin(pphi[i]);
+		px[i] += c * dx[i] - s * dy[i];
+		py[i] += s * dx[i] + c * dy[i];
+		pphi[i] += dphi[i];
+	}
+	normalizePhi();
+}
+
+void TPose2DParticlesSoA::normalizePhi()
+{
+	double* pphi = phi.data();
+	// Angles are usually already in range, or out by just one turn:
+	for (size_t i = 0; i < phi.size(); i++)
+	{
+		if (pphi[i] > M_PI)
+			pphi[i] -= 2 * M_PI;
+		else if (pphi[i] <= -M_PI)
+			pphi[i] += 2 * M_PI;
+		if (pphi[i] > M_PI || pphi[i] <= -M_PI)
+			pphi[i] = mrpt::math::wrapToPi(pphi[i]);
+	}
+}
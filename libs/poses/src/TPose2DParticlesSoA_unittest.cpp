@@ -0,0 +1,80 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/poses/CPose2D.h>
+#include <mrpt/poses/CPosePDFParticles.h>
+#include <mrpt/poses/TPose2DParticlesSoA.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace mrpt::poses;
+using mrpt::bayes::CParticleFilterCapable;
+
+TEST(TPose2DParticlesSoA, composeWith)
+{
+	const mrpt::math::TPose2D poses[3] = {
+		{1.0, 2.0, 0.5}, {-1.0, 0.0, 3.0}, {0.0, 5.0, -3.0}};
+	const mrpt::math::TPose2D incrs[3] = {
+		{0.3, -0.2, 0.1}, {1.0, 0.5, 0.5}, {0.0, 0.0, -0.5}};
+
+	CPosePDFParticles parts(3);
+	for (size_t i = 0; i < 3; i++) parts.m_particles[i].d = poses[i];
+	parts.m_particles[1].log_w = -2.0;
+
+	TPose2DParticlesSoA soa, incr;
+	soa.loadFrom(parts.m_particles);
+	EXPECT_EQ(soa.log_w[1], -2.0);
+	incr.resize(3);
+	for (size_t i = 0; i < 3; i++) incr.setPose(i, incrs[i]);
+
+	soa.composeWith(incr);
+	soa.storeTo(parts.m_particles);
+
+	// Same than the regular pose composition:
+	for (size_t i = 0; i < 3; i++)
+	{
+		const CPose2D expected = CPose2D(poses[i]) + CPose2D(incrs[i]);
+		const auto& p = parts.m_particles[i].d;
+		EXPECT_NEAR(p.x, expected.x(), 1e-12);
+		EXPECT_NEAR(p.y, expected.y(), 1e-12);
+		EXPECT_NEAR(p.phi, expected.phi(), 1e-12);
+	}
+	EXPECT_EQ(parts.m_particles[1].log_w, -2.0);
+}
+
+TEST(TPose2DParticlesSoA, bulk_weights)
+{
+	// Huge log-weights must not overflow:
+	std::vector<double> log_w = {1000.0, 1000.0, 1000.0, 1000.0};
+	EXPECT_NEAR(
+		CParticleFilterCapable::computeESS(log_w.data(), log_w.size()), 1.0,
+		1e-9);
+
+	log_w = {0.0, -1e6, -1e6, -1e6};
+	EXPECT_NEAR(
+		CParticleFilterCapable::computeESS(log_w.data(), log_w.size()), 0.25,
+		1e-9);
+
+	log_w = {-1.0, -3.0, 2.0};
+	double max_log_w = 0;
+	const double ratio = CParticleFilterCapable::normalizeLogWeights(
+		log_w.data(), log_w.size(), &max_log_w);
+	EXPECT_NEAR(max_log_w, 2.0, 1e-12);
+	EXPECT_NEAR(ratio, std::exp(5.0), 1e-6);
+	EXPECT_NEAR(log_w[0], -3.0, 1e-12);
+	EXPECT_NEAR(log_w[2], 0.0, 1e-12);
+
+	// Same results through the particle container interface:
+	CPosePDFParticles parts(3);
+	parts.m_particles[0].log_w = 0.0;
+	parts.m_particles[1].log_w = std::log(2.0);
+	parts.m_particles[2].log_w = std::log(3.0);
+	// ESS = (1+2+3)^2 / (3 * (1+4+9))
+	EXPECT_NEAR(parts.ESS(), 36.0 / 42.0, 1e-9);
+}
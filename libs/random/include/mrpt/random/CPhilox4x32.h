@@ -0,0 +1,119 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace mrpt::random
+{
+/** A counter-based pseudo random number generator, implementing the
+ * Philox4x32-10 algorithm (Salmon et al., "Parallel random numbers: as easy
+ * as 1, 2, 3", SC'11).
+ *
+ * Each block of four 32-bit numbers is a pure function of a 64-bit key (the
+ * seed), a 64-bit stream index and a 64-bit block counter, so:
+ * - Generating many blocks at once is a plain loop without dependencies
+ *   between iterations, which compilers vectorize. See fillUniform32(),
+ *   fillUniform() and fillGaussian().
+ * - Generators with the same seed and different stream indices produce
+ *   independent sequences, e.g. one per thread, which are reproducible
+ *   regardless of how the work is scheduled. See stream().
+ *
+ * This class fulfills the C++ UniformRandomBitGenerator requirements, so it
+ * can be also used with `<random>` distributions. Bulk fills return exactly
+ * the same numbers than successive calls to operator().
+ *
+ * \ingroup mrpt_random_grp
+ * \sa CRandomGenerator::fillGaussian
+ */
+class CPhilox4x32
+{
+   public:
+	using result_type = uint32_t;
+	using block_t = std::array<uint32_t, 4>;
+
+	/** Creates a generator for the given seed and stream index */
+	explicit CPhilox4x32(uint64_t seed = 0, uint64_t stream_index = 0)
+	{
+		this->seed(seed, stream_index);
+	}
+
+	/** Resets the generator to the beginning of the given stream */
+	void seed(uint64_t seed, uint64_t stream_index = 0)
+	{
+		m_key = seed;
+		m_stream = stream_index;
+		m_counter = 0;
+		m_bufIdx = 4;
+	}
+
+	/** Returns a new generator with the same seed and another stream index,
+	 * independent from this one. */
+	CPhilox4x32 stream(uint64_t stream_index) const
+	{
+		return CPhilox4x32(m_key, stream_index);
+	}
+
+	uint64_t getSeed() const { return m_key; }
+	uint64_t getStreamIndex() const { return m_stream; }
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max()
+	{
+		return std::numeric_limits<result_type>::max();
+	}
+
+	/** Returns the next 32-bit number of the stream */
+	result_type operator()()
+	{
+		if (m_bufIdx == 4)
+		{
+			m_buf = block(m_key, m_stream, m_counter++);
+			m_bufIdx = 0;
+		}
+		return m_buf[m_bufIdx++];
+	}
+
+	/** Skips the next `n` 32-bit numbers, in constant time */
+	void discard(uint64_t n);
+
+	/** Fills an array with the next `n` numbers of the stream */
+	void fillUniform32(uint32_t* out, size_t n);
+
+	/** Fills an array with uniformly distributed numbers in [min,max), with
+	 * 52 random bits each (two 32-bit numbers per sample). */
+	void fillUniform(
+		double* out, size_t n, const double min = 0, const double max = 1);
+
+	/** Fills an array with normally distributed numbers, using the Box-Muller
+	 * transform on pairs of uniform samples (four 32-bit numbers for each
+	 * pair of outputs). The transform uses its own polynomial approximations
+	 * of log(), sin() and cos(), so it is vectorized, and the results do not
+	 * depend on the platform math library. */
+	void fillGaussian(
+		double* out, size_t n, const double mean = 0, const double std_dev = 1);
+
+	/** The Philox4x32-10 bijection: the block number `counter` of the stream
+	 * `stream_index`, with key `seed`. */
+	static block_t block(
+		uint64_t seed, uint64_t stream_index, uint64_t counter);
+
+   private:
+	uint64_t m_key, m_stream;
+	/** Index of the next block to generate */
+	uint64_t m_counter;
+	/** The last generated block, and how many of its words were used */
+	block_t m_buf;
+	unsigned int m_bufIdx;
+};
+
+}  // namespace mrpt::random
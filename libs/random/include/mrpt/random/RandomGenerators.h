@@ -16,6 +16,7 @@
 #include <cstddef>
 #include <type_traits>  // remove_reference
 #include <mrpt/random/random_shuffle.h>
+#include <mrpt/random/CPhilox4x32.h>
 
 // Frwd decl:
 namespace Eigen
@@ -38,7 +39,12 @@ namespace random
  * http://en.wikipedia.org/wiki/Mersenne_twister
  *
  * For real thread-safety, each thread must create and use its own instance of
- * this class.
+ * this class. Use deriveStream() to create independent and reproducible
+ * generators for each thread from a common seed.
+ *
+ * Large arrays of uniform or Gaussian samples are faster generated with the
+ * bulk methods fillUniform() and fillGaussian(), which use a counter-based
+ * generator (CPhilox4x32) instead of the MT19937 one.
  *
  * Single-thread programs can use the static object
  * mrpt::random::randomGenerator
@@ -54,6 +60,11 @@ class CRandomGenerator
 	std::uniform_int_distribution<uint32_t> m_uint32;
 	std::uniform_int_distribution<uint64_t> m_uint64;
 
+	/** Generator for the bulk methods */
+	CPhilox4x32 m_philox;
+	/** The last seed, for deriveStream() */
+	uint32_t m_seed{0};
+
 	void MT19937_initializeGenerator(const uint32_t& seed);
 
    public:
@@ -64,11 +75,31 @@ class CRandomGenerator
 	CRandomGenerator() { randomize(); }
 	/** Constructor for providing a custom random seed to initialize the PRNG */
 	CRandomGenerator(const uint32_t seed) { randomize(seed); }
+	/** Constructor for a given seed and stream index. \sa deriveStream */
+	CRandomGenerator(const uint32_t seed, const uint64_t stream)
+	{
+		randomize(seed, stream);
+	}
 	/** Initialize the PRNG from the given random seed */
-	void randomize(const uint32_t seed);
+	void randomize(const uint32_t seed) { randomize(seed, 0); }
+	/** Initialize the PRNG from the given random seed and stream index.
+	 * Different streams with the same seed are independent, and stream #0
+	 * is the same than randomize(seed). */
+	void randomize(const uint32_t seed, const uint64_t stream);
 	/** Randomize the generators, based on std::random_device */
 	void randomize();
 
+	/** Returns a new generator with the same seed than this one, and the given
+	 * stream index. For example, to reproduce the results of a parallel
+	 * algorithm regardless of thread scheduling, each work item `i` can use
+	 * `deriveStream(i+1)` of a generator randomized with a known seed.
+	 * \note The new generator starts at the beginning of its stream, not at
+	 * the current state of this one. */
+	CRandomGenerator deriveStream(const uint64_t stream) const
+	{
+		return CRandomGenerator(m_seed, stream);
+	}
+
 	/** @} */
 
 	/** @name Uniform pdf
@@ -143,6 +174,17 @@ class CRandomGenerator
 				drawUniform(unif_min, unif_max));
 	}
 
+	/** Fills an array with independent, uniformly distributed samples in
+	 * [unif_min,unif_max), much faster than drawUniform() for large arrays.
+	 * Samples come from the counter-based generator, not from the
+	 * MT19937 one. \sa CPhilox4x32::fillUniform */
+	void fillUniform(
+		double* out, const size_t N, const double unif_min = 0,
+		const double unif_max = 1)
+	{
+		m_philox.fillUniform(out, N, unif_min, unif_max);
+	}
+
 	/** @} */
 
 	/** @name Normal/Gaussian pdf
@@ -164,6 +206,17 @@ class CRandomGenerator
 		return mean + std * drawGaussian1D_normalized();
 	}
 
+	/** Fills an array with independent, normally distributed samples, much
+	 * faster than drawGaussian1D() for large arrays. Samples come from the
+	 * counter-based generator, not from the MT19937 one.
+	 * \sa CPhilox4x32::fillGaussian */
+	void fillGaussian(
+		double* out, const size_t N, const double mean = 0,
+		const double std = 1)
+	{
+		m_philox.fillGaussian(out, N, mean, std);
+	}
+
 	/** Fills the given matrix with independent, 1D-normally distributed
 	 * samples.
 	 * Matrix classes can be mrpt::math::CMatrixTemplateNumeric or
@@ -359,13 +412,19 @@ class CRandomGenerator
 
 	/** Returns a random permutation of a vector: all the elements of the input
 	 * vector are in the output but at random positions.
+	 * The permutation is drawn from this generator, so it is reproducible
+	 * after randomize() with a given seed.
 	 */
 	template <class VEC>
 	void permuteVector(const VEC& in_vector, VEC& out_result)
 	{
 		out_result = in_vector;
 		const size_t N = out_result.size();
-		if (N > 1) mrpt::random::shuffle(&out_result[0], &out_result[N - 1]);
+		// Fisher-Yates shuffle:
+		for (size_t i = N; i > 1; i--)
+			std::swap(
+				out_result[i - 1],
+				out_result[static_cast<size_t>(drawUniform64bit() % i)]);
 	}
 
 	/** @} */
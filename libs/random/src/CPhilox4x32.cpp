@@ -0,0 +1,251 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "random-precomp.h"  // Precompiled headers
+
+#include <mrpt/random/CPhilox4x32.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace mrpt::random;
+
+namespace
+{
+// Philox4x32 multipliers and Weyl sequence increments for the key:
+constexpr uint32_t PHILOX_M0 = 0xD2511F53, PHILOX_M1 = 0xCD9E8D57;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9, PHILOX_W1 = 0xBB67AE85;
+constexpr unsigned int PHILOX_ROUNDS = 10;
+
+// Number of blocks processed at once, in independent "lanes":
+constexpr size_t LANES = 16;
+
+/** Generates `nBlocks` consecutive blocks, starting at `first`, into
+ * `out[4*nBlocks]`. All lanes run the same branch-free operations, so the
+ * inner loops are vectorized by the compiler. */
+void philoxBlocks(
+	const uint64_t key, const uint64_t stream, uint64_t first, size_t nBlocks,
+	uint32_t* out)
+{
+	while (nBlocks > 0)
+	{
+		const size_t L = std::min(nBlocks, LANES);
+		uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+		for (size_t i = 0; i < L; i++)
+		{
+			const uint64_t ctr = first + i;
+			c0[i] = static_cast<uint32_t>(ctr);
+			c1[i] = static_cast<uint32_t>(ctr >> 32);
+			c2[i] = static_cast<uint32_t>(stream);
+			c3[i] = static_cast<uint32_t>(stream >> 32);
+		}
+		uint32_t k0 = static_cast<uint32_t>(key);
+		uint32_t k1 = static_cast<uint32_t>(key >> 32);
+		for (unsigned int r = 0; r < PHILOX_ROUNDS; r++)
+		{
+			for (size_t i = 0; i < L; i++)
+			{
+				const uint64_t p0 = uint64_t(PHILOX_M0) * c0[i];
+				const uint64_t p1 = uint64_t(PHILOX_M1) * c2[i];
+				const uint32_t n0 = uint32_t(p1 >> 32) ^ c1[i] ^ k0;
+				const uint32_t n2 = uint32_t(p0 >> 32) ^ c3[i] ^ k1;
+				c0[i] = n0;
+				c1[i] = static_cast<uint32_t>(p1);
+				c2[i] = n2;
+				c3[i] = static_cast<uint32_t>(p0);
+			}
+			k0 += PHILOX_W0;
+			k1 += PHILOX_W1;
+		}
+		for (size_t i = 0; i < L; i++)
+		{
+			out[4 * i + 0] = c0[i];
+			out[4 * i + 1] = c1[i];
+			out[4 * i + 2] = c2[i];
+			out[4 * i + 3] = c3[i];
+		}
+		out += 4 * L;
+		first += L;
+		nBlocks -= L;
+	}
+}
+
+// A double in [1,2) with 52 random bits from two 32-bit words, built with
+// integer operations only (faster than converting a 64-bit integer):
+inline double uniform12(const uint32_t a, const uint32_t b)
+{
+	const uint64_t bits =
+		0x3FF0000000000000ULL | (uint64_t(a) << 20) | (b >> 12);
+	double d;
+	std::memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+// Samples converted in each chunk, using a temporary buffer on the stack:
+constexpr size_t CHUNK = 128;
+
+// The Box-Muller transform below uses polynomial approximations of log(),
+// sin() and cos() accurate to about 1e-15, without branches or calls to the
+// math library, so its loop is vectorized (and its results are the same in
+// all platforms).
+
+// Natural logarithm of a normal, positive double:
+inline double logPoly(const double x)
+{
+	constexpr double LN2 = 0.693147180559945309417232121458;
+	constexpr double LN1_5 = 0.405465108108164381978013115464;
+	uint64_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	// Exponent, as the double 2^52+exponent:
+	const uint64_t e_bits = (bits >> 52) | 0x4330000000000000ULL;
+	double e;
+	std::memcpy(&e, &e_bits, sizeof(e));
+	e -= 4503599627370496.0 + 1023;
+	bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+	double m;  // mantissa, in [1,2)
+	std::memcpy(&m, &bits, sizeof(m));
+	// log(m) = log(1.5) + 2*atanh(t), t=(m-1.5)/(m+1.5), |t|<=0.2:
+	const double t = (m - 1.5) / (m + 1.5), t2 = t * t;
+	double p = 1.0 / 23;
+	p = p * t2 + 1.0 / 21;
+	p = p * t2 + 1.0 / 19;
+	p = p * t2 + 1.0 / 17;
+	p = p * t2 + 1.0 / 15;
+	p = p * t2 + 1.0 / 13;
+	p = p * t2 + 1.0 / 11;
+	p = p * t2 + 1.0 / 9;
+	p = p * t2 + 1.0 / 7;
+	p = p * t2 + 1.0 / 5;
+	p = p * t2 + 1.0 / 3;
+	p = p * t2 + 1.0;
+	return e * LN2 + LN1_5 + 2.0 * t * p;
+}
+
+// sin() and cos() of the angle 2*pi*u, for u in [0,1):
+inline void sinCosUniform(const double u, double& out_sin, double& out_cos)
+{
+	constexpr double HALF_PI = 1.57079632679489661923132169164;
+	constexpr double SQRT1_2 = 0.707106781186547524400844362105;
+	// Quadrant q, and angle "a" from the center of the quadrant:
+	const double q = static_cast<double>(static_cast<int32_t>(4 * u));
+	const double a = (4 * u - q - 0.5) * HALF_PI;
+	// Taylor series, |a|<=pi/4:
+	const double a2 = a * a;
+	double sa = -1.0 / 1307674368000;
+	sa = sa * a2 + 1.0 / 6227020800;
+	sa = sa * a2 - 1.0 / 39916800;
+	sa = sa * a2 + 1.0 / 362880;
+	sa = sa * a2 - 1.0 / 5040;
+	sa = sa * a2 + 1.0 / 120;
+	sa = sa * a2 - 1.0 / 6;
+	sa = (sa * a2 + 1.0) * a;
+	double ca = 1.0 / 20922789888000;
+	ca = ca * a2 - 1.0 / 87178291200;
+	ca = ca * a2 + 1.0 / 479001600;
+	ca = ca * a2 - 1.0 / 3628800;
+	ca = ca * a2 + 1.0 / 40320;
+	ca = ca * a2 - 1.0 / 720;
+	ca = ca * a2 + 1.0 / 24;
+	ca = ca * a2 - 0.5;
+	ca = ca * a2 + 1.0;
+	// Rotate by the quadrant center (q+1/2)*pi/2:
+	const double cq = std::abs(q - 1.5) > 1.0 ? SQRT1_2 : -SQRT1_2;
+	const double sq = q < 1.5 ? SQRT1_2 : -SQRT1_2;
+	out_cos = cq * ca - sq * sa;
+	out_sin = sq * ca + cq * sa;
+}
+}  // namespace
+
+CPhilox4x32::block_t CPhilox4x32::block(
+	uint64_t seed, uint64_t stream_index, uint64_t counter)
+{
+	block_t b;
+	philoxBlocks(seed, stream_index, counter, 1, b.data());
+	return b;
+}
+
+void CPhilox4x32::discard(uint64_t n)
+{
+	while (n > 0 && m_bufIdx < 4)
+	{
+		m_bufIdx++;
+		n--;
+	}
+	m_counter += n / 4;
+	if (n % 4)
+	{
+		m_buf = block(m_key, m_stream, m_counter++);
+		m_bufIdx = static_cast<unsigned int>(n % 4);
+	}
+}
+
+void CPhilox4x32::fillUniform32(uint32_t* out, size_t n)
+{
+	// Remaining words of the last block:
+	while (n > 0 && m_bufIdx < 4)
+	{
+		*out++ = m_buf[m_bufIdx++];
+		n--;
+	}
+	// Whole blocks:
+	const size_t nBlocks = n / 4;
+	philoxBlocks(m_key, m_stream, m_counter, nBlocks, out);
+	m_counter += nBlocks;
+	out += 4 * nBlocks;
+	// Partial block at the end:
+	for (size_t i = 0; i < n % 4; i++) out[i] = (*this)();
+}
+
+void CPhilox4x32::fillUniform(
+	double* out, size_t n, const double min, const double max)
+{
+	const double scale = max - min;
+	uint32_t buf[2 * CHUNK];
+	while (n > 0)
+	{
+		const size_t m = std::min(n, CHUNK);
+		fillUniform32(buf, 2 * m);
+		for (size_t i = 0; i < m; i++)
+			out[i] = min + scale * (uniform12(buf[2 * i], buf[2 * i + 1]) - 1);
+		out += m;
+		n -= m;
+	}
+}
+
+void CPhilox4x32::fillGaussian(
+	double* out, size_t n, const double mean, const double std_dev)
+{
+	uint32_t buf[4 * CHUNK];
+	double rad[CHUNK], c[CHUNK], s[CHUNK];
+	while (n > 0)
+	{
+		const size_t nOut = std::min(n, 2 * CHUNK);
+		const size_t nPairs = (nOut + 1) / 2;
+		fillUniform32(buf, 4 * nPairs);
+		for (size_t i = 0; i < nPairs; i++)
+		{
+			// u1 in (0,1], so its log is finite:
+			const double u1 = 2.0 - uniform12(buf[4 * i], buf[4 * i + 1]);
+			const double u2 = uniform12(buf[4 * i + 2], buf[4 * i + 3]) - 1;
+			// (max(): log(1) may round to a tiny positive number)
+			rad[i] = std_dev * std::sqrt(std::max(0.0, -2.0 * logPoly(u1)));
+			sinCosUniform(u2, s[i], c[i]);
+		}
+		const size_t nFull = nOut / 2;
+		for (size_t i = 0; i < nFull; i++)
+		{
+			out[2 * i] = mean + rad[i] * c[i];
+			out[2 * i + 1] = mean + rad[i] * s[i];
+		}
+		// Odd number of outputs: the last pair gives only one sample
+		if (nOut % 2) out[nOut - 1] = mean + rad[nFull] * c[nFull];
+		out += nOut;
+		n -= nOut;
+	}
+}
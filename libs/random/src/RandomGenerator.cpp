@@ -29,15 +29,21 @@ uint64_t CRandomGenerator::drawUniform64bit() { return m_uint64(m_MT19937); }
 // MT19937 algorithm
 // http://en.wikipedia.org/wiki/Mersenne_twister
 uint32_t CRandomGenerator::drawUniform32bit() { return m_uint32(m_MT19937); }
-void CRandomGenerator::randomize(const uint32_t seed)
+void CRandomGenerator::randomize(const uint32_t seed, const uint64_t stream)
 {
-	MT19937_initializeGenerator(seed);
+	m_seed = seed;
+	if (stream == 0)
+		MT19937_initializeGenerator(seed);
+	else
+	{
+		std::seed_seq seq{seed, static_cast<uint32_t>(stream),
+						  static_cast<uint32_t>(stream >> 32)};
+		m_MT19937.seed(seq);
+	}
+	m_philox.seed(seed, stream);
 }
 
-void CRandomGenerator::randomize()
-{
-	MT19937_initializeGenerator(std::random_device{}());
-}
+void CRandomGenerator::randomize() { randomize(std::random_device{}()); }
 
 double CRandomGenerator::drawGaussian1D_normalized()
 {
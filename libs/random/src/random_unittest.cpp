@@ -9,6 +9,8 @@
 
 #include <mrpt/random/RandomGenerators.h>
 #include <gtest/gtest.h>
+#include <cmath>
+#include <numeric>
 
 TEST(Random, Randomize)
 {
@@ -26,3 +28,94 @@ TEST(Random, Randomize)
 	auto r1abis = rnd.drawUniform32bit();
 	EXPECT_EQ(r1a, r1abis);
 }
+
+// Known-answer tests from the Random123 distribution (kat_vectors):
+TEST(Random, Philox4x32_KAT)
+{
+	using mrpt::random::CPhilox4x32;
+
+	const auto b0 = CPhilox4x32::block(0, 0, 0);
+	EXPECT_EQ(b0[0], 0x6627e8d5U);
+	EXPECT_EQ(b0[1], 0xe169c58dU);
+	EXPECT_EQ(b0[2], 0xbc57ac4cU);
+	EXPECT_EQ(b0[3], 0x9b00dbd8U);
+
+	const auto b1 = CPhilox4x32::block(
+		0x299f31d0a4093822ULL, 0x0370734413198a2eULL, 0x85a308d3243f6a88ULL);
+	EXPECT_EQ(b1[0], 0xd16cfe09U);
+	EXPECT_EQ(b1[1], 0x94fdccebU);
+	EXPECT_EQ(b1[2], 0x5001e420U);
+	EXPECT_EQ(b1[3], 0x24126ea1U);
+}
+
+TEST(Random, Philox4x32_bulk_equals_sequential)
+{
+	using mrpt::random::CPhilox4x32;
+
+	CPhilox4x32 seq(123, 4), bulk(123, 4), skip(123, 4);
+	std::vector<uint32_t> a(1003), b(1003);
+	for (auto& v : a) v = seq();
+	// Unaligned start, many whole blocks, and a partial block at the end:
+	b[0] = bulk();
+	bulk.fillUniform32(&b[1], b.size() - 1);
+	EXPECT_EQ(a, b);
+
+	skip.discard(1001);
+	EXPECT_EQ(skip(), a[1001]);
+	EXPECT_EQ(skip(), a[1002]);
+	EXPECT_EQ(seq(), bulk());
+
+	// Other streams are different:
+	auto other = CPhilox4x32(123, 4).stream(5);
+	EXPECT_NE(other(), a[0]);
+}
+
+TEST(Random, fillGaussian_statistics)
+{
+	using namespace mrpt::random;
+
+	CRandomGenerator rnd(1);
+	const size_t N = 200001;
+	std::vector<double> v(N);
+	rnd.fillGaussian(v.data(), N, 2.0, 3.0);
+	double m = 0, m2 = 0;
+	for (const double x : v) m += x;
+	m /= N;
+	for (const double x : v) m2 += (x - m) * (x - m);
+	const double stdev = std::sqrt(m2 / (N - 1));
+	EXPECT_NEAR(m, 2.0, 0.05);
+	EXPECT_NEAR(stdev, 3.0, 0.05);
+
+	std::vector<double> u(N);
+	rnd.fillUniform(u.data(), N, -1.0, 1.0);
+	for (const double x : u)
+	{
+		EXPECT_GE(x, -1.0);
+		EXPECT_LT(x, 1.0);
+	}
+	EXPECT_NEAR(std::accumulate(u.begin(), u.end(), 0.0) / N, 0.0, 0.01);
+}
+
+TEST(Random, deriveStream)
+{
+	using namespace mrpt::random;
+
+	CRandomGenerator rnd(10);
+	auto s1 = rnd.deriveStream(1), s1bis = rnd.deriveStream(1),
+		 s2 = rnd.deriveStream(2);
+	// Reproducible:
+	EXPECT_EQ(s1.drawUniform32bit(), s1bis.drawUniform32bit());
+	double g1[8], g1bis[8], g2[8];
+	s1.fillGaussian(g1, 8);
+	s1bis.fillGaussian(g1bis, 8);
+	s2.fillGaussian(g2, 8);
+	for (int i = 0; i < 8; i++)
+	{
+		EXPECT_EQ(g1[i], g1bis[i]);
+		EXPECT_NE(g1[i], g2[i]);
+	}
+	// Stream #0 is the same than the plain seed:
+	CRandomGenerator s0 = rnd.deriveStream(0);
+	CRandomGenerator plain(10);
+	EXPECT_EQ(s0.drawUniform32bit(), plain.drawUniform32bit());
+}
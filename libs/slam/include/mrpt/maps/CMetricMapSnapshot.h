@@ -0,0 +1,72 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/maps/CMultiMetricMap.h>
+#include <string>
+
+namespace mrpt::maps
+{
+/** Saves and loads "snapshots" of a CMultiMetricMap: binary files with the
+ * raw arrays of its maps, together with their prebuilt acceleration
+ * structures, so that loading a large map does not spend any time in
+ * rebuilding them.
+ *
+ * Each map is stored in a section starting at a 4096-byte boundary, with its
+ * arrays aligned to 64 bytes, so the files can be memory-mapped:
+ * - mrpt::maps::CSimplePointsMap: the x, y and z coordinate arrays, and the
+ *   3D KD-tree (mrpt::math::KDTreeCapable::kdTreeSaveIndex3D()).
+ * - mrpt::maps::COccupancyGridMap2D: the array of cells, and the cache of
+ *   the likelihood field (see TLikelihoodOptions::enableLikelihoodCache), if
+ *   it has been already computed.
+ * - Any other map (e.g. COctoMap), serialized with
+ *   mrpt::serialization::CArchive, so it is rebuilt upon loading as usual.
+ *
+ * The options of each map are stored too. Snapshot files are meant for
+ * caching prebuilt maps in the same machine (or identical ones), so they use
+ * the native byte order and word size, and they are rejected if those do not
+ * match when loading.
+ *
+ * File format:
+ * - Header: `uint64_t` magic number, `uint32_t` format version, `uint32_t`
+ *   marker 0x01020304 (byte order), `uint32_t` sizeof(size_t), `uint32_t`
+ *   number of sections, and a table with one entry per section: `uint32_t`
+ *   section type, `uint32_t` (reserved), and the `uint64_t` offset and length
+ *   of the section.
+ * - The sections, one per map, in the same order than
+ *   CMultiMetricMap::maps.
+ *
+ * \sa CMultiMetricMap, CSimpleMapIndexedFile
+ * \ingroup mrpt_slam_grp
+ */
+class CMetricMapSnapshot
+{
+   public:
+	/** Writes a snapshot of all the maps. This builds the acceleration
+	 * structures which were not built yet (e.g. the KD-tree of point maps).
+	 * \exception std::exception On any I/O error. */
+	static void save(const CMultiMetricMap& m, const std::string& fileName);
+
+	/** Replaces the contents of `m` by the maps of a snapshot file.
+	 * \exception std::exception On any I/O error, or if the file is not a
+	 * valid snapshot for this platform. */
+	static void load(const std::string& fileName, CMultiMetricMap& m);
+
+	/** Returns true if the file exists and it is a snapshot file (checking
+	 * its magic number only). */
+	static bool isSnapshotFile(const std::string& fileName);
+
+   private:
+	static void savePointsMap(const CSimplePointsMap& m, FILE* f);
+	static void loadPointsMap(CSimplePointsMap& m, FILE* f);
+	static void saveGridMap(const COccupancyGridMap2D& m, FILE* f);
+	static void loadGridMap(COccupancyGridMap2D& m, FILE* f);
+};
+
+}  // namespace mrpt::maps
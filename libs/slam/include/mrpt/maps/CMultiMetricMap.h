@@ -49,6 +49,8 @@ class TSetOfMetricMapInitializers;
  *with octrees (based on the library `octomap`).
  *		- mrpt::maps::CColouredOctoMap: The same than above, but nodes can store
  *RGB data appart from occupancy.
+ *		- mrpt::maps::CVoxelMap: For 3D occupancy grids of fixed resolution,
+ *with a native sparse voxel grid (faster to update than octomaps).
  *		- mrpt::maps::CLandmarksMap: For visual landmarks,etc...
  *		- mrpt::maps::CGasConcentrationGridMap2D: For gas concentration maps.
  *		- mrpt::maps::CWirelessPowerGridMap2D: For wifi power maps.
@@ -311,7 +313,7 @@ class CMultiMetricMap : public mrpt::maps::CMetricMap
 			internal_update_ref();
 			return m_ret ? true : false;
 		}
-		ptr_t get()
+		ptr_t get() const
 		{
 			internal_update_ref();
 			return m_ret.get();
@@ -30,6 +30,13 @@ class CMetricMapBuilderRBPF;
 namespace maps
 {
 /** Auxiliary class used in mrpt::maps::CMultiMetricMapPDF
+ *
+ * Copies of this object (e.g. particles duplicated during resampling) share
+ * the same map, which is only copied when one of them needs to modify it
+ * (copy-on-write). Hence, maps should be accessed through mapTillNow() for
+ * reading, and through mapTillNowForWriting() only right before modifying
+ * them.
+ *
  * \ingroup mrpt_slam_grp
  */
 class CRBPFParticleData : public mrpt::serialization::CSerializable
@@ -38,12 +45,30 @@ class CRBPFParticleData : public mrpt::serialization::CSerializable
    public:
 	CRBPFParticleData(
 		const TSetOfMetricMapInitializers* mapsInitializers = nullptr)
-		: mapTillNow(mapsInitializers), robotPath()
+		: robotPath(),
+		  m_mapTillNow(
+			  mrpt::make_aligned_shared<CMultiMetricMap>(mapsInitializers))
 	{
 	}
 
-	CMultiMetricMap mapTillNow;
+	/** Read-only access to the map of this particle */
+	const CMultiMetricMap& mapTillNow() const { return *m_mapTillNow; }
+	/** Read/write access to the map of this particle. If it is shared with
+	 * other particles, it is copied first. */
+	CMultiMetricMap& mapTillNowForWriting()
+	{
+		if (m_mapTillNow.use_count() > 1)
+			m_mapTillNow =
+				mrpt::make_aligned_shared<CMultiMetricMap>(*m_mapTillNow);
+		return *m_mapTillNow;
+	}
+	/** Whether the map of this particle is shared with other particles */
+	bool isMapShared() const { return m_mapTillNow.use_count() > 1; }
+
 	std::deque<mrpt::math::TPose3D> robotPath;
+
+   private:
+	std::shared_ptr<CMultiMetricMap> m_mapTillNow;
 };
 
 /** Declares a class that represents a Rao-Blackwellized set of particles for
@@ -20,6 +20,7 @@ MRPT_WARNING(
 #include <mrpt/maps.h>
 #include <mrpt/maps/CMultiMetricMap.h>  // This class is in [mrpt-slam]
 #include <mrpt/maps/CMultiMetricMapPDF.h>  // This class is in [mrpt-slam]
+#include <mrpt/maps/CMetricMapSnapshot.h>  // This class is in [mrpt-slam]
 
 // Map Building algorithms:
 #include <mrpt/slam/CMetricMapBuilderICP.h>
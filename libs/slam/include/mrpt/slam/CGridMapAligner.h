@@ -135,6 +135,19 @@ class CGridMapAligner : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 		/** Maximum KL-divergence for merging modes of the SOG (default=0.9) */
 		double maxKLd_for_merge{0.9};
 
+		/** [amCorrelation method only] Step between the evaluated rotations
+		 * (rad) (default=1 deg). For each rotation, all the translations are
+		 * evaluated at once with a FFT-based cross-correlation of the grids. */
+		double correlation_phi_resolution{mrpt::DEG2RAD(1.0)};
+		/** [amCorrelation method only] Number of coarser levels (each one with
+		 * half the grid resolution and twice the rotation step) in a
+		 * coarse-to-fine search of the rotation. 0 (default) means evaluating
+		 * all the rotations at the full map resolution. */
+		unsigned int correlation_pyramid_levels{0};
+		/** [amCorrelation method only] Number of threads evaluating
+		 * rotations in parallel (default=0: all hardware threads) */
+		unsigned int correlation_num_threads{0};
+
 		/** DEBUG - Dump all feature correspondences in a directory "grid_feats"
 		 */
 		bool save_feat_coors{false};
@@ -221,7 +234,7 @@ class CGridMapAligner : public mrpt::slam::CMetricMapsAlignmentAlgorithm
 	 *
 	 * \note The returned PDF depends on the selected alignment method:
 	 *		- "amRobustMatch" --> A "poses::CPosePDFSOG" object.
-	 *		- "amCorrelation" --> A "poses::CPosePDFGrid" object.
+	 *		- "amCorrelation" --> A "poses::CPosePDFGaussian" object.
 	 *
 	 * \return A smart pointer to the output estimated pose PDF.
 	 * \sa CPointsMapAlignmentAlgorithm, options
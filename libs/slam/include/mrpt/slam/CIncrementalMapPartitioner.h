@@ -17,6 +17,7 @@
 #include <mrpt/maps/CMultiMetricMap.h>
 #include <mrpt/poses/poses_frwds.h>
 #include <mrpt/typemeta/TEnumType.h>
+#include <mrpt/graphs/CGraphPartitioner.h>
 #include <functional>
 #include <limits>
 
@@ -107,6 +108,13 @@ class CIncrementalMapPartitioner : public mrpt::system::COutputLogger,
 		uint64_t maxKeyFrameDistanceToEval{
 			std::numeric_limits<uint64_t>::max()};
 
+		/** If true (default), partitions are computed on a sparse graph
+		 * (only keyframes with a non-zero similarity are connected) with a
+		 * Lanczos solver warm-started from the previous call to
+		 * updatePartitions(). If false, the dense adjacency matrix and dense
+		 * eigen-decompositions are used instead. */
+		bool useSparseSolver{true};
+
 		TOptions();
 	};
 
@@ -183,15 +191,23 @@ class CIncrementalMapPartitioner : public mrpt::system::COutputLogger,
 		mrpt::opengl::CSetOfObjects::Ptr& objs,
 		const std::map<uint32_t, int64_t>* renameIndexes = nullptr) const;
 
-	/** Return a copy of the adjacency matrix.  */
+	/** Return a copy of the adjacency matrix.
+	 * \note Not thread-safe, even if const: the first call after adding new
+	 * keyframes rebuilds the internally cached dense matrix. */
 	template <class MATRIX>
 	void getAdjacencyMatrix(MATRIX& outMatrix) const
 	{
-		outMatrix = m_A;
+		outMatrix = denseAdjacency();
 	}
 
-	/** Return a const ref to the internal adjacency matrix.  */
-	const mrpt::math::CMatrixDouble& getAdjacencyMatrix() const { return m_A; }
+	/** Return a const ref to the internal adjacency matrix.
+	 * \note Not thread-safe, even if const: the first call after adding new
+	 * keyframes rebuilds the internally cached dense matrix, and the returned
+	 * reference is invalidated by any later change to the partitioner. */
+	const mrpt::math::CMatrixDouble& getAdjacencyMatrix() const
+	{
+		return denseAdjacency();
+	}
 
 	/** Read-only access to the sequence of Sensory Frames */
 	const mrpt::maps::CSimpleMap* getSequenceOfFrames() const
@@ -210,8 +226,24 @@ class CIncrementalMapPartitioner : public mrpt::system::COutputLogger,
 	mrpt::maps::CSimpleMap m_individualFrames;
 	std::deque<mrpt::maps::CMultiMetricMap::Ptr> m_individualMaps;
 
-	/** Adjacency matrix */
-	mrpt::math::CMatrixD m_A{0, 0};
+	/** The non-zero similarities between keyframes, as adjacency lists. This
+	 * is the actual storage of the graph: adding keyframes only appends to
+	 * it. */
+	mrpt::graphs::CGraphPartitioner<mrpt::math::CMatrixD>::sparse_adjacency_t
+		m_A_sparse;
+
+	/** Dense adjacency matrix, only built from m_A_sparse upon demand */
+	mutable mrpt::math::CMatrixD m_A{0, 0};
+	mutable bool m_A_outdated{false};
+	/** Returns m_A, updating it first if needed (not synchronized: callers
+	 * must not share a partitioner between threads without a lock) */
+	const mrpt::math::CMatrixD& denseAdjacency() const;
+
+	/** The Fiedler vector of the last partition, to warm-start the next one */
+	std::vector<double> m_last_fiedler;
+
+	/** Rebuilds m_A_sparse from m_A */
+	void rebuildSparseAdjacency();
 
 	/** The last partition */
 	std::vector<std::vector<uint32_t>> m_last_partition;
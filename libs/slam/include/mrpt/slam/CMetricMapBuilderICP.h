@@ -12,6 +12,12 @@
 #include <mrpt/slam/CICP.h>
 #include <mrpt/poses/CRobot2DPoseEstimator.h>
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace mrpt::slam
 {
 /** A class for very simple 2D SLAM based on ICP. This is a non-probabilistic
@@ -70,6 +76,15 @@ class CMetricMapBuilderICP : public mrpt::slam::CMetricMapBuilder
 		 * position (default: 0.40) */
 		double minICPgoodnessToAccept;
 
+		/** (default:false) Insert observations into the map from a
+		 * background thread, so processObservation() is not delayed by map
+		 * updates and KD-tree rebuilds. ICP then matches against the last
+		 * immutable copy of the map published by that thread after each
+		 * insertion, which may lag behind by the observation being inserted
+		 * and, at most, one more queued observation.
+		 * \sa waitForPendingMapUpdates */
+		bool asyncMapUpdate;
+
 		mrpt::system::VerbosityLevel& verbosity_level;
 
 		/** What maps to create (at least one points map and/or a grid map are
@@ -137,9 +152,16 @@ class CMetricMapBuilderICP : public mrpt::slam::CMetricMapBuilder
 	/** Returns the 2D points of current local map */
 	void getCurrentMapPoints(std::vector<float>& x, std::vector<float>& y);
 
+	/** \note With TConfigParams::asyncMapUpdate, call
+	 * waitForPendingMapUpdates() first, and do not use the map while
+	 * processing new observations. */
 	const mrpt::maps::CMultiMetricMap* getCurrentlyBuiltMetricMap()
 		const override;
 
+	/** With TConfigParams::asyncMapUpdate, blocks until all the observations
+	 * queued for insertion are already in the map. Does nothing otherwise. */
+	void waitForPendingMapUpdates();
+
 	/** Returns just how many sensory-frames are stored in the currently build
 	 * map */
 	unsigned int getCurrentlyBuiltMapSize() override;
@@ -192,6 +214,44 @@ class CMetricMapBuilderICP : public mrpt::slam::CMetricMapBuilder
 	void accumulateRobotDisplacementCounters(
 		const mrpt::poses::CPose2D& new_pose);
 	void resetRobotDisplacementCounters(const mrpt::poses::CPose2D& new_pose);
+
+	/** @name Asynchronous map updates (TConfigParams::asyncMapUpdate)
+		@{ */
+	struct TPendingInsertion
+	{
+		mrpt::obs::CObservation::Ptr obs;
+		mrpt::poses::CPose3D pose;
+	};
+	/** Observations waiting to be inserted by m_mapUpdateThread, protected
+	 * by m_pendingInsertions_mtx */
+	std::deque<TPendingInsertion> m_pendingInsertions;
+	/** processObservation() blocks while this many observations are already
+	 * queued, to bound how outdated the map used by ICP can be */
+	static constexpr size_t MAX_PENDING_INSERTIONS = 1;
+	/** Whether m_mapUpdateThread is inserting an observation */
+	bool m_mapUpdateBusy{false};
+	bool m_mapUpdateThreadExit{false};
+	std::mutex m_pendingInsertions_mtx;
+	std::condition_variable m_pendingInsertions_cv;
+	std::thread m_mapUpdateThread;
+	/** Held by m_mapUpdateThread while modifying metricMap */
+	std::mutex m_metricMap_mtx;
+	/** Immutable copy of the map to match against with ICP, with its KD-tree
+	 * already built. Replaced as a whole after each batch of insertions. */
+	std::shared_ptr<const mrpt::maps::CMetricMap> m_matchSnapshot;
+	mutable std::mutex m_matchSnapshot_mtx;
+
+	/** Inserts into metricMap, from either thread */
+	void insertObservationIntoMap(
+		const mrpt::obs::CObservation::Ptr& obs,
+		const mrpt::poses::CPose3D& pose);
+	void mapUpdateThread();
+	void stopMapUpdateThread();
+	/** Copies the map to match against into a new m_matchSnapshot */
+	void publishMatchSnapshot();
+	/** The map to match against with ICP: a member of metricMap */
+	mrpt::maps::CMetricMap* getMapToMatchAgainst();
+	/** @} */
 };
 
 }  // namespace mrpt::slam
@@ -213,6 +213,10 @@ class CRangeBearingKFSLAM
 		/** Only if data_assoc_IC_metric==ML, the log-ML threshold (Default=0.0)
 		 */
 		double data_assoc_IC_ml_threshold{0.0};
+		/** Number of threads for data association (0: all the hardware
+		 * threads). See mrpt::slam::data_association_full_covariance()
+		 * (Default=1) */
+		unsigned int data_assoc_num_threads{1};
 
 		/** Whether to fill m_SFs (default=false) */
 		bool create_simplemap{false};
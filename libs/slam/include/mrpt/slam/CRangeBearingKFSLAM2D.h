@@ -142,6 +142,10 @@ class CRangeBearingKFSLAM2D
 		/** Only if data_assoc_IC_metric==ML, the log-ML threshold (Default=0.0)
 		 */
 		double data_assoc_IC_ml_threshold{0.0};
+		/** Number of threads for data association (0: all the hardware
+		 * threads). See mrpt::slam::data_association_full_covariance()
+		 * (Default=1) */
+		unsigned int data_assoc_num_threads{1};
 	};
 
 	/** The options for the algorithm */
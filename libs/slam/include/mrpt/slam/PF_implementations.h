@@ -239,29 +239,54 @@ void PF_implementation<PARTICLE_TYPE, MYSELF, STORAGE>::
 			// -------------------------------------------------------------
 			// FIXED SAMPLE SIZE
 			// -------------------------------------------------------------
-			mrpt::poses::CPose3D incrPose;
-			for (size_t i = 0; i < M; i++)
+			if constexpr (
+				std::is_same_v<PARTICLE_TYPE, mrpt::math::TPose2D> &&
+				STORAGE == mrpt::bayes::particle_storage_mode::VALUE)
 			{
-				// Generate gaussian-distributed 2D-pose increments according to
-				// mean-cov:
-				m_movementDrawer.drawSample(incrPose);
-				bool pose_is_valid;
-				const mrpt::poses::CPose3D finalPose =
-					mrpt::poses::CPose3D(getLastPose(i, pose_is_valid)) +
-					incrPose;
-
-				// Update the particle with the new pose: this part is
-				// caller-dependant and must be implemented there:
-				if constexpr (
-					STORAGE == mrpt::bayes::particle_storage_mode::POINTER)
+				// 2D poses stored by value (e.g. CMonteCarloLocalization2D):
+				// draw all the increments and compose them at once, in a
+				// structure-of-arrays layout. Poses are still read and
+				// written through the caller-dependant methods.
+				m_movementDrawer.drawSamples(M, m_bulkIncrements);
+				m_bulkParticles.resize(M);
+				for (size_t i = 0; i < M; i++)
 				{
-					PF_SLAM_implementation_custom_update_particle_with_new_pose(
-						me->m_particles[i].d.get(), finalPose.asTPose());
+					bool pose_is_valid;
+					m_bulkParticles.setPose(
+						i, mrpt::math::TPose2D(getLastPose(i, pose_is_valid)));
 				}
-				else
-				{
+				m_bulkParticles.composeWith(m_bulkIncrements);
+				for (size_t i = 0; i < M; i++)
 					PF_SLAM_implementation_custom_update_particle_with_new_pose(
-						&me->m_particles[i].d, finalPose.asTPose());
+						&me->m_particles[i].d,
+						mrpt::math::TPose3D(m_bulkParticles.pose(i)));
+			}
+			else
+			{
+				mrpt::poses::CPose3D incrPose;
+				for (size_t i = 0; i < M; i++)
+				{
+					// Generate gaussian-distributed 2D-pose increments
+					// according to mean-cov:
+					m_movementDrawer.drawSample(incrPose);
+					bool pose_is_valid;
+					const mrpt::poses::CPose3D finalPose =
+						mrpt::poses::CPose3D(getLastPose(i, pose_is_valid)) +
+						incrPose;
+
+					// Update the particle with the new pose: this part is
+					// caller-dependant and must be implemented there:
+					if constexpr (
+						STORAGE == mrpt::bayes::particle_storage_mode::POINTER)
+					{
+						PF_SLAM_implementation_custom_update_particle_with_new_pose(
+							me->m_particles[i].d.get(), finalPose.asTPose());
+					}
+					else
+					{
+						PF_SLAM_implementation_custom_update_particle_with_new_pose(
+							&me->m_particles[i].d, finalPose.asTPose());
+					}
 				}
 			}
 		}
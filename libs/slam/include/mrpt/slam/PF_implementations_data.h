@@ -15,6 +15,7 @@
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/poses/CPose3DPDFGaussian.h>
 #include <mrpt/poses/CPoseRandomSampler.h>
+#include <mrpt/poses/TPose2DParticlesSoA.h>
 #include <mrpt/slam/TKLDParams.h>
 #include <mrpt/system/COutputLogger.h>
 
@@ -51,6 +52,9 @@ class PF_implementation : public mrpt::system::COutputLogger
 	/** Used in al PF implementations. \sa
 	 * PF_SLAM_implementation_gatherActionsCheckBothActObs */
 	mrpt::poses::CPoseRandomSampler m_movementDrawer;
+	/** Auxiliary variables for the bulk prediction of 2D particles in
+	 * "pfStandardProposal" */
+	mrpt::poses::TPose2DParticlesSoA m_bulkParticles, m_bulkIncrements;
 	/** Auxiliary variable used in the "pfAuxiliaryPFOptimal" algorithm. */
 	mutable mrpt::math::CVectorDouble m_pfAuxiliaryPFOptimal_estimatedProb;
 	/** Auxiliary variable used in the "pfAuxiliaryPFStandard" algorithm. */
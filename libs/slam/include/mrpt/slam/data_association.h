@@ -78,6 +78,8 @@ struct TDataAssociationResults
 		indiv_compatibility.setSize(0, 0);
 		indiv_compatibility_counts.clear();
 		nNodesExploredInJCBB = 0;
+		nIndivCompatEvaluated = 0;
+		nJointCompatEvaluated = 0;
 	}
 
 	/** For each observation (with row index IDX_obs in the input
@@ -115,6 +117,14 @@ struct TDataAssociationResults
 	/** Only for the JCBB method,the number of recursive calls expent in the
 	 * algorithm. */
 	size_t nNodesExploredInJCBB{0};
+	/** Number of prediction/observation pairs whose individual distance was
+	 * actually evaluated, i.e. those not discarded by the KD-tree gating (if
+	 * enabled). Out of a maximum of "nPredictions x nObservations". */
+	size_t nIndivCompatEvaluated{0};
+	/** Only for the JCBB method, the number of evaluations of the joint
+	 * distance of a whole set of pairings (one per visited leaf of the search
+	 * tree which is at least as good as the best one so far). */
+	size_t nJointCompatEvaluated{0};
 };
 
 /** Computes the data-association between the prediction of a set of landmarks
@@ -145,11 +155,17 @@ struct TDataAssociationResults
  *between two close Gaussians for two landmarks, in the range [0,1]. It is used
  *to call mrpt::math::chi2inv
  * \param use_kd_tree [IN, optional] Build a KD-tree to speed-up the evaluation
- *of individual compatibility (IC). It's perhaps more efficient to disable it
- *for a small number of features. (default=true).
+ *of individual compatibility (IC). Only the predictions within an Euclidean
+ *radius which is guaranteed to contain all the compatible ones (from the
+ *largest eigenvalue of each prediction covariance) are evaluated. It's perhaps
+ *more efficient to disable it for a small number of features. (default=true).
  * \param predictions_IDs [IN, optional] (default:none) An N-vector. If
  *provided, the resulting associations in "results.associations" will not
  *contain prediction indices "i", but "predictions_IDs[i]".
+ * \param num_threads [IN, optional] Number of threads for the individual
+ *compatibility test and the JCBB search, whose subtrees are explored in
+ *parallel sharing the best bound found so far (0: all the hardware threads).
+ *Results do not depend on the number of threads. (default=1)
  *
  * \sa data_association_independent_predictions,
  *data_association_independent_2d_points,
@@ -166,7 +182,8 @@ void data_association_full_covariance(
 	const std::vector<prediction_index_t>& predictions_IDs =
 		std::vector<prediction_index_t>(),
 	const TDataAssociationMetric compatibilityTestMetric = metricMaha,
-	const double log_ML_compat_test_threshold = 0.0);
+	const double log_ML_compat_test_threshold = 0.0,
+	const unsigned int num_threads = 1);
 
 /** Computes the data-association between the prediction of a set of landmarks
  *and their observations, all of them with covariance matrices - Generic
@@ -196,11 +213,17 @@ void data_association_full_covariance(
  *between two close Gaussians for two landmarks, in the range [0,1]. It is used
  *to call mrpt::math::chi2inv
  * \param use_kd_tree [IN, optional] Build a KD-tree to speed-up the evaluation
- *of individual compatibility (IC). It's perhaps more efficient to disable it
- *for a small number of features. (default=true).
+ *of individual compatibility (IC). Only the predictions within an Euclidean
+ *radius which is guaranteed to contain all the compatible ones (from the
+ *largest eigenvalue of each prediction covariance) are evaluated. It's perhaps
+ *more efficient to disable it for a small number of features. (default=true).
  * \param predictions_IDs [IN, optional] (default:none) An N-vector. If
  *provided, the resulting associations in "results.associations" will not
  *contain prediction indices "i", but "predictions_IDs[i]".
+ * \param num_threads [IN, optional] Number of threads for the individual
+ *compatibility test and the JCBB search, whose subtrees are explored in
+ *parallel sharing the best bound found so far (0: all the hardware threads).
+ *Results do not depend on the number of threads. (default=1)
  *
  * \sa data_association_full_covariance,
  *data_association_independent_2d_points,
@@ -217,7 +240,8 @@ void data_association_independent_predictions(
 	const std::vector<prediction_index_t>& predictions_IDs =
 		std::vector<prediction_index_t>(),
 	const TDataAssociationMetric compatibilityTestMetric = metricMaha,
-	const double log_ML_compat_test_threshold = 0.0);
+	const double log_ML_compat_test_threshold = 0.0,
+	const unsigned int num_threads = 1);
 
 /** @} */
 
@@ -0,0 +1,388 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "slam-precomp.h"  // Precompiled headers
+
+#include <mrpt/maps/CMetricMapSnapshot.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace mrpt::maps;
+
+namespace
+{
+constexpr uint64_t SNAPSHOT_MAGIC = 0x4d5250544d534e50ULL;  // "MRPTMSNP"
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+// Sections start at page boundaries, and arrays within them at cache lines:
+constexpr uint64_t SECTION_ALIGN = 4096, ARRAY_ALIGN = 64;
+
+enum TSectionType : uint32_t
+{
+	SECTION_SERIALIZED = 0,
+	SECTION_POINTS = 1,
+	SECTION_GRID = 2
+};
+
+struct TSectionEntry
+{
+	uint32_t type, reserved;
+	uint64_t offset, length;
+};
+
+/** Closes the file when going out of scope */
+struct FileCloser
+{
+	void operator()(FILE* f) const { std::fclose(f); }
+};
+using file_ptr_t = std::unique_ptr<FILE, FileCloser>;
+
+// 64-bit file positions (files may be larger than 2GB):
+uint64_t tell(FILE* f)
+{
+#ifdef _MSC_VER
+	const int64_t pos = _ftelli64(f);
+#else
+	const int64_t pos = ftello(f);
+#endif
+	if (pos < 0) THROW_EXCEPTION("Error getting the file position");
+	return static_cast<uint64_t>(pos);
+}
+
+void seek(FILE* f, const uint64_t pos)
+{
+#ifdef _MSC_VER
+	const int ret = _fseeki64(f, static_cast<int64_t>(pos), SEEK_SET);
+#else
+	const int ret = fseeko(f, static_cast<off_t>(pos), SEEK_SET);
+#endif
+	if (ret != 0) THROW_EXCEPTION("Error seeking in the file");
+}
+
+void writeRaw(FILE* f, const void* data, const size_t len)
+{
+	if (len && std::fwrite(data, 1, len, f) != len)
+		THROW_EXCEPTION("Error writing the snapshot file");
+}
+
+void readRaw(FILE* f, void* data, const size_t len)
+{
+	if (len && std::fread(data, 1, len, f) != len)
+		THROW_EXCEPTION("Error reading the snapshot file");
+}
+
+template <typename T>
+void writeValue(FILE* f, const T& v)
+{
+	writeRaw(f, &v, sizeof(v));
+}
+
+template <typename T>
+T readValue(FILE* f)
+{
+	T v;
+	readRaw(f, &v, sizeof(v));
+	return v;
+}
+
+/** Writes zeros up to the next multiple of `align` */
+void writePadding(FILE* f, const uint64_t align)
+{
+	static const char zeros[SECTION_ALIGN] = {0};
+	const uint64_t pos = tell(f);
+	writeRaw(f, zeros, static_cast<size_t>((align - pos % align) % align));
+}
+
+/** Skips the padding written by writePadding() */
+void skipPadding(FILE* f, const uint64_t align)
+{
+	const uint64_t pos = tell(f);
+	seek(f, pos + (align - pos % align) % align);
+}
+
+/** Writes an object with CArchive, preceded by its length in bytes */
+void writeSerialized(FILE* f, const mrpt::serialization::CSerializable& o)
+{
+	mrpt::io::CMemoryStream buf;
+	mrpt::serialization::archiveFrom(buf) << o;
+	const uint64_t len = buf.getTotalBytesCount();
+	writeValue(f, len);
+	writeRaw(f, buf.getRawBufferData(), static_cast<size_t>(len));
+}
+
+/** Reads the data written by writeSerialized() into `buf` */
+void readSerialized(FILE* f, mrpt::io::CMemoryStream& buf)
+{
+	const auto len = readValue<uint64_t>(f);
+	buf.Clear();
+	buf.changeSize(len);
+	readRaw(f, buf.getRawBufferData(), static_cast<size_t>(len));
+	buf.Seek(0);
+}
+
+template <typename T>
+void writeArray(FILE* f, const T* data, const size_t n)
+{
+	writePadding(f, ARRAY_ALIGN);
+	writeRaw(f, data, n * sizeof(T));
+}
+
+template <typename T>
+void readArray(FILE* f, T* data, const size_t n)
+{
+	skipPadding(f, ARRAY_ALIGN);
+	readRaw(f, data, n * sizeof(T));
+}
+}  // namespace
+
+/*---------------------------------------------------------------
+							save
+ ---------------------------------------------------------------*/
+void CMetricMapSnapshot::save(
+	const CMultiMetricMap& m, const std::string& fileName)
+{
+	MRPT_START
+
+	file_ptr_t f(std::fopen(fileName.c_str(), "wb"));
+	if (!f) THROW_EXCEPTION_FMT("Cannot create file `%s`", fileName.c_str());
+
+	// The table of sections is written at the end, once it is known:
+	const auto nSections = static_cast<uint32_t>(m.maps.size());
+	std::vector<TSectionEntry> sections(nSections);
+	const auto writeHeader = [&]() {
+		writeValue(f.get(), SNAPSHOT_MAGIC);
+		writeValue(f.get(), SNAPSHOT_VERSION);
+		writeValue(f.get(), BYTE_ORDER_MARK);
+		writeValue(f.get(), static_cast<uint32_t>(sizeof(size_t)));
+		writeValue(f.get(), nSections);
+		writeRaw(
+			f.get(), sections.data(), sections.size() * sizeof(sections[0]));
+	};
+	writeHeader();
+
+	for (uint32_t i = 0; i < nSections; i++)
+	{
+		const CMetricMap* map = m.maps[i].get();
+		ASSERT_(map);
+		writePadding(f.get(), SECTION_ALIGN);
+		auto& s = sections[i];
+		s.offset = tell(f.get());
+		s.reserved = 0;
+		if (IS_CLASS(map, CSimplePointsMap))
+		{
+			s.type = SECTION_POINTS;
+			savePointsMap(*static_cast<const CSimplePointsMap*>(map), f.get());
+		}
+		else if (IS_CLASS(map, COccupancyGridMap2D))
+		{
+			s.type = SECTION_GRID;
+			saveGridMap(*static_cast<const COccupancyGridMap2D*>(map), f.get());
+		}
+		else
+		{
+			s.type = SECTION_SERIALIZED;
+			writeSerialized(f.get(), *map);
+		}
+		s.length = tell(f.get()) - s.offset;
+	}
+
+	seek(f.get(), 0);
+	writeHeader();
+	if (std::fclose(f.release()) != 0)
+		THROW_EXCEPTION_FMT("Error writing file `%s`", fileName.c_str());
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+							load
+ ---------------------------------------------------------------*/
+void CMetricMapSnapshot::load(const std::string& fileName, CMultiMetricMap& m)
+{
+	MRPT_START
+
+	file_ptr_t f(std::fopen(fileName.c_str(), "rb"));
+	if (!f) THROW_EXCEPTION_FMT("Cannot open file `%s`", fileName.c_str());
+
+	if (readValue<uint64_t>(f.get()) != SNAPSHOT_MAGIC)
+		THROW_EXCEPTION_FMT(
+			"File `%s` is not a metric map snapshot", fileName.c_str());
+	const auto version = readValue<uint32_t>(f.get());
+	if (version != SNAPSHOT_VERSION)
+		THROW_EXCEPTION_FMT(
+			"Unsupported snapshot version %u in `%s`",
+			static_cast<unsigned>(version), fileName.c_str());
+	if (readValue<uint32_t>(f.get()) != BYTE_ORDER_MARK ||
+		readValue<uint32_t>(f.get()) != sizeof(size_t))
+		THROW_EXCEPTION_FMT(
+			"Snapshot `%s` was created in an incompatible platform",
+			fileName.c_str());
+
+	const auto nSections = readValue<uint32_t>(f.get());
+	std::vector<TSectionEntry> sections(nSections);
+	readRaw(f.get(), sections.data(), sections.size() * sizeof(sections[0]));
+
+	CMultiMetricMap::TListMaps maps;
+	for (const auto& s : sections)
+	{
+		seek(f.get(), s.offset);
+		switch (s.type)
+		{
+			case SECTION_POINTS:
+			{
+				auto pts = CSimplePointsMap::Create();
+				loadPointsMap(*pts, f.get());
+				maps.emplace_back(pts);
+			}
+			break;
+			case SECTION_GRID:
+			{
+				auto grid = COccupancyGridMap2D::Create();
+				loadGridMap(*grid, f.get());
+				maps.emplace_back(grid);
+			}
+			break;
+			case SECTION_SERIALIZED:
+			{
+				mrpt::io::CMemoryStream buf;
+				readSerialized(f.get(), buf);
+				auto arch = mrpt::serialization::archiveFrom(buf);
+				maps.emplace_back(arch.ReadObject<CMetricMap>());
+			}
+			break;
+			default:
+				THROW_EXCEPTION_FMT(
+					"Unknown section type %u in `%s`",
+					static_cast<unsigned>(s.type), fileName.c_str());
+		};
+		if (tell(f.get()) != s.offset + s.length)
+			THROW_EXCEPTION_FMT(
+				"Corrupted section in snapshot `%s`", fileName.c_str());
+	}
+
+	m.maps = std::move(maps);
+
+	MRPT_END
+}
+
+bool CMetricMapSnapshot::isSnapshotFile(const std::string& fileName)
+{
+	file_ptr_t f(std::fopen(fileName.c_str(), "rb"));
+	uint64_t magic;
+	return f && std::fread(&magic, sizeof(magic), 1, f.get()) == 1 &&
+		   magic == SNAPSHOT_MAGIC;
+}
+
+/*---------------------------------------------------------------
+						Points maps
+ ---------------------------------------------------------------*/
+void CMetricMapSnapshot::savePointsMap(const CSimplePointsMap& m, FILE* f)
+{
+	// Options, as an empty map:
+	CSimplePointsMap opts;
+	opts.genericMapParams = m.genericMapParams;
+	opts.insertionOptions = m.insertionOptions;
+	opts.likelihoodOptions = m.likelihoodOptions;
+	opts.renderOptions = m.renderOptions;
+	writeSerialized(f, opts);
+
+	const uint64_t N = m.size();
+	writeValue(f, N);
+	writeArray(f, m.m_x.data(), N);
+	writeArray(f, m.m_y.data(), N);
+	writeArray(f, m.m_z.data(), N);
+
+	writePadding(f, ARRAY_ALIGN);
+	m.kdTreeSaveIndex3D(f);
+}
+
+void CMetricMapSnapshot::loadPointsMap(CSimplePointsMap& m, FILE* f)
+{
+	{
+		mrpt::io::CMemoryStream buf;
+		readSerialized(f, buf);
+		mrpt::serialization::archiveFrom(buf) >> m;
+	}
+
+	const auto N = static_cast<size_t>(readValue<uint64_t>(f));
+	m.resize(N);
+	readArray(f, m.m_x.data(), N);
+	readArray(f, m.m_y.data(), N);
+	readArray(f, m.m_z.data(), N);
+	m.mark_as_modified();
+
+	// After setting all the points, so the KD-tree is not marked as outdated:
+	skipPadding(f, ARRAY_ALIGN);
+	m.kdTreeLoadIndex3D(f);
+}
+
+/*---------------------------------------------------------------
+						Occupancy grids
+ ---------------------------------------------------------------*/
+void CMetricMapSnapshot::saveGridMap(const COccupancyGridMap2D& m, FILE* f)
+{
+	// Options, as a grid with a single cell:
+	COccupancyGridMap2D opts(0, m.resolution, 0, m.resolution, m.resolution);
+	opts.genericMapParams = m.genericMapParams;
+	opts.insertionOptions = m.insertionOptions;
+	opts.likelihoodOptions = m.likelihoodOptions;
+	writeSerialized(f, opts);
+
+	writeValue(f, m.size_x);
+	writeValue(f, m.size_y);
+	writeValue(f, m.x_min);
+	writeValue(f, m.x_max);
+	writeValue(f, m.y_min);
+	writeValue(f, m.y_max);
+	writeValue(f, m.resolution);
+	writeValue(f, static_cast<uint32_t>(sizeof(COccupancyGridMap2D::cellType)));
+	writeArray(f, m.map.data(), m.map.size());
+
+	// The likelihood field cache, if it is up to date:
+	const size_t nLik = m.precomputedLikelihoodToBeRecomputed
+							? 0
+							: m.precomputedLikelihood.size();
+	writeValue(f, static_cast<uint64_t>(nLik));
+	writeArray(f, m.precomputedLikelihood.data(), nLik);
+}
+
+void CMetricMapSnapshot::loadGridMap(COccupancyGridMap2D& m, FILE* f)
+{
+	{
+		mrpt::io::CMemoryStream buf;
+		readSerialized(f, buf);
+		mrpt::serialization::archiveFrom(buf) >> m;
+	}
+
+	const auto size_x = readValue<uint32_t>(f);
+	const auto size_y = readValue<uint32_t>(f);
+	const auto x_min = readValue<float>(f), x_max = readValue<float>(f);
+	const auto y_min = readValue<float>(f), y_max = readValue<float>(f);
+	const auto resolution = readValue<float>(f);
+	if (readValue<uint32_t>(f) != sizeof(COccupancyGridMap2D::cellType))
+		THROW_EXCEPTION("The snapshot uses a different grid cell size");
+
+	m.setSize(x_min, x_max, y_min, y_max, resolution);
+	ASSERT_(m.size_x == size_x && m.size_y == size_y);
+	readArray(f, m.map.data(), m.map.size());
+
+	const auto nLik = static_cast<size_t>(readValue<uint64_t>(f));
+	if (nLik)
+	{
+		ASSERT_EQUAL_(nLik, m.map.size());
+		m.precomputedLikelihood.resize(nLik);
+		readArray(f, m.precomputedLikelihood.data(), nLik);
+		m.precomputedLikelihoodToBeRecomputed = false;
+	}
+	else
+		skipPadding(f, ARRAY_ALIGN);
+}
@@ -0,0 +1,74 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/maps/CMetricMapSnapshot.h>
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/system/filesystem.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt::maps;
+
+TEST(CMetricMapSnapshot, saveAndLoad)
+{
+	auto& rng = mrpt::random::getRandomGenerator();
+	rng.randomize(123);
+
+	CMultiMetricMap m;
+	auto pts = CSimplePointsMap::Create();
+	for (int i = 0; i < 1000; i++)
+		pts->insertPoint(
+			rng.drawUniform(-10, 10), rng.drawUniform(-10, 10),
+			rng.drawUniform(0, 2));
+	pts->insertionOptions.minDistBetweenLaserPoints = 0.123f;
+	auto grid = COccupancyGridMap2D::Create(-5, 5, -3, 3, 0.1f);
+	for (int i = 0; i < 100; i++)
+		grid->setCell(rng.drawUniform32bit() % 100, i % 60, 0.1f);
+	grid->likelihoodOptions.LF_stdHit = 0.42f;
+	auto beacons = CBeaconMap::Create();
+	m.maps.emplace_back(pts);
+	m.maps.emplace_back(grid);
+	m.maps.emplace_back(beacons);
+
+	const std::string fil =
+		mrpt::system::getTempFileName() + std::string(".mapsnapshot");
+	CMetricMapSnapshot::save(m, fil);
+	EXPECT_TRUE(CMetricMapSnapshot::isSnapshotFile(fil));
+
+	CMultiMetricMap m2;
+	CMetricMapSnapshot::load(fil, m2);
+	mrpt::system::deleteFile(fil);
+
+	ASSERT_EQ(m2.maps.size(), 3U);
+	ASSERT_EQ(m2.m_pointsMaps.size(), 1U);
+	ASSERT_EQ(m2.m_gridMaps.size(), 1U);
+	EXPECT_TRUE(IS_CLASS(m2.maps[2].get(), CBeaconMap));
+
+	// Points and their (restored) KD-tree:
+	const auto pts2 = m2.m_pointsMaps[0];
+	ASSERT_EQ(pts2->size(), pts->size());
+	EXPECT_EQ(pts2->getPointsBufferRef_x(), pts->getPointsBufferRef_x());
+	EXPECT_EQ(pts2->getPointsBufferRef_z(), pts->getPointsBufferRef_z());
+	EXPECT_FLOAT_EQ(pts2->insertionOptions.minDistBetweenLaserPoints, 0.123f);
+	for (int i = 0; i < 20; i++)
+	{
+		const float x = rng.drawUniform(-10, 10), y = rng.drawUniform(-10, 10);
+		float d1, d2;
+		EXPECT_EQ(
+			pts->kdTreeClosestPoint3D(x, y, 1.0f, d1),
+			pts2->kdTreeClosestPoint3D(x, y, 1.0f, d2));
+		EXPECT_FLOAT_EQ(d1, d2);
+	}
+
+	// Grid cells:
+	const auto grid2 = m2.m_gridMaps[0];
+	ASSERT_EQ(grid2->getSizeX(), grid->getSizeX());
+	ASSERT_EQ(grid2->getSizeY(), grid->getSizeY());
+	EXPECT_EQ(grid2->getRawMap(), grid->getRawMap());
+	EXPECT_FLOAT_EQ(grid2->likelihoodOptions.LF_stdHit, 0.42f);
+}
@@ -25,6 +25,7 @@
 #include <mrpt/slam/CICP.h>
 #include <mrpt/maps/CLandmarksMap.h>
 #include <mrpt/tfest/se2.h>
+#include "grid_correlation.h"
 
 using namespace mrpt::math;
 using namespace mrpt::slam;
@@ -403,6 +404,7 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF_robustMatch(
 				tfest_params.probability_find_good_model =
 					options.ransac_prob_good_inliers;
 				tfest_params.verbose = false;
+				tfest_params.num_threads = 0;  // 0=all cores
 
 				mrpt::tfest::TSE2RobustResult tfest_result;
 				mrpt::tfest::se2_l2_robust(
@@ -1004,143 +1006,79 @@ CPosePDF::Ptr CGridMapAligner::AlignPDF_correlation(
 	void* info)
 {
 	MRPT_UNUSED_PARAM(initialEstimationPDF);
-	MRPT_UNUSED_PARAM(info);
 
 	MRPT_START
 
-	//#define	CORRELATION_SHOW_DEBUG
-
-	CTicTac* tictac = nullptr;
+	CTicTac tictac;
+	tictac.Tic();
 
 	// Asserts:
 	// -----------------
-	ASSERT_(mm1->GetRuntimeClass() == CLASS_ID(COccupancyGridMap2D));
-	ASSERT_(mm2->GetRuntimeClass() == CLASS_ID(COccupancyGridMap2D));
-	const auto* m1 = static_cast<const COccupancyGridMap2D*>(mm1);
-	const auto* m2 = static_cast<const COccupancyGridMap2D*>(mm2);
-
-	ASSERT_(m1->getResolution() == m2->getResolution());
-
-	if (runningTime)
+	const COccupancyGridMap2D* m1 = nullptr;
+	const COccupancyGridMap2D* m2 = nullptr;
+	if (IS_CLASS(mm1, CMultiMetricMap) && IS_CLASS(mm2, CMultiMetricMap))
 	{
-		tictac = new CTicTac();
-		tictac->Tic();
+		const auto* multimap1 = static_cast<const CMultiMetricMap*>(mm1);
+		const auto* multimap2 = static_cast<const CMultiMetricMap*>(mm2);
+		ASSERT_(multimap1->m_gridMaps.size() && multimap1->m_gridMaps[0]);
+		ASSERT_(multimap2->m_gridMaps.size() && multimap2->m_gridMaps[0]);
+		m1 = multimap1->m_gridMaps[0].get();
+		m2 = multimap2->m_gridMaps[0].get();
 	}
-
-	// The PDF to estimate:
-	// ------------------------------------------------------
-	CPosePDFGaussian::Ptr PDF = mrpt::make_aligned_shared<CPosePDFGaussian>();
-
-	// Determine the extension to compute the correlation into:
-	// ----------------------------------------------------------
-	float phiResolution = DEG2RAD(0.2f);
-	float phiMin = -M_PIf + 0.5f * phiResolution;
-	float phiMax = M_PIf;
-
-	// Compute the difference between maps for each (u,v) pair!
-	// --------------------------------------------------------------
-	float phi;
-	float pivotPt_x = 0.5f * (m1->getXMax() + m1->getXMin());
-	float pivotPt_y = 0.5f * (m1->getYMax() + m1->getYMin());
-	COccupancyGridMap2D map2_mod;
-	CImage map1_img, map2_img;
-	float currentMaxCorr = -1e6f;
-
-	m1->getAsImage(map1_img);
-
-	map2_mod.setSize(
-		m1->getXMin(), m1->getXMax(), m1->getYMin(), m1->getYMax(),
-		m1->getResolution());
-	size_t map2_lx = map2_mod.getSizeX();
-	size_t map2_ly = map2_mod.getSizeY();
-	CMatrix outCrossCorr, bestCrossCorr;
-	float map2width_2 = 0.5f * (map2_mod.getXMax() - map2_mod.getXMin());
-
-#ifdef CORRELATION_SHOW_DEBUG
-	CDisplayWindow* win = new CDisplayWindow("corr");
-	CDisplayWindow* win2 = new CDisplayWindow("map2_mod");
-#endif
-
-	// --------------------------------------------------------
-	// Use FFT-based correlation for each orientation:
-	// --------------------------------------------------------
-	for (phi = phiMin; phi < phiMax; phi += phiResolution)
+	else if (
+		IS_CLASS(mm1, COccupancyGridMap2D) &&
+		IS_CLASS(mm2, COccupancyGridMap2D))
 	{
-		// Create the displaced map2 grid, for the size of map1:
-		// --------------------------------------------------------
-		CPose2D v2(
-			pivotPt_x - cos(phi) * map2width_2,
-			pivotPt_y - sin(phi) * map2width_2,
-			phi);  // Rotation point: the centre of img1:
-		CPoint2D v1, v3;
-		v2 = CPose2D(0, 0, 0) - v2;  // Inverse
-
-		for (unsigned int cy2 = 0; cy2 < map2_ly; cy2++)
-		{
-			COccupancyGridMap2D::cellType* row = map2_mod.getRow(cy2);
-			for (unsigned int cx2 = 0; cx2 < map2_lx; cx2++)
-			{
-				v3 = v2 + CPoint2D(map2_mod.idx2x(cx2), map2_mod.idx2y(cy2));
-				*row++ = m2->p2l(m2->getPos(v3.x(), v3.y()));
-			}
-		}
-
-		map2_mod.getAsImage(map2_img);
-		//		map2_img.saveToBMP("__debug_map2mod.bmp");
-
-		// Compute the correlation:
-		map1_img.cross_correlation_FFT(
-			map2_img, outCrossCorr, -1, -1, -1, -1,
-			127,  // Bias to be substracted
-			127  // Bias to be substracted
-		);
-
-		float corrPeak = outCrossCorr.maxCoeff();
-		printf("phi = %fdeg \tmax corr=%f\n", RAD2DEG(phi), corrPeak);
-
-		// Keep the maximum:
-		if (corrPeak > currentMaxCorr)
-		{
-			currentMaxCorr = corrPeak;
-			bestCrossCorr = outCrossCorr;
-			PDF->mean.phi(phi);
-		}
+		m1 = static_cast<const COccupancyGridMap2D*>(mm1);
+		m2 = static_cast<const COccupancyGridMap2D*>(mm2);
+	}
+	else
+		THROW_EXCEPTION(
+			"Metric maps must be of classes COccupancyGridMap2D or "
+			"CMultiMetricMap")
 
-#ifdef CORRELATION_SHOW_DEBUG
-		outCrossCorr.adjustRange(0, 1);
-		CImage aux(outCrossCorr, true);
-		win->showImage(aux);
-		win2->showImage(map2_img);
-		std::this_thread::sleep_for(5ms);
-#endif
+	ASSERT_(m1->getResolution() == m2->getResolution());
 
-	}  // end for phi
+	// Grids with zero mean for unknown cells: occupied cells correlate
+	// positively with occupied ones, and negatively with free ones.
+	auto toCorrelationGrid = [](const COccupancyGridMap2D& m) {
+		internal::TCorrelationGrid g;
+		g.resolution = m.getResolution();
+		g.x0 = m.idx2x(0);
+		g.y0 = m.idx2y(0);
+		g.cells.setSize(m.getSizeY(), m.getSizeX());
+		for (unsigned int cy = 0; cy < m.getSizeY(); cy++)
+			for (unsigned int cx = 0; cx < m.getSizeX(); cx++)
+				g.cells.get_unsafe(cy, cx) = 0.5f - m.getCell(cx, cy);
+		return g;
+	};
+
+	internal::TGridCorrelationOptions corrOpts;
+	corrOpts.phi_resolution = options.correlation_phi_resolution;
+	corrOpts.pyramid_levels = options.correlation_pyramid_levels;
+	corrOpts.num_threads = options.correlation_num_threads;
+
+	const internal::TGridCorrelationResult res = internal::correlate_grids(
+		toCorrelationGrid(*m1), toCorrelationGrid(*m2), corrOpts);
+
+	// The PDF: the uncertainty is that of the quantization of the search
+	CPosePDFGaussian::Ptr PDF = mrpt::make_aligned_shared<CPosePDFGaussian>();
+	PDF->mean = CPose2D(res.pose);
+	PDF->cov.setZero();
+	PDF->cov(0, 0) = PDF->cov(1, 1) = square(m1->getResolution());
+	PDF->cov(2, 2) = square(options.correlation_phi_resolution);
 
-	if (runningTime)
+	if (info)
 	{
-		*runningTime = tictac->Tac();
-		delete tictac;
+		auto* outInfo = static_cast<TReturnInfo*>(info);
+		outInfo->goodness = static_cast<float>(res.goodness);
+		outInfo->noRobustEstimation = PDF->mean;
 	}
 
-	bestCrossCorr.normalize(0, 1);
-	CImage aux(bestCrossCorr, true);
-	aux.saveToFile("_debug_best_corr.png");
-
-#ifdef CORRELATION_SHOW_DEBUG
-	delete win;
-	delete win2;
-#endif
-
-	// Transform the best corr matrix peak into coordinates:
-	CMatrix::Index uMax, vMax;
-	currentMaxCorr = bestCrossCorr.maxCoeff(&uMax, &vMax);
-
-	PDF->mean.x(m1->idx2x(uMax));
-	PDF->mean.y(m1->idx2y(vMax));
+	if (runningTime) *runningTime = tictac.Tac();
 
 	return PDF;
 
-	// Done!
 	MRPT_END
 }
 
@@ -1172,6 +1110,9 @@ void CGridMapAligner::TConfigParams::dumpToTextStream(std::ostream& out) const
 	LOADABLEOPTS_DUMP_VAR(save_feat_coors, bool)
 	LOADABLEOPTS_DUMP_VAR(debug_show_corrs, bool)
 	LOADABLEOPTS_DUMP_VAR(debug_save_map_pairs, bool)
+	LOADABLEOPTS_DUMP_VAR_DEG(correlation_phi_resolution)
+	LOADABLEOPTS_DUMP_VAR(correlation_pyramid_levels, int)
+	LOADABLEOPTS_DUMP_VAR(correlation_num_threads, int)
 
 	LOADABLEOPTS_DUMP_VAR(feature_descriptor, int)
 
@@ -1213,6 +1154,10 @@ void CGridMapAligner::TConfigParams::loadFromConfigFile(
 	MRPT_LOAD_CONFIG_VAR(debug_show_corrs, bool, iniFile, section)
 	MRPT_LOAD_CONFIG_VAR(debug_save_map_pairs, bool, iniFile, section)
 
+	MRPT_LOAD_CONFIG_VAR_DEGREES(correlation_phi_resolution, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(correlation_pyramid_levels, int, iniFile, section)
+	MRPT_LOAD_CONFIG_VAR(correlation_num_threads, int, iniFile, section)
+
 	feature_descriptor = iniFile.read_enum(
 		section, "feature_descriptor", feature_descriptor, true);
 	feature_detector_options.loadFromConfigFile(iniFile, section);
@@ -0,0 +1,85 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/slam/CGridMapAligner.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/math/wrap2pi.h>
+#include <mrpt/poses/CPoint2D.h>
+#include <mrpt/poses/CPosePDFGaussian.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::slam;
+using namespace mrpt::maps;
+using namespace mrpt::poses;
+using namespace std;
+
+namespace
+{
+// A room with a few inner walls: free inside, unknown outside.
+void buildRoom(COccupancyGridMap2D& m)
+{
+	m.setSize(-8, 8, -6, 6, 0.1f);
+	auto isWall = [](double x, double y) {
+		const auto near = [](double a, double b) {
+			return std::abs(a - b) < 0.1;
+		};
+		return ((near(x, -6) || near(x, 6)) && std::abs(y) <= 4) ||
+			   ((near(y, -4) || near(y, 4)) && std::abs(x) <= 6) ||
+			   (near(x, -2) && y > -4 && y < 1) ||
+			   (near(y, 1.5) && x > 1 && x < 6) ||
+			   (near(x, 3) && y > -4 && y < -1.5);
+	};
+	for (unsigned int cy = 0; cy < m.getSizeY(); cy++)
+		for (unsigned int cx = 0; cx < m.getSizeX(); cx++)
+		{
+			const double x = m.idx2x(cx), y = m.idx2y(cy);
+			if (isWall(x, y))
+				m.setCell(cx, cy, 0.0f);
+			else if (std::abs(x) < 6 && std::abs(y) < 4)
+				m.setCell(cx, cy, 1.0f);
+		}
+}
+}  // namespace
+
+TEST(CGridMapAligner, CorrelationFindsRelativePose)
+{
+	COccupancyGridMap2D m1, m2;
+	buildRoom(m1);
+
+	// m2: the same room, seen from `gt` (i.e. m2 is at `gt` wrt m1)
+	const CPose2D gt(1.2, -0.7, DEG2RAD(35.0));
+	m2.setSize(-7, 7, -7, 7, 0.1f);
+	for (unsigned int cy = 0; cy < m2.getSizeY(); cy++)
+		for (unsigned int cx = 0; cx < m2.getSizeX(); cx++)
+		{
+			const CPoint2D p = gt + CPoint2D(m2.idx2x(cx), m2.idx2y(cy));
+			m2.setCell(cx, cy, m1.getPos(p.x(), p.y()));
+		}
+
+	for (unsigned int levels = 0; levels <= 2; levels += 2)
+	{
+		CGridMapAligner gma;
+		gma.options.methodSelection = CGridMapAligner::amCorrelation;
+		gma.options.correlation_pyramid_levels = levels;
+		gma.options.correlation_num_threads = 2;
+
+		CGridMapAligner::TReturnInfo info;
+		const CPosePDF::Ptr pdf =
+			gma.AlignPDF(&m1, &m2, CPosePDFGaussian(), nullptr, &info);
+		const CPose2D est = pdf->getMeanVal();
+
+		EXPECT_NEAR(est.x(), gt.x(), 0.1) << "levels=" << levels;
+		EXPECT_NEAR(est.y(), gt.y(), 0.1) << "levels=" << levels;
+		EXPECT_NEAR(
+			mrpt::math::wrapToPi(est.phi() - gt.phi()), 0, DEG2RAD(1.0))
+			<< "levels=" << levels;
+		EXPECT_GT(info.goodness, 0.3f);
+	}
+}
@@ -72,6 +72,7 @@ void CIncrementalMapPartitioner::TOptions::loadFromConfigFile(
 		"minMahaDistForCorrespondence", double, mrp.maxMahaDistForCorr, source,
 		section);
 	MRPT_LOAD_CONFIG_VAR(maxKeyFrameDistanceToEval, uint64_t, source, section);
+	MRPT_LOAD_CONFIG_VAR(useSparseSolver, bool, source, section);
 
 	mrpt::config::CConfigFilePrefixer cfp(
 		source, section + std::string("."), "");
@@ -94,6 +95,8 @@ void CIncrementalMapPartitioner::TOptions::saveToConfigFile(
 	MRPT_SAVE_CONFIG_VAR_COMMENT(minimumNumberElementsEachCluster, "");
 	MRPT_SAVE_CONFIG_VAR_COMMENT(
 		maxKeyFrameDistanceToEval, "Max KF ID distance");
+	MRPT_SAVE_CONFIG_VAR_COMMENT(
+		useSparseSolver, "Use the sparse (Lanczos) N-cut solver");
 	c.write(
 		s, "minDistForCorrespondence", mrp.maxDistForCorr,
 		mrpt::config::MRPT_SAVE_NAME_PADDING(),
@@ -111,6 +114,9 @@ void CIncrementalMapPartitioner::clear()
 {
 	m_last_last_partition_are_new_ones = false;
 	m_A.setSize(0, 0);
+	m_A_outdated = false;
+	m_A_sparse.clear();
+	m_last_fiedler.clear();
 	m_individualFrames.clear();  // Free the map...
 	m_individualMaps.clear();
 	m_last_partition.clear();  // Delete last partitions
@@ -136,8 +142,9 @@ uint32_t CIncrementalMapPartitioner::addMapFrame(
 	// Add tuple (pose,SF) to "simplemap":
 	m_individualFrames.insert(&robotPose, frame);
 
-	// Expand the adjacency matrix (pads with 0)
-	m_A.setSize(n, n);
+	// Expand the adjacency lists (the dense matrix is built upon demand)
+	m_A_sparse.resize(n);
+	m_A_outdated = true;
 
 	ASSERT_(m_individualMaps.size() == n);
 	ASSERT_(m_individualFrames.size() == n);
@@ -175,38 +182,38 @@ uint32_t CIncrementalMapPartitioner::addMapFrame(
 		m_individualFrames.get(i, posePDF_i, map_i.raw_observations);
 		auto pose_i = posePDF_i->getMeanVal();
 
-		for (uint32_t j = 0; j < new_id; j++)
+		// Keyframes farther than maxKeyFrameDistanceToEval are not
+		// evaluated, and keep a zero similarity:
+		const uint32_t first_j =
+			new_id > options.maxKeyFrameDistanceToEval
+				? static_cast<uint32_t>(
+					  new_id - options.maxKeyFrameDistanceToEval)
+				: 0;
+		for (uint32_t j = first_j; j < new_id; j++)
 		{
-			const auto id_diff = new_id - j;
-			double s_sym;
-			if (id_diff > options.maxKeyFrameDistanceToEval)
-			{
-				// skip evaluation
-				s_sym = .0;
-			}
-			else
+			// KF "j":
+			map_keyframe_t map_j;
+			CPose3DPDF::Ptr posePDF_j;
+			map_j.kf_id = j;
+			m_individualFrames.get(j, posePDF_j, map_j.raw_observations);
+			auto pose_j = posePDF_j->getMeanVal();
+			map_j.metric_map = m_individualMaps[j];
+
+			auto relPose = pose_j - pose_i;
+
+			// Evaluate similarity metric & make it symetric:
+			const auto s_ij = sim_func(map_i, map_j, relPose);
+			const auto s_ji = sim_func(map_j, map_i, relPose);
+			const double s_sym = 0.5 * (s_ij + s_ji);
+			if (s_sym != 0)
 			{
-				// KF "j":
-				map_keyframe_t map_j;
-				CPose3DPDF::Ptr posePDF_j;
-				map_j.kf_id = j;
-				m_individualFrames.get(j, posePDF_j, map_j.raw_observations);
-				auto pose_j = posePDF_j->getMeanVal();
-				map_j.metric_map = m_individualMaps[j];
-
-				auto relPose = pose_j - pose_i;
-
-				// Evaluate similarity metric & make it symetric:
-				const auto s_ij = sim_func(map_i, map_j, relPose);
-				const auto s_ji = sim_func(map_j, map_i, relPose);
-				s_sym = 0.5 * (s_ij + s_ji);
+				m_A_sparse[i].emplace_back(j, s_sym);
+				m_A_sparse[j].emplace_back(i, s_sym);
 			}
-			m_A(i, j) = m_A(j, i) = s_sym;
 		}  // for j
 	}  // i=n-1=new_id
 
 	// Self-similatity: Not used
-	m_A(new_id, new_id) = 0;
 
 	// If a partition has been already computed, add these new keyframes
 	// into a new partition on its own. When the user calls updatePartitions()
@@ -239,11 +246,28 @@ void CIncrementalMapPartitioner::updatePartitions(
 	MRPT_START
 
 	partitions.clear();
-	CGraphPartitioner<CMatrixD>::RecursiveSpectralPartition(
-		m_A, partitions, options.partitionThreshold, true, true,
-		!options.forceBisectionOnly, options.minimumNumberElementsEachCluster,
-		false /* verbose */
-	);
+	if (options.useSparseSolver)
+	{
+		// Warm-start from the last solution. New nodes start at zero, and
+		// are quickly pulled towards the side of their neighbors:
+		m_last_fiedler.resize(m_A_sparse.size(), 0);
+		CGraphPartitioner<CMatrixD>::RecursiveSpectralPartition(
+			m_A_sparse, partitions, options.partitionThreshold,
+			!options.forceBisectionOnly,
+			options.minimumNumberElementsEachCluster, &m_last_fiedler,
+			false /* verbose */
+		);
+	}
+	else
+	{
+		// The solver may modify its input:
+		CMatrixD A = denseAdjacency();
+		CGraphPartitioner<CMatrixD>::RecursiveSpectralPartition(
+			A, partitions, options.partitionThreshold, true, true,
+			!options.forceBisectionOnly,
+			options.minimumNumberElementsEachCluster, false /* verbose */
+		);
+	}
 
 	m_last_partition = partitions;
 	m_last_last_partition_are_new_ones = false;
@@ -261,7 +285,7 @@ void CIncrementalMapPartitioner::removeSetOfNodes(
 {
 	MRPT_START
 
-	size_t nOld = m_A.cols();
+	size_t nOld = m_A_sparse.size();
 	size_t nNew = nOld - indexesToRemove.size();
 	size_t i, j;
 
@@ -286,15 +310,21 @@ void CIncrementalMapPartitioner::removeSetOfNodes(
 
 	ASSERT_(indexesToStay.size() == nNew);
 
-	// Update the A matrix:
+	// Update the adjacency lists:
 	// ---------------------------------------------------
-	CMatrixDouble newA(nNew, nNew);
+	std::vector<int64_t> newIndex(nOld, -1);
+	for (i = 0; i < nNew; i++) newIndex[indexesToStay[i]] = i;
+	decltype(m_A_sparse) newA(nNew);
 	for (i = 0; i < nNew; i++)
-		for (j = 0; j < nNew; j++)
-			newA(i, j) = m_A(indexesToStay[i], indexesToStay[j]);
+		for (const auto& e : m_A_sparse[indexesToStay[i]])
+			if (newIndex[e.first] >= 0)
+				newA[i].emplace_back(
+					static_cast<uint32_t>(newIndex[e.first]), e.second);
 
 	// Substitute "A":
-	m_A = newA;
+	m_A_sparse = std::move(newA);
+	m_A_outdated = true;
+	m_last_fiedler.clear();
 
 	// The last partitioning is all the nodes together:
 	// --------------------------------------------------
@@ -335,6 +365,29 @@ void CIncrementalMapPartitioner::removeSetOfNodes(
 	MRPT_END
 }
 
+const CMatrixD& CIncrementalMapPartitioner::denseAdjacency() const
+{
+	if (m_A_outdated)
+	{
+		const size_t n = m_A_sparse.size();
+		m_A.setZero(n, n);
+		for (size_t i = 0; i < n; i++)
+			for (const auto& e : m_A_sparse[i]) m_A(i, e.first) = e.second;
+		m_A_outdated = false;
+	}
+	return m_A;
+}
+
+void CIncrementalMapPartitioner::rebuildSparseAdjacency()
+{
+	const size_t n = m_A.cols();
+	m_A_sparse.assign(n, {});
+	for (size_t i = 0; i < n; i++)
+		for (size_t j = 0; j < n; j++)
+			if (i != j && m_A(i, j) != 0)
+				m_A_sparse[i].emplace_back(j, m_A(i, j));
+}
+
 void CIncrementalMapPartitioner::changeCoordinatesOrigin(
 	const CPose3D& newOrigin)
 {
@@ -362,7 +415,8 @@ void CIncrementalMapPartitioner::getAs3DScene(
 	const std::map<uint32_t, int64_t>* renameIndexes) const
 {
 	objs->clear();
-	ASSERT_((int)m_individualFrames.size() == m_A.cols());
+	const auto& A = denseAdjacency();
+	ASSERT_((int)m_individualFrames.size() == A.cols());
 
 	auto gl_grid = opengl::CGridPlaneXY::Create();
 	objs->insert(gl_grid);
@@ -414,7 +468,7 @@ void CIncrementalMapPartitioner::getAs3DScene(
 			CPose3D j_mean;
 			j_pdf->getMean(j_mean);
 
-			float SSO_ij = m_A(i, j);
+			float SSO_ij = A(i, j);
 
 			if (SSO_ij > 0.01)
 			{
@@ -451,6 +505,9 @@ void CIncrementalMapPartitioner::serializeFrom(
 				std::vector<uint8_t> old_modified_nodes;
 				in >> old_modified_nodes;
 			}
+			m_A_outdated = false;
+			rebuildSparseAdjacency();
+			m_last_fiedler.clear();
 		}
 		break;
 		default:
@@ -462,6 +519,6 @@ uint8_t CIncrementalMapPartitioner::serializeGetVersion() const { return 1; }
 void CIncrementalMapPartitioner::serializeTo(
 	mrpt::serialization::CArchive& out) const
 {
-	out << m_individualFrames << m_individualMaps << m_A << m_last_partition
-		<< m_last_last_partition_are_new_ones;
+	out << m_individualFrames << m_individualMaps << denseAdjacency()
+		<< m_last_partition << m_last_last_partition_are_new_ones;
 }
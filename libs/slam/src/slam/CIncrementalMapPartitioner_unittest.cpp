@@ -8,7 +8,10 @@
    +------------------------------------------------------------------------+ */
 
 #include <mrpt/slam/CIncrementalMapPartitioner.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/poses/CPose3DPDFGaussian.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 
 using namespace mrpt;
 using namespace mrpt::slam;
@@ -22,3 +25,45 @@ extern std::string MRPT_GLOBAL_UNITTEST_SRC_DIR;
 
 // TEST =================
 TEST(CIncrementalMapPartitioner, test_dataset) { MRPT_TODO("Write me"); }
+
+TEST(CIncrementalMapPartitioner, two_clusters_and_remove_nodes)
+{
+	// Two groups of 4 keyframes, strongly connected within each group:
+	CIncrementalMapPartitioner imp;
+	imp.setSimilarityMethod([](const map_keyframe_t& kf1,
+							   const map_keyframe_t& kf2,
+							   const mrpt::poses::CPose3D&) {
+		return (kf1.kf_id < 4) == (kf2.kf_id < 4) ? 1.0 : 0.01;
+	});
+	const mrpt::obs::CSensoryFrame sf;
+	for (int i = 0; i < 8; i++)
+		imp.addMapFrame(
+			sf, mrpt::poses::CPose3DPDFGaussian(
+					mrpt::poses::CPose3D(i, 0, 0, 0, 0, 0)));
+
+	const auto& A = imp.getAdjacencyMatrix();
+	ASSERT_EQ(A.rows(), 8);
+	EXPECT_EQ(A(0, 0), 0.0);
+	EXPECT_EQ(A(0, 3), 1.0);
+	EXPECT_EQ(A(3, 0), 1.0);
+	EXPECT_EQ(A(2, 6), 0.01);
+
+	std::vector<std::vector<uint32_t>> parts;
+	imp.updatePartitions(parts);
+	ASSERT_EQ(parts.size(), 2U);
+	for (auto& p : parts)
+	{
+		ASSERT_EQ(p.size(), 4U);
+		std::sort(p.begin(), p.end());
+		EXPECT_EQ(p.back() - p.front(), 3U);
+	}
+
+	// Remove the first keyframe: the rest are renumbered.
+	imp.removeSetOfNodes({0}, false);
+	EXPECT_EQ(imp.getNodesCount(), 7U);
+	const auto& A2 = imp.getAdjacencyMatrix();
+	ASSERT_EQ(A2.rows(), 7);
+	EXPECT_EQ(A2(0, 2), 1.0);
+	EXPECT_EQ(A2(2, 3), 0.01);
+	EXPECT_EQ(A2(3, 6), 1.0);
+}
@@ -43,6 +43,9 @@ CMetricMapBuilderICP::~CMetricMapBuilderICP()
 	enterCriticalSection();
 	leaveCriticalSection();
 
+	// Finish pending insertions, if any:
+	stopMapUpdateThread();
+
 	// Save current map to current file:
 	setCurrentMapFile("");
 }
@@ -58,6 +61,7 @@ CMetricMapBuilderICP::TConfigParams::TConfigParams(
 	  localizationLinDistance(0.20),
 	  localizationAngDistance(DEG2RAD(30)),
 	  minICPgoodnessToAccept(0.40),
+	  asyncMapUpdate(false),
 	  verbosity_level(parent_verbosity_level),
 	  mapInitializers()
 {
@@ -72,6 +76,7 @@ CMetricMapBuilderICP::TConfigParams& CMetricMapBuilderICP::TConfigParams::
 	localizationLinDistance = other.localizationLinDistance;
 	localizationAngDistance = other.localizationAngDistance;
 	minICPgoodnessToAccept = other.minICPgoodnessToAccept;
+	asyncMapUpdate = other.asyncMapUpdate;
 	//	We can't copy a reference type
 	//	verbosity_level         = other.verbosity_level;
 	mapInitializers = other.mapInitializers;
@@ -90,6 +95,7 @@ void CMetricMapBuilderICP::TConfigParams::loadFromConfigFile(
 		section, "verbosity_level", verbosity_level);
 
 	MRPT_LOAD_CONFIG_VAR(minICPgoodnessToAccept, double, source, section)
+	MRPT_LOAD_CONFIG_VAR(asyncMapUpdate, bool, source, section)
 
 	mapInitializers.loadFromConfigFile(source, section);
 }
@@ -113,6 +119,9 @@ void CMetricMapBuilderICP::TConfigParams::dumpToTextStream(
 	out << mrpt::format(
 		"localizationAngDistance                 = %f deg\n",
 		RAD2DEG(localizationAngDistance));
+	out << mrpt::format(
+		"asyncMapUpdate                          = %s\n",
+		asyncMapUpdate ? "YES" : "NO");
 	out << mrpt::format(
 		"verbosity_level                         = %s\n",
 		mrpt::typemeta::TEnumType<mrpt::system::VerbosityLevel>::value2name(
@@ -235,22 +244,28 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 		bool can_do_icp = false;
 
 		// Select the map to match with ....
-		CMetricMap* matchWith = nullptr;
-		if (ICP_options.matchAgainstTheGrid && !metricMap.m_gridMaps.empty())
+		// With asynchronous map updates, the map itself may be being
+		// modified: use the last published copy instead.
+		std::shared_ptr<const CMetricMap> matchSnapshot;
+		const CMetricMap* matchWith = nullptr;
+		if (ICP_options.asyncMapUpdate)
 		{
-			matchWith = static_cast<CMetricMap*>(metricMap.m_gridMaps[0].get());
-			MRPT_LOG_DEBUG("processObservation(): matching against gridmap.");
+			std::unique_lock<std::mutex> lck(m_matchSnapshot_mtx);
+			if (!m_matchSnapshot)
+			{
+				lck.unlock();
+				publishMatchSnapshot();
+				lck.lock();
+			}
+			matchSnapshot = m_matchSnapshot;
+			matchWith = matchSnapshot.get();
 		}
 		else
-		{
-			ASSERTMSG_(
-				metricMap.m_pointsMaps.size(),
-				"No points map in multi-metric map.");
-			matchWith =
-				static_cast<CMetricMap*>(metricMap.m_pointsMaps[0].get());
-			MRPT_LOG_DEBUG("processObservation(): matching against point map.");
-		}
+			matchWith = getMapToMatchAgainst();
 		ASSERT_(matchWith != nullptr);
+		MRPT_LOG_DEBUG_STREAM(
+			"processObservation(): matching against "
+			<< matchWith->GetRuntimeClass()->className);
 
 		if (!we_skip_ICP_pose_correction)
 		{
@@ -269,19 +284,29 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 			// Create points representation of the observation:
 			// Insert only those planar range scans in the altitude of the grid
 			// map:
-			if (ICP_options.matchAgainstTheGrid &&
-				!metricMap.m_gridMaps.empty() &&
-				metricMap.m_gridMaps[0]->insertionOptions.useMapAltitude)
+			// (The map may be being modified by the map update thread)
+			bool useGridAltitude = false;
+			double gridAltitude = 0;
+			if (ICP_options.matchAgainstTheGrid)
+			{
+				std::lock_guard<std::mutex> lck(m_metricMap_mtx);
+				if (!metricMap.m_gridMaps.empty() &&
+					metricMap.m_gridMaps[0]->insertionOptions.useMapAltitude)
+				{
+					useGridAltitude = true;
+					gridAltitude =
+						metricMap.m_gridMaps[0]->insertionOptions.mapAltitude;
+				}
+			}
+			if (useGridAltitude)
 			{
 				// Use grid altitude:
 				if (IS_CLASS(obs, CObservation2DRangeScan))
 				{
 					CObservation2DRangeScan::Ptr obsLaser =
 						std::dynamic_pointer_cast<CObservation2DRangeScan>(obs);
-					if (std::abs(
-							metricMap.m_gridMaps[0]
-								->insertionOptions.mapAltitude -
-							obsLaser->sensorPose.z()) < 0.01)
+					if (std::abs(gridAltitude - obsLaser->sensorPose.z()) <
+						0.01)
 						can_do_icp = sensedPoints.insertObservationPtr(obs);
 				}
 			}
@@ -292,7 +317,7 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 			}
 
 			if (IS_DERIVED(matchWith, CPointsMap) &&
-				static_cast<CPointsMap*>(matchWith)->empty())
+				static_cast<const CPointsMap*>(matchWith)->empty())
 				can_do_icp = false;  // The reference map is empty!
 
 			if (can_do_icp)
@@ -422,13 +447,25 @@ void CMetricMapBuilderICP::processObservation(const CObservation::Ptr& obs)
 				currentKnownRobotPose.asString().c_str()));
 
 			CPose3D estimatedPose3D(currentKnownRobotPose);
-			const bool anymap_update =
-				metricMap.insertObservationPtr(obs, &estimatedPose3D);
-			if (!anymap_update)
-				MRPT_LOG_WARN_STREAM(
-					"**No map was updated** after inserting an observation of "
-					"type `"
-					<< obs->GetRuntimeClass()->className << "`");
+			if (ICP_options.asyncMapUpdate)
+			{
+				// Leave it to the map update thread:
+				{
+					std::unique_lock<std::mutex> lck(m_pendingInsertions_mtx);
+					if (!m_mapUpdateThread.joinable())
+						m_mapUpdateThread = std::thread(
+							&CMetricMapBuilderICP::mapUpdateThread, this);
+					// Do not let ICP fall too much behind the map:
+					m_pendingInsertions_cv.wait(lck, [this]() {
+						return m_pendingInsertions.size() <
+							   MAX_PENDING_INSERTIONS;
+					});
+					m_pendingInsertions.push_back({obs, estimatedPose3D});
+				}
+				m_pendingInsertions_cv.notify_all();
+			}
+			else
+				insertObservationIntoMap(obs, estimatedPose3D);
 
 			// Add to the vector of "poses"-"SFs" pairs:
 			CPosePDFGaussian posePDF(currentKnownRobotPose);
@@ -522,6 +559,9 @@ void CMetricMapBuilderICP::initialize(
 {
 	MRPT_START
 
+	// The map is about to be rebuilt:
+	waitForPendingMapUpdates();
+
 	// Reset vars:
 	m_estRobotPath.clear();
 	m_auxAccumOdometry = CPose2D(0, 0, 0);
@@ -534,6 +574,12 @@ void CMetricMapBuilderICP::initialize(
 	// Init path & map:
 	std::lock_guard<std::mutex> lock_cs(critZoneChangingMap);
 
+	std::lock_guard<std::mutex> lock_map(m_metricMap_mtx);
+	{
+		std::lock_guard<std::mutex> lck(m_matchSnapshot_mtx);
+		m_matchSnapshot.reset();
+	}
+
 	// Create metric maps:
 	metricMap.setListOfMaps(&ICP_options.mapInitializers);
 
@@ -591,13 +637,11 @@ void CMetricMapBuilderICP::getCurrentMapPoints(
 	std::vector<float>& x, std::vector<float>& y)
 {
 	// Critical section: We are using our global metric map
-	enterCriticalSection();
+	std::lock_guard<std::mutex> lock_cs(critZoneChangingMap);
+	std::lock_guard<std::mutex> lock_map(m_metricMap_mtx);
 
 	ASSERT_(metricMap.m_pointsMaps.size() > 0);
 	metricMap.m_pointsMaps[0]->getAllPoints(x, y);
-
-	// Exit critical zone.
-	leaveCriticalSection();
 }
 
 /*---------------------------------------------------------------
@@ -632,6 +676,7 @@ void CMetricMapBuilderICP::saveCurrentEstimationToImage(
 	CImage img;
 	const size_t nPoses = m_estRobotPath.size();
 
+	std::lock_guard<std::mutex> lock_map(m_metricMap_mtx);
 	ASSERT_(metricMap.m_gridMaps.size() > 0);
 
 	if (!formatEMF_BMP) THROW_EXCEPTION("Not implemented yet for BMP!");
@@ -703,3 +748,109 @@ void CMetricMapBuilderICP::TDist::updatePose(const mrpt::poses::CPose2D& p)
 	lin = 0;
 	ang = 0;
 }
+
+CMetricMap* CMetricMapBuilderICP::getMapToMatchAgainst()
+{
+	if (ICP_options.matchAgainstTheGrid && !metricMap.m_gridMaps.empty())
+		return metricMap.m_gridMaps[0].get();
+	ASSERTMSG_(
+		metricMap.m_pointsMaps.size(), "No points map in multi-metric map.");
+	return metricMap.m_pointsMaps[0].get();
+}
+
+void CMetricMapBuilderICP::insertObservationIntoMap(
+	const CObservation::Ptr& obs, const CPose3D& pose)
+{
+	bool anymap_update;
+	{
+		std::lock_guard<std::mutex> lck(m_metricMap_mtx);
+		anymap_update = metricMap.insertObservationPtr(obs, &pose);
+	}
+	if (!anymap_update)
+		MRPT_LOG_WARN_STREAM(
+			"**No map was updated** after inserting an observation of "
+			"type `"
+			<< obs->GetRuntimeClass()->className << "`");
+}
+
+void CMetricMapBuilderICP::publishMatchSnapshot()
+{
+	std::shared_ptr<CMetricMap> snap;
+	{
+		std::lock_guard<std::mutex> lck(m_metricMap_mtx);
+		snap = std::dynamic_pointer_cast<CMetricMap>(
+			getMapToMatchAgainst()->duplicateGetSmartPtr());
+	}
+	ASSERT_(snap);
+
+	// Build the KD-tree now, instead of upon the first ICP query:
+	const auto* pts = dynamic_cast<const CPointsMap*>(snap.get());
+	if (pts && !pts->empty()) pts->kdTreeClosestPoint2DsqrError(0, 0);
+
+	std::lock_guard<std::mutex> lck(m_matchSnapshot_mtx);
+	m_matchSnapshot = std::move(snap);
+}
+
+void CMetricMapBuilderICP::mapUpdateThread()
+{
+	for (;;)
+	{
+		TPendingInsertion ins;
+		{
+			std::unique_lock<std::mutex> lck(m_pendingInsertions_mtx);
+			m_pendingInsertions_cv.wait(lck, [this]() {
+				return m_mapUpdateThreadExit || !m_pendingInsertions.empty();
+			});
+			// Only exit once all pending insertions are done:
+			if (m_pendingInsertions.empty()) return;
+			ins = std::move(m_pendingInsertions.front());
+			m_pendingInsertions.pop_front();
+			m_mapUpdateBusy = true;
+		}
+
+		try
+		{
+			CTicTac tictac;
+			insertObservationIntoMap(ins.obs, ins.pose);
+
+			// Publish the new version of the map for ICP:
+			publishMatchSnapshot();
+
+			MRPT_LOG_DEBUG_STREAM(
+				"mapUpdateThread(): map updated in "
+				<< mrpt::system::formatTimeInterval(tictac.Tac()));
+		}
+		catch (const std::exception& e)
+		{
+			MRPT_LOG_ERROR_STREAM(
+				"mapUpdateThread(): exception inserting observation:\n"
+				<< e.what());
+		}
+
+		{
+			std::lock_guard<std::mutex> lck(m_pendingInsertions_mtx);
+			m_mapUpdateBusy = false;
+		}
+		m_pendingInsertions_cv.notify_all();
+	}
+}
+
+void CMetricMapBuilderICP::stopMapUpdateThread()
+{
+	if (!m_mapUpdateThread.joinable()) return;
+	{
+		std::lock_guard<std::mutex> lck(m_pendingInsertions_mtx);
+		m_mapUpdateThreadExit = true;
+	}
+	m_pendingInsertions_cv.notify_all();
+	m_mapUpdateThread.join();
+	m_mapUpdateThreadExit = false;
+}
+
+void CMetricMapBuilderICP::waitForPendingMapUpdates()
+{
+	std::unique_lock<std::mutex> lck(m_pendingInsertions_mtx);
+	m_pendingInsertions_cv.wait(lck, [this]() {
+		return m_pendingInsertions.empty() && !m_mapUpdateBusy;
+	});
+}
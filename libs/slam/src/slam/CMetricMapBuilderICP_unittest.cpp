@@ -0,0 +1,175 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/slam/CMetricMapBuilderICP.h>
+#include <mrpt/config/CConfigFile.h>
+#include <mrpt/maps/CMultiMetricMap.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/math/wrap2pi.h>
+#include <mrpt/obs/CRawlog.h>
+#include <mrpt/poses/CPose3DPDF.h>
+#include <mrpt/system/filesystem.h>
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace mrpt;
+using namespace mrpt::slam;
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace std;
+
+// Defined in tests/test_main.cpp
+namespace mrpt
+{
+extern std::string MRPT_GLOBAL_UNITTEST_SRC_DIR;
+}
+
+// Only the beginning of the dataset, to keep the tests short:
+static const size_t NUM_STEPS = 100;
+
+// Runs ICP-SLAM on the beginning of a dataset, with and without
+// asynchronous map updates.
+class ICPSlamAsyncTests : public ::testing::Test
+{
+   protected:
+	void SetUp() override
+	{
+		const string ini_fil =
+			MRPT_GLOBAL_UNITTEST_SRC_DIR +
+			"/share/mrpt/config_files/icp-slam/icp-slam_demo_classic.ini";
+		const string rawlog_fil = MRPT_GLOBAL_UNITTEST_SRC_DIR +
+								  "/share/mrpt/datasets/2006-01ENE-21-SENA_"
+								  "Telecom Faculty_one_loop_only.rawlog";
+		if (!mrpt::system::fileExists(ini_fil) ||
+			!mrpt::system::fileExists(rawlog_fil))
+		{
+			cerr << "WARNING: Skipping test due to missing files: " << ini_fil
+				 << ", " << rawlog_fil << "\n";
+			return;
+		}
+		m_ini.setFileName(ini_fil);
+		m_rawlog.loadFromRawLogFile(rawlog_fil);
+	}
+
+	std::unique_ptr<CMetricMapBuilderICP> createBuilder(bool async)
+	{
+		auto mapBuilder = std::make_unique<CMetricMapBuilderICP>();
+		mapBuilder->ICP_options.loadFromConfigFile(m_ini, "MappingApplication");
+		mapBuilder->ICP_params.loadFromConfigFile(m_ini, "ICP");
+		mapBuilder->ICP_options.asyncMapUpdate = async;
+		mapBuilder->setVerbosityLevel(mrpt::system::LVL_ERROR);
+		mapBuilder->initialize();
+		return mapBuilder;
+	}
+
+	/** Feeds the action/observation pairs of the rawlog, from `rawlogEntry`
+	 * on, up to a total of NUM_STEPS */
+	void processRawlog(
+		CMetricMapBuilderICP& mapBuilder, bool waitAtEachStep,
+		size_t& rawlogEntry)
+	{
+		CActionCollection::Ptr action;
+		CSensoryFrame::Ptr observations;
+		for (size_t step = 0; step < NUM_STEPS &&
+							  m_rawlog.getActionObservationPair(
+								  action, observations, rawlogEntry);
+			 step++)
+		{
+			mapBuilder.processActionObservation(*action, *observations);
+			if (waitAtEachStep) mapBuilder.waitForPendingMapUpdates();
+		}
+	}
+
+	static size_t mapPointCount(const CMetricMapBuilderICP& mapBuilder)
+	{
+		return mapBuilder.getCurrentlyBuiltMetricMap()->m_pointsMaps[0]->size();
+	}
+
+	mrpt::config::CConfigFile m_ini;
+	CRawlog m_rawlog;
+};
+
+TEST_F(ICPSlamAsyncTests, sameResultWhenWaitingAtEachStep)
+{
+	if (!m_rawlog.size()) return;
+
+	size_t e1 = 0, e2 = 0;
+	auto syncBuilder = createBuilder(false);
+	processRawlog(*syncBuilder, false, e1);
+	auto asyncBuilder = createBuilder(true);
+	processRawlog(*asyncBuilder, true, e2);
+
+	// ICP matched against an up-to-date copy of the map at every step:
+	const CPose3D pSync = syncBuilder->getCurrentPoseEstimation()->getMeanVal();
+	const CPose3D pAsync =
+		asyncBuilder->getCurrentPoseEstimation()->getMeanVal();
+	EXPECT_NEAR(pSync.distanceTo(pAsync), 0.0, 1e-3);
+	EXPECT_NEAR(pSync.yaw(), pAsync.yaw(), 1e-4);
+	EXPECT_EQ(
+		syncBuilder->getCurrentlyBuiltMapSize(),
+		asyncBuilder->getCurrentlyBuiltMapSize());
+	EXPECT_EQ(mapPointCount(*syncBuilder), mapPointCount(*asyncBuilder));
+}
+
+TEST_F(ICPSlamAsyncTests, similarResultWithoutWaiting)
+{
+	if (!m_rawlog.size()) return;
+
+	size_t e1 = 0, e2 = 0;
+	auto syncBuilder = createBuilder(false);
+	processRawlog(*syncBuilder, false, e1);
+	auto asyncBuilder = createBuilder(true);
+	processRawlog(*asyncBuilder, false, e2);
+	asyncBuilder->waitForPendingMapUpdates();
+
+	// ICP may have matched against a map lagging behind by a bounded number
+	// of observations, but the trajectory must remain consistent:
+	const CPose3D pSync = syncBuilder->getCurrentPoseEstimation()->getMeanVal();
+	const CPose3D pAsync =
+		asyncBuilder->getCurrentPoseEstimation()->getMeanVal();
+	EXPECT_LT(pSync.distanceTo(pAsync), 0.25);
+	EXPECT_LT(
+		std::abs(mrpt::math::wrapToPi(pSync.yaw() - pAsync.yaw())),
+		mrpt::DEG2RAD(5.0));
+
+	const double nSync = mapPointCount(*syncBuilder);
+	const double nAsync = mapPointCount(*asyncBuilder);
+	EXPECT_GT(nAsync, 0);
+	EXPECT_NEAR(nSync, nAsync, 0.1 * nSync);
+}
+
+TEST_F(ICPSlamAsyncTests, waitAndDestroyWithPendingUpdates)
+{
+	if (!m_rawlog.size()) return;
+
+	size_t entry = 0;
+	auto asyncBuilder = createBuilder(true);
+
+	// Waiting right after feeding observations must leave all of them in the
+	// map. Nothing is pending afterwards, so waiting again must not block:
+	processRawlog(*asyncBuilder, false, entry);
+	asyncBuilder->waitForPendingMapUpdates();
+	EXPECT_GT(asyncBuilder->getCurrentlyBuiltMapSize(), 0U);
+	EXPECT_GT(mapPointCount(*asyncBuilder), 0U);
+	asyncBuilder->waitForPendingMapUpdates();
+
+	// Re-initializing also waits for the map update thread:
+	entry = 0;
+	processRawlog(*asyncBuilder, false, entry);
+	asyncBuilder->initialize();
+	EXPECT_EQ(asyncBuilder->getCurrentlyBuiltMapSize(), 0U);
+	EXPECT_EQ(mapPointCount(*asyncBuilder), 0U);
+
+	// Destroying the builder right after feeding observations must finish
+	// (or discard) the queued insertions without crashing or hanging:
+	entry = 0;
+	processRawlog(*asyncBuilder, false, entry);
+	asyncBuilder.reset();
+}
@@ -268,8 +268,10 @@ void CMetricMapBuilderRBPF::processActionObservation(
 	// Added 29/JUN/2007 JLBC: Tell all maps that they can now free aux.
 	// variables
 	//  (if any) since one PF cycle is over:
+	//  (this only frees cached data, so there is no need to unshare maps)
 	for (auto& m_particle : mapPDF.m_particles)
-		m_particle.d->mapTillNow.auxParticleFilterCleanUp();
+		const_cast<CMultiMetricMap&>(m_particle.d->mapTillNow())
+			.auxParticleFilterCleanUp();
 
 	MRPT_END;
 }
@@ -87,7 +87,7 @@ void CMultiMetricMapPDF::clear(const CPose3D& initialPose)
 	{
 		m_particles[i].log_w = 0;
 
-		m_particles[i].d->mapTillNow.clear();
+		m_particles[i].d->mapTillNowForWriting().clear();
 
 		m_particles[i].d->robotPath.resize(1);
 		m_particles[i].d->robotPath[0] = initialPose.asTPose();
@@ -115,7 +115,7 @@ void CMultiMetricMapPDF::clear(
 		auto& p = m_particles[idxPart];
 		p.log_w = 0;
 
-		p.d->mapTillNow.clear();
+		p.d->mapTillNowForWriting().clear();
 
 		p.d->robotPath.resize(nOldKeyframes);
 		for (size_t i = 0; i < nOldKeyframes; i++)
@@ -148,7 +148,8 @@ void CMultiMetricMapPDF::clear(
 			p.d->robotPath[i] = kf_pose.asTPose();
 			for (const auto& obs : *sfkeyframe_sf)
 			{
-				p.d->mapTillNow.insertObservation(&(*obs), &kf_pose);
+				p.d->mapTillNowForWriting().insertObservation(
+					&(*obs), &kf_pose);
 			}
 		}
 	}
@@ -212,7 +213,7 @@ void CMultiMetricMapPDF::serializeTo(mrpt::serialization::CArchive& out) const
 	out.WriteAs<uint32_t>(m_particles.size());
 	for (const auto& part : m_particles)
 	{
-		out << part.log_w << part.d->mapTillNow;
+		out << part.log_w << part.d->mapTillNow();
 		out.WriteAs<uint32_t>(part.d->robotPath.size());
 		for (const auto& p : part.d->robotPath) out << p;
 	}
@@ -246,7 +247,8 @@ void CMultiMetricMapPDF::serializeFrom(
 				m_particles[i].d.reset(new CRBPFParticleData());
 
 				// Load
-				in >> m_particles[i].log_w >> m_particles[i].d->mapTillNow;
+				in >> m_particles[i].log_w >>
+					m_particles[i].d->mapTillNowForWriting();
 
 				in >> m;
 				m_particles[i].d->robotPath.resize(m);
@@ -299,32 +301,38 @@ void CMultiMetricMapPDF::rebuildAverageMap()
 	// ---------------------------------------------------------
 	for (part = m_particles.begin(); part != m_particles.end(); ++part)
 	{
-		ASSERT_(part->d->mapTillNow.m_gridMaps.size() > 0);
+		ASSERT_(part->d->mapTillNow().m_gridMaps.size() > 0);
 
-		min_x = min(min_x, part->d->mapTillNow.m_gridMaps[0]->getXMin());
-		max_x = max(max_x, part->d->mapTillNow.m_gridMaps[0]->getXMax());
-		min_y = min(min_y, part->d->mapTillNow.m_gridMaps[0]->getYMin());
-		max_y = max(max_y, part->d->mapTillNow.m_gridMaps[0]->getYMax());
+		min_x = min(min_x, part->d->mapTillNow().m_gridMaps[0]->getXMin());
+		max_x = max(max_x, part->d->mapTillNow().m_gridMaps[0]->getXMax());
+		min_y = min(min_y, part->d->mapTillNow().m_gridMaps[0]->getYMin());
+		max_y = max(max_y, part->d->mapTillNow().m_gridMaps[0]->getYMax());
 	}
 
-	// Asure all maps have the same dimensions:
+	// Asure all maps have the same dimensions (only unsharing those which
+	// actually need to grow):
 	for (part = m_particles.begin(); part != m_particles.end(); ++part)
-		part->d->mapTillNow.m_gridMaps[0]->resizeGrid(
-			min_x, max_x, min_y, max_y, 0.5f, false);
+	{
+		const auto& grid = part->d->mapTillNow().m_gridMaps[0];
+		if (grid->getXMin() > min_x || grid->getXMax() < max_x ||
+			grid->getYMin() > min_y || grid->getYMax() < max_y)
+			part->d->mapTillNowForWriting().m_gridMaps[0]->resizeGrid(
+				min_x, max_x, min_y, max_y, 0.5f, false);
+	}
 
 	for (part = m_particles.begin(); part != m_particles.end(); ++part)
 	{
-		min_x = min(min_x, part->d->mapTillNow.m_gridMaps[0]->getXMin());
-		max_x = max(max_x, part->d->mapTillNow.m_gridMaps[0]->getXMax());
-		min_y = min(min_y, part->d->mapTillNow.m_gridMaps[0]->getYMin());
-		max_y = max(max_y, part->d->mapTillNow.m_gridMaps[0]->getYMax());
+		min_x = min(min_x, part->d->mapTillNow().m_gridMaps[0]->getXMin());
+		max_x = max(max_x, part->d->mapTillNow().m_gridMaps[0]->getXMax());
+		min_y = min(min_y, part->d->mapTillNow().m_gridMaps[0]->getYMin());
+		max_y = max(max_y, part->d->mapTillNow().m_gridMaps[0]->getYMax());
 	}
 
 	// Prepare target map:
 	ASSERT_(averageMap.m_gridMaps.size() > 0);
 	averageMap.m_gridMaps[0]->setSize(
 		min_x, max_x, min_y, max_y,
-		m_particles[0].d->mapTillNow.m_gridMaps[0]->getResolution(), 0);
+		m_particles[0].d->mapTillNow().m_gridMaps[0]->getResolution(), 0);
 
 	// Compute the sum of weights:
 	double sumLinearWeights = 0;
@@ -335,10 +343,10 @@ void CMultiMetricMapPDF::rebuildAverageMap()
 	for (part = m_particles.begin(); part != m_particles.end(); ++part)
 	{
 		ASSERT_(
-			part->d->mapTillNow.m_gridMaps[0]->getSizeX() ==
+			part->d->mapTillNow().m_gridMaps[0]->getSizeX() ==
 			averageMap.m_gridMaps[0]->getSizeX());
 		ASSERT_(
-			part->d->mapTillNow.m_gridMaps[0]->getSizeY() ==
+			part->d->mapTillNow().m_gridMaps[0]->getSizeY() ==
 			averageMap.m_gridMaps[0]->getSizeY());
 	}
 
@@ -364,15 +372,16 @@ void CMultiMetricMapPDF::rebuildAverageMap()
 		{
 			// Variables:
 			std::vector<COccupancyGridMap2D::cellType>::iterator srcCell;
-			auto firstSrcCell = part->d->mapTillNow.m_gridMaps[0]->map.begin();
-			auto lastSrcCell = part->d->mapTillNow.m_gridMaps[0]->map.end();
+			auto firstSrcCell =
+				part->d->mapTillNow().m_gridMaps[0]->map.begin();
+			auto lastSrcCell = part->d->mapTillNow().m_gridMaps[0]->map.end();
 			std::vector<float>::iterator destCell;
 
 			// The weight of particle:
 			float w = exp(part->log_w) / sumW;
 
 			ASSERT_(
-				part->d->mapTillNow.m_gridMaps[0]->map.size() ==
+				part->d->mapTillNow().m_gridMaps[0]->map.size() ==
 				floatMap.size());
 
 			// For each cell in individual maps:
@@ -423,7 +432,7 @@ bool CMultiMetricMapPDF::insertObservation(CSensoryFrame& sf)
 		const CPose3D robotPose = CPose3D(getLastPose(i, pose_is_valid));
 		// ASSERT_(pose_is_valid); // if not, use the default (0,0,0)
 		const bool map_modified = sf.insertObservationsInto(
-			&m_particles[i].d->mapTillNow, &robotPose);
+			&m_particles[i].d->mapTillNowForWriting(), &robotPose);
 		anymap = anymap || map_modified;
 	}
 
@@ -491,18 +500,24 @@ double CMultiMetricMapPDF::getCurrentJointEntropy()
 	// ---------------------------------------------------------
 	for (part = m_particles.begin(); part != m_particles.end(); ++part)
 	{
-		ASSERT_(part->d->mapTillNow.m_gridMaps.size() > 0);
+		ASSERT_(part->d->mapTillNow().m_gridMaps.size() > 0);
 
-		min_x = min(min_x, part->d->mapTillNow.m_gridMaps[0]->getXMin());
-		max_x = max(max_x, part->d->mapTillNow.m_gridMaps[0]->getXMax());
-		min_y = min(min_y, part->d->mapTillNow.m_gridMaps[0]->getYMin());
-		max_y = max(max_y, part->d->mapTillNow.m_gridMaps[0]->getYMax());
+		min_x = min(min_x, part->d->mapTillNow().m_gridMaps[0]->getXMin());
+		max_x = max(max_x, part->d->mapTillNow().m_gridMaps[0]->getXMax());
+		min_y = min(min_y, part->d->mapTillNow().m_gridMaps[0]->getYMin());
+		max_y = max(max_y, part->d->mapTillNow().m_gridMaps[0]->getYMax());
 	}
 
-	// Asure all maps have the same dimensions:
+	// Asure all maps have the same dimensions (only unsharing those which
+	// actually need to grow):
 	for (part = m_particles.begin(); part != m_particles.end(); ++part)
-		part->d->mapTillNow.m_gridMaps[0]->resizeGrid(
-			min_x, max_x, min_y, max_y, 0.5f, false);
+	{
+		const auto& grid = part->d->mapTillNow().m_gridMaps[0];
+		if (grid->getXMin() > min_x || grid->getXMax() < max_x ||
+			grid->getYMin() > min_y || grid->getYMax() < max_y)
+			part->d->mapTillNowForWriting().m_gridMaps[0]->resizeGrid(
+				min_x, max_x, min_y, max_y, 0.5f, false);
+	}
 
 	// Sum of linear weights:
 	double sumLinearWeights = 0;
@@ -513,9 +528,9 @@ double CMultiMetricMapPDF::getCurrentJointEntropy()
 	H_maps = 0;
 	for (i = 0; i < M; i++)
 	{
-		ASSERT_(m_particles[i].d->mapTillNow.m_gridMaps.size() > 0);
+		ASSERT_(m_particles[i].d->mapTillNow().m_gridMaps.size() > 0);
 
-		m_particles[i].d->mapTillNow.m_gridMaps[0]->computeEntropy(entropy);
+		m_particles[i].d->mapTillNow().m_gridMaps[0]->computeEntropy(entropy);
 		H_maps += exp(m_particles[i].log_w) * entropy.H / sumLinearWeights;
 	}
 
@@ -541,7 +556,7 @@ const CMultiMetricMap* CMultiMetricMapPDF::getCurrentMostLikelyMetricMap() const
 	}
 
 	// Return its map:
-	return &m_particles[max_i].d->mapTillNow;
+	return &m_particles[max_i].d->mapTillNow();
 }
 
 /*---------------------------------------------------------------
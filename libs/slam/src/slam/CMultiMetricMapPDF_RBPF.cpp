@@ -284,18 +284,18 @@ void CMultiMetricMapPDF::prediction_and_update_pfOptimalProposal(
 			CPosePDFGaussian icpEstimation;
 
 			// Configure the matchings that will take place in the ICP process:
-			if (partIt->d->mapTillNow.m_pointsMaps.size())
+			if (partIt->d->mapTillNow().m_pointsMaps.size())
 			{
-				ASSERT_(partIt->d->mapTillNow.m_pointsMaps.size() == 1);
-				// partIt->d->mapTillNow.m_pointsMaps[0]->insertionOptions.matchStaticPointsOnly
+				ASSERT_(partIt->d->mapTillNow().m_pointsMaps.size() == 1);
+				// partIt->d->mapTillNow().m_pointsMaps[0]->insertionOptions.matchStaticPointsOnly
 				// = false;
 			}
 
-			CMetricMap* map_to_align_to = nullptr;
+			const CMetricMap* map_to_align_to = nullptr;
 
 			if (options.pfOptimalProposal_mapSelection == 0)  // Grid map
 			{
-				ASSERT_(!partIt->d->mapTillNow.m_gridMaps.empty());
+				ASSERT_(!partIt->d->mapTillNow().m_gridMaps.empty());
 
 				// Build local map of points.
 				if (!built_map_points)
@@ -304,17 +304,17 @@ void CMultiMetricMapPDF::prediction_and_update_pfOptimalProposal(
 
 					localMapPoints.insertionOptions.minDistBetweenLaserPoints =
 						0.02f;  // 3.0f *
-					// m_particles[0].d->mapTillNow.m_gridMaps[0]->getResolution();;
+					// m_particles[0].d->mapTillNow().m_gridMaps[0]->getResolution();;
 					localMapPoints.insertionOptions.isPlanarMap = true;
 					sf->insertObservationsInto(&localMapPoints);
 				}
 
-				map_to_align_to = partIt->d->mapTillNow.m_gridMaps[0].get();
+				map_to_align_to = partIt->d->mapTillNow().m_gridMaps[0].get();
 			}
 			else if (options.pfOptimalProposal_mapSelection == 3)  // Map of
 			// points
 			{
-				ASSERT_(!partIt->d->mapTillNow.m_pointsMaps.empty());
+				ASSERT_(!partIt->d->mapTillNow().m_pointsMaps.empty());
 
 				// Build local map of points.
 				if (!built_map_points)
@@ -323,16 +323,16 @@ void CMultiMetricMapPDF::prediction_and_update_pfOptimalProposal(
 
 					localMapPoints.insertionOptions.minDistBetweenLaserPoints =
 						0.02f;  // 3.0f *
-					// m_particles[0].d->mapTillNow.m_gridMaps[0]->getResolution();;
+					// m_particles[0].d->mapTillNow().m_gridMaps[0]->getResolution();;
 					localMapPoints.insertionOptions.isPlanarMap = true;
 					sf->insertObservationsInto(&localMapPoints);
 				}
 
-				map_to_align_to = partIt->d->mapTillNow.m_pointsMaps[0].get();
+				map_to_align_to = partIt->d->mapTillNow().m_pointsMaps[0].get();
 			}
 			else
 			{
-				ASSERT_(partIt->d->mapTillNow.m_landmarksMap);
+				ASSERT_(partIt->d->mapTillNow().m_landmarksMap);
 
 				// Build local map of LMs.
 				if (!built_map_lms)
@@ -341,7 +341,7 @@ void CMultiMetricMapPDF::prediction_and_update_pfOptimalProposal(
 					sf->insertObservationsInto(&localMapLandmarks);
 				}
 
-				map_to_align_to = partIt->d->mapTillNow.m_landmarksMap.get();
+				map_to_align_to = partIt->d->mapTillNow().m_landmarksMap.get();
 			}
 
 			ASSERT_(map_to_align_to != nullptr);
@@ -429,8 +429,8 @@ void CMultiMetricMapPDF::prediction_and_update_pfOptimalProposal(
 			// --------------------------------------------------------
 			/** \todo Add paper ref!
 			 */
-			ASSERT_(partIt->d->mapTillNow.m_beaconMap);
-			CBeaconMap::Ptr beacMap = partIt->d->mapTillNow.m_beaconMap;
+			ASSERT_(partIt->d->mapTillNow().m_beaconMap);
+			CBeaconMap::Ptr beacMap = partIt->d->mapTillNow().m_beaconMap;
 
 			updateStageAlreadyDone =
 				true;  // We'll also update the weight of the particle here
@@ -1000,7 +1000,8 @@ bool CMultiMetricMapPDF::PF_SLAM_implementation_doWeHaveValidObservations(
 	ASSERT_(!particles.empty());
 	return particles.begin()
 		->d.get()
-		->mapTillNow.canComputeObservationsLikelihood(*sf);
+		->mapTillNow()
+		.canComputeObservationsLikelihood(*sf);
 }
 
 /** Do not move the particles until the map is populated.  */
@@ -1019,8 +1020,10 @@ double CMultiMetricMapPDF::PF_SLAM_computeObservationLikelihoodForParticle(
 	const CPose3D& x) const
 {
 	MRPT_UNUSED_PARAM(PF_options);
+	// The likelihood only updates cached data of the maps, so there is no
+	// need to unshare them (see CRBPFParticleData):
 	auto* map = const_cast<CMultiMetricMap*>(
-		&m_particles[particleIndexForMap].d->mapTillNow);
+		&m_particles[particleIndexForMap].d->mapTillNow());
 	double ret = 0;
 	for (const auto& it : observation)
 		ret += map->computeObservationLikelihood((CObservation*)it.get(), x);
@@ -0,0 +1,52 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/maps/CMultiMetricMapPDF.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::maps;
+
+TEST(CMultiMetricMapPDF, resampling_shares_maps)
+{
+	TSetOfMetricMapInitializers mapInit;
+	COccupancyGridMap2D::TMapDefinition def;
+	def.resolution = 0.1f;
+	mapInit.push_back(def);
+
+	mrpt::bayes::CParticleFilter::TParticleFilterOptions pfOpts;
+	pfOpts.sampleSize = 4;
+	CMultiMetricMapPDF pdf(pfOpts, &mapInit);
+	for (const auto& p : pdf.m_particles) EXPECT_FALSE(p.d->isMapShared());
+
+	// Particle #0 duplicated three times:
+	pdf.performSubstitution({0, 0, 0, 1});
+	ASSERT_EQ(pdf.m_particles.size(), 4U);
+	for (size_t i = 0; i < 3; i++)
+		EXPECT_TRUE(pdf.m_particles[i].d->isMapShared());
+	EXPECT_FALSE(pdf.m_particles[3].d->isMapShared());
+	EXPECT_EQ(
+		&pdf.m_particles[0].d->mapTillNow(),
+		&pdf.m_particles[1].d->mapTillNow());
+
+	// Writing into one copy does not affect the others:
+	auto grid = pdf.m_particles[1]
+					.d->mapTillNowForWriting()
+					.getMapByClass<COccupancyGridMap2D>();
+	ASSERT_TRUE(grid);
+	grid->setCell(0, 0, 0.1f);
+	EXPECT_FALSE(pdf.m_particles[1].d->isMapShared());
+	EXPECT_TRUE(pdf.m_particles[0].d->isMapShared());
+
+	const auto other_grid = pdf.m_particles[0]
+								.d->mapTillNow()
+								.getMapByClass<COccupancyGridMap2D>();
+	EXPECT_NEAR(grid->getCell(0, 0), 0.1f, 0.01f);
+	EXPECT_NEAR(other_grid->getCell(0, 0), 0.5f, 0.01f);
+}
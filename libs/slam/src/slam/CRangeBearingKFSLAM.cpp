@@ -697,7 +697,8 @@ void CRangeBearingKFSLAM::OnGetObservationsAndDataAssociation(
 				true,  // Use KD-tree
 				m_last_data_association.predictions_IDs,
 				options.data_assoc_IC_metric,
-				options.data_assoc_IC_ml_threshold);
+				options.data_assoc_IC_ml_threshold,
+				options.data_assoc_num_threads);
 
 			// Return pairings to the main KF algorithm:
 			for (auto it = m_last_data_association.results.associations.begin();
@@ -778,6 +779,7 @@ void CRangeBearingKFSLAM::TOptions::loadFromConfigFile(
 
 	MRPT_LOAD_CONFIG_VAR(data_assoc_IC_chi2_thres, double, source, section);
 	MRPT_LOAD_CONFIG_VAR(data_assoc_IC_ml_threshold, double, source, section);
+	MRPT_LOAD_CONFIG_VAR(data_assoc_num_threads, int, source, section);
 
 	MRPT_LOAD_CONFIG_VAR(quantiles_3D_representation, float, source, section);
 }
@@ -830,6 +832,9 @@ void CRangeBearingKFSLAM::TOptions::dumpToTextStream(std::ostream& out) const
 	out << mrpt::format(
 		"data_assoc_IC_ml_threshold              = %.06f\n",
 		data_assoc_IC_ml_threshold);
+	out << mrpt::format(
+		"data_assoc_num_threads                  = %u\n",
+		data_assoc_num_threads);
 
 	out << mrpt::format("\n");
 }
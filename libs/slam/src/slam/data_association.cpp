@@ -29,9 +29,12 @@
 #include <mrpt/poses/CPointPDFGaussian.h>
 #include <mrpt/poses/CPoint2DPDFGaussian.h>
 
-#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
 #include <set>
-#include <numeric>  // accumulate
+#include <thread>
 #include <memory>  // unique_ptr
 
 #include <nanoflann.hpp>  // For kd-tree's
@@ -65,9 +68,8 @@ double joint_pdf_metric(
 	const CMatrixTemplateNumeric<T>& Z_observations_mean,
 	const CMatrixTemplateNumeric<T>& Y_predictions_mean,
 	const CMatrixTemplateNumeric<T>& Y_predictions_cov,
-	const TAuxDataRecursiveJCBB& info, const TDataAssociationResults& aux_data)
+	const TAuxDataRecursiveJCBB& info)
 {
-	MRPT_UNUSED_PARAM(aux_data);
 	// Make a list of the indices of the predictions that appear in
 	// "currentAssociation":
 	const size_t N = info.currentAssociation.size();
@@ -145,113 +147,307 @@ bool isCloser<metricML>(const double v1, const double v2)
 	return v1 > v2;
 }
 
+/** Marks an observation without pairing in a JCBB node */
+constexpr prediction_index_t JCBB_STAR =
+	std::numeric_limits<prediction_index_t>::max();
+
+/** A node of the JCBB search tree: the prediction paired to each one of the
+ * first observations (or JCBB_STAR) */
+using TJCBBNode = std::vector<prediction_index_t>;
+
+/** Read-only data and best bound shared by all the JCBB search threads */
+struct TJCBBSharedData
+{
+	const CMatrixDouble* Z_observations_mean{nullptr};
+	const CMatrixDouble* Y_predictions_mean{nullptr};
+	const CMatrixDouble* Y_predictions_cov{nullptr};
+	size_t nPredictions{0}, nObservations{0}, length_O{0};
+	/** Individually compatible predictions of each observation, in
+	 * increasing order */
+	std::vector<std::vector<prediction_index_t>> compatibles;
+	/** `potentials[j]`: number of individually compatible pairings of
+	 * observations j+1,...,nObservations-1 */
+	std::vector<size_t> potentials;
+	/** Size of the largest set of pairings found so far by any thread */
+	std::atomic<size_t> best_size{0};
+};
+
+/** The best set of pairings found in one subtree of the JCBB search */
+struct TJCBBBest
+{
+	std::map<observation_index_t, prediction_index_t> associations;
+	double distance{0};
+
+	/** Whether a set of pairings with the given size and joint distance
+	 * should replace this one. Applied in depth-first order, so on ties the
+	 * first one found is kept, as in the original recursive algorithm. */
+	template <TDataAssociationMetric METRIC>
+	bool isWorseThan(size_t size, double dist) const
+	{
+		return size > associations.size() ||
+			   (size != 0 && size == associations.size() &&
+				isCloser<METRIC>(dist, distance));
+	}
+};
+
 /* Based on MATLAB code by:
   University of Zaragoza
   Centro Politecnico Superior
   Robotics and Real Time Group
   Authors of the original MATLAB code:  J. Neira, J. Tardos
   C++ version: J.L. Blanco Claraco
+
+  Depth-first search with backtracking over the subtree of a given node. The
+  bound used to prune branches is the largest set of pairings found so far by
+  this search or by any other thread.
 */
-template <typename T, TDataAssociationMetric METRIC>
-void JCBB_recursive(
-	const mrpt::math::CMatrixTemplateNumeric<T>& Z_observations_mean,
-	const mrpt::math::CMatrixTemplateNumeric<T>& Y_predictions_mean,
-	const mrpt::math::CMatrixTemplateNumeric<T>& Y_predictions_cov,
-	TDataAssociationResults& results, const TAuxDataRecursiveJCBB& info,
-	const observation_index_t curObsIdx)
+template <TDataAssociationMetric METRIC>
+class CJCBBSearch
 {
-	// End of iteration?
-	if (curObsIdx >= info.nObservations)
+   public:
+	CJCBBSearch(TJCBBSharedData& shared) : m_shared(shared)
 	{
-		if (info.currentAssociation.size() > results.associations.size())
-		{
-			// It's a better choice since more features are matched.
-			results.associations = info.currentAssociation;
-			results.distance = joint_pdf_metric<T, METRIC>(
-				Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-				info, results);
-		}
-		else if (
-			!info.currentAssociation.empty() &&
-			info.currentAssociation.size() == results.associations.size())
-		{
-			// The same # of features matched than the previous best one...
-			// decide by better distance:
-			const double d2 = joint_pdf_metric<T, METRIC>(
-				Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-				info, results);
+		m_info.nPredictions = shared.nPredictions;
+		m_info.nObservations = shared.nObservations;
+		m_info.length_O = shared.length_O;
+	}
 
-			if (isCloser<METRIC>(d2, results.distance))
-			{
-				results.associations = info.currentAssociation;
-				results.distance = d2;
-			}
+	/** Explores the subtree below `node`, leaving its best set of pairings
+	 * in `best` */
+	void run(const TJCBBNode& node)
+	{
+		m_pairing.assign(m_shared.nObservations, JCBB_STAR);
+		m_pred_taken.assign(m_shared.nPredictions, 0);
+		m_nPairings = 0;
+		for (size_t j = 0; j < node.size(); j++)
+		{
+			if (node[j] == JCBB_STAR) continue;
+			m_pairing[j] = node[j];
+			m_pred_taken[node[j]] = 1;
+			m_nPairings++;
 		}
+		best = TJCBBBest();
+		recurse(node.size());
 	}
-	else  // A normal iteration:
+
+	TJCBBBest best;
+	size_t nNodesExplored{0}, nJointCompatEvaluated{0};
+
+   private:
+	TJCBBSharedData& m_shared;
+	TAuxDataRecursiveJCBB m_info;
+	std::vector<prediction_index_t> m_pairing;
+	std::vector<char> m_pred_taken;
+	size_t m_nPairings{0};
+
+	size_t bound() const
 	{
-		// Iterate for all compatible landmarsk of "curObsIdx"
-		const observation_index_t obsIdx = curObsIdx;
+		return std::max(
+			best.associations.size(),
+			m_shared.best_size.load(std::memory_order_relaxed));
+	}
 
-		const size_t nPreds = results.indiv_compatibility.rows();
+	void recurse(const observation_index_t obsIdx)
+	{
+		// End of iteration?
+		if (obsIdx >= m_shared.nObservations)
+		{
+			evaluateLeaf();
+			return;
+		}
 
-		// Can we do it better than the current "results.associations"?
+		// Can we do it at least as good as the current best set of pairings?
 		// This can be checked by counting the potential new pairings+the so-far
 		// established ones.
 		//    Matlab: potentials  = pairings(compatibility.AL(i+1:end))
-		// Moved up by Kasra Khosoussi
-		const size_t potentials = std::accumulate(
-			results.indiv_compatibility_counts.begin() + (obsIdx + 1),
-			results.indiv_compatibility_counts.end(), 0);
-		for (prediction_index_t predIdx = 0; predIdx < nPreds; predIdx++)
+		// All the branches which may tie with the best size are explored, so
+		// the one with the best joint distance is found regardless of the
+		// order in which subtrees are visited.
+		const size_t potentials = m_shared.potentials[obsIdx];
+
+		// Iterate for all compatible landmarks of "obsIdx":
+		for (const prediction_index_t predIdx :
+			 m_shared.compatibles[obsIdx])
 		{
-			if ((info.currentAssociation.size() + potentials) >=
-				results.associations.size())
-			{
-				// Only if predIdx is NOT already assigned:
-				if (results.indiv_compatibility(predIdx, obsIdx))
-				{
-					// Only if predIdx is NOT already assigned:
-					bool already_asigned = false;
-					for (auto itS : info.currentAssociation)
-					{
-						if (itS.second == predIdx)
-						{
-							already_asigned = true;
-							break;
-						}
-					}
+			// (The bound never decreases)
+			if (m_nPairings + 1 + potentials < bound()) break;
+			// Only if predIdx is NOT already assigned:
+			if (m_pred_taken[predIdx]) continue;
+
+			// Launch a new recursive line for this hipothesis:
+			m_pairing[obsIdx] = predIdx;
+			m_pred_taken[predIdx] = 1;
+			m_nPairings++;
+			nNodesExplored++;
+
+			recurse(obsIdx + 1);
+
+			m_nPairings--;
+			m_pred_taken[predIdx] = 0;
+			m_pairing[obsIdx] = JCBB_STAR;
+		}
 
-					if (!already_asigned)
-					{
-						// Launch a new recursive line for this hipothesis:
-						TAuxDataRecursiveJCBB new_info = info;
-						new_info.currentAssociation[curObsIdx] = predIdx;
+		if (m_nPairings + potentials >= bound())
+		{
+			// star node: Ei not paired
+			nNodesExplored++;
+			recurse(obsIdx + 1);
+		}
+	}
 
-						results.nNodesExploredInJCBB++;
+	void evaluateLeaf()
+	{
+		if (m_nPairings == 0 ||
+			m_nPairings < m_shared.best_size.load(std::memory_order_relaxed) ||
+			m_nPairings < best.associations.size())
+			return;
+
+		m_info.currentAssociation.clear();
+		for (size_t j = 0; j < m_pairing.size(); j++)
+			if (m_pairing[j] != JCBB_STAR)
+				m_info.currentAssociation[j] = m_pairing[j];
+
+		const double d2 = joint_pdf_metric<CMatrixDouble::Scalar, METRIC>(
+			*m_shared.Z_observations_mean, *m_shared.Y_predictions_mean,
+			*m_shared.Y_predictions_cov, m_info);
+		nJointCompatEvaluated++;
+
+		if (!best.isWorseThan<METRIC>(m_nPairings, d2)) return;
+		best.associations = m_info.currentAssociation;
+		best.distance = d2;
+
+		// Publish the new bound to other threads:
+		size_t cur = m_shared.best_size.load();
+		while (cur < m_nPairings &&
+			   !m_shared.best_size.compare_exchange_weak(cur, m_nPairings))
+		{
+		}
+	}
+};
 
-						JCBB_recursive<T, METRIC>(
-							Z_observations_mean, Y_predictions_mean,
-							Y_predictions_cov, results, new_info,
-							curObsIdx + 1);
-					}
-				}
+/** Splits the JCBB search tree into a number of subtrees, in depth-first
+ * order, large enough to keep `num_threads` threads busy.
+ * \return The number of tree nodes generated in the process. */
+size_t JCBB_split_tree(
+	const TJCBBSharedData& shared, unsigned int num_threads,
+	std::vector<TJCBBNode>& subtrees)
+{
+	size_t nNodes = 0;
+	subtrees.assign(1, TJCBBNode());  // The root
+	if (num_threads <= 1) return nNodes;
+
+	const size_t min_subtrees = 8 * num_threads;
+	std::vector<TJCBBNode> next;
+	for (size_t depth = 0;
+		 depth < shared.nObservations && subtrees.size() < min_subtrees;
+		 depth++)
+	{
+		next.clear();
+		for (const auto& node : subtrees)
+		{
+			for (const prediction_index_t predIdx : shared.compatibles[depth])
+			{
+				if (std::find(node.begin(), node.end(), predIdx) != node.end())
+					continue;
+				next.push_back(node);
+				next.back().push_back(predIdx);
 			}
+			next.push_back(node);
+			next.back().push_back(JCBB_STAR);
 		}
+		nNodes += next.size();
+		subtrees.swap(next);
+	}
+	return nNodes;
+}
 
-		// Can we do it better than the current "results.associations"?
-		if ((info.currentAssociation.size() + potentials) >=
-			results.associations.size())
+/** Runs JCBB over all the subtrees in `num_threads` threads, which take the
+ * next pending subtree as soon as they finish with the previous one. */
+template <TDataAssociationMetric METRIC>
+void JCBB_parallel(
+	TJCBBSharedData& shared, unsigned int num_threads,
+	TDataAssociationResults& results)
+{
+	std::vector<TJCBBNode> subtrees;
+	results.nNodesExploredInJCBB +=
+		JCBB_split_tree(shared, num_threads, subtrees);
+	num_threads = std::min<unsigned int>(num_threads, subtrees.size());
+
+	std::vector<TJCBBBest> bests(subtrees.size());
+	std::atomic<size_t> next_subtree{0};
+	std::mutex mtx;
+	std::exception_ptr error;
+
+	auto worker = [&]() {
+		try
 		{
-			// Yes we can </obama>
-
-			// star node: Ei not paired
-			results.nNodesExploredInJCBB++;
-			JCBB_recursive<T, METRIC>(
-				Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-				results, info, curObsIdx + 1);
+			CJCBBSearch<METRIC> search(shared);
+			for (size_t i; (i = next_subtree++) < subtrees.size();)
+			{
+				search.run(subtrees[i]);
+				bests[i] = std::move(search.best);
+			}
+			std::lock_guard<std::mutex> lck(mtx);
+			results.nNodesExploredInJCBB += search.nNodesExplored;
+			results.nJointCompatEvaluated += search.nJointCompatEvaluated;
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			if (!error) error = std::current_exception();
+			next_subtree = subtrees.size();
 		}
+	};
+	std::vector<std::thread> threads;
+	for (unsigned int t = 1; t < num_threads; t++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& t : threads) t.join();
+	if (error) std::rethrow_exception(error);
+
+	// Merge in depth-first order, so the result is the same than that of a
+	// single depth-first search of the whole tree:
+	TJCBBBest best;
+	for (auto& b : bests)
+		if (best.isWorseThan<METRIC>(b.associations.size(), b.distance))
+			best = std::move(b);
+	if (!best.associations.empty())
+	{
+		results.associations = std::move(best.associations);
+		results.distance = best.distance;
+	}
+}
+
+/** Runs `func(i)` for i=0,...,n-1 from `num_threads` threads */
+template <class FUNC>
+void run_in_threads(size_t n, unsigned int num_threads, FUNC&& func)
+{
+	if (num_threads <= 1 || n <= 1)
+	{
+		for (size_t i = 0; i < n; i++) func(i);
+		return;
 	}
+	std::atomic<size_t> next{0};
+	std::mutex mtx;
+	std::exception_ptr error;
+	auto worker = [&]() {
+		try
+		{
+			for (size_t i; (i = next++) < n;) func(i);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			if (!error) error = std::current_exception();
+			next = n;
+		}
+	};
+	std::vector<std::thread> threads;
+	for (unsigned int t = 1; t < num_threads && t < n; t++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& t : threads) t.join();
+	if (error) std::rethrow_exception(error);
 }
 
 }  // namespace mrpt::slam
@@ -303,7 +499,7 @@ void mrpt::slam::data_association_full_covariance(
 	const bool DAT_ASOC_USE_KDTREE,
 	const std::vector<prediction_index_t>& predictions_IDs,
 	const TDataAssociationMetric compatibilityTestMetric,
-	const double log_ML_compat_test_threshold)
+	const double log_ML_compat_test_threshold, const unsigned int num_threads)
 {
 	// For details on the theory, see the papers cited at the beginning of this
 	// file.
@@ -327,6 +523,43 @@ void mrpt::slam::data_association_full_covariance(
 	ASSERT_(chi2quantile > 0 && chi2quantile < 1);
 	ASSERT_(metric == metricMaha || metric == metricML);
 	const double chi2thres = mrpt::math::chi2inv(chi2quantile, length_O);
+	const unsigned int nThreads =
+		num_threads != 0 ? num_threads
+						 : std::max(1u, std::thread::hardware_concurrency());
+
+	// ------------------------------------------------------------
+	// Inverse of the covariance of each prediction, and the largest square
+	// Mahalanobis distance for it to be individually compatible:
+	// ------------------------------------------------------------
+	const double log_2pi_O = length_O * ::log(M_2PI);
+	std::vector<CMatrixDouble> pred_cov_inv(nPredictions);
+	std::vector<double> pred_log_det(nPredictions);
+	// Largest Euclidean distance (squared) of any compatible pairing:
+	double max_compatible_dist2 = 0;
+	{
+		CMatrixDouble pred_i_cov(length_O, length_O);
+		for (size_t i = 0; i < nPredictions; ++i)
+		{
+			// Extract the submatrix from the diagonal:
+			const size_t pred_cov_idx = i * length_O;
+			Y_predictions_cov.extractMatrix(
+				pred_cov_idx, pred_cov_idx, length_O, length_O, pred_i_cov);
+			pred_i_cov.inv(pred_cov_inv[i]);
+			pred_log_det[i] = ::log(pred_i_cov.det());
+
+			if (!DAT_ASOC_USE_KDTREE) continue;
+			const double max_d2 =
+				(compatibilityTestMetric == metricML)
+					? -2 * log_ML_compat_test_threshold - log_2pi_O -
+						  pred_log_det[i]
+					: chi2thres;
+			// d2 >= |diff|^2 / (largest eigenvalue of the covariance):
+			const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> es(
+				pred_i_cov, Eigen::EigenvaluesOnly);
+			mrpt::keep_max(
+				max_compatible_dist2, max_d2 * es.eigenvalues().maxCoeff());
+		}
+	}
 
 	// ------------------------------------------------------------
 	// Build a KD-tree of the predictions for quick look-up:
@@ -334,13 +567,6 @@ void mrpt::slam::data_association_full_covariance(
 	using KDTreeMatrixPtr =
 		std::unique_ptr<KDTreeEigenMatrixAdaptor<CMatrixDouble>>;
 	KDTreeMatrixPtr kd_tree;
-	const size_t N_KD_RESULTS = nPredictions;
-	std::vector<double> kd_result_distances(
-		DAT_ASOC_USE_KDTREE ? N_KD_RESULTS : 0);
-	std::vector<CMatrixDouble::Index> kd_result_indices(
-		DAT_ASOC_USE_KDTREE ? N_KD_RESULTS : 0);
-	std::vector<double> kd_queryPoint(DAT_ASOC_USE_KDTREE ? length_O : 0);
-
 	if (DAT_ASOC_USE_KDTREE)
 	{
 		// Construct kd-tree for the predictions:
@@ -364,97 +590,56 @@ void mrpt::slam::data_association_full_covariance(
 							 : -1000 /*A very small log-likelihoo   */);
 	results.indiv_compatibility.fillAll(false);
 
-	CMatrixDouble pred_i_cov(length_O, length_O);
+	// Observations are independent of each other: evaluate them in parallel
+	std::vector<size_t> nEvaluated(nObservations, 0);
+	run_in_threads(nObservations, nThreads, [&](const size_t j) {
+		Eigen::VectorXd diff_means_i_j(length_O);
+
+		// Evaluate sqr. mahalanobis distance of obs_j -> pred_i:
+		auto evaluatePair = [&](const size_t i) {
+			for (size_t k = 0; k < length_O; k++)
+				diff_means_i_j[k] = Z_observations_mean.get_unsafe(j, k) -
+									Y_predictions_mean.get_unsafe(i, k);
 
-	Eigen::VectorXd diff_means_i_j(length_O);
+			const double d2 = mrpt::math::multiply_HCHt_scalar(
+				diff_means_i_j, pred_cov_inv[i]);
+			const double ml = -0.5 * (d2 + log_2pi_O + pred_log_det[i]);
+
+			// The distance according to the metric
+			const double val = (metric == metricMaha) ? d2 : ml;
+
+			results.indiv_distances(i, j) = val;
+
+			// Individual compatibility
+			const bool IC = (compatibilityTestMetric == metricML)
+								? (ml > log_ML_compat_test_threshold)
+								: (d2 < chi2thres);
+			results.indiv_compatibility(i, j) = IC;
+			if (IC) results.indiv_compatibility_counts[j]++;
+			nEvaluated[j]++;
+		};
 
-	for (size_t j = 0; j < nObservations; ++j)
-	{
 		if (!DAT_ASOC_USE_KDTREE)
 		{
 			// Compute all the distances w/o a KD-tree
-			for (size_t i = 0; i < nPredictions; ++i)
-			{
-				// Evaluate sqr. mahalanobis distance of obs_j -> pred_i:
-				const size_t pred_cov_idx =
-					i * length_O;  // Extract the submatrix from the diagonal:
-				Y_predictions_cov.extractMatrix(
-					pred_cov_idx, pred_cov_idx, length_O, length_O, pred_i_cov);
-
-				for (size_t k = 0; k < length_O; k++)
-					diff_means_i_j[k] = Z_observations_mean.get_unsafe(j, k) -
-										Y_predictions_mean.get_unsafe(i, k);
-
-				double d2, ml;
-				// mrpt::math::productIntegralAndMahalanobisTwoGaussians(diff_means_i_j,pred_i_cov,obs_j_cov,
-				// d2,ml);
-				mrpt::math::mahalanobisDistance2AndLogPDF(
-					diff_means_i_j, pred_i_cov, d2, ml);
-
-				// The distance according to the metric
-				double val = (metric == metricMaha) ? d2 : ml;
-
-				results.indiv_distances(i, j) = val;
-
-				// Individual compatibility
-				const bool IC = (compatibilityTestMetric == metricML)
-									? (ml > log_ML_compat_test_threshold)
-									: (d2 < chi2thres);
-				results.indiv_compatibility(i, j) = IC;
-				if (IC) results.indiv_compatibility_counts[j]++;
-			}
+			for (size_t i = 0; i < nPredictions; ++i) evaluatePair(i);
+			return;
 		}
-		else
-		{
-			// Use a kd-tree and compute only the N closest ones:
-			for (size_t k = 0; k < length_O; k++)
-				kd_queryPoint[k] = Z_observations_mean.get_unsafe(j, k);
-
-			kd_tree->query(
-				&kd_queryPoint[0], N_KD_RESULTS, &kd_result_indices[0],
-				&kd_result_distances[0]);
-
-			// Only compute the distances for these ones:
-			for (size_t w = 0; w < N_KD_RESULTS; w++)
-			{
-				const size_t i = kd_result_indices[w];  // This is the index of
-				// the prediction in
-				// "predictions_mean"
-
-				// Build the PDF of the prediction:
-				const size_t pred_cov_idx =
-					i * length_O;  // Extract the submatrix from the diagonal:
-				Y_predictions_cov.extractMatrix(
-					pred_cov_idx, pred_cov_idx, length_O, length_O, pred_i_cov);
-
-				for (size_t k = 0; k < length_O; k++)
-					diff_means_i_j[k] = Z_observations_mean.get_unsafe(j, k) -
-										Y_predictions_mean.get_unsafe(i, k);
-
-				double d2, ml;
-				//				mrpt::math::productIntegralAndMahalanobisTwoGaussians(diff_means_i_j,pred_i_cov,obs_j_cov,
-				// d2,ml);
-				mrpt::math::mahalanobisDistance2AndLogPDF(
-					diff_means_i_j, pred_i_cov, d2, ml);
-
-				if (d2 > 6 * chi2thres)
-					break;  // Since kd-tree returns the landmarks by distance
-				// order, we can skip the rest
-
-				// The distance according to the metric
-				double val = (metric == metricMaha) ? d2 : ml;
-
-				results.indiv_distances(i, j) = val;
-
-				// Individual compatibility
-				const bool IC = (compatibilityTestMetric == metricML)
-									? (ml > log_ML_compat_test_threshold)
-									: (d2 < chi2thres);
-				results.indiv_compatibility(i, j) = IC;
-				if (IC) results.indiv_compatibility_counts[j]++;
-			}
-		}  // end use KD-Tree
-	}  // end for
+		if (max_compatible_dist2 <= 0) return;
+
+		// Use a kd-tree and only evaluate the predictions close enough to be
+		// compatible:
+		std::vector<double> kd_queryPoint(length_O);
+		for (size_t k = 0; k < length_O; k++)
+			kd_queryPoint[k] = Z_observations_mean.get_unsafe(j, k);
+
+		std::vector<std::pair<CMatrixDouble::Index, double>> kd_matches;
+		kd_tree->index->radiusSearch(
+			&kd_queryPoint[0], max_compatible_dist2 * (1 + 1e-9), kd_matches,
+			nanoflann::SearchParams(32, 0, false /*sorted*/));
+		for (const auto& m : kd_matches) evaluatePair(m.first);
+	});
+	for (const size_t n : nEvaluated) results.nIndivCompatEvaluated += n;
 
 #if 0
 	cout << "Distances: " << endl << results.indiv_distances << endl;
@@ -535,20 +720,27 @@ void mrpt::slam::data_association_full_covariance(
 		// ------------------------------------
 		case assocJCBB:
 		{
-			// Call to the recursive method:
-			TAuxDataRecursiveJCBB info;
-			info.nPredictions = nPredictions;
-			info.nObservations = nObservations;
-			info.length_O = length_O;
+			TJCBBSharedData shared;
+			shared.Z_observations_mean = &Z_observations_mean;
+			shared.Y_predictions_mean = &Y_predictions_mean;
+			shared.Y_predictions_cov = &Y_predictions_cov;
+			shared.nPredictions = nPredictions;
+			shared.nObservations = nObservations;
+			shared.length_O = length_O;
+			shared.compatibles.resize(nObservations);
+			shared.potentials.assign(nObservations, 0);
+			for (size_t j = 0; j < nObservations; ++j)
+				for (size_t i = 0; i < nPredictions; ++i)
+					if (results.indiv_compatibility.get_unsafe(i, j))
+						shared.compatibles[j].push_back(i);
+			const auto& counts = results.indiv_compatibility_counts;
+			for (size_t j = nObservations - 1; j > 0; --j)
+				shared.potentials[j - 1] = shared.potentials[j] + counts[j];
 
 			if (metric == metricMaha)
-				JCBB_recursive<CMatrixDouble::Scalar, metricMaha>(
-					Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-					results, info, 0);
+				JCBB_parallel<metricMaha>(shared, nThreads, results);
 			else
-				JCBB_recursive<CMatrixDouble::Scalar, metricML>(
-					Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-					results, info, 0);
+				JCBB_parallel<metricML>(shared, nThreads, results);
 		}
 		break;
 
@@ -581,7 +773,7 @@ void mrpt::slam::data_association_independent_predictions(
 	const bool DAT_ASOC_USE_KDTREE,
 	const std::vector<prediction_index_t>& predictions_IDs,
 	const TDataAssociationMetric compatibilityTestMetric,
-	const double log_ML_compat_test_threshold)
+	const double log_ML_compat_test_threshold, const unsigned int num_threads)
 {
 	MRPT_START
 
@@ -616,7 +808,8 @@ void mrpt::slam::data_association_independent_predictions(
 	data_association_full_covariance(
 		Z_observations_mean, Y_predictions_mean, Y_predictions_cov_full,
 		results, method, metric, chi2quantile, DAT_ASOC_USE_KDTREE,
-		predictions_IDs, compatibilityTestMetric, log_ML_compat_test_threshold);
+		predictions_IDs, compatibilityTestMetric, log_ML_compat_test_threshold,
+		num_threads);
 
 	MRPT_END
 }
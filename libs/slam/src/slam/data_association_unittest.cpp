@@ -8,6 +8,7 @@
    +------------------------------------------------------------------------+ */
 
 #include <mrpt/slam/data_association.h>
+#include <mrpt/random/RandomGenerators.h>
 #include <gtest/gtest.h>
 
 using namespace mrpt;
@@ -55,3 +56,56 @@ TEST(DataAssociation, TestNoICs)
 		}
 	}
 }
+
+TEST(DataAssociation, JCBB_KDTreeAndThreads)
+{
+	// Predictions in a grid, with some clusters of nearby landmarks to make
+	// the association ambiguous, and noisy observations of some of them:
+	auto& rnd = mrpt::random::getRandomGenerator();
+	rnd.randomize(123);
+	const size_t N = 60, M = 10;
+	CMatrixDouble y(N, 2), y_cov(2 * N, 2 * N), z(M, 2);
+	y_cov.setZero();
+	for (size_t i = 0; i < N; i++)
+	{
+		y(i, 0) = (i % 10) * 2.0 + (i >= 30 ? 0.3 : 0.0);
+		y(i, 1) = ((i % 30) / 10) * 2.0;
+		y_cov(2 * i, 2 * i) = rnd.drawUniform(0.02, 0.1);
+		y_cov(2 * i + 1, 2 * i + 1) = rnd.drawUniform(0.02, 0.1);
+	}
+	std::vector<size_t> gt(M);
+	for (size_t j = 0; j < M; j++)
+	{
+		gt[j] = (j * 7) % N;
+		z(j, 0) = y(gt[j], 0) + rnd.drawGaussian1D(0, 0.05);
+		z(j, 1) = y(gt[j], 1) + rnd.drawGaussian1D(0, 0.05);
+	}
+
+	for (const auto metric : {metricMaha, metricML})
+	{
+		TDataAssociationResults ref;
+		data_association_full_covariance(
+			z, y, y_cov, ref, assocJCBB, metric, 0.99, false);
+		EXPECT_EQ(ref.nIndivCompatEvaluated, N * M);
+		EXPECT_EQ(ref.associations.size(), M);
+		for (const auto& a : ref.associations)
+			EXPECT_EQ(a.second, gt[a.first]) << "obs #" << a.first;
+
+		// The result must not depend on the KD-tree or the threads:
+		for (const unsigned int nThreads : {1u, 4u})
+		{
+			TDataAssociationResults res;
+			data_association_full_covariance(
+				z, y, y_cov, res, assocJCBB, metric, 0.99, true,
+				std::vector<prediction_index_t>(), metricMaha, 0.0, nThreads);
+			EXPECT_LT(res.nIndivCompatEvaluated, N * M / 4);
+			EXPECT_EQ(
+				res.indiv_compatibility_counts, ref.indiv_compatibility_counts);
+			EXPECT_TRUE(res.associations == ref.associations)
+				<< "nThreads=" << nThreads;
+			EXPECT_DOUBLE_EQ(res.distance, ref.distance);
+			EXPECT_GT(res.nNodesExploredInJCBB, 0u);
+			EXPECT_GT(res.nJointCompatEvaluated, 0u);
+		}
+	}
+}
@@ -0,0 +1,300 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include "slam-precomp.h"  // Precompiled headers
+
+#include "grid_correlation.h"
+#include <mrpt/core/bits_math.h>
+#include <mrpt/core/round.h>
+#include <mrpt/math/fourier.h>
+#include <mrpt/math/wrap2pi.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <thread>
+
+using namespace mrpt::slam::internal;
+using mrpt::math::CMatrixFloat;
+
+float TCorrelationGrid::interpolate(double x, double y) const
+{
+	const double fx = (x - x0) / resolution, fy = (y - y0) / resolution;
+	const int ix = static_cast<int>(std::floor(fx));
+	const int iy = static_cast<int>(std::floor(fy));
+	const float wx = static_cast<float>(fx - ix);
+	const float wy = static_cast<float>(fy - iy);
+	const int nrows = static_cast<int>(cells.rows());
+	const int ncols = static_cast<int>(cells.cols());
+	auto cell = [&](int r, int c) -> float {
+		return (r < 0 || c < 0 || r >= nrows || c >= ncols)
+				   ? 0.0f
+				   : cells.get_unsafe(r, c);
+	};
+	return (1 - wy) * ((1 - wx) * cell(iy, ix) + wx * cell(iy, ix + 1)) +
+		   wy * ((1 - wx) * cell(iy + 1, ix) + wx * cell(iy + 1, ix + 1));
+}
+
+TCorrelationGrid TCorrelationGrid::halved() const
+{
+	TCorrelationGrid g;
+	const size_t nrows = cells.rows(), ncols = cells.cols();
+	g.cells.setConstant(
+		(nrows + 1) / 2, (ncols + 1) / 2, -std::numeric_limits<float>::max());
+	for (size_t r = 0; r < nrows; r++)
+		for (size_t c = 0; c < ncols; c++)
+		{
+			float& v = g.cells.get_unsafe(r / 2, c / 2);
+			v = std::max(v, cells.get_unsafe(r, c));
+		}
+	g.x0 = x0 + 0.5 * resolution;
+	g.y0 = y0 + 0.5 * resolution;
+	g.resolution = 2 * resolution;
+	return g;
+}
+
+namespace
+{
+/** Runs `job(i)` for i in [0,N), handing out indices dynamically to
+ * `num_threads` threads */
+template <class JOB>
+void run_parallel(size_t N, unsigned int num_threads, JOB job)
+{
+	if (num_threads == 0)
+		num_threads = std::max(1U, std::thread::hardware_concurrency());
+	num_threads = static_cast<unsigned int>(std::min<size_t>(num_threads, N));
+	if (num_threads <= 1)
+	{
+		for (size_t i = 0; i < N; i++) job(i);
+		return;
+	}
+	std::atomic<size_t> next{0};
+	auto worker = [&]() {
+		for (size_t i; (i = next++) < N;) job(i);
+	};
+	std::vector<std::thread> threads;
+	for (unsigned int t = 1; t < num_threads; t++) threads.emplace_back(worker);
+	worker();
+	for (auto& t : threads) t.join();
+}
+
+/** Data of one pyramid level, shared by all the rotations */
+struct TLevel
+{
+	TCorrelationGrid g1, g2;
+	/** Side (in cells) of the rotated versions of g2 */
+	size_t side{0};
+	/** FFT size, large enough to hold all the translations without wrapping
+	 */
+	size_t fft_rows{0}, fft_cols{0};
+	/** Spectrum of g1, zero-padded to the FFT size */
+	CMatrixFloat g1_re, g1_im;
+	double g1_energy{0};
+	/** Center of g2, in its own frame */
+	double g2_cx{0}, g2_cy{0};
+
+	void setup()
+	{
+		const double res = g1.resolution;
+		const size_t rows2 = g2.cells.rows(), cols2 = g2.cells.cols();
+		g2_cx = g2.x0 + 0.5 * (cols2 - 1) * res;
+		g2_cy = g2.y0 + 0.5 * (rows2 - 1) * res;
+		side = static_cast<size_t>(std::ceil(std::hypot(rows2, cols2))) + 2;
+
+		fft_rows = mrpt::round2up(g1.cells.rows() + side - 1);
+		fft_cols = mrpt::round2up(g1.cells.cols() + side - 1);
+		CMatrixFloat padded;
+		padded.setZero(fft_rows, fft_cols);
+		padded.block(0, 0, g1.cells.rows(), g1.cells.cols()) = g1.cells;
+		mrpt::math::dft2_real(padded, g1_re, g1_im);
+		g1_energy = g1.cells.array().square().sum();
+	}
+};
+
+struct TPeak
+{
+	double corr{-std::numeric_limits<double>::max()};
+	double x{0}, y{0}, goodness{0};
+};
+
+/** Offset in [-0.5,0.5] of the maximum of a parabola through 3 points */
+double parabolic_peak(double prev, double cur, double next)
+{
+	const double den = prev - 2 * cur + next;
+	if (den >= 0) return 0;
+	return std::min(0.5, std::max(-0.5, 0.5 * (prev - next) / den));
+}
+
+TPeak correlate_rotation(const TLevel& L, const double phi)
+{
+	const double res = L.g1.resolution;
+	const double ccos = std::cos(phi), csin = std::sin(phi);
+
+	// g2 rotated by phi, in a square grid centered at the rotated center of
+	// g2, with cells aligned with those of g1:
+	const double rcx = ccos * L.g2_cx - csin * L.g2_cy;
+	const double rcy = csin * L.g2_cx + ccos * L.g2_cy;
+	const double o2x = rcx - 0.5 * (L.side - 1) * res;
+	const double o2y = rcy - 0.5 * (L.side - 1) * res;
+
+	CMatrixFloat g2rot;
+	g2rot.setZero(L.fft_rows, L.fft_cols);
+	double g2_energy = 0;
+	for (size_t r = 0; r < L.side; r++)
+	{
+		const double qy = o2y + r * res;
+		for (size_t c = 0; c < L.side; c++)
+		{
+			const double qx = o2x + c * res;
+			const float v = L.g2.interpolate(
+				ccos * qx + csin * qy, -csin * qx + ccos * qy);
+			g2rot.get_unsafe(r, c) = v;
+			g2_energy += v * v;
+		}
+	}
+
+	// Cross-correlation: IDFT( DFT(g1) * conj(DFT(g2rot)) ):
+	CMatrixFloat re, im;
+	mrpt::math::dft2_real(g2rot, re, im);
+	for (size_t r = 0; r < L.fft_rows; r++)
+		for (size_t c = 0; c < L.fft_cols; c++)
+		{
+			const float ar = L.g1_re.get_unsafe(r, c);
+			const float ai = L.g1_im.get_unsafe(r, c);
+			const float br = re.get_unsafe(r, c), bi = im.get_unsafe(r, c);
+			re.get_unsafe(r, c) = ar * br + ai * bi;
+			im.get_unsafe(r, c) = ai * br - ar * bi;
+		}
+	CMatrixFloat corr;
+	mrpt::math::idft2_real(re, im, corr);
+
+	CMatrixFloat::Index pr, pc;
+	TPeak peak;
+	peak.corr = corr.maxCoeff(&pr, &pc);
+
+	// Sub-cell refinement:
+	const size_t R = L.fft_rows, C = L.fft_cols;
+	const double sub_r = parabolic_peak(
+		corr((pr + R - 1) % R, pc), peak.corr, corr((pr + 1) % R, pc));
+	const double sub_c = parabolic_peak(
+		corr(pr, (pc + C - 1) % C), peak.corr, corr(pr, (pc + 1) % C));
+
+	// corr(dr,dc) = sum g1(r+dr,c+dc)*g2rot(r,c), with negative shifts
+	// wrapped around the end of the FFT:
+	const double dr = pr < L.g1.cells.rows() ? pr : pr - double(R);
+	const double dc = pc < L.g1.cells.cols() ? pc : pc - double(C);
+	peak.x = L.g1.x0 - o2x + (dc + sub_c) * res;
+	peak.y = L.g1.y0 - o2y + (dr + sub_r) * res;
+
+	const double norm = std::sqrt(L.g1_energy * g2_energy);
+	peak.goodness = norm > 0 ? std::max(0.0, peak.corr / norm) : 0;
+	return peak;
+}
+
+}  // namespace
+
+TGridCorrelationResult mrpt::slam::internal::correlate_grids(
+	const TCorrelationGrid& g1, const TCorrelationGrid& g2,
+	const TGridCorrelationOptions& opts)
+{
+	MRPT_START
+
+	ASSERT_ABOVE_(g1.resolution, 0);
+	ASSERT_(std::abs(g1.resolution - g2.resolution) < 1e-6 * g1.resolution);
+	ASSERT_(g1.cells.rows() > 0 && g1.cells.cols() > 0);
+	ASSERT_(g2.cells.rows() > 0 && g2.cells.cols() > 0);
+	ASSERT_ABOVE_(opts.phi_resolution, 0);
+
+	const size_t nRots = std::max<size_t>(
+		1, static_cast<size_t>(mrpt::round(2 * M_PI / opts.phi_resolution)));
+	const double phi_step = 2 * M_PI / nRots;
+	auto rot2phi = [&](size_t k) { return -M_PI + k * phi_step; };
+
+	// Build the pyramid, while grids are large enough to be meaningful:
+	std::vector<TLevel> levels(1);
+	levels[0].g1 = g1;
+	levels[0].g2 = g2;
+	while (levels.size() <= opts.pyramid_levels &&
+		   (size_t(1) << levels.size()) < nRots)
+	{
+		const TLevel& prev = levels.back();
+		if (std::min(
+				std::min(prev.g1.cells.rows(), prev.g1.cells.cols()),
+				std::min(prev.g2.cells.rows(), prev.g2.cells.cols())) < 16)
+			break;
+		TLevel next;
+		next.g1 = prev.g1.halved();
+		next.g2 = prev.g2.halved();
+		levels.emplace_back(std::move(next));
+	}
+	for (auto& L : levels) L.setup();
+
+	TGridCorrelationResult ret;
+
+	// Coarsest level: all the rotations with its step. Finer levels: only
+	// around the best candidates from the previous one.
+	const size_t top = levels.size() - 1;
+	std::set<size_t> rots;
+	for (size_t k = 0; k < nRots; k += (size_t(1) << top)) rots.insert(k);
+
+	std::vector<std::pair<size_t, TPeak>> evals;
+	for (size_t l = top + 1; l-- > 0;)
+	{
+		evals.assign(rots.size(), {0, TPeak()});
+		{
+			size_t i = 0;
+			for (const size_t k : rots) evals[i++].first = k;
+		}
+		run_parallel(evals.size(), opts.num_threads, [&](size_t i) {
+			evals[i].second =
+				correlate_rotation(levels[l], rot2phi(evals[i].first));
+		});
+		ret.nEvaluatedRotations += evals.size();
+		if (l == 0) break;
+
+		std::sort(evals.begin(), evals.end(), [](const auto& a, const auto& b) {
+			return a.second.corr > b.second.corr;
+		});
+		const size_t nCandidates = std::min<size_t>(
+			evals.size(), std::max(1U, opts.pyramid_candidates));
+		const size_t step = size_t(1) << (l - 1);
+		rots.clear();
+		for (size_t i = 0; i < nCandidates; i++)
+			for (const size_t k :
+				 {evals[i].first + nRots - step, evals[i].first,
+				  evals[i].first + step})
+				rots.insert(k % nRots);
+	}
+
+	// Best rotation, refined with its neighbors if they were evaluated:
+	const auto best = std::max_element(
+		evals.begin(), evals.end(), [](const auto& a, const auto& b) {
+			return a.second.corr < b.second.corr;
+		});
+	const size_t kBest = best->first;
+	auto corrAt = [&](size_t k) {
+		for (const auto& e : evals)
+			if (e.first == k) return e.second.corr;
+		return std::numeric_limits<double>::quiet_NaN();
+	};
+	const double cPrev = corrAt((kBest + nRots - 1) % nRots);
+	const double cNext = corrAt((kBest + 1) % nRots);
+	double sub_k = 0;
+	if (nRots > 2 && !std::isnan(cPrev) && !std::isnan(cNext))
+		sub_k = parabolic_peak(cPrev, best->second.corr, cNext);
+
+	ret.pose.x = best->second.x;
+	ret.pose.y = best->second.y;
+	ret.pose.phi = mrpt::math::wrapToPi(rot2phi(kBest) + sub_k * phi_step);
+	ret.goodness = std::min(1.0, best->second.goodness);
+	return ret;
+
+	MRPT_END
+}
@@ -0,0 +1,68 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mrpt/math/CMatrixTemplateNumeric.h>
+#include <mrpt/math/lightweight_geom_data.h>
+
+namespace mrpt::slam::internal
+{
+/** A 2D grid of "occupiedness" values, with zero mean for unknown areas (e.g.
+ * positive for occupied cells and negative for free ones), as used by
+ * correlate_grids(). Rows of `cells` go along "y", columns along "x". */
+struct TCorrelationGrid
+{
+	mrpt::math::CMatrixFloat cells;
+	/** Coordinates of the center of cell (0,0) */
+	double x0{0}, y0{0};
+	/** Cell size (meters) */
+	double resolution{0};
+
+	/** Bilinear interpolation at (x,y). Out of the grid, cells are zero. */
+	float interpolate(double x, double y) const;
+	/** Returns a grid with half the resolution, keeping the maximum of each
+	 * block of 2x2 cells (so thin obstacles are not blurred away) */
+	TCorrelationGrid halved() const;
+};
+
+struct TGridCorrelationOptions
+{
+	/** Step between the evaluated rotations (rad) */
+	double phi_resolution{mrpt::DEG2RAD(1.0)};
+	/** Number of coarser levels in the coarse-to-fine search (0: evaluate
+	 * all the rotations at the full resolution). Each level halves the grid
+	 * resolution and doubles the rotation step, and only the best rotations
+	 * of each level are refined in the next finer one. */
+	unsigned int pyramid_levels{0};
+	/** Number of candidate rotations kept between pyramid levels */
+	unsigned int pyramid_candidates{4};
+	/** Number of threads evaluating rotations (0: all hardware threads) */
+	unsigned int num_threads{0};
+};
+
+struct TGridCorrelationResult
+{
+	/** The pose of the second grid with respect to the first one */
+	mrpt::math::TPose2D pose;
+	/** Correlation peak normalized to [0,1] */
+	double goodness{0};
+	/** Number of rotations evaluated (at any pyramid level) */
+	size_t nEvaluatedRotations{0};
+};
+
+/** Finds the rigid transformation between two grids with the same resolution
+ * by maximizing their cross-correlation. For each rotation, the
+ * correlation for all the translations is obtained at once with 2D FFTs
+ * (the spectrum of the first grid is computed only once), and rotations are
+ * evaluated in parallel. */
+TGridCorrelationResult correlate_grids(
+	const TCorrelationGrid& g1, const TCorrelationGrid& g2,
+	const TGridCorrelationOptions& opts);
+
+}  // namespace mrpt::slam::internal
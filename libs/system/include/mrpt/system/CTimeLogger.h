@@ -12,6 +12,8 @@
 #include <mrpt/system/COutputLogger.h>
 #include <mrpt/core/exceptions.h>
 #include <mrpt/containers/ts_hash_map.h>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <stack>
 #include <map>
@@ -33,6 +35,15 @@ namespace mrpt::system
  * - `enter()`: average 445 ns
  * - `leave()`: average 316 ns
  *
+ * For always-on profiling, sections can be registered once with
+ * registerSection() and then timed with the enter()/leave() overloads taking
+ * the returned ID ("tracing mode"). These do not allocate nor look up names:
+ * each thread records its calls into its own lock-free buffers (merged into
+ * the logger stats when the thread finishes), with:
+ * - Log-scale histograms of durations, with percentiles, see getTraceStats().
+ * - The most recent calls, which can be exported to the Chrome trace-event
+ *   format (open with `chrome://tracing`), see saveTraceToChromeJSON().
+ *
  * \sa CTimeLoggerEntry
  *
  * \note The default behavior is dumping all the information at destruction.
@@ -65,6 +76,14 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	void do_enter(const char* func_name);
 	double do_leave(const char* func_name);
 
+	/** Sections and per-thread buffers of the tracing mode */
+	struct TraceData;
+	std::shared_ptr<TraceData> m_trace;
+
+	void do_enter(uint32_t section_id);
+	double do_leave(uint32_t section_id);
+	void do_addSectionTime(uint32_t section_id, double seconds);
+
    public:
 	/** Data of each call section: # of calls, minimum, maximum, average and
 	 * overall execution time (in seconds) \sa getStats */
@@ -74,6 +93,28 @@ class CTimeLogger : public mrpt::system::COutputLogger
 		double min_t, max_t, mean_t, total_t, last_t;
 	};
 
+	/** Identifier of a section in tracing mode \sa registerSection. A
+	 * distinct type, so calls with IDs are never mistaken for calls with
+	 * section names. */
+	enum class section_id_t : uint32_t
+	{
+	};
+
+	/** Statistics of a section in tracing mode (times in seconds). Percentiles
+	 * are estimated from a log-scale histogram, with a relative error below
+	 * 6.25%. \sa getTraceStats */
+	struct TTraceStats
+	{
+		size_t n_calls{0};
+		double min_t{0}, max_t{0}, mean_t{0}, total_t{0};
+		double p50_t{0}, p90_t{0}, p99_t{0};
+		/** Non-empty histogram bins, as pairs (bin upper limit, count) */
+		std::vector<std::pair<double, uint64_t>> histogram;
+
+		/** Estimated duration below which a fraction `p` of all calls are */
+		double percentile(double p) const;
+	};
+
 	CTimeLogger(
 		bool enabled = true,
 		const std::string& name = "");  //! Default constructor
@@ -98,7 +139,8 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	void dumpAllStats(const size_t column_width = 80) const;
 	/** Resets all stats. By default (deep_clear=false), all section names are
 	 * remembered (not freed) so the cost of creating upon the first next call
-	 * is avoided. */
+	 * is avoided. Sections registered with registerSection() are always kept.
+	 * Must not be called while other threads are within traced sections. */
 	void clear(bool deep_clear = false);
 	void enable(bool enabled = true) { m_enabled = enabled; }
 	void disable() { m_enabled = false; }
@@ -126,6 +168,53 @@ class CTimeLogger : public mrpt::system::COutputLogger
 	/** Return the last execution time of the given "section", or 0 if it hasn't
 	 * ever been called "enter" with that section name */
 	double getLastTime(const std::string& name) const;
+
+	/** \name Tracing mode
+	 * @{ */
+
+	/** Returns the ID of a section, registering it the first time. The same
+	 * name always gets the same ID. Thread-safe, but intended to be called
+	 * once per section (e.g. into a static variable), not on every call. */
+	section_id_t registerSection(const std::string& name);
+
+	/** Start of a registered section \sa registerSection */
+	inline void enter(section_id_t section_id)
+	{
+		if (m_enabled) do_enter(static_cast<uint32_t>(section_id));
+	}
+	/** End of a registered section \return The ellapsed time, in seconds or
+	 * 0 if disabled. */
+	inline double leave(section_id_t section_id)
+	{
+		return m_enabled ? do_leave(static_cast<uint32_t>(section_id)) : 0;
+	}
+
+	/** Records a call of the given duration to a registered section, ending
+	 * now, for intervals which cannot be timed with enter()/leave() from a
+	 * single thread (e.g. the time an object waits in an inter-thread queue).
+	 */
+	inline void addSectionTime(section_id_t section_id, double seconds)
+	{
+		if (m_enabled)
+			do_addSectionTime(static_cast<uint32_t>(section_id), seconds);
+	}
+
+	/** Number of recent calls (per thread) kept for saveTraceToChromeJSON().
+	 * Only affects threads which have not used this logger yet.
+	 * Default=16384. Use 0 to keep only the statistics. */
+	void setTraceBufferSize(size_t calls_per_thread);
+
+	/** Returns the statistics of all registered sections with at least one
+	 * call, from all threads. Can be called while other threads are running.
+	 */
+	void getTraceStats(std::map<std::string, TTraceStats>& out_stats) const;
+
+	/** Saves the most recent calls to registered sections, from all threads
+	 * still running, as a JSON file in the Chrome trace-event format.
+	 * \return false on any error writing the file */
+	bool saveTraceToChromeJSON(const std::string& json_file) const;
+
+	/** @} */
 };  // End of class def.
 
 /** A safe way to call enter() and leave() of a mrpt::system::CTimeLogger upon
@@ -148,9 +237,14 @@ class CTimeLogger : public mrpt::system::COutputLogger
 struct CTimeLoggerEntry
 {
 	CTimeLoggerEntry(const CTimeLogger& logger, const char* section_name);
+	/** For sections registered with CTimeLogger::registerSection() */
+	CTimeLoggerEntry(
+		const CTimeLogger& logger, CTimeLogger::section_id_t section_id);
 	~CTimeLoggerEntry();
 	CTimeLogger& m_logger;
+	/** nullptr for registered sections */
 	const char* m_section_name;
+	CTimeLogger::section_id_t m_section_id{};
 };
 
 /** @name Auxiliary stuff for the global profiler used in MRPT_START / MRPT_END
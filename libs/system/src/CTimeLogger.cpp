@@ -12,13 +12,330 @@
 #include <mrpt/system/CTimeLogger.h>
 #include <mrpt/system/string_utils.h>
 #include <mrpt/core/bits_math.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 using namespace mrpt;
 using namespace mrpt::system;
 using namespace std;
 
+namespace
+{
+/** Durations are histogrammed in log scale: 8 bins per power of 2 (exact
+ * below 16 ns), up to 2^43 ns (~2.4 hours). */
+constexpr unsigned HIST_SUBBITS = 3;
+constexpr unsigned HIST_MAX_EXP = 43;
+constexpr unsigned HIST_BINS = (HIST_MAX_EXP - HIST_SUBBITS + 1)
+							   << HIST_SUBBITS;
+
+unsigned histBin(uint64_t ns)
+{
+	if (ns < (1U << (HIST_SUBBITS + 1))) return static_cast<unsigned>(ns);
+	mrpt::keep_min(ns, (uint64_t(1) << HIST_MAX_EXP) - 1);
+	// floor(log2(ns)):
+#if defined(__GNUC__)
+	const unsigned e = 63 - __builtin_clzll(ns);
+#else
+	unsigned e = 0;
+	while ((ns >> e) > 1) e++;
+#endif
+	const unsigned m = (ns >> (e - HIST_SUBBITS)) & ((1U << HIST_SUBBITS) - 1);
+	return ((e - HIST_SUBBITS + 1) << HIST_SUBBITS) + m;
+}
+/** Returns the [lower,upper) limits of a histogram bin, in ns */
+std::pair<uint64_t, uint64_t> histBinLimits(unsigned bin)
+{
+	if (bin < (1U << (HIST_SUBBITS + 1))) return {bin, bin + 1};
+	const unsigned e = (bin >> HIST_SUBBITS) + HIST_SUBBITS - 1;
+	const uint64_t m = bin & ((1U << HIST_SUBBITS) - 1);
+	const uint64_t w = uint64_t(1) << (e - HIST_SUBBITS);
+	const uint64_t lo = ((uint64_t(1) << HIST_SUBBITS) + m) * w;
+	return {lo, lo + w};
+}
+
+/** Stats of one section in one thread. Only written by its thread, with
+ * plain loads and stores of atomics, so they can be read at any time. */
+struct TSectionCounters
+{
+	std::atomic<uint64_t> n{0}, sum_ns{0}, min_ns{0}, max_ns{0};
+	std::array<std::atomic<uint64_t>, HIST_BINS> hist{};
+
+	void add(uint64_t ns)
+	{
+		const auto r = std::memory_order_relaxed;
+		const uint64_t cnt = n.load(r);
+		if (!cnt || ns < min_ns.load(r)) min_ns.store(ns, r);
+		if (!cnt || ns > max_ns.load(r)) max_ns.store(ns, r);
+		sum_ns.store(sum_ns.load(r) + ns, r);
+		auto& h = hist[histBin(ns)];
+		h.store(h.load(r) + 1, r);
+		n.store(cnt + 1, std::memory_order_release);
+	}
+	/** Adds the stats of other counters, no longer being written */
+	void merge(const TSectionCounters& o)
+	{
+		const uint64_t on = o.n.load(std::memory_order_acquire);
+		if (!on) return;
+		const uint64_t cnt = n.load();
+		if (!cnt || o.min_ns.load() < min_ns.load()) min_ns = o.min_ns.load();
+		if (!cnt || o.max_ns.load() > max_ns.load()) max_ns = o.max_ns.load();
+		sum_ns = sum_ns.load() + o.sum_ns.load();
+		for (unsigned k = 0; k < HIST_BINS; k++)
+			hist[k] = hist[k].load() + o.hist[k].load();
+		n.store(cnt + on, std::memory_order_release);
+	}
+	void reset()
+	{
+		n = 0;
+		sum_ns = 0;
+		min_ns = 0;
+		max_ns = 0;
+		for (auto& h : hist) h = 0;
+	}
+};
+
+/** A completed call to a section */
+struct TTraceEvent
+{
+	uint64_t start_ns, dur_ns;
+	uint32_t section_id;
+};
+
+/** A TTraceEvent in a ring buffer, written by one thread and read by others
+ * (seqlock): `seq` is odd while the event `seq/2` is being written, and
+ * `2*(i+1)` once the event `i` is complete. */
+struct TTraceEventSlot
+{
+	std::atomic<uint64_t> seq{0};
+	std::atomic<uint64_t> start_ns{0}, dur_ns{0};
+	std::atomic<uint32_t> section_id{0};
+};
+
+/** Sections counters are allocated in blocks, on demand */
+constexpr size_t SECTIONS_PER_BLOCK = 64;
+constexpr size_t MAX_SECTION_BLOCKS = 1024;
+using TSectionBlock = std::array<TSectionCounters, SECTIONS_PER_BLOCK>;
+
+/** Unique ID of each logger, to tell apart the buffers of a destroyed logger
+ * from those of a new one at the same address */
+std::atomic<uint64_t> timelogger_next_serial{1};
+
+/** The data of one thread in one logger. All members but those in the
+ * "shared" group are only accessed from its thread. */
+struct ThreadTraceBuffer
+{
+	/** One more event than requested is allocated, for the one being
+	 * written while others are read. */
+	explicit ThreadTraceBuffer(size_t capacity)
+		: events(capacity ? capacity + 1 : 0)
+	{
+	}
+
+	uint32_t thread_index{0};
+	/** Open calls: (section, start time) */
+	std::vector<std::pair<uint32_t, uint64_t>> open_calls;
+
+	// shared:
+	/** Ring buffer of the last events. The next one goes at `head` (modulo
+	 * capacity). */
+	std::vector<TTraceEventSlot> events;
+	std::atomic<uint64_t> head{0};
+	std::array<std::atomic<TSectionBlock*>, MAX_SECTION_BLOCKS> blocks{};
+
+	~ThreadTraceBuffer()
+	{
+		for (auto& b : blocks) delete b.load();
+	}
+
+	TSectionCounters& counters(uint32_t id)
+	{
+		auto& b = blocks[id / SECTIONS_PER_BLOCK];
+		TSectionBlock* blk = b.load(std::memory_order_acquire);
+		if (!blk)
+		{
+			blk = new TSectionBlock();
+			b.store(blk, std::memory_order_release);
+		}
+		return (*blk)[id % SECTIONS_PER_BLOCK];
+	}
+
+	/** Records a finished call. Only called from the owner thread. */
+	void add(uint32_t id, uint64_t start_ns, uint64_t dur_ns)
+	{
+		counters(id).add(dur_ns);
+
+		const size_t cap = events.size();
+		if (!cap) return;
+		const uint64_t h = head.load(std::memory_order_relaxed);
+		auto& ev = events[h % cap];
+		ev.seq.store(2 * h + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		ev.start_ns.store(start_ns, std::memory_order_relaxed);
+		ev.dur_ns.store(dur_ns, std::memory_order_relaxed);
+		ev.section_id.store(id, std::memory_order_relaxed);
+		ev.seq.store(2 * h + 2, std::memory_order_release);
+		head.store(h + 1, std::memory_order_release);
+	}
+
+	/** Adds the counters of the buffer of a finished thread */
+	void mergeCounters(const ThreadTraceBuffer& o)
+	{
+		for (size_t b = 0; b < MAX_SECTION_BLOCKS; b++)
+		{
+			const TSectionBlock* oblk = o.blocks[b].load();
+			if (!oblk) continue;
+			for (size_t i = 0; i < SECTIONS_PER_BLOCK; i++)
+				counters(b * SECTIONS_PER_BLOCK + i).merge((*oblk)[i]);
+		}
+	}
+};
+}  // namespace
+
+struct CTimeLogger::TraceData
+	: public std::enable_shared_from_this<CTimeLogger::TraceData>
+{
+	const uint64_t serial{timelogger_next_serial++};
+	const std::chrono::steady_clock::time_point t0{
+		std::chrono::steady_clock::now()};
+	size_t buffer_size{16384};
+
+	mutable std::mutex mtx;
+	std::vector<std::string> section_names;
+	std::unordered_map<std::string, uint32_t> section_ids;
+	/** section_names.size(), to range-check IDs without locking */
+	std::atomic<uint32_t> num_sections{0};
+	std::vector<std::unique_ptr<ThreadTraceBuffer>> threads;
+	std::unordered_map<std::thread::id, ThreadTraceBuffer*> thread_buffers;
+	/** Stats of finished threads (no events), also in `threads` */
+	ThreadTraceBuffer* finished_threads{nullptr};
+
+	uint64_t now_ns() const
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				   std::chrono::steady_clock::now() - t0)
+			.count();
+	}
+
+	/** Merges the stats of the buffers of each thread into its loggers
+	 * when the thread finishes, and frees them */
+	struct ThreadExitHook
+	{
+		std::vector<std::pair<std::weak_ptr<TraceData>, ThreadTraceBuffer*>>
+			buffers;
+		~ThreadExitHook()
+		{
+			for (const auto& b : buffers)
+				if (auto T = b.first.lock()) T->releaseThreadBuffer(b.second);
+		}
+	};
+
+	/** The buffer of the calling thread, created upon first use */
+	ThreadTraceBuffer& threadBuffer()
+	{
+		// Small per-thread cache of (logger serial, buffer):
+		struct TCacheEntry
+		{
+			uint64_t serial{0};
+			ThreadTraceBuffer* buf{nullptr};
+		};
+		static thread_local std::array<TCacheEntry, 4> cache;
+		for (const auto& c : cache)
+			if (c.serial == serial) return *c.buf;
+
+		// Not cached: look it up, or create it.
+		ThreadTraceBuffer* buf;
+		bool created = false;
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			auto& b = thread_buffers[std::this_thread::get_id()];
+			if (!b)
+			{
+				threads.emplace_back(new ThreadTraceBuffer(buffer_size));
+				b = threads.back().get();
+				b->thread_index = threads.size();
+				created = true;
+			}
+			buf = b;
+		}
+		if (created)
+		{
+			static thread_local ThreadExitHook hook;
+			auto& hb = hook.buffers;
+			hb.erase(
+				std::remove_if(
+					hb.begin(), hb.end(),
+					[](const auto& e) { return e.first.expired(); }),
+				hb.end());
+			hb.emplace_back(shared_from_this(), buf);
+		}
+		// Replace the oldest cache entry:
+		std::rotate(cache.rbegin(), cache.rbegin() + 1, cache.rend());
+		cache[0].serial = serial;
+		cache[0].buf = buf;
+		return *buf;
+	}
+
+	/** Called from a thread when it finishes */
+	void releaseThreadBuffer(ThreadTraceBuffer* buf)
+	{
+		std::lock_guard<std::mutex> lck(mtx);
+		if (!finished_threads)
+		{
+			threads.emplace_back(new ThreadTraceBuffer(0));
+			finished_threads = threads.back().get();
+		}
+		finished_threads->mergeCounters(*buf);
+		thread_buffers.erase(std::this_thread::get_id());
+		threads.erase(std::find_if(
+			threads.begin(), threads.end(),
+			[buf](const auto& t) { return t.get() == buf; }));
+	}
+
+	/** Copies keep the registered section names (with the same IDs), not
+	 * the stats or events. */
+	void copySectionsFrom(const TraceData& o)
+	{
+		std::lock_guard<std::mutex> lck(o.mtx);
+		section_names = o.section_names;
+		section_ids = o.section_ids;
+		num_sections = static_cast<uint32_t>(section_names.size());
+		buffer_size = o.buffer_size;
+	}
+
+	/** Copies the events of a thread which are not being overwritten */
+	static std::vector<TTraceEvent> snapshotEvents(const ThreadTraceBuffer& b)
+	{
+		std::vector<TTraceEvent> out;
+		const uint64_t cap = b.events.size();
+		if (!cap) return out;
+		const uint64_t h1 = b.head.load(std::memory_order_acquire);
+		const uint64_t first = h1 > cap - 1 ? h1 - (cap - 1) : 0;
+		out.reserve(h1 - first);
+		for (uint64_t i = first; i < h1; i++)
+		{
+			// Skip events the thread is overwriting, or has overwritten:
+			const auto& slot = b.events[i % cap];
+			const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+			if (seq != 2 * i + 2) continue;
+			TTraceEvent ev;
+			ev.start_ns = slot.start_ns.load(std::memory_order_relaxed);
+			ev.dur_ns = slot.dur_ns.load(std::memory_order_relaxed);
+			ev.section_id = slot.section_id.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.seq.load(std::memory_order_relaxed) != seq) continue;
+			out.push_back(ev);
+		}
+		return out;
+	}
+};
+
 struct MyGlobalProfiler : public mrpt::system::CTimeLogger
 {
 	MyGlobalProfiler() : mrpt::system::CTimeLogger("MRPT_global_profiler") {}
@@ -54,7 +371,11 @@ void global_profiler_leave(const char* func_name) noexcept
 
 CTimeLogger::CTimeLogger(
 	bool enabled /*=true*/, const std::string& name /*=""*/)
-	: COutputLogger("CTimeLogger"), m_tictac(), m_enabled(enabled), m_name(name)
+	: COutputLogger("CTimeLogger"),
+	  m_tictac(),
+	  m_enabled(enabled),
+	  m_name(name),
+	  m_trace(new TraceData)
 {
 	m_tictac.Tic();
 }
@@ -62,16 +383,23 @@ CTimeLogger::CTimeLogger(
 CTimeLogger::~CTimeLogger()
 {
 	// Dump all stats:
-	if (!m_data.empty())  // If logging is disabled, do nothing...
-		dumpAllStats();
+	bool any_trace = false;
+	{
+		std::lock_guard<std::mutex> lck(m_trace->mtx);
+		any_trace = !m_trace->threads.empty();
+	}
+	// If logging is disabled, do nothing...
+	if (!m_data.empty() || any_trace) dumpAllStats();
 }
 
 CTimeLogger::CTimeLogger(const CTimeLogger& o)
 	: COutputLogger(o),
 	  m_enabled(o.m_enabled),
 	  m_name(o.m_name),
-	  m_data(o.m_data)
+	  m_data(o.m_data),
+	  m_trace(new TraceData)
 {
+	m_trace->copySectionsFrom(*o.m_trace);
 }
 CTimeLogger& CTimeLogger::operator=(const CTimeLogger& o)
 {
@@ -79,14 +407,21 @@ CTimeLogger& CTimeLogger::operator=(const CTimeLogger& o)
 	m_enabled = o.m_enabled;
 	m_name = o.m_name;
 	m_data = o.m_data;
+	if (this != &o)
+	{
+		m_trace.reset(new TraceData);
+		m_trace->copySectionsFrom(*o.m_trace);
+	}
 	return *this;
 }
 CTimeLogger::CTimeLogger(CTimeLogger&& o)
 	: COutputLogger(o),
 	  m_enabled(o.m_enabled),
 	  m_name(o.m_name),
-	  m_data(o.m_data)
+	  m_data(o.m_data),
+	  m_trace(new TraceData)
 {
+	m_trace->copySectionsFrom(*o.m_trace);
 }
 CTimeLogger& CTimeLogger::operator=(CTimeLogger&& o)
 {
@@ -94,6 +429,11 @@ CTimeLogger& CTimeLogger::operator=(CTimeLogger&& o)
 	m_enabled = o.m_enabled;
 	m_name = o.m_name;
 	m_data = o.m_data;
+	if (this != &o)
+	{
+		m_trace.reset(new TraceData);
+		m_trace->copySectionsFrom(*o.m_trace);
+	}
 	return *this;
 }
 
@@ -105,6 +445,15 @@ void CTimeLogger::clear(bool deep_clear)
 	{
 		for (auto& e : m_data) e.second = TCallData();
 	}
+
+	std::lock_guard<std::mutex> lck(m_trace->mtx);
+	for (auto& t : m_trace->threads)
+	{
+		t->head = 0;
+		for (auto& b : t->blocks)
+			if (auto* blk = b.load())
+				for (auto& c : *blk) c.reset();
+	}
 }
 
 std::string aux_format_string_multilines(const std::string& s, const size_t len)
@@ -132,6 +481,20 @@ void CTimeLogger::getStats(std::map<std::string, TCallStats>& out_stats) const
 		cs.n_calls = e.second.n_calls;
 		cs.last_t = e.second.last_t;
 	}
+
+	// Sections in tracing mode:
+	std::map<std::string, TTraceStats> trace_stats;
+	getTraceStats(trace_stats);
+	for (const auto& e : trace_stats)
+	{
+		TCallStats& cs = out_stats[e.first];
+		cs.min_t = e.second.min_t;
+		cs.max_t = e.second.max_t;
+		cs.total_t = e.second.total_t;
+		cs.mean_t = e.second.mean_t;
+		cs.n_calls = e.second.n_calls;
+		cs.last_t = 0;
+	}
 }
 
 std::string CTimeLogger::getStatsAsText(const size_t column_width) const
@@ -183,6 +546,26 @@ std::string CTimeLogger::getStatsAsText(const size_t column_width) const
 			i.second.has_time_units ? 's' : ' ');
 	}
 
+	// Sections in tracing mode:
+	std::map<std::string, TTraceStats> trace_stats;
+	getTraceStats(trace_stats);
+	for (const auto& i : trace_stats)
+	{
+		stats_text += format(
+			"%s %7u %6ss %6ss %6ss %6ss\n",
+			aux_format_string_multilines(i.first, 39).c_str(),
+			static_cast<unsigned int>(i.second.n_calls),
+			unitsFormat(i.second.min_t, 1, false).c_str(),
+			unitsFormat(i.second.mean_t, 1, false).c_str(),
+			unitsFormat(i.second.max_t, 1, false).c_str(),
+			unitsFormat(i.second.total_t, 1, false).c_str());
+		stats_text += format(
+			"%39s  p50=%ss p90=%ss p99=%ss\n", "",
+			unitsFormat(i.second.p50_t, 1, false).c_str(),
+			unitsFormat(i.second.p90_t, 1, false).c_str(),
+			unitsFormat(i.second.p99_t, 1, false).c_str());
+	}
+
 	std::string footer(top_header);
 	stats_text += footer + "\n";
 
@@ -202,6 +585,15 @@ void CTimeLogger::saveToCSVFile(const std::string& csv_file) const
 			i.second.n_calls ? i.second.mean_t / i.second.n_calls : 0,
 			i.second.max_t, i.second.mean_t);
 	}
+	std::map<std::string, TTraceStats> trace_stats;
+	getTraceStats(trace_stats);
+	for (const auto& i : trace_stats)
+	{
+		s += format(
+			"\"%s\",\"%7u\",\"%e\",\"%e\",\"%e\",\"%e\",\"%e\"\n",
+			i.first.c_str(), static_cast<unsigned int>(i.second.n_calls), 0.0,
+			i.second.min_t, i.second.mean_t, i.second.max_t, i.second.total_t);
+	}
 	std::ofstream(csv_file) << s;
 }
 
@@ -293,10 +685,193 @@ double CTimeLogger::getLastTime(const std::string& name) const
 		return it->second.last_t;
 }
 
+CTimeLogger::section_id_t CTimeLogger::registerSection(const std::string& name)
+{
+	auto& T = *m_trace;
+	std::lock_guard<std::mutex> lck(T.mtx);
+	const auto it = T.section_ids.find(name);
+	if (it != T.section_ids.end()) return section_id_t(it->second);
+
+	ASSERT_BELOW_(
+		T.section_names.size(), SECTIONS_PER_BLOCK * MAX_SECTION_BLOCKS);
+	const auto id = static_cast<uint32_t>(T.section_names.size());
+	T.section_names.push_back(name);
+	T.section_ids[name] = id;
+	T.num_sections.store(id + 1, std::memory_order_release);
+	return section_id_t(id);
+}
+
+void CTimeLogger::do_enter(uint32_t section_id)
+{
+	ASSERT_BELOW_(
+		section_id, m_trace->num_sections.load(std::memory_order_acquire));
+	auto& buf = m_trace->threadBuffer();
+	buf.open_calls.emplace_back(section_id, m_trace->now_ns());
+}
+
+double CTimeLogger::do_leave(uint32_t section_id)
+{
+	const uint64_t t = m_trace->now_ns();
+	auto& buf = m_trace->threadBuffer();
+
+	// Normally, the last open call. Search backwards for mismatched ones:
+	auto it = buf.open_calls.rbegin();
+	while (it != buf.open_calls.rend() && it->first != section_id) ++it;
+	if (it == buf.open_calls.rend()) return 0;  // This shouldn't happen!
+	const uint64_t t0 = it->second;
+	buf.open_calls.erase(std::next(it).base());
+
+	const uint64_t dur = t - t0;
+	buf.add(section_id, t0, dur);
+	return dur * 1e-9;
+}
+
+void CTimeLogger::do_addSectionTime(uint32_t section_id, double seconds)
+{
+	ASSERT_BELOW_(
+		section_id, m_trace->num_sections.load(std::memory_order_acquire));
+	const uint64_t t = m_trace->now_ns();
+	const auto dur = static_cast<uint64_t>(std::max(0.0, seconds) * 1e9);
+	m_trace->threadBuffer().add(section_id, t > dur ? t - dur : 0, dur);
+}
+
+void CTimeLogger::setTraceBufferSize(size_t calls_per_thread)
+{
+	std::lock_guard<std::mutex> lck(m_trace->mtx);
+	m_trace->buffer_size = calls_per_thread;
+}
+
+double CTimeLogger::TTraceStats::percentile(double p) const
+{
+	if (!n_calls || histogram.empty()) return 0;
+	const double target = mrpt::saturate_val(p, 0.0, 1.0) * n_calls;
+	double accum = 0, prev_upper = 0;
+	for (const auto& bin : histogram)
+	{
+		const double cnt = static_cast<double>(bin.second);
+		if (accum + cnt >= target)
+		{
+			// Interpolate within the bin, limited to the actual min/max:
+			const double lo = std::max(prev_upper, min_t);
+			const double hi = std::min(bin.first, max_t);
+			const double f = cnt > 0 ? (target - accum) / cnt : 0;
+			return lo + std::max(0.0, hi - lo) * f;
+		}
+		accum += cnt;
+		prev_upper = bin.first;
+	}
+	return max_t;
+}
+
+void CTimeLogger::getTraceStats(
+	std::map<std::string, TTraceStats>& out_stats) const
+{
+	out_stats.clear();
+
+	const auto& T = *m_trace;
+	std::lock_guard<std::mutex> lck(T.mtx);
+	std::vector<uint64_t> hist(HIST_BINS);
+	for (size_t id = 0; id < T.section_names.size(); id++)
+	{
+		const auto b = id / SECTIONS_PER_BLOCK, i = id % SECTIONS_PER_BLOCK;
+		uint64_t n = 0, sum = 0, mn = 0, mx = 0;
+		std::fill(hist.begin(), hist.end(), 0);
+		for (const auto& t : T.threads)
+		{
+			const TSectionBlock* blk =
+				t->blocks[b].load(std::memory_order_acquire);
+			if (!blk) continue;
+			const TSectionCounters& c = (*blk)[i];
+			const uint64_t cn = c.n.load(std::memory_order_acquire);
+			if (!cn) continue;
+			const uint64_t cmin = c.min_ns.load(), cmax = c.max_ns.load();
+			mn = n ? std::min(mn, cmin) : cmin;
+			mx = n ? std::max(mx, cmax) : cmax;
+			n += cn;
+			sum += c.sum_ns.load();
+			for (unsigned k = 0; k < HIST_BINS; k++)
+				hist[k] += c.hist[k].load();
+		}
+		if (!n) continue;
+
+		TTraceStats& st = out_stats[T.section_names[id]];
+		st.n_calls = n;
+		st.min_t = mn * 1e-9;
+		st.max_t = mx * 1e-9;
+		st.total_t = sum * 1e-9;
+		st.mean_t = st.total_t / n;
+		for (unsigned k = 0; k < HIST_BINS; k++)
+			if (hist[k])
+				st.histogram.emplace_back(
+					histBinLimits(k).second * 1e-9, hist[k]);
+		st.p50_t = st.percentile(0.50);
+		st.p90_t = st.percentile(0.90);
+		st.p99_t = st.percentile(0.99);
+	}
+}
+
+bool CTimeLogger::saveTraceToChromeJSON(const std::string& json_file) const
+{
+	std::ofstream f(json_file);
+	if (!f.is_open()) return false;
+
+	const auto& T = *m_trace;
+	std::lock_guard<std::mutex> lck(T.mtx);
+
+	// Escape names as JSON strings:
+	std::vector<std::string> names;
+	for (const auto& name : T.section_names)
+	{
+		std::string e;
+		for (const char c : name)
+		{
+			if (c == '"' || c == '\\')
+				e += std::string("\\") + c;
+			else if (static_cast<unsigned char>(c) < 0x20)
+				e += format("\\u%04x", static_cast<unsigned int>(c));
+			else
+				e += c;
+		}
+		names.push_back(e);
+	}
+
+	f << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	for (const auto& t : T.threads)
+	{
+		for (const auto& ev : TraceData::snapshotEvents(*t))
+		{
+			f << (first ? "\n" : ",\n")
+			  << format(
+					 "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+					 "\"ts\":%.3f,\"dur\":%.3f}",
+					 names[ev.section_id].c_str(), t->thread_index,
+					 ev.start_ns * 1e-3, ev.dur_ns * 1e-3);
+			first = false;
+		}
+	}
+	f << "\n]}\n";
+	return f.good();
+}
+
 CTimeLoggerEntry::CTimeLoggerEntry(
 	const CTimeLogger& logger, const char* section_name)
 	: m_logger(const_cast<CTimeLogger&>(logger)), m_section_name(section_name)
 {
 	m_logger.enter(m_section_name);
 }
-CTimeLoggerEntry::~CTimeLoggerEntry() { m_logger.leave(m_section_name); }
+CTimeLoggerEntry::CTimeLoggerEntry(
+	const CTimeLogger& logger, CTimeLogger::section_id_t section_id)
+	: m_logger(const_cast<CTimeLogger&>(logger)),
+	  m_section_name(nullptr),
+	  m_section_id(section_id)
+{
+	m_logger.enter(m_section_id);
+}
+CTimeLoggerEntry::~CTimeLoggerEntry()
+{
+	if (m_section_name)
+		m_logger.leave(m_section_name);
+	else
+		m_logger.leave(m_section_id);
+}
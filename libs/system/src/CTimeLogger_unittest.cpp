@@ -0,0 +1,206 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/system/CTimeLogger.h>
+#include <mrpt/system/filesystem.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using mrpt::system::CTimeLogger;
+using mrpt::system::CTimeLoggerEntry;
+
+TEST(CTimeLogger, tracing_multithread)
+{
+	CTimeLogger tl(true /*enabled*/);
+	tl.setMinLoggingLevel(mrpt::system::LVL_ERROR);  // no dump at dtor
+
+	const auto id_outer = tl.registerSection("outer");
+	const auto id_inner = tl.registerSection("inner");
+	EXPECT_NE(id_outer, id_inner);
+	EXPECT_EQ(tl.registerSection("outer"), id_outer);
+	// Not registered:
+	EXPECT_THROW(tl.enter(CTimeLogger::section_id_t(2)), std::exception);
+
+	const int nThreads = 4, nCalls = 1000;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < nThreads; t++)
+		threads.emplace_back([&]() {
+			for (int i = 0; i < nCalls; i++)
+			{
+				CTimeLoggerEntry tle(tl, id_outer);
+				tl.enter(id_inner);
+				tl.leave(id_inner);
+			}
+		});
+	for (auto& t : threads) t.join();
+
+	std::map<std::string, CTimeLogger::TTraceStats> stats;
+	tl.getTraceStats(stats);
+	ASSERT_EQ(stats.size(), 2U);
+	for (const auto& s : stats)
+	{
+		const auto& st = s.second;
+		EXPECT_EQ(st.n_calls, size_t(nThreads * nCalls));
+		EXPECT_LE(st.min_t, st.p50_t);
+		EXPECT_LE(st.p50_t, st.p90_t);
+		EXPECT_LE(st.p90_t, st.p99_t);
+		EXPECT_LE(st.p99_t, st.max_t);
+		EXPECT_NEAR(st.mean_t * st.n_calls, st.total_t, 1e-9);
+		uint64_t n = 0;
+		for (const auto& bin : st.histogram) n += bin.second;
+		EXPECT_EQ(n, st.n_calls);
+	}
+	EXPECT_GE(stats["outer"].total_t, stats["inner"].total_t);
+
+	// Also reported together with the old-style sections:
+	std::map<std::string, CTimeLogger::TCallStats> call_stats;
+	tl.getStats(call_stats);
+	EXPECT_EQ(call_stats["inner"].n_calls, size_t(nThreads * nCalls));
+
+	tl.clear();
+	tl.getTraceStats(stats);
+	EXPECT_TRUE(stats.empty());
+}
+
+TEST(CTimeLogger, tracing_percentiles)
+{
+	CTimeLogger::TTraceStats st;
+	st.n_calls = 100;
+	st.min_t = 1.0;
+	st.max_t = 4.0;
+	st.histogram = {{2.0, 50}, {4.0, 50}};
+	EXPECT_NEAR(st.percentile(0.0), 1.0, 1e-9);
+	EXPECT_NEAR(st.percentile(0.5), 2.0, 1e-9);
+	EXPECT_NEAR(st.percentile(0.75), 3.0, 1e-9);
+	EXPECT_NEAR(st.percentile(1.0), 4.0, 1e-9);
+}
+
+TEST(CTimeLogger, tracing_chrome_json)
+{
+	CTimeLogger tl(true /*enabled*/);
+	tl.setMinLoggingLevel(mrpt::system::LVL_ERROR);  // no dump at dtor
+	tl.setTraceBufferSize(10);
+
+	const auto id = tl.registerSection("a \"quoted\" name");
+	for (int i = 0; i < 25; i++)
+	{
+		tl.enter(id);
+		tl.leave(id);
+	}
+	// Disabled loggers record nothing:
+	tl.disable();
+	tl.enter(id);
+	EXPECT_EQ(tl.leave(id), 0.0);
+
+	const std::string fil = mrpt::system::getTempFileName();
+	ASSERT_TRUE(tl.saveTraceToChromeJSON(fil));
+	std::stringstream ss;
+	ss << std::ifstream(fil).rdbuf();
+	const std::string json = ss.str();
+	mrpt::system::deleteFile(fil);
+
+	// Only the last 10 calls are kept:
+	size_t nEvents = 0;
+	for (size_t p = 0; (p = json.find("\"ph\":\"X\"", p)) != std::string::npos;
+		 p++)
+		nEvents++;
+	EXPECT_EQ(nEvents, 10U);
+	EXPECT_NE(json.find("\"traceEvents\":["), std::string::npos);
+	EXPECT_NE(json.find("a \\\"quoted\\\" name"), std::string::npos);
+
+	std::map<std::string, CTimeLogger::TTraceStats> stats;
+	tl.getTraceStats(stats);
+	EXPECT_EQ(stats["a \"quoted\" name"].n_calls, 25U);
+}
+
+TEST(CTimeLogger, tracing_addSectionTime)
+{
+	CTimeLogger tl(true /*enabled*/);
+	tl.setMinLoggingLevel(mrpt::system::LVL_ERROR);  // no dump at dtor
+
+	const auto id = tl.registerSection("wait");
+	tl.addSectionTime(id, 1e-3);
+	tl.addSectionTime(id, 3e-3);
+
+	std::map<std::string, CTimeLogger::TTraceStats> stats;
+	tl.getTraceStats(stats);
+	const auto& st = stats["wait"];
+	EXPECT_EQ(st.n_calls, 2U);
+	EXPECT_NEAR(st.min_t, 1e-3, 1e-9);
+	EXPECT_NEAR(st.max_t, 3e-3, 1e-9);
+	EXPECT_NEAR(st.total_t, 4e-3, 1e-9);
+}
+
+TEST(CTimeLogger, tracing_many_loggers_per_thread)
+{
+	// More loggers than entries in the per-thread cache, with nested calls:
+	const size_t nLoggers = 10;
+	std::vector<CTimeLogger> tls(nLoggers);
+	std::vector<CTimeLogger::section_id_t> ids;
+	for (auto& tl : tls)
+	{
+		tl.setMinLoggingLevel(mrpt::system::LVL_ERROR);  // no dump at dtor
+		ids.push_back(tl.registerSection("s"));
+	}
+	for (int rep = 0; rep < 3; rep++)
+	{
+		for (size_t i = 0; i < nLoggers; i++) tls[i].enter(ids[i]);
+		for (size_t i = nLoggers; i-- > 0;) tls[i].leave(ids[i]);
+	}
+	for (const auto& tl : tls)
+	{
+		std::map<std::string, CTimeLogger::TTraceStats> stats;
+		tl.getTraceStats(stats);
+		EXPECT_EQ(stats["s"].n_calls, 3U);
+	}
+}
+
+TEST(CTimeLogger, tracing_finished_threads)
+{
+	CTimeLogger tl(true /*enabled*/);
+	tl.setMinLoggingLevel(mrpt::system::LVL_ERROR);  // no dump at dtor
+	const auto id = tl.registerSection("s");
+
+	// Short-lived threads: their stats are kept after they finish.
+	const int nThreads = 50, nCalls = 3;
+	for (int t = 0; t < nThreads; t++)
+	{
+		std::thread th([&]() {
+			for (int i = 0; i < nCalls; i++)
+			{
+				tl.enter(id);
+				tl.leave(id);
+			}
+		});
+		th.join();
+	}
+	std::map<std::string, CTimeLogger::TTraceStats> stats;
+	tl.getTraceStats(stats);
+	EXPECT_EQ(stats["s"].n_calls, size_t(nThreads * nCalls));
+
+	// Threads finishing after the logger is destroyed:
+	auto tl2 = std::make_unique<CTimeLogger>();
+	tl2->setMinLoggingLevel(mrpt::system::LVL_ERROR);
+	const auto id2 = tl2->registerSection("s");
+	std::atomic<bool> used{false}, destroyed{false};
+	std::thread th([&]() {
+		tl2->enter(id2);
+		tl2->leave(id2);
+		used = true;
+		while (!destroyed) std::this_thread::yield();
+	});
+	while (!used) std::this_thread::yield();
+	tl2.reset();
+	destroyed = true;
+	th.join();
+}
@@ -107,6 +107,21 @@ struct TSE2RobustParams
 	 * threshold. Special value "0" means "auto", which employs
 	 * "2*normalizationStd". */
 	double max_rmse_to_end{0};
+	/** Stop searching for solutions when one consensus set contains at least
+	 * this ratio (0,1] of the (different) correspondences. Special value "0"
+	 * (default) disables this test. */
+	double min_inliers_ratio_to_end{0};
+	/** (Default=false) If true, landmarks with exactly the same coordinates
+	 * (e.g. visual features with different descriptors) are considered as
+	 * one single landmark, so they are not paired twice in one consensus set.
+	 */
+	bool ransac_detectDuplicatedLandmarks{false};
+	/** Number of threads to evaluate RANSAC hypotheses. (Default=1). "0"
+	 * means one per hardware thread. Results do not depend on this value,
+	 * only on the state of mrpt::random::getRandomGenerator() at call time.
+	 * If not "1", `user_individual_compat_callback` must be thread-safe.
+	 * Ignored (always 1) if `ransac_algorithmForLandmarks`=false. */
+	unsigned int num_threads{1};
 	/** (Default=false) */
 	bool verbose{false};
 
@@ -176,6 +191,11 @@ struct TSE2RobustResult
  * `in_correspondences.size()` to make sure that every correspondence is tested
  * for each random permutation.
  *
+ * Hypotheses can be evaluated in parallel (see
+ * TSE2RobustParams::num_threads), each one with its own random stream, and
+ * duplicated modes in the output SoG are detected with a hash table of the
+ * correspondences in each consensus set.
+ *
  * \return True upon success, false if no subset was found with the minimum
  * number of correspondences.
  * \note [New in MRPT 1.3.0] This function replaces
@@ -83,6 +83,15 @@ struct TSE3RobustParams
 	double ransac_threshold_scale{0.03};
 	/** (Default=true)  */
 	bool forceScaleToUnity{true};
+	/** Stop searching for solutions when one consensus set contains at least
+	 * this ratio (0,1] of the input correspondences. Special value "0"
+	 * (default) disables this test. */
+	double min_inliers_ratio_to_end{0};
+	/** Number of threads to evaluate RANSAC hypotheses. (Default=1). "0"
+	 * means one per hardware thread. Results do not depend on this value,
+	 * only on the state of mrpt::random::getRandomGenerator() at call time.
+	 * If not "1", `user_individual_compat_callback` must be thread-safe. */
+	unsigned int num_threads{1};
 	/** (Default=false) */
 	bool verbose{false};
 
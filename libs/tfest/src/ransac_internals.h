@@ -0,0 +1,154 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mrpt/random/RandomGenerators.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mrpt::tfest::internal
+{
+/** Seed of the independent random stream of the `iter`-th RANSAC hypothesis
+ * (splitmix64 finalizer, so consecutive iterations get unrelated seeds) */
+inline uint32_t ransac_iter_seed(uint64_t base_seed, size_t iter)
+{
+	uint64_t z = base_seed + 0x9E3779B97F4A7C15ULL * (iter + 1);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return static_cast<uint32_t>(z ^ (z >> 31));
+}
+
+/** Resolves a user-given number of threads: 0 means all hardware threads */
+inline unsigned int ransac_num_threads(unsigned int num_threads)
+{
+	if (num_threads == 0)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	return num_threads;
+}
+
+/** Generic multi-threaded RANSAC loop, shared by all the robust estimators
+ * in mrpt::tfest.
+ *
+ * Hypotheses are generated in parallel by `num_threads` threads with
+ * `generate(iter, rng, scratch, hyp)`, where `rng` has been seeded with an
+ * independent stream for each hypothesis index (see ransac_iter_seed()) and
+ * `scratch` is a per-thread working area. Generated hypotheses are then
+ * passed to `consume(iter, hyp, max_iters)` strictly in increasing order of
+ * `iter` and from one thread at a time, so the final result only depends on
+ * `base_seed` and not on the number of threads or their scheduling.
+ *
+ * `consume` may change `max_iters` (adaptive number of iterations) and must
+ * return false to end the search (early termination).
+ *
+ * \return The number of consumed hypotheses.
+ */
+template <class HYP, class SCRATCH, class GENERATE, class CONSUME>
+size_t run_ransac(
+	size_t max_iters, unsigned int num_threads, uint64_t base_seed,
+	GENERATE&& generate, CONSUME&& consume)
+{
+	num_threads = ransac_num_threads(num_threads);
+
+	if (num_threads == 1)
+	{
+		mrpt::random::CRandomGenerator rng;
+		SCRATCH scratch;
+		HYP hyp;
+		size_t iter = 0;
+		while (iter < max_iters)
+		{
+			rng.randomize(ransac_iter_seed(base_seed, iter));
+			generate(iter, rng, scratch, hyp);
+			const bool go_on = consume(iter, hyp, max_iters);
+			iter++;
+			if (!go_on) break;
+		}
+		return iter;
+	}
+
+	// All the shared state is protected by `mtx`. Hypotheses generated out
+	// of order wait in `pending` for their turn to be consumed.
+	std::mutex mtx;
+	std::condition_variable cv;
+	std::map<size_t, HYP> pending;
+	size_t next_iter = 0, next_to_consume = 0;
+	bool stop = false;
+	// First exception thrown by any thread, rethrown at the end:
+	std::exception_ptr error;
+
+	auto worker_loop = [&]() {
+		mrpt::random::CRandomGenerator rng;
+		SCRATCH scratch;
+		std::unique_lock<std::mutex> lck(mtx);
+		for (;;)
+		{
+			// Wait if there is nothing to do now, but `max_iters` may still
+			// grow after consuming the hypotheses being generated:
+			cv.wait(lck, [&]() {
+				return stop || next_iter < max_iters ||
+					   next_to_consume == next_iter;
+			});
+			if (stop || next_iter >= max_iters) break;
+			const size_t iter = next_iter++;
+			lck.unlock();
+
+			HYP hyp;
+			rng.randomize(ransac_iter_seed(base_seed, iter));
+			generate(iter, rng, scratch, hyp);
+
+			lck.lock();
+			if (stop) break;
+			pending.emplace(iter, std::move(hyp));
+			for (auto it = pending.begin();
+				 it != pending.end() && it->first == next_to_consume;
+				 it = pending.erase(it))
+			{
+				const bool go_on = consume(it->first, it->second, max_iters);
+				next_to_consume++;
+				if (!go_on || next_to_consume >= max_iters)
+				{
+					stop = true;
+					break;
+				}
+			}
+			cv.notify_all();
+		}
+	};
+	auto worker = [&]() {
+		try
+		{
+			worker_loop();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+			if (!error) error = std::current_exception();
+			stop = true;
+		}
+		cv.notify_all();
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned int i = 1; i < num_threads; i++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& t : threads) t.join();
+	if (error) std::rethrow_exception(error);
+
+	return next_to_consume;
+}
+
+}  // namespace mrpt::tfest::internal
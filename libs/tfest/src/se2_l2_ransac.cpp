@@ -17,6 +17,9 @@
 #include <mrpt/math/distributions.h>
 #include <mrpt/system/CTimeLogger.h>
 #include <iostream>
+#include <array>
+#include <unordered_map>
+#include "ransac_internals.h"
 
 using namespace mrpt;
 using namespace mrpt::tfest;
@@ -25,35 +28,101 @@ using namespace mrpt::poses;
 using namespace mrpt::math;
 using namespace std;
 
-//#define AVOID_MULTIPLE_CORRESPONDENCES
+namespace
+{
+/** Output of one RANSAC hypothesis */
+struct TSE2Hypothesis
+{
+	TMatchingPairList subSet;
+	CPosePDFGaussian estimation;
+	double rmse{std::numeric_limits<double>::max()};
+};
+
+/** Per-thread working memory */
+struct TSE2Scratch
+{
+	std::vector<bool> alreadySelectedThis, alreadySelectedOther;
+	std::vector<size_t> corrsIdxsPermutation;
+	CPoint2DPDFGaussian pt_this;
+};
+
+/** Groups of landmarks with exactly the same coordinates. For each landmark
+ * index, the list of all the indices in its group, or an empty list if it
+ * has no duplicates. */
+struct TDuplicatedLandmarks
+{
+	std::vector<std::vector<unsigned int>> this_idxs, other_idxs;
+};
+
+struct TPoint3DHash
+{
+	size_t operator()(const std::array<float, 3>& p) const
+	{
+		size_t h = 0;
+		for (const float v : p)
+			h ^= std::hash<float>()(v) + 0x9e3779b9 + (h << 6) + (h >> 2);
+		return h;
+	}
+};
+
+void findDuplicatedLandmarks(
+	const TMatchingPairList& corrs, unsigned int maxThis,
+	unsigned int maxOther, TDuplicatedLandmarks& dups)
+{
+	std::unordered_map<std::array<float, 3>, std::vector<unsigned int>,
+					   TPoint3DHash>
+		groupsThis, groupsOther;
+	auto addUnique = [](std::vector<unsigned int>& v, unsigned int idx) {
+		if (std::find(v.begin(), v.end(), idx) == v.end()) v.push_back(idx);
+	};
+	for (const auto& c : corrs)
+	{
+		addUnique(groupsThis[{c.this_x, c.this_y, c.this_z}], c.this_idx);
+		addUnique(groupsOther[{c.other_x, c.other_y, c.other_z}], c.other_idx);
+	}
+	dups.this_idxs.assign(maxThis + 1, {});
+	dups.other_idxs.assign(maxOther + 1, {});
+	for (const auto& g : groupsThis)
+		if (g.second.size() > 1)
+			for (const auto idx : g.second) dups.this_idxs[idx] = g.second;
+	for (const auto& g : groupsOther)
+		if (g.second.size() > 1)
+			for (const auto idx : g.second) dups.other_idxs[idx] = g.second;
+}
 
 // mark this pair as "selected" so it won't be picked again:
 void markAsPicked(
-	const TMatchingPair& c, std::vector<bool>& alreadySelectedThis,
-	std::vector<bool>& alreadySelectedOther
-#ifdef AVOID_MULTIPLE_CORRESPONDENCES
-	,
-	const std::vector<std::vector<int>>& listDuplicatedLandmarksThis
-#endif
-)
+	const TMatchingPair& c, TSE2Scratch& scratch,
+	const TDuplicatedLandmarks* dups)
+{
+	ASSERTDEB_(c.this_idx < scratch.alreadySelectedThis.size());
+	ASSERTDEB_(c.other_idx < scratch.alreadySelectedOther.size());
+
+	scratch.alreadySelectedThis[c.this_idx] = true;
+	scratch.alreadySelectedOther[c.other_idx] = true;
+	if (dups)
+	{
+		for (const auto idx : dups->this_idxs[c.this_idx])
+			scratch.alreadySelectedThis[idx] = true;
+		for (const auto idx : dups->other_idxs[c.other_idx])
+			scratch.alreadySelectedOther[idx] = true;
+	}
+}
+
+/** Hash of the pairings in a consensus set, to detect repeated sets */
+size_t hashSubSet(const TMatchingPairList& subSet)
 {
-	ASSERTDEB_(c.this_idx < alreadySelectedThis.size());
-	ASSERTDEB_(c.other_idx < alreadySelectedOther.size());
-
-#ifndef AVOID_MULTIPLE_CORRESPONDENCES
-	alreadySelectedThis[c.this_idx] = true;
-	alreadySelectedOther[c.other_idx] = true;
-#else
-	for (std::vector<int>::iterator it1 =
-			 listDuplicatedLandmarksThis[c.this_idx].begin();
-		 it1 != listDuplicatedLandmarksThis[c.this_idx].end(); it1++)
-		alreadySelectedThis[*it1] = true;
-	for (std::vector<int>::iterator it2 =
-			 listDuplicatedLandmarksOther[c.other_idx].begin();
-		 it2 != listDuplicatedLandmarksOther[c.other_idx].end(); it2++)
-		alreadySelectedOther[*it2] = true;
-#endif
+	size_t h = subSet.size();
+	for (const auto& c : subSet)
+	{
+		h ^= std::hash<unsigned int>()(c.this_idx) + 0x9e3779b9 + (h << 6) +
+			 (h >> 2);
+		h ^= std::hash<unsigned int>()(c.other_idx) + 0x9e3779b9 + (h << 6) +
+			 (h >> 2);
+	}
+	return h;
 }
+}  // namespace
 
 /*---------------------------------------------------------------
 
@@ -80,12 +149,6 @@ bool tfest::se2_l2_robust(
 	const double normalizationStd, const TSE2RobustParams& params,
 	TSE2RobustResult& results)
 {
-	//#define DO_PROFILING
-
-#ifdef DO_PROFILING
-	CTimeLogger timlog;
-#endif
-
 	const size_t nCorrs = in_correspondences.size();
 
 	// Default: 2 * normalizationStd ("noise level")
@@ -104,9 +167,6 @@ bool tfest::se2_l2_robust(
 		return false;
 	}
 
-#ifdef DO_PROFILING
-	timlog.enter("ransac.find_max*");
-#endif
 	// Find the max. index of "this" and "other:
 	unsigned int maxThis = 0, maxOther = 0;
 	for (const auto& in_correspondence : in_correspondences)
@@ -114,13 +174,6 @@ bool tfest::se2_l2_robust(
 		maxThis = max(maxThis, in_correspondence.this_idx);
 		maxOther = max(maxOther, in_correspondence.other_idx);
 	}
-#ifdef DO_PROFILING
-	timlog.leave("ransac.find_max*");
-#endif
-
-#ifdef DO_PROFILING
-	timlog.enter("ransac.count_unique_corrs");
-#endif
 
 	// Fill out 2 arrays indicating whether each element has a correspondence:
 	std::vector<bool> hasCorrThis(maxThis + 1, false);
@@ -136,9 +189,6 @@ bool tfest::se2_l2_robust(
 			howManyDifCorrs++;
 		}
 	}
-#ifdef DO_PROFILING
-	timlog.leave("ransac.count_unique_corrs");
-#endif
 
 	// Clear the set of output particles:
 	results.transformation.clear();
@@ -153,139 +203,62 @@ bool tfest::se2_l2_robust(
 		return false;
 	}
 
-#ifdef AVOID_MULTIPLE_CORRESPONDENCES
-	unsigned k;
 	// Find duplicated landmarks (from SIFT features with different
 	// descriptors,etc...)
 	//   this is to avoid establishing multiple correspondences for the same
 	//   physical point!
-	// ------------------------------------------------------------------------------------------------
-	std::vector<std::vector<int>> listDuplicatedLandmarksThis(maxThis + 1);
-	ASSERT_(nCorrs >= 1);
-	for (k = 0; k < nCorrs - 1; k++)
-	{
-		std::vector<int> duplis;
-		for (unsigned j = k; j < nCorrs - 1; j++)
-		{
-			if (in_correspondences[k].this_x == in_correspondences[j].this_x &&
-				in_correspondences[k].this_y == in_correspondences[j].this_y &&
-				in_correspondences[k].this_z == in_correspondences[j].this_z)
-				duplis.push_back(in_correspondences[j].this_idx);
-		}
-		listDuplicatedLandmarksThis[in_correspondences[k].this_idx] = duplis;
-	}
-
-	std::vector<std::vector<int>> listDuplicatedLandmarksOther(maxOther + 1);
-	for (k = 0; k < nCorrs - 1; k++)
-	{
-		std::vector<int> duplis;
-		for (unsigned j = k; j < nCorrs - 1; j++)
-		{
-			if (in_correspondences[k].other_x ==
-					in_correspondences[j].other_x &&
-				in_correspondences[k].other_y ==
-					in_correspondences[j].other_y &&
-				in_correspondences[k].other_z == in_correspondences[j].other_z)
-				duplis.push_back(in_correspondences[j].other_idx);
-		}
-		listDuplicatedLandmarksOther[in_correspondences[k].other_idx] = duplis;
-	}
-#endif
-
-	std::deque<TMatchingPairList> alreadyAddedSubSets;
-
-	CPosePDFGaussian referenceEstimation;
-	CPoint2DPDFGaussian pt_this;
+	TDuplicatedLandmarks duplicatedLandmarks;
+	if (params.ransac_detectDuplicatedLandmarks)
+		findDuplicatedLandmarks(
+			in_correspondences, maxThis, maxOther, duplicatedLandmarks);
+	const TDuplicatedLandmarks* dups = params.ransac_detectDuplicatedLandmarks
+										   ? &duplicatedLandmarks
+										   : nullptr;
 
 	const double ransac_consistency_test_chi2_quantile = 0.99;
 	const double chi2_thres_dim1 =
 		mrpt::math::chi2inv(ransac_consistency_test_chi2_quantile, 1);
 
-	// -------------------------
-	//		The RANSAC loop
-	// -------------------------
-	size_t largest_consensus_yet = 0;  // Used for dynamic # of steps
-	double largestSubSet_RMSE = std::numeric_limits<double>::max();
-
-	results.ransac_iters = params.ransac_nSimulations;
-	const bool use_dynamic_iter_number = results.ransac_iters == 0;
-	if (use_dynamic_iter_number)
-	{
-		ASSERT_(
-			params.probability_find_good_model > 0 &&
-			params.probability_find_good_model < 1);
-		// Set an initial # of iterations:
-		results.ransac_iters = 10;  // It doesn't matter actually, since will be
-		// changed in the first loop
-	}
-
-	std::vector<bool> alreadySelectedThis, alreadySelectedOther;
-
-	if (!params.ransac_algorithmForLandmarks)
-	{
-		alreadySelectedThis.assign(maxThis + 1, false);
-		alreadySelectedOther.assign(maxOther + 1, false);
-	}
-	// else -> It will be done anyway inside the for() below
-
-	// First: Build a permutation of the correspondences to pick from it
-	// sequentially:
-	std::vector<size_t> corrsIdxs(nCorrs), corrsIdxsPermutation;
+	// Indices of the correspondences, to pick from a random permutation of
+	// them in each iteration:
+	std::vector<size_t> corrsIdxs(nCorrs);
 	for (size_t i = 0; i < nCorrs; i++) corrsIdxs[i] = i;
 
-	size_t iter_idx;
-	for (iter_idx = 0; iter_idx < results.ransac_iters;
-		 iter_idx++)  // results.ransac_iters can be dynamic
-	{
-#ifdef DO_PROFILING
-		CTimeLoggerEntry tle(timlog, "ransac.iter");
-#endif
-
-#ifdef DO_PROFILING
-		timlog.enter("ransac.permute");
-#endif
-		getRandomGenerator().permuteVector(corrsIdxs, corrsIdxsPermutation);
-
-#ifdef DO_PROFILING
-		timlog.leave("ransac.permute");
-#endif
+	// --------------------------------------------------------
+	//  RANSAC hypothesis: build a consensus set from a random
+	//  permutation of the correspondences.
+	//  (Invoked in parallel from several threads)
+	// --------------------------------------------------------
+	auto generateHypothesis = [&](size_t /*iter_idx*/, CRandomGenerator& rng,
+								  TSE2Scratch& scratch, TSE2Hypothesis& hyp) {
+		rng.permuteVector(corrsIdxs, scratch.corrsIdxsPermutation);
 
-		TMatchingPairList subSet;
+		TMatchingPairList& subSet = hyp.subSet;
+		CPosePDFGaussian& referenceEstimation = hyp.estimation;
+		subSet.clear();
 
 		// Select a subset of correspondences at random:
-		if (params.ransac_algorithmForLandmarks)
+		// (For points: do not repeat the corrs, and take the number of corrs
+		// as weights)
+		if (params.ransac_algorithmForLandmarks ||
+			scratch.alreadySelectedThis.empty())
 		{
-#ifdef DO_PROFILING
-			timlog.enter("ransac.reset_selection_marks");
-#endif
-			alreadySelectedThis.assign(maxThis + 1, false);
-			alreadySelectedOther.assign(maxOther + 1, false);
-#ifdef DO_PROFILING
-			timlog.leave("ransac.reset_selection_marks");
-#endif
-		}
-		else
-		{
-			// For points: Do not repeat the corrs, and take the number of corrs
-			// as weights
+			scratch.alreadySelectedThis.assign(maxThis + 1, false);
+			scratch.alreadySelectedOther.assign(maxOther + 1, false);
 		}
 
-// Try to build a subsetof "ransac_maxSetSize" (maximum) elements that achieve
-// consensus:
-// ------------------------------------------------------------------------------------------
-#ifdef DO_PROFILING
-		timlog.enter("ransac.inner_loops");
-#endif
+		// Try to build a subset of "ransac_maxSetSize" (maximum) elements
+		// that achieve consensus:
 		for (unsigned int j = 0;
 			 j < nCorrs && subSet.size() < params.ransac_maxSetSize; j++)
 		{
-			const size_t idx = corrsIdxsPermutation[j];
+			const size_t idx = scratch.corrsIdxsPermutation[j];
 
 			const TMatchingPair& corr_j = in_correspondences[idx];
 
 			// Don't pick the same features twice!
-			if (alreadySelectedThis[corr_j.this_idx] ||
-				alreadySelectedOther[corr_j.other_idx])
+			if (scratch.alreadySelectedThis[corr_j.this_idx] ||
+				scratch.alreadySelectedOther[corr_j.other_idx])
 				continue;
 
 			// Additional user-provided filter:
@@ -300,21 +273,16 @@ bool tfest::se2_l2_robust(
 
 			if (subSet.size() < 2)
 			{
-				// ------------------------------------------------------------------------------------------------------
-				// If we are within the first two correspondences, just add them
-				// to the subset:
-				// ------------------------------------------------------------------------------------------------------
+				// If we are within the first two correspondences, just add
+				// them to the subset:
 				subSet.push_back(corr_j);
-				markAsPicked(corr_j, alreadySelectedThis, alreadySelectedOther);
+				markAsPicked(corr_j, scratch, dups);
 
 				if (subSet.size() == 2)
 				{
-					// Consistency Test: From
-
 					// Check the feasibility of this pair "idx1"-"idx2":
 					//  The distance between the pair of points in MAP1 must be
-					//  very close
-					//   to that of their correspondences in MAP2:
+					//  very close to that of their correspondences in MAP2:
 					const double corrs_dist1 =
 						mrpt::math::distanceBetweenPoints(
 							subSet[0].this_x, subSet[0].this_y,
@@ -355,109 +323,103 @@ bool tfest::se2_l2_robust(
 						// different pair:
 						subSet.erase(subSet.begin() + (subSet.size() - 1));
 					}
-					else
-					{
-						// Only mark as picked if we're really keeping it:
-						markAsPicked(
-							corr_j, alreadySelectedThis, alreadySelectedOther);
-					}
 				}
 			}
 			else
 			{
-#ifdef DO_PROFILING
-				timlog.enter("ransac.test_consistency");
-#endif
-
-				// ------------------------------------------------------------------------------------------------------
 				// The normal case:
 				//  - test for "consensus" with the current group:
 				//		- If it is compatible (ransac_maxErrorXY,
 				// ransac_maxErrorPHI), grow the "consensus set"
 				//		- If not, do not add it.
-				// ------------------------------------------------------------------------------------------------------
 
 				// Test for the mahalanobis distance between:
 				//  "referenceEstimation (+) point_other" AND "point_this"
 				referenceEstimation.composePoint(
 					mrpt::math::TPoint2D(corr_j.other_x, corr_j.other_y),
-					pt_this);
+					scratch.pt_this);
 
-				const double maha_dist = pt_this.mahalanobisDistanceToPoint(
-					corr_j.this_x, corr_j.this_y);
+				const double maha_dist =
+					scratch.pt_this.mahalanobisDistanceToPoint(
+						corr_j.this_x, corr_j.this_y);
 
-				const bool passTest =
-					maha_dist < params.ransac_mahalanobisDistanceThreshold;
-
-				if (passTest)
+				if (maha_dist < params.ransac_mahalanobisDistanceThreshold)
 				{
 					// OK, consensus passed:
 					subSet.push_back(corr_j);
-					markAsPicked(
-						corr_j, alreadySelectedThis, alreadySelectedOther);
+					markAsPicked(corr_j, scratch, dups);
 				}
 				// else -> Test failed
-
-#ifdef DO_PROFILING
-				timlog.leave("ransac.test_consistency");
-#endif
 			}  // end else "normal case"
-
 		}  // end for j
-#ifdef DO_PROFILING
-		timlog.leave("ransac.inner_loops");
-#endif
-
-		const bool has_to_eval_RMSE =
-			(subSet.size() >= params.ransac_minSetSize);
 
 		// Compute the RMSE of this matching and the corresponding
 		// transformation (only if we'll use this value below)
-		double this_subset_RMSE = 0;
-		if (has_to_eval_RMSE)
+		hyp.rmse = std::numeric_limits<double>::max();
+		if (subSet.size() >= params.ransac_minSetSize)
 		{
-#ifdef DO_PROFILING
-			CTimeLoggerEntry tle(timlog, "ransac.comp_rmse");
-#endif
-
 			// Recompute referenceEstimation from all the corrs:
 			tfest::se2_l2(subSet, referenceEstimation);
 			// Normalized covariance: scale!
 			referenceEstimation.cov *= square(normalizationStd);
 
+			double rmse = 0;
 			for (size_t k = 0; k < subSet.size(); k++)
 			{
 				double gx, gy;
 				referenceEstimation.mean.composePoint(
 					subSet[k].other_x, subSet[k].other_y, gx, gy);
 
-				this_subset_RMSE +=
-					mrpt::math::distanceSqrBetweenPoints<double>(
-						subSet[k].this_x, subSet[k].this_y, gx, gy);
+				rmse += mrpt::math::distanceSqrBetweenPoints<double>(
+					subSet[k].this_x, subSet[k].this_y, gx, gy);
 			}
-			this_subset_RMSE /= std::max(static_cast<size_t>(1), subSet.size());
-		}
-		else
-		{
-			this_subset_RMSE = std::numeric_limits<double>::max();
+			hyp.rmse = rmse / std::max(static_cast<size_t>(1), subSet.size());
 		}
+	};
+
+	// --------------------------------------------------------
+	//  Merge of hypotheses into the output SOG.
+	//  (Invoked sequentially, in order of iteration index)
+	// --------------------------------------------------------
+	// Consensus sets of each SOG mode, and a hash table from their contents
+	// to their indices in results.transformation:
+	std::vector<TMatchingPairList> alreadyAddedSubSets;
+	std::unordered_multimap<size_t, size_t> alreadyAddedSubSetsHash;
+
+	size_t largest_consensus_yet = 0;  // Used for dynamic # of steps
+	double largestSubSet_RMSE = std::numeric_limits<double>::max();
+
+	const bool use_dynamic_iter_number = params.ransac_nSimulations == 0;
+	if (use_dynamic_iter_number)
+	{
+		ASSERT_(
+			params.probability_find_good_model > 0 &&
+			params.probability_find_good_model < 1);
+	}
+	// Initial # of iterations (if dynamic, it doesn't matter actually, since
+	// it will be changed after the first hypothesis)
+	const size_t initial_iters =
+		use_dynamic_iter_number ? 10 : params.ransac_nSimulations;
+
+	auto consumeHypothesis = [&](size_t iter_idx, TSE2Hypothesis& hyp,
+								 size_t& max_iters) -> bool {
+		const TMatchingPairList& subSet = hyp.subSet;
+		const CPosePDFGaussian& referenceEstimation = hyp.estimation;
 
 		// Save the estimation result as a "particle", only if the subSet
-		// contains
-		//  "ransac_minSetSize" elements at least:
+		// contains "ransac_minSetSize" elements at least:
 		if (subSet.size() >= params.ransac_minSetSize)
 		{
 			// If this subset was previously added to the SOG, just increment
-			// its weight
-			//  and do not add a new mode:
+			// its weight and do not add a new mode:
 			int indexFound = -1;
+			size_t subSetHash = 0;
 
 			// JLBC Added DEC-2007: An alternative (optional) method to fuse
 			// Gaussian modes:
 			if (!params.ransac_fuseByCorrsMatch)
 			{
 				// Find matching by approximate match in the X,Y,PHI means
-				// -------------------------------------------------------------------
 				for (size_t i = 0; i < results.transformation.size(); i++)
 				{
 					double diffXY =
@@ -469,8 +431,6 @@ bool tfest::se2_l2_robust(
 					if (diffXY < params.ransac_fuseMaxDiffXY &&
 						diffPhi < params.ransac_fuseMaxDiffPhi)
 					{
-						// printf("Match by distance found: distXY:%f distPhi=%f
-						// deg\n",diffXY,RAD2DEG(diffPhi));
 						indexFound = i;
 						break;
 					}
@@ -480,16 +440,14 @@ bool tfest::se2_l2_robust(
 			{
 				// Find matching mode by exact match in the list of
 				// correspondences:
-				// -------------------------------------------------------------------
-				// Sort "subSet" in order to compare them easily!
-				// std::sort( subSet.begin(), subSet.end() );
-
-				// Try to find matching corrs:
-				for (size_t i = 0; i < alreadyAddedSubSets.size(); i++)
+				subSetHash = hashSubSet(subSet);
+				const auto range =
+					alreadyAddedSubSetsHash.equal_range(subSetHash);
+				for (auto it = range.first; it != range.second; ++it)
 				{
-					if (subSet == alreadyAddedSubSets[i])
+					if (subSet == alreadyAddedSubSets[it->second])
 					{
-						indexFound = i;
+						indexFound = it->second;
 						break;
 					}
 				}
@@ -509,7 +467,12 @@ bool tfest::se2_l2_robust(
 			else
 			{
 				// Add a new mode to the SOG:
-				alreadyAddedSubSets.push_back(subSet);
+				if (params.ransac_fuseByCorrsMatch)
+				{
+					alreadyAddedSubSetsHash.emplace(
+						subSetHash, alreadyAddedSubSets.size());
+					alreadyAddedSubSets.push_back(subSet);
+				}
 
 				CPosePDFSOG::TGaussianMode newSOGMode;
 				if (params.ransac_algorithmForLandmarks)
@@ -534,11 +497,9 @@ bool tfest::se2_l2_robust(
 			if (use_dynamic_iter_number)
 			{
 				// Update estimate of nCorrs, the number of trials to ensure we
-				// pick,
-				// with probability p, a data set with no outliers.
+				// pick, with probability p, a data set with no outliers.
 				const double fracinliers =
-					ninliers /
-					static_cast<double>(howManyDifCorrs);  // corrsIdxs.size());
+					ninliers / static_cast<double>(howManyDifCorrs);
 				double pNoOutliers =
 					1 - pow(fracinliers, static_cast<double>(
 											 2.0 /*minimumSizeSamplesToFit*/));
@@ -550,16 +511,16 @@ bool tfest::se2_l2_robust(
 					1.0 - std::numeric_limits<double>::epsilon(),
 					pNoOutliers);  // Avoid division by 0.
 				// Number of
-				results.ransac_iters =
+				max_iters = static_cast<size_t>(
 					log(1 - params.probability_find_good_model) /
-					log(pNoOutliers);
+					log(pNoOutliers));
 
-				results.ransac_iters = std::max(
-					results.ransac_iters, params.ransac_min_nSimulations);
+				max_iters = std::max<size_t>(
+					max_iters, params.ransac_min_nSimulations);
 
 				if (params.verbose)
 					cout << "[tfest::RANSAC] Iter #" << iter_idx
-						 << ":est. # iters=" << results.ransac_iters
+						 << ":est. # iters=" << max_iters
 						 << " pNoOutliers=" << pNoOutliers
 						 << " #inliers: " << ninliers << endl;
 			}
@@ -567,31 +528,43 @@ bool tfest::se2_l2_robust(
 
 		// Save the largest subset:
 		if (subSet.size() >= params.ransac_minSetSize &&
-			this_subset_RMSE < largestSubSet_RMSE)
+			hyp.rmse < largestSubSet_RMSE)
 		{
 			if (params.verbose)
 				cout << "[tfest::RANSAC] Iter #" << iter_idx
 					 << " Better subset: " << subSet.size()
-					 << " inliers, RMSE=" << this_subset_RMSE << endl;
+					 << " inliers, RMSE=" << hyp.rmse << endl;
 
 			results.largestSubSet = subSet;
-			largestSubSet_RMSE = this_subset_RMSE;
+			largestSubSet_RMSE = hyp.rmse;
 		}
 
 		// Is the found subset good enough?
-		if (subSet.size() >= params.ransac_minSetSize &&
-			this_subset_RMSE < MAX_RMSE_TO_END)
+		if (subSet.size() >= params.ransac_minSetSize)
 		{
-			break;  // end RANSAC iterations.
+			if (hyp.rmse < MAX_RMSE_TO_END) return false;
+			if (params.min_inliers_ratio_to_end > 0 &&
+				ninliers >= params.min_inliers_ratio_to_end * howManyDifCorrs)
+				return false;
 		}
+		return true;
+	};
+
+	// In "points" mode, each hypothesis excludes the correspondences already
+	// picked by the previous ones, so they must be evaluated sequentially:
+	const unsigned int num_threads =
+		params.ransac_algorithmForLandmarks ? params.num_threads : 1;
 
-#ifdef DO_PROFILING
-		timlog.leave("ransac.iter");
-#endif
-	}  // end for each iteration
+	// -------------------------
+	//		The RANSAC loop
+	// -------------------------
+	results.ransac_iters = internal::run_ransac<TSE2Hypothesis, TSE2Scratch>(
+		initial_iters, num_threads,
+		getRandomGenerator().drawUniform64bit(), generateHypothesis,
+		consumeHypothesis);
 
 	if (params.verbose)
-		cout << "[tfest::RANSAC] Finished after " << iter_idx
+		cout << "[tfest::RANSAC] Finished after " << results.ransac_iters
 			 << " iterations.\n";
 
 	// Set the weights of the particles to sum the unity:
@@ -0,0 +1,105 @@
+/* +------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)            |
+   |                          http://www.mrpt.org/                          |
+   |                                                                        |
+   | Copyright (c) 2005-2018, Individual contributors, see AUTHORS file     |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                |
+   | Released under BSD License. See details in http://www.mrpt.org/License |
+   +------------------------------------------------------------------------+ */
+
+#include <mrpt/tfest.h>
+#include <mrpt/random.h>
+#include <mrpt/poses/CPosePDFGaussian.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::tfest;
+using namespace mrpt::random;
+using namespace mrpt::poses;
+using namespace mrpt::math;
+using namespace std;
+
+// Landmarks seen from two poses, with all-vs-all candidate pairings, so most
+// of them are outliers:
+static void generate_2d_landmark_pairs(
+	const CPose2D& GT_pose, TMatchingPairList& corrs)
+{
+	const size_t N = 25;
+	auto& rnd = getRandomGenerator();
+	std::vector<TPoint2D> lms(N);
+	for (auto& lm : lms)
+	{
+		lm.x = rnd.drawUniform(-10.0, 10.0);
+		lm.y = rnd.drawUniform(-10.0, 10.0);
+	}
+	corrs.clear();
+	for (size_t i = 0; i < N; i++)
+	{
+		// landmark as seen from the "other" frame:
+		double ox, oy;
+		GT_pose.inverseComposePoint(lms[i].x, lms[i].y, ox, oy);
+		ox += rnd.drawGaussian1D(0, 0.01);
+		oy += rnd.drawGaussian1D(0, 0.01);
+		for (size_t j = 0; j < N; j++)
+		{
+			if (j != i && rnd.drawUniform(0.0, 1.0) > 0.3) continue;
+			TMatchingPair p;
+			p.this_idx = j;
+			p.this_x = lms[j].x;
+			p.this_y = lms[j].y;
+			p.other_idx = i;
+			p.other_x = ox;
+			p.other_y = oy;
+			corrs.push_back(p);
+		}
+	}
+}
+
+TEST(tfest, se2_l2_robust_multithread)
+{
+	getRandomGenerator().randomize(1234);
+	const CPose2D GT_pose(2.0, -1.0, DEG2RAD(30.0));
+	TMatchingPairList corrs;
+	generate_2d_landmark_pairs(GT_pose, corrs);
+
+	TSE2RobustParams params;
+	params.ransac_minSetSize = 5;
+	params.ransac_maxSetSize = corrs.size();
+	params.ransac_mahalanobisDistanceThreshold = 3.0;
+	params.ransac_nSimulations = 0;  // 0=auto
+	params.ransac_min_nSimulations = 200;
+	params.ransac_algorithmForLandmarks = true;
+
+	// The result must only depend on the RNG seed, not on the threads:
+	std::vector<TSE2RobustResult> results;
+	for (const unsigned int nThreads : {1u, 4u})
+	{
+		params.num_threads = nThreads;
+		getRandomGenerator().randomize(5678);
+		TSE2RobustResult res;
+		EXPECT_TRUE(se2_l2_robust(corrs, 0.02, params, res));
+		results.push_back(res);
+
+		CPosePDFGaussian sol;
+		se2_l2(res.largestSubSet, sol);
+		EXPECT_LT(sol.mean.distanceTo(GT_pose), 0.05)
+			<< "nThreads=" << nThreads;
+		EXPECT_NEAR(wrapToPi(sol.mean.phi() - GT_pose.phi()), 0, 0.01);
+	}
+	EXPECT_EQ(results[0].ransac_iters, results[1].ransac_iters);
+	EXPECT_TRUE(results[0].largestSubSet == results[1].largestSubSet);
+	EXPECT_EQ(
+		results[0].transformation.size(), results[1].transformation.size());
+
+	// Early termination once enough inliers are found:
+	params.num_threads = 0;
+	params.max_rmse_to_end = 1e-9;
+	TSE2RobustResult res_all, res_early;
+	getRandomGenerator().randomize(5678);
+	EXPECT_TRUE(se2_l2_robust(corrs, 0.02, params, res_all));
+	EXPECT_GE(res_all.ransac_iters, params.ransac_min_nSimulations);
+	params.min_inliers_ratio_to_end = 0.5;
+	getRandomGenerator().randomize(5678);
+	EXPECT_TRUE(se2_l2_robust(corrs, 0.02, params, res_early));
+	EXPECT_LT(res_early.ransac_iters, res_all.ransac_iters);
+}
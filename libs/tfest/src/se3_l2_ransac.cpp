@@ -18,6 +18,7 @@
 #include <mrpt/math/utils.h>  // linspace()
 #include <numeric>
 #include <iostream>
+#include "ransac_internals.h"
 
 using namespace mrpt;
 using namespace mrpt::tfest;
@@ -55,7 +56,6 @@ bool tfest::se3_l2_robust(
 	double min_err =
 		std::numeric_limits<double>::max();  // Minimum error achieved so far
 	size_t max_size = 0;  // Maximum size of the consensus set so far
-	double scale;  // Output scale
 
 	const size_t n =
 		params.ransac_minSetSize;  // Minimum number of points to fit the model
@@ -70,20 +70,46 @@ bool tfest::se3_l2_robust(
 		"Minimum number of points to be considered a good set is < Minimum "
 		"number of points to fit the model");
 
+	// Indices of the correspondences, to pick from a random permutation of
+	// them in each iteration:
+	std::vector<uint32_t> rub;
+	mrpt::math::linspace((int)0, (int)N - 1, (int)N, rub);
+
+	// One RANSAC hypothesis: consensus set, and the transformation estimated
+	// from it, if it is large enough:
+	struct THypothesis
+	{
+		std::vector<uint32_t> cSet;
+		CPose3DQuat cIOutQuat;
+		double scale{.0};
+		double err{std::numeric_limits<double>::max()};
+	};
+	struct TScratch
+	{
+		std::vector<uint32_t> mbSet;
+		TMatchingPairList mbInliers, cSetInliers;
+	};
+
 	// -------------------------------------------
-	// MAIN loop
+	// RANSAC hypothesis (invoked in parallel from several threads)
 	// -------------------------------------------
-	for (size_t iterations = 0; iterations < max_it; iterations++)
-	{
-		// printf("Iteration %2u of %u", iterations+1, max_it );
+	auto generateHypothesis = [&](size_t iterations, CRandomGenerator& rng,
+								  TScratch& scratch, THypothesis& hyp) {
+		std::vector<uint32_t>& mbSet = scratch.mbSet;
+		std::vector<uint32_t>& cSet = hyp.cSet;
+		cSet.clear();
+		hyp.err = std::numeric_limits<double>::max();
+		// se3_l2() does not fully overwrite its output pose, so reset it to
+		// make the result independent of the previous hypothesis:
+		hyp.cIOutQuat = CPose3DQuat();
+		double scale;
 
 		// Generate maybe inliers
-		std::vector<uint32_t> rub, mbSet, cSet;
-		mrpt::math::linspace((int)0, (int)N - 1, (int)N, rub);
-		getRandomGenerator().permuteVector(rub, mbSet);
+		rng.permuteVector(rub, mbSet);
 
 		// Compute first inliers output
-		TMatchingPairList mbInliers;
+		TMatchingPairList& mbInliers = scratch.mbInliers;
+		mbInliers.clear();
 		mbInliers.reserve(n);
 		for (size_t i = 0; mbInliers.size() < n && i < N; i++)
 		{
@@ -110,7 +136,7 @@ bool tfest::se3_l2_robust(
 				std::cerr << "[tfest::se3_l2_robust] Iter " << iterations
 						  << ": It was not possible to find the min no of "
 							 "(compatible) matching pairs.\n";
-			continue;  // Try again
+			return;  // Try again
 		}
 
 		CPose3DQuat mbOutQuat;
@@ -121,7 +147,7 @@ bool tfest::se3_l2_robust(
 			std::cerr << "[tfest::se3_l2_robust] tfest::se3_l2() returned "
 						 "false for tentative subset during RANSAC "
 						 "iteration!\n";
-			continue;
+			return;
 		}
 
 		// Maybe inliers Output
@@ -181,26 +207,20 @@ bool tfest::se3_l2_robust(
 				// Inlier detected -> add to the inlier list
 				cSet.push_back(idx);
 			}  // end if INLIERS
-			else
-			{
-				// cout << " It " << iterations << " - RANSAC Outlier Detected:
-				// " << k << endl;
-			}
 		}  // end 'inner' for
 
 		// Test cSet size
 		if (cSet.size() >= d)
 		{
 			// Good set of points found
-			TMatchingPairList cSetInliers;
+			TMatchingPairList& cSetInliers = scratch.cSetInliers;
 			cSetInliers.resize(cSet.size());
 			for (unsigned int m = 0; m < cSet.size(); m++)
 				cSetInliers[m] = in_correspondences[cSet[m]];
 
 			// Compute output: Consensus Set + Initial Inliers Guess
-			CPose3DQuat cIOutQuat;
 			res = mrpt::tfest::se3_l2(
-				cSetInliers, cIOutQuat, scale,
+				cSetInliers, hyp.cIOutQuat, hyp.scale,
 				params.forceScaleToUnity);  // Compute output
 			ASSERTMSG_(
 				res,
@@ -208,34 +228,46 @@ bool tfest::se3_l2_robust(
 				"RANSAC iteration!");
 
 			// Compute error for consensus_set
-			const CPose3D cIOut = CPose3D(cIOutQuat);
-			const double err = std::sqrt(
+			const CPose3D cIOut = CPose3D(hyp.cIOutQuat);
+			hyp.err = std::sqrt(
 				square(mbOut_vec[0] - cIOut.x()) +
 				square(mbOut_vec[1] - cIOut.y()) +
 				square(mbOut_vec[2] - cIOut.z()) +
 				square(mbOut_vec[3] - cIOut.yaw()) +
 				square(mbOut_vec[4] - cIOut.pitch()) +
 				square(mbOut_vec[5] - cIOut.roll()) +
-				square(mbOut_vec[6] - scale));
-
-			// Is the best set of points so far?
-			if (err < min_err && cSet.size() >= max_size)
-			{
-				min_err = err;
-				max_size = cSet.size();
-				results.transformation = cIOutQuat;
-				results.scale = scale;
-				results.inliers_idx = cSet;
-			}  // end if SCALE ERROR
-			// printf(" - Consensus set size: %u - Error: %.6f\n", (unsigned
-			// int)cSet.size(), err );
+				square(mbOut_vec[6] - hyp.scale));
 		}  // end if cSet.size() > d
-		else
+	};
+
+	// -------------------------------------------
+	// Selection of the best hypothesis (invoked in order of iteration index)
+	// -------------------------------------------
+	auto consumeHypothesis = [&](size_t /*iterations*/, THypothesis& hyp,
+								 size_t& /*max_iters*/) -> bool {
+		if (hyp.cSet.size() < d) return true;
+
+		// Is the best set of points so far?
+		if (hyp.err < min_err && hyp.cSet.size() >= max_size)
 		{
-			// printf(" - Consensus set size: %u - Not big enough!\n", (unsigned
-			// int)cSet.size() );
+			min_err = hyp.err;
+			max_size = hyp.cSet.size();
+			results.transformation = hyp.cIOutQuat;
+			results.scale = hyp.scale;
+			results.inliers_idx = hyp.cSet;
 		}
-	}  // end 'iterations' for
+		// Good enough?
+		return !(
+			params.min_inliers_ratio_to_end > 0 &&
+			hyp.cSet.size() >= params.min_inliers_ratio_to_end * N);
+	};
+
+	// -------------------------------------------
+	// MAIN loop
+	// -------------------------------------------
+	internal::run_ransac<THypothesis, TScratch>(
+		max_it, params.num_threads, getRandomGenerator().drawUniform64bit(),
+		generateHypothesis, consumeHypothesis);
 
 	if (max_size == 0)
 	{
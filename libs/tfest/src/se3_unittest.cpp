@@ -223,3 +223,34 @@ TEST(tfest, se3_l2_robust)
 					 << outQuat << endl;
 	}
 }
+
+TEST(tfest, se3_l2_robust_multithread)
+{
+	TPoints pA, pB;  // The input points
+	generate_points(pA, pB);
+
+	TMatchingPairList list;
+	generate_list_of_points(pA, pB, list);
+	// Add an outlier:
+	list[4].other_x += 1.0;
+
+	mrpt::tfest::TSE3RobustParams params;
+	params.ransac_minSetSize = 3;
+	params.ransac_maxSetSizePct = 3.0 / list.size();
+
+	// The result must only depend on the RNG seed, not on the threads:
+	std::vector<mrpt::tfest::TSE3RobustResult> results(2);
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		params.num_threads = i == 0 ? 1 : 4;
+		getRandomGenerator().randomize(1234);
+		EXPECT_TRUE(mrpt::tfest::se3_l2_robust(list, params, results[i]));
+	}
+	EXPECT_EQ(results[0].inliers_idx, results[1].inliers_idx);
+	for (unsigned int i = 0; i < 7; ++i)
+		EXPECT_EQ(results[0].transformation[i], results[1].transformation[i]);
+	EXPECT_EQ(
+		std::count(
+			results[0].inliers_idx.begin(), results[0].inliers_idx.end(), 4),
+		0);
+}